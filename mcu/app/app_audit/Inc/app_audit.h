@@ -0,0 +1,100 @@
+/**
+ * @file    app_audit.h
+ * @author  Yukikaze
+ * @brief   异步审计上报（RFID_AUDIT 入队、重复读卡合并、丢失汇总）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note
+ * - 审计事件经 app_uplink 队列异步上报，按事件分优先级类别（见 uplink_sched.h）。
+ * - 合并：同卡同柜的 CARD_READ（按柜门分槽位跟踪，不同柜门交替读卡互不打断） 在 APP_AUDIT_COALESCE_MS 窗口内只保留一条记录，
+ *   后续读卡直接改写仍在队列中、尚未发出的那条（cnt/firstMs/lastMs），不再占用新的队列槽位；
+ *   那条已经发出时另起一条新记录。
+ * - 汇总：本地入队被拒与 uplink 内部被挤掉/过期/超限丢弃都计入丢失数；丢失数增长时
+ *   （最多每 APP_AUDIT_SUMMARY_MS 一次）上报一条 ev=AUDIT_DROP 的汇总记录（cnt=本次新增丢失数），
+ *   汇总记录尚未发出时同样原地累加。过载时后端看到的是“汇总后的数据”，而不是悄悄缺失。
+ * - 积压：启用 SDRAM 后备队列（UPLINK_BACKLOG_ENABLE）时审计记录不过期，上级长时间不可用也只是排队，
+ *   仍在后备队列里的记录同样可以原地合并（uplink_update_json 也查后备队列）。
+ * - 线程：只由鉴权任务（Task_RfidAuth）调用，模块状态不加锁。
+ */
+
+#ifndef __APP_AUDIT_H
+#define __APP_AUDIT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink.h"
+
+#include <stdint.h>
+
+/** CARD_READ 合并窗口（毫秒，从该条记录的首次读卡起算） */
+#ifndef APP_AUDIT_COALESCE_MS
+#define APP_AUDIT_COALESCE_MS 10000U
+#endif
+
+/** 同时跟踪的合并槽位数（每个柜门占一个，超出时替换最久未读卡的柜门） */
+#ifndef APP_AUDIT_COALESCE_SLOTS
+#define APP_AUDIT_COALESCE_SLOTS 4U
+#endif
+
+/** 丢失汇总记录的最小间隔（毫秒） */
+#ifndef APP_AUDIT_SUMMARY_MS
+#define APP_AUDIT_SUMMARY_MS 5000U
+#endif
+
+/**
+ * 审计记录的存活时长（毫秒，传给 uplink_enqueue_reserve）
+ * - 启用 SDRAM 后备队列时为 0（不过期）：上级断开几小时，记录也只是排队等待，恢复后按顺序补报；
+ * - 未启用时沿用类别默认值（NORMAL 2min / BULK 30s），热队列只有几个槽位，过时记录让位给新事件。
+ */
+#ifndef APP_AUDIT_TTL_MS
+#if UPLINK_BACKLOG_ENABLE
+#define APP_AUDIT_TTL_MS 0U
+#else
+#define APP_AUDIT_TTL_MS UPLINK_TTL_CLASS_DEFAULT
+#endif
+#endif
+
+/** 丢失汇总事件名 */
+#define APP_AUDIT_EV_DROP "AUDIT_DROP"
+
+/**
+ * @brief 审计模块统计
+ *
+ */
+typedef struct
+{
+    uint32_t reported;  /* 调用 AppAudit_Report 的次数（含被合并的） */
+    uint32_t enqueued;  /* 新入队的审计记录数 */
+    uint32_t coalesced; /* 合并进已排队记录的读卡次数 */
+    uint32_t rejected;  /* 入队被拒数 */
+    uint32_t summaries; /* 新入队的丢失汇总记录数 */
+} app_audit_stats_t;
+
+void AppAudit_Init(uplink_t *uplink);
+
+void AppAudit_Report(const char *event,
+                     uint32_t session_id,
+                     const char *locker_id,
+                     const char *uid_hex,
+                     int32_t code,
+                     uint16_t http_status,
+                     uint8_t network_ok,
+                     uint8_t door_ok,
+                     uint8_t cache_hit,
+                     uint32_t now_ms);
+
+void AppAudit_Poll(uint32_t now_ms);
+
+uint32_t AppAudit_GetLost(void);
+
+void AppAudit_GetStats(app_audit_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_AUDIT_H */
@@ -0,0 +1,517 @@
+/**
+ * @file    app_audit.c
+ * @author  Yukikaze
+ * @brief   异步审计上报实现（RFID_AUDIT 入队、重复读卡合并、丢失汇总）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note
+ * - 合并与汇总都依赖 uplink_update_json：只改写尚未发出过的记录，已发出/正在发送时改为新入队一条，
+ *   因此每次读卡、每个丢失都恰好计入一条记录，不会重复也不会遗漏。
+ * - 载荷字段与原 Task_RfidAuth_Audit 一致；合并/汇总记录额外带 cnt、firstMs、lastMs（设备毫秒时钟）。
+ */
+
+#include "app_audit.h"
+
+#include <string.h>
+
+/**
+ * 内部类型/变量
+ */
+
+/* 仍可合并的 CARD_READ 记录（每个柜门一个槽位） */
+typedef struct
+{
+    uint8_t valid;
+    uint32_t message_id;
+    uint32_t session_id; /* 首次读卡的会话号 */
+    char locker_id[16];
+    char uid_hex[16];
+    uint8_t cache_hit;
+    uint32_t cnt;
+    uint32_t first_ms;
+    uint32_t last_ms;
+} app_audit_card_read_t;
+
+/* 丢失汇总状态 */
+typedef struct
+{
+    uint32_t seen_lost;      /* 已观察到的累计丢失数 */
+    uint32_t reported_lost;  /* 已计入汇总记录的累计丢失数 */
+    uint32_t unrep_first_ms; /* 未汇总丢失的首次观察时刻 */
+
+    uint8_t valid;        /* 1=最近一条汇总记录可能仍在队列中（可原地累加） */
+    uint32_t message_id;  /* 最近一条汇总记录 */
+    uint32_t cnt;         /* 该记录承载的丢失数 */
+    uint32_t first_ms;    /* 该记录的首次丢失时刻 */
+    uint8_t emitted;      /* 是否入队过汇总记录（限频用） */
+    uint32_t last_emit_ms;
+} app_audit_drop_t;
+
+/* RFID_AUDIT 载荷字段表（顺序即输出顺序） */
+#define APP_AUDIT_FIELDS(X)         \
+    X(str, ev, event)               \
+    X(u32, sid, session_id)         \
+    X(str, lockerId, locker_id)     \
+    X(str, uid, uid_hex)            \
+    X(i32, code, code)              \
+    X(u32, http, http_status)       \
+    X(u32, net, network_ok)         \
+    X(u32, door, door_ok)           \
+    X(u32, cache, cache_hit)        \
+    X(u32, drop, drop)
+
+/* 合并/汇总记录追加的字段 */
+#define APP_AUDIT_AGG_FIELDS(X)   \
+    X(u32, cnt, cnt)              \
+    X(u32, firstMs, first_ms)     \
+    X(u32, lastMs, last_ms)
+
+UPLINK_JSON_SCHEMA_DEFINE(app_audit_json, APP_AUDIT_FIELDS)
+UPLINK_JSON_SCHEMA_DEFINE(app_audit_agg_json, APP_AUDIT_AGG_FIELDS)
+
+static uplink_t *g_auditUplink = NULL;
+static app_audit_stats_t g_auditStats;
+static app_audit_card_read_t g_cardRead[APP_AUDIT_COALESCE_SLOTS];
+static app_audit_drop_t g_auditDrop;
+
+/**
+ * @brief 审计事件的上报优先级类别
+ *
+ * @note 说明：
+ * - 开门失败、鉴权网络失败、远程开门需要后端尽快感知，走 HIGH；丢失汇总也走 HIGH，保证过载时能挤进队列；
+ * - CARD_READ 每次刷卡都会产生、可能成批涌入，走 BULK（类别满时挤掉最旧的读卡记录）；
+ * - 其余业务结果走 NORMAL。
+ */
+static uplink_prio_t AppAudit_Prio(const char *event)
+{
+    if ((strcmp(event, "DOOR_OPEN_FAIL") == 0) || (strcmp(event, "AUTH_NET_FAIL") == 0) ||
+        (strcmp(event, "REMOTE_OPEN") == 0) || (strcmp(event, APP_AUDIT_EV_DROP) == 0))
+    {
+        return UPLINK_PRIO_HIGH;
+    }
+
+    if (strcmp(event, "CARD_READ") == 0)
+    {
+        return UPLINK_PRIO_BULK;
+    }
+
+    return UPLINK_PRIO_NORMAL;
+}
+
+/**
+ * @brief 生成审计载荷
+ *
+ * @param cnt 合并/汇总计数；0=普通记录（不带 cnt/firstMs/lastMs）
+ * @param drop 累计丢失数（载荷中的 drop）
+ * @return uint8_t 1=成功；0=载荷过长
+ */
+static uint8_t AppAudit_Format(char *buf,
+                               size_t buf_len,
+                               const char *event,
+                               uint32_t session_id,
+                               const char *locker_id,
+                               const char *uid_hex,
+                               int32_t code,
+                               uint16_t http_status,
+                               uint8_t network_ok,
+                               uint8_t door_ok,
+                               uint8_t cache_hit,
+                               uint32_t cnt,
+                               uint32_t first_ms,
+                               uint32_t last_ms,
+                               uint32_t drop)
+{
+    uplink_json_writer_t w;
+    app_audit_json_t rec;
+    app_audit_agg_json_t agg;
+
+    rec.event = event;
+    rec.session_id = session_id;
+    rec.locker_id = locker_id;
+    rec.uid_hex = uid_hex;
+    rec.code = code;
+    rec.http_status = http_status;
+    rec.network_ok = network_ok;
+    rec.door_ok = door_ok;
+    rec.cache_hit = cache_hit;
+    rec.drop = drop;
+
+    uplink_json_writer_init(&w, buf, buf_len);
+    uplink_json_obj_begin(&w);
+    app_audit_json_write(&w, &rec);
+    if (cnt != 0U)
+    {
+        agg.cnt = cnt;
+        agg.first_ms = first_ms;
+        agg.last_ms = last_ms;
+        app_audit_agg_json_write(&w, &agg);
+    }
+    uplink_json_obj_end(&w);
+
+    return (uplink_json_writer_finish(&w, NULL) == UPLINK_OK) ? 1U : 0U;
+}
+
+/**
+ * @brief 查找柜门对应的合并槽位
+ *
+ * @param locker_id 柜门 ID
+ * @param create 1=没有时分配一个（优先空槽，否则替换最久未读卡的槽位）；0=只查找
+ * @return app_audit_card_read_t* 槽位；没有返回 NULL
+ */
+static app_audit_card_read_t *AppAudit_CardReadSlot(const char *locker_id, uint8_t create)
+{
+    app_audit_card_read_t *victim = NULL;
+    uint32_t i;
+
+    for (i = 0U; i < APP_AUDIT_COALESCE_SLOTS; i++)
+    {
+        if ((g_cardRead[i].valid != 0U) && (strcmp(g_cardRead[i].locker_id, locker_id) == 0))
+        {
+            return &g_cardRead[i];
+        }
+    }
+
+    if (create == 0U)
+    {
+        return NULL;
+    }
+
+    for (i = 0U; i < APP_AUDIT_COALESCE_SLOTS; i++)
+    {
+        if (g_cardRead[i].valid == 0U)
+        {
+            return &g_cardRead[i];
+        }
+        if ((victim == NULL) || ((int32_t)(g_cardRead[i].last_ms - victim->last_ms) < 0))
+        {
+            victim = &g_cardRead[i];
+        }
+    }
+
+    return victim;
+}
+
+/**
+ * @brief 尝试把一次 CARD_READ 合并进仍在队列中的记录
+ *
+ * @param rec 该柜门的合并槽位
+ * @param uid_hex 卡号
+ * @param now_ms 当前时间（毫秒）
+ * @return uint8_t 1=已合并；0=不能合并（需要新入队）
+ */
+static uint8_t AppAudit_CoalesceCardRead(app_audit_card_read_t *rec, const char *uid_hex, uint32_t now_ms)
+{
+    char payload[UPLINK_MAX_PAYLOAD_LEN];
+
+    if ((rec->valid == 0U) || (strcmp(rec->uid_hex, uid_hex) != 0) ||
+        ((uint32_t)(now_ms - rec->first_ms) >= APP_AUDIT_COALESCE_MS))
+    {
+        return 0U;
+    }
+
+    if (AppAudit_Format(payload,
+                        sizeof(payload),
+                        "CARD_READ",
+                        rec->session_id,
+                        rec->locker_id,
+                        rec->uid_hex,
+                        0,
+                        0U,
+                        1U,
+                        0U,
+                        rec->cache_hit,
+                        rec->cnt + 1U,
+                        rec->first_ms,
+                        now_ms,
+                        g_auditDrop.seen_lost) == 0U)
+    {
+        return 0U;
+    }
+
+    /* 记录已发出（或已被丢弃）：改写失败，由调用者另起一条 */
+    if (uplink_update_json(g_auditUplink, rec->message_id, payload) != UPLINK_OK)
+    {
+        return 0U;
+    }
+
+    rec->cnt++;
+    rec->last_ms = now_ms;
+    return 1U;
+}
+
+/**
+ * @brief 初始化审计模块
+ *
+ * @param uplink 已初始化的 uplink 上下文（审计记录入此队列）
+ */
+void AppAudit_Init(uplink_t *uplink)
+{
+    g_auditUplink = uplink;
+    (void)memset(&g_auditStats, 0, sizeof(g_auditStats));
+    (void)memset(g_cardRead, 0, sizeof(g_cardRead));
+    (void)memset(&g_auditDrop, 0, sizeof(g_auditDrop));
+}
+
+/**
+ * @brief 上报一条审计事件（仅入队，不阻塞）
+ *
+ * @param event 事件名（CARD_READ / AUTH_DENY / DOOR_OPEN_OK ...）
+ * @param session_id 会话号
+ * @param locker_id 柜门 ID
+ * @param uid_hex 卡号（十六进制，可为空串）
+ * @param code 业务码
+ * @param http_status HTTP 状态码
+ * @param network_ok 网络是否正常
+ * @param door_ok 是否开门成功
+ * @param cache_hit 是否命中本地放行缓存
+ * @param now_ms 当前时间（毫秒）
+ *
+ * @note CARD_READ 在合并窗口内与该柜门上一条同卡记录合并，合并后的记录保留首次读卡的 sid 与 cache。
+ */
+void AppAudit_Report(const char *event,
+                     uint32_t session_id,
+                     const char *locker_id,
+                     const char *uid_hex,
+                     int32_t code,
+                     uint16_t http_status,
+                     uint8_t network_ok,
+                     uint8_t door_ok,
+                     uint8_t cache_hit,
+                     uint32_t now_ms)
+{
+    char *payload = NULL;
+    size_t cap = 0U;
+    app_audit_card_read_t *rec = NULL;
+    uint8_t is_card_read;
+    uint32_t message_id = 0U;
+
+    if ((g_auditUplink == NULL) || (event == NULL) || (locker_id == NULL) || (uid_hex == NULL))
+    {
+        return;
+    }
+
+    g_auditStats.reported++;
+    is_card_read = (strcmp(event, "CARD_READ") == 0) ? 1U : 0U;
+
+    if (is_card_read != 0U)
+    {
+        rec = AppAudit_CardReadSlot(locker_id, 0U);
+        if ((rec != NULL) && (AppAudit_CoalesceCardRead(rec, uid_hex, now_ms) != 0U))
+        {
+            g_auditStats.coalesced++;
+            return;
+        }
+        if (rec != NULL)
+        {
+            rec->valid = 0U;
+        }
+    }
+
+    /* 容量与丢弃由 uplink 按类别处理：审计洪峰只会占满 BULK 类别，不会挤掉告警类事件 */
+    if (uplink_enqueue_reserve(g_auditUplink,
+                               "RFID_AUDIT",
+                               AppAudit_Prio(event),
+                               APP_AUDIT_TTL_MS,
+                               &payload,
+                               &cap) != UPLINK_OK)
+    {
+        g_auditStats.rejected++;
+        return;
+    }
+
+    /* 直接格式化进队列槽位（持有 uplink 互斥量期间只做格式化，drop 取上次 Poll 的快照，不再读 uplink 统计） */
+    if (AppAudit_Format(payload,
+                        cap,
+                        event,
+                        session_id,
+                        locker_id,
+                        uid_hex,
+                        code,
+                        http_status,
+                        network_ok,
+                        door_ok,
+                        cache_hit,
+                        (is_card_read != 0U) ? 1U : 0U,
+                        now_ms,
+                        now_ms,
+                        g_auditDrop.seen_lost) == 0U)
+    {
+        uplink_enqueue_abort(g_auditUplink);
+        g_auditStats.rejected++;
+        return;
+    }
+
+    if (uplink_enqueue_commit(g_auditUplink, &message_id) != UPLINK_OK)
+    {
+        g_auditStats.rejected++;
+        return;
+    }
+
+    g_auditStats.enqueued++;
+
+    if ((is_card_read != 0U) && (strlen(locker_id) < sizeof(g_cardRead[0].locker_id)) &&
+        (strlen(uid_hex) < sizeof(g_cardRead[0].uid_hex)))
+    {
+        rec = AppAudit_CardReadSlot(locker_id, 1U);
+        rec->valid = 1U;
+        rec->message_id = message_id;
+        rec->session_id = session_id;
+        (void)memcpy(rec->locker_id, locker_id, strlen(locker_id) + 1U);
+        (void)memcpy(rec->uid_hex, uid_hex, strlen(uid_hex) + 1U);
+        rec->cache_hit = cache_hit;
+        rec->cnt = 1U;
+        rec->first_ms = now_ms;
+        rec->last_ms = now_ms;
+    }
+}
+
+/**
+ * @brief 周期处理：丢失数增长时上报/累加丢失汇总记录
+ *
+ * @param now_ms 当前时间（毫秒）
+ *
+ * @note 建议在鉴权任务每个周期调用一次；uplink 内部的挤掉/过期发生在上报任务中，靠这里周期发现。
+ */
+void AppAudit_Poll(uint32_t now_ms)
+{
+    char payload[UPLINK_MAX_PAYLOAD_LEN];
+    uint32_t lost;
+    uint32_t unrep;
+    uint32_t message_id = 0U;
+
+    if (g_auditUplink == NULL)
+    {
+        return;
+    }
+
+    lost = AppAudit_GetLost();
+    if (lost != g_auditDrop.seen_lost)
+    {
+        if (g_auditDrop.seen_lost == g_auditDrop.reported_lost)
+        {
+            g_auditDrop.unrep_first_ms = now_ms;
+        }
+        g_auditDrop.seen_lost = lost;
+    }
+
+    unrep = g_auditDrop.seen_lost - g_auditDrop.reported_lost;
+    if (unrep == 0U)
+    {
+        return;
+    }
+
+    /* 上一条汇总还没发出：原地累加，不占新槽位 */
+    if (g_auditDrop.valid != 0U)
+    {
+        if ((AppAudit_Format(payload,
+                             sizeof(payload),
+                             APP_AUDIT_EV_DROP,
+                             0U,
+                             "",
+                             "",
+                             0,
+                             0U,
+                             1U,
+                             0U,
+                             0U,
+                             g_auditDrop.cnt + unrep,
+                             g_auditDrop.first_ms,
+                             now_ms,
+                             lost) != 0U) &&
+            (uplink_update_json(g_auditUplink, g_auditDrop.message_id, payload) == UPLINK_OK))
+        {
+            g_auditDrop.cnt += unrep;
+            g_auditDrop.reported_lost = g_auditDrop.seen_lost;
+            return;
+        }
+        g_auditDrop.valid = 0U;
+    }
+
+    if ((g_auditDrop.emitted != 0U) && ((uint32_t)(now_ms - g_auditDrop.last_emit_ms) < APP_AUDIT_SUMMARY_MS))
+    {
+        return;
+    }
+
+    if (AppAudit_Format(payload,
+                        sizeof(payload),
+                        APP_AUDIT_EV_DROP,
+                        0U,
+                        "",
+                        "",
+                        0,
+                        0U,
+                        1U,
+                        0U,
+                        0U,
+                        unrep,
+                        g_auditDrop.unrep_first_ms,
+                        now_ms,
+                        lost) == 0U)
+    {
+        return;
+    }
+
+    /* 汇总入队失败不计入丢失，下个周期重试 */
+    if (uplink_enqueue_json_ttl(g_auditUplink,
+                                "RFID_AUDIT",
+                                payload,
+                                AppAudit_Prio(APP_AUDIT_EV_DROP),
+                                APP_AUDIT_TTL_MS,
+                                &message_id) != UPLINK_OK)
+    {
+        return;
+    }
+
+    g_auditStats.summaries++;
+    g_auditDrop.valid = 1U;
+    g_auditDrop.message_id = message_id;
+    g_auditDrop.cnt = unrep;
+    g_auditDrop.first_ms = g_auditDrop.unrep_first_ms;
+    g_auditDrop.emitted = 1U;
+    g_auditDrop.last_emit_ms = now_ms;
+    g_auditDrop.reported_lost = g_auditDrop.seen_lost;
+}
+
+/**
+ * @brief 审计累计丢失数（即载荷中的 drop）
+ *
+ * @return uint32_t 本地入队被拒 + uplink 内部被挤掉、过期、超过重试上限的消息数
+ *
+ * @note uplink 队列目前只承载审计记录，其内部丢弃都算审计丢失。
+ * @note 需要读 uplink 统计（一次加锁）；普通审计载荷的 drop 用 AppAudit_Poll 时取得的快照，入队路径不调用本函数。
+ */
+uint32_t AppAudit_GetLost(void)
+{
+    uplink_stats_t st;
+    uint32_t lost = g_auditStats.rejected;
+    uint8_t c;
+
+    if (g_auditUplink == NULL)
+    {
+        return lost;
+    }
+
+    uplink_get_stats(g_auditUplink, &st);
+    for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+    {
+        lost += st.evicted[c] + st.expired[c] + st.exhausted[c];
+    }
+
+    return lost;
+}
+
+/**
+ * @brief 读取审计模块统计
+ *
+ * @param out_stats 输出：统计快照
+ */
+void AppAudit_GetStats(app_audit_stats_t *out_stats)
+{
+    if (out_stats == NULL)
+    {
+        return;
+    }
+
+    *out_stats = g_auditStats;
+}
@@ -14,9 +14,13 @@ extern "C"
 {
 #endif
 
+#include "uplink_breaker.h"
 #include "uplink_codec_json.h"
 #include "uplink_config.h"
+#include "uplink_failover.h"
+#include "uplink_msgid.h"
 #include "uplink_transport_http_netconn.h"
+#include "uplink_transport_udp_netconn.h"
 
 #include "FreeRTOS.h"
 
@@ -27,6 +31,51 @@ extern "C"
 #define APP_AUTH_TRACE_MAX_LEN 64U
 #define APP_AUTH_UID_SHA1_HEX_LEN 40U
 
+/** 鉴权传输方式：0=HTTP/TCP（默认）；1=UDP 单往返（需服务端开启 AUTH_UDP_ENABLED） */
+#ifndef APP_AUTH_USE_UDP
+#define APP_AUTH_USE_UDP 0
+#endif
+
+/** UDP 鉴权端口（与服务端 AUTH_UDP_PORT 一致） */
+#ifndef APP_AUTH_UDP_PORT
+#define APP_AUTH_UDP_PORT 5683
+#endif
+
+/** 设备共享密钥（与服务端 devices.secret 一致，用于 UDP 报文认证） */
+#ifndef APP_AUTH_DEVICE_SECRET
+#define APP_AUTH_DEVICE_SECRET "dev-secret-stm32f4"
+#endif
+
+/** 对冲请求：1=首选上级超过阈值未应答时把同一请求发往备用上级（仅 HTTP，且需配置 TASK_UPLINK_FALLBACK_HOST） */
+#ifndef APP_AUTH_HEDGE_ENABLE
+#define APP_AUTH_HEDGE_ENABLE 1
+#endif
+
+/** 对冲阈值统计窗口（最近多少次应答耗时，取 p95） */
+#ifndef APP_AUTH_HEDGE_SAMPLES
+#define APP_AUTH_HEDGE_SAMPLES 32U
+#endif
+
+/** 样本不足 8 个时使用的对冲阈值（毫秒） */
+#ifndef APP_AUTH_HEDGE_DEFAULT_MS
+#define APP_AUTH_HEDGE_DEFAULT_MS 300U
+#endif
+
+/** 对冲阈值下限（毫秒），避免上级一直很快时几乎每次都发两份 */
+#ifndef APP_AUTH_HEDGE_MIN_MS
+#define APP_AUTH_HEDGE_MIN_MS 50U
+#endif
+
+/** 自适应接收超时下限（毫秒）：RTT 很稳时给上级查库留出余量 */
+#ifndef APP_AUTH_RTO_MIN_MS
+#define APP_AUTH_RTO_MIN_MS 200U
+#endif
+
+/** 自适应接收超时上限（毫秒）：慢链路/连续失败退避后的最长等待（尚无 RTT 样本时用静态 1500ms） */
+#ifndef APP_AUTH_RTO_MAX_MS
+#define APP_AUTH_RTO_MAX_MS 3000U
+#endif
+
     typedef enum
     {
         APP_AUTH_OK = 0,
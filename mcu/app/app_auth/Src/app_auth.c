@@ -8,10 +8,23 @@
  * @note
  * - 本模块用于“刷卡后立即鉴权”：构造 RFID_AUTH_REQ 并同步等待上级响应。
  * - 复用现有 app_uplink 的 JSON 编解码与 netconn HTTP 传输实现。
+ * - 可选 UDP 单往返传输（APP_AUTH_USE_UDP=1），判定规则与 HTTP 完全一致。
+ * - 配置了备用上级（TASK_UPLINK_FALLBACK_HOST）时按 FAST 策略选端点：超时/5xx 立即在同一次鉴权内换下一个端点，
+ *   失败的端点进入冷却，后续刷卡直接走备用上级，不再每次先等一轮超时。
+ * - 对冲（APP_AUTH_HEDGE_ENABLE=1，HTTP）：首选上级超过最近应答耗时 p95 仍未应答时，把同一请求（同一 messageId）
+ *   发往备用上级，先到的有效应答胜出；服务端对同一 messageId 回放首次判定，两份请求结论一致。
+ * - 自适应超时（HTTP）：每个端点按 SRTT + 4×RTTVAR 给出接收超时，夹在 [APP_AUTH_RTO_MIN_MS, APP_AUTH_RTO_MAX_MS] 内；
+ *   上级不可达时几百毫秒内判定失败并换端点/返回 NET_FAIL，而不是每个端点都等满 1500ms；
+ *   上级慢但存活时超时随 RTT 放宽，不会因为偶尔超过 1500ms 被误判。
+ * - 签名（HTTP）：与上报一样带 X-Device-Id/X-Timestamp/X-Nonce/X-Signature（独立 nonce lane），
+ *   服务端 SIGNATURE_REQUIRED=1 时鉴权照常可用；开机后首个请求从应答 Date 对时后签名重发（传输层完成）。
+ * - 熔断（uplink_breaker，与 uplink 上报共享）：所有上级都不可用的鉴权记一次失败，连续失败熔断后刷卡立即返回 NET_FAIL，
+ *   熔断到期后由第一个请求（鉴权或上报）探测，成功即恢复。
  */
 
 #include "app_auth.h"
 
+#include "app_epoch.h"
 #include "task_uplink.h"
 
 #include "sys.h"
@@ -22,19 +35,42 @@
 /**
  * 内部类型/变量
  */
+
+/* RFID_AUTH_REQ 载荷字段表（顺序即输出顺序） */
+#define APP_AUTH_REQ_FIELDS(X)    \
+    X(str, lockerId, locker_id)   \
+    X(str, uid, uid_hex)          \
+    X(str, uidSha1, uid_sha1_hex) \
+    X(str, deviceId, device_id)   \
+    X(u32, sessionId, session_id) \
+    X(u32, clientTsMs, client_ts_ms)
+
+UPLINK_JSON_SCHEMA_DEFINE(app_auth_req_json, APP_AUTH_REQ_FIELDS)
+
 typedef struct
 {
     uint8_t inited;
 
     uplink_transport_t transport;
+#if APP_AUTH_USE_UDP
+    uplink_transport_udp_netconn_ctx_t udp_ctx;
+#else
     uplink_transport_http_netconn_ctx_t http_ctx;
-
-    uplink_endpoint_t endpoint;
+    uplink_signer_t signer; /* 请求签名器（lane=UPLINK_SIGN_LANE_AUTH，普通与对冲请求共用） */
+#endif
+
+    uplink_failover_t failover; /* 上级端点选择器（首选 + 备用） */
+#if (APP_AUTH_USE_UDP == 0) && (APP_AUTH_HEDGE_ENABLE != 0)
+    uplink_http_hedge_t hedge;                       /* 对冲请求工作区 */
+    uint16_t rtt_samples[APP_AUTH_HEDGE_SAMPLES];    /* 最近应答耗时（毫秒） */
+    uint8_t rtt_count;
+    uint8_t rtt_pos;
+#endif
     char device_id[UPLINK_MAX_DEVICE_ID_LEN];
 
     uint32_t send_timeout_ms;
     uint32_t recv_timeout_ms;
-    uint32_t next_message_id;
+    uplink_msgid_t msgid;
 
     char payload_json[UPLINK_MAX_PAYLOAD_LEN];
     char event_json[UPLINK_MAX_EVENT_JSON_LEN];
@@ -298,6 +334,203 @@ static void AppAuth_ParseJsonString(const char *body,
     }
 }
 
+/**
+ * @brief 端点本次请求的接收超时
+ *
+ * @note UDP 传输内部已按自己的 RTO 重传，recv_timeout_ms 是总预算，保持静态值，避免压缩重传次数。
+ */
+static uint32_t AppAuth_RecvTimeout(uint8_t ep_index)
+{
+#if APP_AUTH_USE_UDP
+    (void)ep_index;
+    return g_auth.recv_timeout_ms;
+#else
+    return uplink_failover_timeout_ms(&g_auth.failover,
+                                      ep_index,
+                                      g_auth.recv_timeout_ms,
+                                      APP_AUTH_RTO_MIN_MS,
+                                      APP_AUTH_RTO_MAX_MS);
+#endif
+}
+
+/**
+ * @brief 依次尝试各端点：失败（超时/断开/5xx）立即换下一个端点
+ */
+static uplink_err_t AppAuth_PostFailover(size_t event_len, uplink_ack_t *ack, size_t *body_len)
+{
+    uint32_t tried_mask = 0U;
+    uint8_t attempt;
+    uplink_err_t tr = UPLINK_ERR_TRANSPORT;
+
+    /* 每个端点最多试一次；同一 messageId 发往不同上级，服务端按幂等回放同一结论 */
+    for (attempt = 0U; attempt < g_auth.failover.count; attempt++)
+    {
+        uint32_t t0 = (uint32_t)sys_now();
+        uint8_t ep_index = uplink_failover_pick(&g_auth.failover, t0, tried_mask);
+        uint32_t t1;
+        uint8_t healthy;
+
+        tried_mask |= (1UL << ep_index);
+
+        (void)memset(ack, 0, sizeof(*ack));
+        ack->app_code = UPLINK_APP_CODE_UNKNOWN;
+        (void)memset(g_auth.response_body, 0, sizeof(g_auth.response_body));
+        *body_len = 0U;
+
+        tr = g_auth.transport.post_json(g_auth.transport.ctx,
+                                        uplink_failover_endpoint(&g_auth.failover, ep_index),
+                                        NULL,
+                                        g_auth.event_json,
+                                        event_len,
+                                        g_auth.send_timeout_ms,
+                                        AppAuth_RecvTimeout(ep_index),
+                                        ack,
+                                        g_auth.response_body,
+                                        sizeof(g_auth.response_body),
+                                        body_len);
+
+        /* 上级有应答且非 5xx：端点健康，结果（含 4xx/拒绝开门）直接采用，不再换端点 */
+        t1 = (uint32_t)sys_now();
+        healthy = ((ack->http_status != 0U) && (ack->http_status < 500U)) ? 1U : 0U;
+        uplink_failover_report(&g_auth.failover, ep_index, healthy, t1 - t0, t1);
+
+        if (healthy != 0U)
+        {
+            break;
+        }
+    }
+
+    return tr;
+}
+
+#if (APP_AUTH_USE_UDP == 0) && (APP_AUTH_HEDGE_ENABLE != 0)
+/**
+ * @brief 记录一次首选上级的应答耗时（对冲阈值样本）
+ */
+static void AppAuth_RecordRtt(uint32_t rtt_ms)
+{
+    g_auth.rtt_samples[g_auth.rtt_pos] = (uint16_t)((rtt_ms > 0xFFFFU) ? 0xFFFFU : rtt_ms);
+    g_auth.rtt_pos = (uint8_t)((g_auth.rtt_pos + 1U) % APP_AUTH_HEDGE_SAMPLES);
+    if (g_auth.rtt_count < APP_AUTH_HEDGE_SAMPLES)
+    {
+        g_auth.rtt_count++;
+    }
+}
+
+/**
+ * @brief 对冲阈值：最近应答耗时的 p95（最近秩法），夹在 [APP_AUTH_HEDGE_MIN_MS, recv_to_ms] 内
+ *
+ * @param recv_to_ms 本次请求的接收超时
+ */
+static uint32_t AppAuth_HedgeThreshold(uint32_t recv_to_ms)
+{
+    uint16_t sorted[APP_AUTH_HEDGE_SAMPLES];
+    uint32_t threshold;
+    uint8_t n = g_auth.rtt_count;
+    uint8_t i;
+
+    if (n < 8U)
+    {
+        threshold = APP_AUTH_HEDGE_DEFAULT_MS;
+    }
+    else
+    {
+        /* 样本最多 32 个，插入排序足够 */
+        for (i = 0U; i < n; i++)
+        {
+            uint16_t v = g_auth.rtt_samples[i];
+            uint8_t k = i;
+
+            while ((k > 0U) && (sorted[k - 1U] > v))
+            {
+                sorted[k] = sorted[k - 1U];
+                k--;
+            }
+            sorted[k] = v;
+        }
+        threshold = sorted[((uint32_t)n * 95U + 99U) / 100U - 1U];
+    }
+
+    if (threshold < APP_AUTH_HEDGE_MIN_MS)
+    {
+        threshold = APP_AUTH_HEDGE_MIN_MS;
+    }
+    if (threshold > recv_to_ms)
+    {
+        threshold = recv_to_ms;
+    }
+
+    return threshold;
+}
+
+/**
+ * @brief 对冲发送：首选上级超过阈值未应答时把同一请求发往备用上级，先到的有效应答胜出
+ *
+ * @note 说明：
+ * - 备用上级在冷却中时不对冲（阻塞建连会拖住首选上级的应答），退化为单路请求。
+ * - 落后被放弃的一路按“慢但存活”反馈：已等待的时长作为 RTT 下限计入 SRTT，并作为 p95 样本。
+ * - 接收超时取首选端点的 RTO；每一路从自己发出时刻起计时，对冲一路天然比首选一路晚截止。
+ */
+static uplink_err_t AppAuth_PostHedged(size_t event_len, uplink_ack_t *ack, size_t *body_len)
+{
+    uint32_t now_ms = (uint32_t)sys_now();
+    uint8_t ep_index[2];
+    uint8_t winner = 0xFFU;
+    uint8_t hedge;
+    uint32_t recv_to;
+    uint8_t i;
+    uplink_err_t tr;
+
+    ep_index[0] = uplink_failover_pick(&g_auth.failover, now_ms, 0U);
+    ep_index[1] = uplink_failover_pick(&g_auth.failover, now_ms, (1UL << ep_index[0]));
+    hedge = uplink_failover_is_available(&g_auth.failover, ep_index[1], now_ms);
+
+    recv_to = AppAuth_RecvTimeout(ep_index[0]);
+
+    (void)memset(g_auth.response_body, 0, sizeof(g_auth.response_body));
+
+    tr = uplink_transport_http_netconn_post_json_hedged(
+        &g_auth.http_ctx,
+        &g_auth.hedge,
+        uplink_failover_endpoint(&g_auth.failover, ep_index[0]),
+        (hedge != 0U) ? uplink_failover_endpoint(&g_auth.failover, ep_index[1]) : NULL,
+        NULL,
+        g_auth.event_json,
+        event_len,
+        g_auth.send_timeout_ms,
+        recv_to,
+        AppAuth_HedgeThreshold(recv_to),
+        ack,
+        g_auth.response_body,
+        sizeof(g_auth.response_body),
+        body_len,
+        &winner);
+
+    for (i = 0U; i < 2U; i++)
+    {
+        const uplink_http_req_t *req = &g_auth.hedge.req[i];
+        uint32_t rtt = req->done_ms - req->start_ms;
+        uint8_t healthy;
+
+        if (req->state != UPLINK_HTTP_REQ_DONE)
+        {
+            continue;
+        }
+
+        healthy = ((req->cancelled != 0U) ||
+                   ((req->ack->http_status != 0U) && (req->ack->http_status < 500U))) ? 1U : 0U;
+        uplink_failover_report(&g_auth.failover, ep_index[i], healthy, rtt, req->done_ms);
+
+        if ((i == 0U) && (healthy != 0U))
+        {
+            AppAuth_RecordRtt(rtt);
+        }
+    }
+
+    return tr;
+}
+#endif
+
 /**
  * 对外接口实现
  */
@@ -316,13 +549,38 @@ BaseType_t AppAuth_Init(void)
     (void)snprintf(cfg.endpoint.path, sizeof(cfg.endpoint.path), "%s", TASK_UPLINK_SERVER_PATH);
     cfg.endpoint.use_dns = 0U;
 
-    g_auth.endpoint = cfg.endpoint;
     (void)snprintf(g_auth.device_id, sizeof(g_auth.device_id), "%s", cfg.device_id);
     g_auth.send_timeout_ms = 1500U;
     g_auth.recv_timeout_ms = 1500U;
-    g_auth.next_message_id = 1U;
+    uplink_msgid_init(&g_auth.msgid, AppEpoch_ClaimCb, NULL);
 
+#if APP_AUTH_USE_UDP
+    /* UDP 单往返：同一上级地址，端口切换到 UDP 鉴权监听端口 */
+    cfg.endpoint.port = (uint16_t)APP_AUTH_UDP_PORT;
+    uplink_transport_udp_netconn_bind(&g_auth.transport, &g_auth.udp_ctx, APP_AUTH_DEVICE_SECRET);
+#else
     uplink_transport_http_netconn_bind(&g_auth.transport, &g_auth.http_ctx);
+    uplink_signer_init(&g_auth.signer,
+                       cfg.device_id,
+                       (cfg.sign.enable != 0U) ? cfg.sign.secret : NULL,
+                       UPLINK_SIGN_LANE_AUTH);
+    uplink_transport_http_netconn_set_signer(&g_auth.http_ctx, &g_auth.signer);
+#endif
+
+    uplink_failover_init(&g_auth.failover, UPLINK_FAILOVER_FAST);
+    (void)uplink_failover_add(&g_auth.failover, &cfg.endpoint);
+
+    if (TASK_UPLINK_FALLBACK_HOST[0] != '\0')
+    {
+        (void)snprintf(cfg.endpoint.host, sizeof(cfg.endpoint.host), "%s", TASK_UPLINK_FALLBACK_HOST);
+#if !APP_AUTH_USE_UDP
+        if ((uint16_t)TASK_UPLINK_FALLBACK_PORT != 0U)
+        {
+            cfg.endpoint.port = (uint16_t)TASK_UPLINK_FALLBACK_PORT;
+        }
+#endif
+        (void)uplink_failover_add(&g_auth.failover, &cfg.endpoint);
+    }
 
     g_auth.inited = 1U;
     return pdPASS;
@@ -337,6 +595,58 @@ const char *AppAuth_GetDeviceId(void)
     return g_auth.device_id;
 }
 
+/**
+ * @brief 构造 RFID_AUTH_REQ 载荷与事件 JSON（写入 g_auth.payload_json / g_auth.event_json）
+ *
+ * @param now_ms 当前时间（同时作为 clientTsMs 与事件 ts）
+ * @param out_event_len 输出：事件 JSON 长度
+ * @return uplink_err_t UPLINK_OK；缓冲不足返回 UPLINK_ERR_BUFFER_TOO_SMALL；没有可用纪元返回 UPLINK_ERR_NO_ID
+ */
+static uplink_err_t AppAuth_BuildRequest(const char *locker_id,
+                                         const char *uid_hex,
+                                         const char *uid_sha1_hex,
+                                         uint32_t session_id,
+                                         uint32_t now_ms,
+                                         size_t *out_event_len)
+{
+    uplink_json_writer_t w;
+    app_auth_req_json_t req;
+    uplink_err_t r;
+
+    req.locker_id = locker_id;
+    req.uid_hex = uid_hex;
+    req.uid_sha1_hex = uid_sha1_hex;
+    req.device_id = g_auth.device_id;
+    req.session_id = session_id;
+    req.client_ts_ms = now_ms;
+
+    uplink_json_writer_init(&w, g_auth.payload_json, sizeof(g_auth.payload_json));
+    uplink_json_obj_begin(&w);
+    app_auth_req_json_write(&w, &req);
+    uplink_json_obj_end(&w);
+    r = uplink_json_writer_finish(&w, NULL);
+    if (r != UPLINK_OK)
+    {
+        return r;
+    }
+
+    /* 本纪元序号快用完时在这里（不持 uplink 的锁）预申请下一个纪元；停发中时每次认证都重试一次 */
+    uplink_msgid_refill(&g_auth.msgid);
+    if (uplink_msgid_ready(&g_auth.msgid) == 0U)
+    {
+        return UPLINK_ERR_NO_ID;
+    }
+
+    return uplink_codec_json_build_event(g_auth.event_json,
+                                         sizeof(g_auth.event_json),
+                                         g_auth.device_id,
+                                         uplink_msgid_next(&g_auth.msgid),
+                                         now_ms,
+                                         "RFID_AUTH_REQ",
+                                         g_auth.payload_json,
+                                         out_event_len);
+}
+
 app_auth_err_t AppAuth_Verify(const char *locker_id,
                               const char *uid_hex,
                               const char *uid_sha1_hex,
@@ -344,7 +654,6 @@ app_auth_err_t AppAuth_Verify(const char *locker_id,
                               app_auth_result_t *out_result)
 {
     uplink_ack_t ack;
-    size_t payload_len;
     size_t event_len;
     size_t body_len = 0U;
     int32_t app_code = UPLINK_APP_CODE_UNKNOWN;
@@ -367,46 +676,42 @@ app_auth_err_t AppAuth_Verify(const char *locker_id,
 
     now_ms = (uint32_t)sys_now();
 
-    payload_len = (size_t)snprintf(g_auth.payload_json,
-                                   sizeof(g_auth.payload_json),
-                                   "{\"lockerId\":\"%s\",\"uid\":\"%s\",\"uidSha1\":\"%s\",\"deviceId\":\"%s\",\"sessionId\":%lu,\"clientTsMs\":%lu}",
-                                   locker_id,
-                                   uid_hex,
-                                   uid_sha1_hex,
-                                   g_auth.device_id,
-                                   (unsigned long)session_id,
-                                   (unsigned long)now_ms);
-
-    if (payload_len >= sizeof(g_auth.payload_json))
+    /* 熔断中：上级整体不可用，直接按网络异常处理，不再等超时；在构造请求之前判断，不白白消耗消息 ID 和纪元 */
+    if (uplink_breaker_allow(now_ms) == 0U)
     {
-        return APP_AUTH_ERR_CODEC;
+        out_result->network_fail = 1U;
+        (void)snprintf(out_result->msg, sizeof(out_result->msg), "breaker_open");
+        return APP_AUTH_OK;
     }
 
-    if (uplink_codec_json_build_event(g_auth.event_json,
-                                      sizeof(g_auth.event_json),
-                                      g_auth.device_id,
-                                      g_auth.next_message_id++,
-                                      now_ms,
-                                      "RFID_AUTH_REQ",
-                                      g_auth.payload_json,
-                                      &event_len) != UPLINK_OK)
+    tr = AppAuth_BuildRequest(locker_id, uid_hex, uid_sha1_hex, session_id, now_ms, &event_len);
+    if (tr != UPLINK_OK)
+    {
+        /* 请求没发出去：若拿到的是半开探测名额，归还给下一个请求 */
+        uplink_breaker_release();
+    }
+    if (tr == UPLINK_ERR_NO_ID)
+    {
+        /* 纪元申请失败：不发可能与其他启动重复的 messageId，按网络异常处理 */
+        printf("[auth] msgid unavailable (claim failures=%lu)\r\n", (unsigned long)g_auth.msgid.claim_failures);
+        out_result->network_fail = 1U;
+        (void)snprintf(out_result->msg, sizeof(out_result->msg), "msgid_unavailable");
+        return APP_AUTH_OK;
+    }
+    if (tr != UPLINK_OK)
     {
         return APP_AUTH_ERR_CODEC;
     }
 
-    (void)memset(g_auth.response_body, 0, sizeof(g_auth.response_body));
+#if (APP_AUTH_USE_UDP == 0) && (APP_AUTH_HEDGE_ENABLE != 0)
+    tr = (g_auth.failover.count >= 2U) ? AppAuth_PostHedged(event_len, &ack, &body_len)
+                                       : AppAuth_PostFailover(event_len, &ack, &body_len);
+#else
+    tr = AppAuth_PostFailover(event_len, &ack, &body_len);
+#endif
 
-    tr = g_auth.transport.post_json(g_auth.transport.ctx,
-                                    &g_auth.endpoint,
-                                    NULL,
-                                    g_auth.event_json,
-                                    event_len,
-                                    g_auth.send_timeout_ms,
-                                    g_auth.recv_timeout_ms,
-                                    &ack,
-                                    g_auth.response_body,
-                                    sizeof(g_auth.response_body),
-                                    &body_len);
+    /* 与上报共享的熔断器：有应答且非 5xx 即上级可用（4xx/拒绝开门也算） */
+    uplink_breaker_report(((ack.http_status != 0U) && (ack.http_status < 500U)) ? 1U : 0U, (uint32_t)sys_now());
 
     out_result->http_status = ack.http_status;
 
@@ -0,0 +1,52 @@
+/**
+ * @file    app_epoch.h
+ * @author  Yukikaze
+ * @brief   消息 ID 纪元持久化（SPI flash）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note
+ * - 为 uplink_msgid 提供跨重启不重复的纪元：每次申请都在 SPI flash（W25Q128）末尾写一条记录，
+ *   上电时扫描记录恢复最大值，下次从它加一开始。
+ * - 存储区为两个 4KB 扇区轮换：每条记录 8 字节（值 + 取反校验），一个扇区 512 条，
+ *   写满后先擦另一个扇区再写；擦除期间掉电，旧扇区仍保留最大值，不会回退。
+ * - 每次启动 uplink 与鉴权各申请一个纪元（2 条记录），擦写寿命按 10 万次计可支撑上亿次启动。
+ * - 纪元共 65535 个，用完后回绕重新从 1 开始；按每天重启一次计约 90 年才会回绕。
+ * - 读不到 flash ID 时 AppEpoch_Claim 返回 0（下次调用重新检测），消息 ID 停发直到申请成功。
+ * - SPI flash 与字库读取（GetGBKCode_from_EXFlash）共用，所有访问都经过 SPI_FLASH_Lock / SPI_FLASH_Unlock。
+ */
+
+#ifndef __APP_EPOCH_H
+#define __APP_EPOCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "FreeRTOS.h"
+
+#include <stdint.h>
+
+/** 存储区起始地址（W25Q128 最后两个扇区，远离 GBKCODE_START_ADDRESS 起的字库） */
+#ifndef APP_EPOCH_FLASH_ADDR
+#define APP_EPOCH_FLASH_ADDR 0xFFE000UL
+#endif
+
+/** 扇区大小（W25Q 扇区擦除粒度） */
+#define APP_EPOCH_SECTOR_SIZE 4096UL
+
+/** 单条记录大小（uint32 值 + uint32 取反） */
+#define APP_EPOCH_RECORD_SIZE 8UL
+
+    BaseType_t AppEpoch_Init(void);
+
+    uint32_t AppEpoch_Claim(void);
+
+    uint32_t AppEpoch_ClaimCb(void *user_ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_EPOCH_H */
@@ -0,0 +1,228 @@
+/**
+ * @file    app_epoch.c
+ * @author  Yukikaze
+ * @brief   消息 ID 纪元持久化实现（SPI flash）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note
+ * - flash 中保存的是单调递增的申请计数 claim（32 位，不回绕），返回给调用者的纪元为
+ *   ((claim - 1) % UPLINK_MSGID_EPOCH_MAX) + 1，范围 1..UPLINK_MSGID_EPOCH_MAX。
+ * - 记录按顺序追加：扇区内第一条全 0xFF 的槽位之前都算已用（含掉电写坏、校验不过的槽位）。
+ */
+
+#include "app_epoch.h"
+
+#include "bsp_spi_flash.h"
+#include "uplink_msgid.h"
+
+#include <string.h>
+
+#define APP_EPOCH_SLOTS_PER_SECTOR (APP_EPOCH_SECTOR_SIZE / APP_EPOCH_RECORD_SIZE)
+
+/* 上电扫描时每次读取的字节数（栈上缓冲） */
+#define APP_EPOCH_SCAN_CHUNK 256U
+
+/* 状态只在持有 SPI flash 锁（SPI_FLASH_Lock）时读写 */
+typedef struct
+{
+    uint8_t ready;   /* 1=flash 可用 */
+    uint8_t sector;  /* 当前写入的扇区（0/1） */
+    uint16_t used;   /* 当前扇区已用槽位数 */
+    uint32_t claim;  /* 已申请到的最大计数（0=从未申请） */
+} AppEpoch_State_TypeDef;
+
+static AppEpoch_State_TypeDef g_epoch;
+
+/**
+ * @brief 扇区基地址
+ */
+static uint32_t AppEpoch_SectorAddr(uint8_t sector)
+{
+    return APP_EPOCH_FLASH_ADDR + ((uint32_t)sector * APP_EPOCH_SECTOR_SIZE);
+}
+
+/**
+ * @brief 扫描一个扇区
+ *
+ * @param sector 扇区号（0/1）
+ * @param out_used 输出：已用槽位数
+ * @param out_max 输出：扇区内校验通过的最大计数（0=没有）
+ */
+static void AppEpoch_ScanSector(uint8_t sector, uint16_t *out_used, uint32_t *out_max)
+{
+    uint8_t buf[APP_EPOCH_SCAN_CHUNK];
+    uint32_t off;
+    uint16_t used = 0U;
+    uint32_t max = 0U;
+
+    for (off = 0U; off < APP_EPOCH_SECTOR_SIZE; off += APP_EPOCH_SCAN_CHUNK)
+    {
+        uint32_t i;
+
+        SPI_FLASH_BufferRead(buf, AppEpoch_SectorAddr(sector) + off, (u16)APP_EPOCH_SCAN_CHUNK);
+        for (i = 0U; i < APP_EPOCH_SCAN_CHUNK; i += APP_EPOCH_RECORD_SIZE)
+        {
+            uint32_t value;
+            uint32_t check;
+
+            (void)memcpy(&value, &buf[i], sizeof(value));
+            (void)memcpy(&check, &buf[i + 4U], sizeof(check));
+
+            if ((value == 0xFFFFFFFFUL) && (check == 0xFFFFFFFFUL))
+            {
+                *out_used = used;
+                *out_max = max;
+                return;
+            }
+
+            used++;
+            if ((value == ~check) && (value > max))
+            {
+                max = value;
+            }
+        }
+    }
+
+    *out_used = used;
+    *out_max = max;
+}
+
+/**
+ * @brief 追加一条记录并读回校验
+ *
+ * @param value 计数
+ * @return uint8_t 1=成功；0=当前扇区已没有可写槽位
+ */
+static uint8_t AppEpoch_Append(uint32_t value)
+{
+    while (g_epoch.used < APP_EPOCH_SLOTS_PER_SECTOR)
+    {
+        uint8_t rec[APP_EPOCH_RECORD_SIZE];
+        uint8_t back[APP_EPOCH_RECORD_SIZE];
+        uint32_t check = ~value;
+        uint32_t addr = AppEpoch_SectorAddr(g_epoch.sector) + ((uint32_t)g_epoch.used * APP_EPOCH_RECORD_SIZE);
+
+        (void)memcpy(&rec[0], &value, sizeof(value));
+        (void)memcpy(&rec[4], &check, sizeof(check));
+
+        /* 8 字节对齐的槽位不会跨页，一次页编程即可 */
+        SPI_FLASH_PageWrite(rec, addr, (u16)sizeof(rec));
+        SPI_FLASH_BufferRead(back, addr, (u16)sizeof(back));
+        g_epoch.used++;
+
+        /* 读回不一致（坏块/写坏）：放弃该槽位，写下一个 */
+        if (memcmp(rec, back, sizeof(rec)) == 0)
+        {
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/**
+ * @brief 检测 SPI flash 并恢复上次申请到的最大计数（调用者持有 SPI flash 锁）
+ *
+ * @note 成功时置 g_epoch.ready=1；失败时保持 0，下次 AppEpoch_Claim 会再检测一次。
+ */
+static void AppEpoch_Probe(void)
+{
+    uint16_t used[2];
+    uint32_t max[2];
+
+    if (SPI_FLASH_ReadID() != sFLASH_ID)
+    {
+        return;
+    }
+
+    AppEpoch_ScanSector(0U, &used[0], &max[0]);
+    AppEpoch_ScanSector(1U, &used[1], &max[1]);
+
+    /* 最大值所在扇区即当前扇区（两个扇区都没有有效记录时从扇区 0 开始） */
+    g_epoch.sector = (max[1] > max[0]) ? 1U : 0U;
+    g_epoch.used = used[g_epoch.sector];
+    g_epoch.claim = max[g_epoch.sector];
+    g_epoch.ready = 1U;
+}
+
+/**
+ * @brief 初始化：检测 SPI flash 并恢复上次申请到的最大计数
+ *
+ * @return BaseType_t pdPASS=完成（flash 不可用也返回 pdPASS，此时 AppEpoch_Claim 返回 0，消息 ID 停发直到检测成功）
+ */
+BaseType_t AppEpoch_Init(void)
+{
+    (void)memset(&g_epoch, 0, sizeof(g_epoch));
+
+    SPI_FLASH_Lock();
+    SPI_FLASH_Init();
+    AppEpoch_Probe();
+    SPI_FLASH_Unlock();
+    return pdPASS;
+}
+
+/**
+ * @brief 申请一个新纪元（持久化后才返回）
+ *
+ * @return uint32_t 纪元（1..UPLINK_MSGID_EPOCH_MAX）；0=flash 不可用或写入失败
+ *
+ * @note flash 之前不可用时先重新检测一次，调用者按自己的节奏重试即可（uplink 见 UPLINK_MSGID_RETRY_MS）。
+ *
+ * @note 扇区写满时先擦除另一个扇区，单次调用最长阻塞一次扇区擦除（W25Q128 典型 45ms，最长 400ms），
+ *       期间字库读取也在 SPI flash 锁上等待；调用者不要持有其他任务会等待的锁（uplink 在锁外预申请）。
+ */
+uint32_t AppEpoch_Claim(void)
+{
+    uint32_t claim;
+    uint32_t epoch = 0U;
+
+    SPI_FLASH_Lock();
+
+    if (g_epoch.ready == 0U)
+    {
+        AppEpoch_Probe();
+    }
+    if (g_epoch.ready == 0U)
+    {
+        SPI_FLASH_Unlock();
+        return 0U;
+    }
+
+    claim = g_epoch.claim + 1U;
+    if (AppEpoch_Append(claim) == 0U)
+    {
+        /* 当前扇区已满：换到另一个扇区（擦除期间旧扇区仍保留最大值） */
+        g_epoch.sector ^= 1U;
+        SPI_FLASH_SectorErase(AppEpoch_SectorAddr(g_epoch.sector));
+        g_epoch.used = 0U;
+
+        if (AppEpoch_Append(claim) == 0U)
+        {
+            /* 整个扇区都写不进去：返回 0，调用者停发消息 ID；下次申请重新检测 */
+            g_epoch.ready = 0U;
+            claim = 0U;
+        }
+    }
+
+    if (claim != 0U)
+    {
+        g_epoch.claim = claim;
+        epoch = ((claim - 1U) % (uint32_t)UPLINK_MSGID_EPOCH_MAX) + 1U;
+    }
+
+    SPI_FLASH_Unlock();
+    return epoch;
+}
+
+/**
+ * @brief uplink_id_epoch_fn 形式的适配（供 uplink_platform_t.id_epoch 与 uplink_msgid_init 使用）
+ *
+ * @param user_ctx 未使用
+ * @return uint32_t 同 AppEpoch_Claim
+ */
+uint32_t AppEpoch_ClaimCb(void *user_ctx)
+{
+    (void)user_ctx;
+    return AppEpoch_Claim();
+}
@@ -0,0 +1,84 @@
+/**
+ * @file    app_push.h
+ * @author  Yukikaze
+ * @brief   下行推送通道（设备常连上级，接收权限变更/远程命令）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note
+ * - 设备主动发起 `GET /api/push/stream` 并保持连接，上级通过 HTTP chunked 流逐条下发消息。
+ * - 消息分帧：每条消息是一行 JSON（以 '\n' 结尾），例如 {"type":"OPEN_DOOR","lockerId":"A01","cmdId":7}。
+ * - 心跳：上级空闲时周期发送 {"type":"PING"}；超过 APP_PUSH_HEARTBEAT_TIMEOUT_MS 无任何数据视为断线。
+ * - 断线后按指数退避 + 抖动重连；成功收到过消息的会话结束后退避计数清零。
+ */
+
+#ifndef __APP_PUSH_H
+#define __APP_PUSH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_types.h"
+
+#include "FreeRTOS.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** 推送流路径 */
+#ifndef APP_PUSH_PATH
+#define APP_PUSH_PATH "/api/push/stream"
+#endif
+
+/** 心跳超时（毫秒）：上级默认每 10s 发一次 PING，超时取 3 倍 */
+#ifndef APP_PUSH_HEARTBEAT_TIMEOUT_MS
+#define APP_PUSH_HEARTBEAT_TIMEOUT_MS 30000U
+#endif
+
+/** 重连退避：首次等待（毫秒） */
+#ifndef APP_PUSH_BACKOFF_BASE_MS
+#define APP_PUSH_BACKOFF_BASE_MS 1000U
+#endif
+
+/** 重连退避：最大等待（毫秒） */
+#ifndef APP_PUSH_BACKOFF_MAX_MS
+#define APP_PUSH_BACKOFF_MAX_MS 30000U
+#endif
+
+/** 单条消息（一行 JSON）最大长度（含结尾 '\0'），超长行整行丢弃 */
+#define APP_PUSH_LINE_MAX_LEN 256U
+
+/** 响应头最大长度 */
+#define APP_PUSH_HEADER_MAX_LEN 384U
+
+    /**
+     * @brief 消息回调（在推送任务上下文中调用，不要长时间阻塞）
+     *
+     * @param user_ctx 用户上下文
+     * @param line 一行 JSON（已去掉行尾 "\r\n"，'\0' 结尾）
+     * @param line_len 行长度
+     */
+    typedef void (*app_push_handler_t)(void *user_ctx, const char *line, size_t line_len);
+
+    typedef struct
+    {
+        uint32_t connects;      /* 建连并收到 200 的次数 */
+        uint32_t disconnects;   /* 会话结束次数（含心跳超时） */
+        uint32_t hb_timeouts;   /* 心跳超时次数 */
+        uint32_t lines;         /* 已交付的消息行数（含 PING） */
+        uint32_t dropped_lines; /* 超长/分帧错误而丢弃的行数 */
+    } app_push_stats_t;
+
+    BaseType_t AppPush_Init(app_push_handler_t handler, void *user_ctx);
+
+    uint32_t AppPush_RunSession(void);
+
+    void AppPush_GetStats(app_push_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APP_PUSH_H */
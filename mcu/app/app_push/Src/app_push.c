@@ -0,0 +1,542 @@
+/**
+ * @file    app_push.c
+ * @author  Yukikaze
+ * @brief   下行推送通道实现
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note
+ * - 一次 AppPush_RunSession() = 建连 -> 发 GET -> 持续读 chunked 流 -> 断开，返回下次重连前应等待的毫秒数。
+ * - 解析按字节推进的状态机完成（响应头 -> chunk 长度行 -> chunk 数据 -> 行组装），
+ *   不依赖 netbuf 的分片边界，TCP 拆包/粘包都能正确处理。
+ * - 接收超时按 APP_PUSH_RECV_SLICE_MS 分片，超时只用于检查心跳，不会断开连接。
+ */
+
+#include "app_push.h"
+
+#include "task_uplink.h"
+
+#include "uplink_dns.h"
+#include "uplink_retry.h"
+#include "uplink_sign.h"
+
+/* lwIP 头文件 */
+#include "api.h"
+#include "err.h"
+#include "ip_addr.h"
+#include "sys.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/** 单次 netconn_recv 超时（毫秒），用于周期检查心跳 */
+#define APP_PUSH_RECV_SLICE_MS 1000U
+
+/** 建连/发送超时（毫秒） */
+#define APP_PUSH_SEND_TIMEOUT_MS 3000U
+
+/** 请求头缓冲长度（含签名头） */
+#define APP_PUSH_REQ_MAX_LEN (192U + UPLINK_SIGN_HEADERS_MAX_LEN)
+
+/**
+ * 内部类型/变量
+ */
+typedef enum
+{
+    APP_PUSH_RX_HEADER = 0,   /* 读取响应头 */
+    APP_PUSH_RX_CHUNK_SIZE,   /* 读取 chunk 长度（十六进制） */
+    APP_PUSH_RX_CHUNK_EXT,    /* 跳过 chunk 扩展，直到 '\n' */
+    APP_PUSH_RX_CHUNK_DATA,   /* 读取 chunk 数据 */
+    APP_PUSH_RX_CHUNK_CRLF,   /* 跳过 chunk 数据后的 "\r\n" */
+    APP_PUSH_RX_RAW,          /* 非 chunked：body 直接按行切分 */
+    APP_PUSH_RX_END           /* 流结束或格式错误 */
+} app_push_rx_state_t;
+
+typedef struct
+{
+    uint8_t inited;
+
+    app_push_handler_t handler;
+    void *user_ctx;
+
+    uplink_endpoint_t endpoint;
+    char device_id[UPLINK_MAX_DEVICE_ID_LEN];
+    uplink_signer_t signer;
+
+    uplink_retry_policy_t backoff;
+    uint16_t fail_streak;
+    uint32_t rand_state;
+
+    app_push_stats_t stats;
+
+    /* 接收状态机（每个会话开始时复位） */
+    app_push_rx_state_t rx_state;
+    uint32_t marker;
+    uint16_t header_used;
+    uint32_t chunk_left;
+    uint8_t chunk_digits;
+    uint16_t line_used;
+    uint8_t line_overflow;
+    uint32_t session_lines;
+
+    char req[APP_PUSH_REQ_MAX_LEN];
+    char header[APP_PUSH_HEADER_MAX_LEN];
+    char line[APP_PUSH_LINE_MAX_LEN];
+} app_push_ctx_t;
+
+static app_push_ctx_t g_push;
+
+/**
+ * @brief 退避抖动用的伪随机数（xorshift32，足够打散多设备重连时刻）
+ */
+static uint32_t AppPush_Rand(void)
+{
+    uint32_t x = g_push.rand_state;
+
+    if (x == 0U)
+    {
+        x = 0x9E3779B9U ^ (uint32_t)sys_now();
+    }
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_push.rand_state = x;
+    return x;
+}
+
+/**
+ * @brief 大小写不敏感的子串查找（响应头字段名大小写不固定）
+ */
+static uint8_t AppPush_ContainsNoCase(const char *text, size_t text_len, const char *needle)
+{
+    size_t n_len = strlen(needle);
+    size_t i;
+    size_t j;
+
+    if (n_len > text_len)
+    {
+        return 0U;
+    }
+
+    for (i = 0U; (i + n_len) <= text_len; i++)
+    {
+        for (j = 0U; j < n_len; j++)
+        {
+            char a = text[i + j];
+            char b = needle[j];
+
+            if ((a >= 'A') && (a <= 'Z'))
+            {
+                a = (char)(a - 'A' + 'a');
+            }
+            if (a != b)
+            {
+                break;
+            }
+        }
+
+        if (j == n_len)
+        {
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/**
+ * @brief 解析响应头：只接受 200；chunked 与否决定后续状态
+ */
+static void AppPush_OnHeaderDone(void)
+{
+    const char *space = (const char *)memchr(g_push.header, ' ', g_push.header_used);
+
+    /* 无论成败都用响应 Date 对时：服务端强制签名时首个未签名会话返回 401，下次重连即可签名 */
+    uplink_signer_observe_response(&g_push.signer, g_push.header, g_push.header_used, (uint32_t)sys_now());
+
+    if ((space == NULL) || ((size_t)(space - g_push.header) + 4U > g_push.header_used) ||
+        (memcmp(space + 1, "200", 3U) != 0))
+    {
+        g_push.rx_state = APP_PUSH_RX_END;
+        return;
+    }
+
+    g_push.stats.connects++;
+
+    if (AppPush_ContainsNoCase(g_push.header, g_push.header_used, "transfer-encoding: chunked") != 0U)
+    {
+        g_push.rx_state = APP_PUSH_RX_CHUNK_SIZE;
+        g_push.chunk_left = 0U;
+        g_push.chunk_digits = 0U;
+    }
+    else
+    {
+        g_push.rx_state = APP_PUSH_RX_RAW;
+    }
+}
+
+/**
+ * @brief 行组装：'\n' 结束一行，去掉行尾 '\r'，空行忽略，超长行整行丢弃
+ */
+static void AppPush_FeedLine(char ch)
+{
+    if (ch == '\n')
+    {
+        if (g_push.line_overflow != 0U)
+        {
+            g_push.stats.dropped_lines++;
+        }
+        else
+        {
+            if ((g_push.line_used > 0U) && (g_push.line[g_push.line_used - 1U] == '\r'))
+            {
+                g_push.line_used--;
+            }
+
+            if (g_push.line_used > 0U)
+            {
+                g_push.line[g_push.line_used] = '\0';
+                g_push.stats.lines++;
+                g_push.session_lines++;
+
+                if (g_push.handler != NULL)
+                {
+                    g_push.handler(g_push.user_ctx, g_push.line, g_push.line_used);
+                }
+            }
+        }
+
+        g_push.line_used = 0U;
+        g_push.line_overflow = 0U;
+        return;
+    }
+
+    if (g_push.line_used < (APP_PUSH_LINE_MAX_LEN - 1U))
+    {
+        g_push.line[g_push.line_used++] = ch;
+    }
+    else
+    {
+        g_push.line_overflow = 1U;
+    }
+}
+
+/**
+ * @brief 接收状态机：逐字节推进
+ */
+static void AppPush_FeedByte(char ch)
+{
+    switch (g_push.rx_state)
+    {
+    case APP_PUSH_RX_HEADER:
+        if (g_push.header_used < (APP_PUSH_HEADER_MAX_LEN - 1U))
+        {
+            g_push.header[g_push.header_used++] = ch;
+            g_push.header[g_push.header_used] = '\0';
+        }
+
+        g_push.marker = (g_push.marker << 8) | (uint8_t)ch;
+        if (g_push.marker == 0x0D0A0D0AU)
+        {
+            AppPush_OnHeaderDone();
+        }
+        break;
+
+    case APP_PUSH_RX_CHUNK_SIZE:
+    {
+        uint32_t digit;
+
+        if ((ch >= '0') && (ch <= '9'))
+        {
+            digit = (uint32_t)(ch - '0');
+        }
+        else if ((ch >= 'a') && (ch <= 'f'))
+        {
+            digit = (uint32_t)(ch - 'a' + 10);
+        }
+        else if ((ch >= 'A') && (ch <= 'F'))
+        {
+            digit = (uint32_t)(ch - 'A' + 10);
+        }
+        else if ((ch == ';') || (ch == '\r') || (ch == '\n'))
+        {
+            if (g_push.chunk_digits == 0U)
+            {
+                g_push.rx_state = APP_PUSH_RX_END;
+            }
+            else if (ch == '\n')
+            {
+                /* 长度 0 = 最后一个 chunk，上级主动结束了推送流 */
+                g_push.rx_state = (g_push.chunk_left == 0U) ? APP_PUSH_RX_END : APP_PUSH_RX_CHUNK_DATA;
+            }
+            else
+            {
+                g_push.rx_state = APP_PUSH_RX_CHUNK_EXT;
+            }
+            break;
+        }
+        else
+        {
+            g_push.rx_state = APP_PUSH_RX_END;
+            break;
+        }
+
+        /* 8 位十六进制已足够，超出视为格式错误 */
+        if (g_push.chunk_digits >= 8U)
+        {
+            g_push.rx_state = APP_PUSH_RX_END;
+            break;
+        }
+        g_push.chunk_left = (g_push.chunk_left << 4) | digit;
+        g_push.chunk_digits++;
+        break;
+    }
+
+    case APP_PUSH_RX_CHUNK_EXT:
+        if (ch == '\n')
+        {
+            g_push.rx_state = (g_push.chunk_left == 0U) ? APP_PUSH_RX_END : APP_PUSH_RX_CHUNK_DATA;
+        }
+        break;
+
+    case APP_PUSH_RX_CHUNK_DATA:
+        AppPush_FeedLine(ch);
+        g_push.chunk_left--;
+        if (g_push.chunk_left == 0U)
+        {
+            g_push.rx_state = APP_PUSH_RX_CHUNK_CRLF;
+        }
+        break;
+
+    case APP_PUSH_RX_CHUNK_CRLF:
+        if (ch == '\n')
+        {
+            g_push.rx_state = APP_PUSH_RX_CHUNK_SIZE;
+            g_push.chunk_left = 0U;
+            g_push.chunk_digits = 0U;
+        }
+        else if (ch != '\r')
+        {
+            g_push.rx_state = APP_PUSH_RX_END;
+        }
+        break;
+
+    case APP_PUSH_RX_RAW:
+        AppPush_FeedLine(ch);
+        break;
+
+    case APP_PUSH_RX_END:
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief 计算下次重连等待时间
+ */
+static uint32_t AppPush_NextDelay(void)
+{
+    if (g_push.session_lines > 0U)
+    {
+        /* 本次会话正常工作过：视为一次“正常断开”，从最短退避重新开始 */
+        g_push.fail_streak = 0U;
+    }
+
+    if (g_push.fail_streak < 0xFFFFU)
+    {
+        g_push.fail_streak++;
+    }
+
+    return uplink_retry_calc_delay_ms(&g_push.backoff, g_push.fail_streak, AppPush_Rand());
+}
+
+/**
+ * 对外接口实现
+ */
+BaseType_t AppPush_Init(app_push_handler_t handler, void *user_ctx)
+{
+    uplink_config_t cfg;
+
+    (void)memset(&g_push, 0, sizeof(g_push));
+
+    uplink_config_set_defaults(&cfg);
+
+    /* 与 uplink/鉴权共用同一上级地址，只是路径不同 */
+    g_push.endpoint.scheme = UPLINK_SCHEME_HTTP;
+    (void)snprintf(g_push.endpoint.host, sizeof(g_push.endpoint.host), "%s", TASK_UPLINK_SERVER_HOST);
+    g_push.endpoint.port = (uint16_t)TASK_UPLINK_SERVER_PORT;
+    (void)snprintf(g_push.endpoint.path, sizeof(g_push.endpoint.path), "%s", APP_PUSH_PATH);
+    g_push.endpoint.use_dns = 0U;
+
+    (void)snprintf(g_push.device_id, sizeof(g_push.device_id), "%s", cfg.device_id);
+    uplink_signer_init(&g_push.signer,
+                       cfg.device_id,
+                       (cfg.sign.enable != 0U) ? cfg.sign.secret : NULL,
+                       UPLINK_SIGN_LANE_PUSH);
+
+    g_push.backoff.base_delay_ms = APP_PUSH_BACKOFF_BASE_MS;
+    g_push.backoff.max_delay_ms = APP_PUSH_BACKOFF_MAX_MS;
+    g_push.backoff.max_attempts = 0U;
+    g_push.backoff.jitter_pct = 20U;
+
+    g_push.handler = handler;
+    g_push.user_ctx = user_ctx;
+    g_push.inited = 1U;
+    return pdPASS;
+}
+
+uint32_t AppPush_RunSession(void)
+{
+    struct netconn *conn;
+    struct netbuf *inbuf = NULL;
+    ip_addr_t server_addr;
+    uint32_t last_rx_ms;
+    int req_len;
+    size_t sign_len = 0U;
+    err_t err;
+
+    if (g_push.inited == 0U)
+    {
+        return APP_PUSH_BACKOFF_MAX_MS;
+    }
+
+    g_push.rx_state = APP_PUSH_RX_HEADER;
+    g_push.marker = 0U;
+    g_push.header_used = 0U;
+    g_push.line_used = 0U;
+    g_push.line_overflow = 0U;
+    g_push.session_lines = 0U;
+
+    {
+        uplink_err_t r = uplink_dns_resolve(&g_push.endpoint, &server_addr);
+
+        /* 地址配置错误：按最长间隔重试；DNS 暂时失败：走正常退避 */
+        if (r != UPLINK_OK)
+        {
+            return (r == UPLINK_ERR_TRANSPORT) ? AppPush_NextDelay() : APP_PUSH_BACKOFF_MAX_MS;
+        }
+    }
+
+    req_len = snprintf(g_push.req,
+                       sizeof(g_push.req) - UPLINK_SIGN_HEADERS_MAX_LEN,
+                       "GET %s HTTP/1.1\r\n"
+                       "Host: %s:%u\r\n"
+                       "Accept: application/x-ndjson\r\n",
+                       g_push.endpoint.path,
+                       g_push.endpoint.host,
+                       (unsigned)g_push.endpoint.port);
+    if ((req_len <= 0) || ((size_t)req_len >= (sizeof(g_push.req) - UPLINK_SIGN_HEADERS_MAX_LEN)))
+    {
+        return APP_PUSH_BACKOFF_MAX_MS;
+    }
+
+    /* GET 无 body：签名原文为 timestamp + "\n" + nonce + "\n"；未对时则只带设备 ID */
+    (void)uplink_signer_append_headers(&g_push.signer,
+                                       (uint32_t)sys_now(),
+                                       NULL,
+                                       0U,
+                                       &g_push.req[req_len],
+                                       sizeof(g_push.req) - (size_t)req_len,
+                                       &sign_len);
+    if (sign_len == 0U)
+    {
+        sign_len = (size_t)snprintf(&g_push.req[req_len],
+                                    sizeof(g_push.req) - (size_t)req_len,
+                                    "X-Device-Id: %s\r\n",
+                                    g_push.device_id);
+    }
+    req_len += (int)sign_len;
+    if ((size_t)req_len + 3U > sizeof(g_push.req))
+    {
+        return APP_PUSH_BACKOFF_MAX_MS;
+    }
+    g_push.req[req_len++] = '\r';
+    g_push.req[req_len++] = '\n';
+
+    conn = netconn_new(NETCONN_TCP);
+    if (conn == NULL)
+    {
+        return AppPush_NextDelay();
+    }
+
+    netconn_set_sendtimeout(conn, APP_PUSH_SEND_TIMEOUT_MS);
+    netconn_set_recvtimeout(conn, APP_PUSH_RECV_SLICE_MS);
+
+    err = netconn_connect(conn, &server_addr, g_push.endpoint.port);
+    if (err != ERR_OK)
+    {
+        (void)netconn_delete(conn);
+        return AppPush_NextDelay();
+    }
+
+    err = netconn_write(conn, g_push.req, (size_t)req_len, NETCONN_COPY);
+    if (err != ERR_OK)
+    {
+        (void)netconn_close(conn);
+        (void)netconn_delete(conn);
+        return AppPush_NextDelay();
+    }
+
+    last_rx_ms = (uint32_t)sys_now();
+
+    while (g_push.rx_state != APP_PUSH_RX_END)
+    {
+        err = netconn_recv(conn, &inbuf);
+
+        if (err == ERR_TIMEOUT)
+        {
+            /* 超时不代表断线：只有持续无数据超过心跳超时才主动断开 */
+            if (((uint32_t)sys_now() - last_rx_ms) >= APP_PUSH_HEARTBEAT_TIMEOUT_MS)
+            {
+                g_push.stats.hb_timeouts++;
+                break;
+            }
+            continue;
+        }
+
+        if (err != ERR_OK)
+        {
+            break;
+        }
+
+        last_rx_ms = (uint32_t)sys_now();
+
+        netbuf_first(inbuf);
+        do
+        {
+            void *data = NULL;
+            u16_t len = 0U;
+
+            if (netbuf_data(inbuf, &data, &len) != ERR_OK || data == NULL || len == 0U)
+            {
+                continue;
+            }
+
+            for (u16_t i = 0U; (i < len) && (g_push.rx_state != APP_PUSH_RX_END); i++)
+            {
+                AppPush_FeedByte(((const char *)data)[i]);
+            }
+
+        } while (netbuf_next(inbuf) >= 0);
+
+        netbuf_delete(inbuf);
+        inbuf = NULL;
+    }
+
+    (void)netconn_close(conn);
+    (void)netconn_delete(conn);
+
+    g_push.stats.disconnects++;
+    return AppPush_NextDelay();
+}
+
+void AppPush_GetStats(app_push_stats_t *out_stats)
+{
+    if (out_stats == NULL)
+    {
+        return;
+    }
+
+    *out_stats = g_push.stats;
+}
@@ -7,6 +7,12 @@
  * @note 说明：
  * - 业务门面层（Facade）：对外提供“初始化、入队、驱动发送”的统一接口。
  * - 上层业务只需要调用 uplink_enqueue_xxx() 把事件放入队列，再周期调用 uplink_poll() 即可。
+ * - 消息按优先级类别入队（uplink_enqueue_json_prio），出队按类别权重公平调度（见 uplink_sched.h）。
+ * - 消息可带送达截止时刻（uplink_enqueue_json_ttl / 类别默认 ttl_ms），过期未送达即丢弃并计入统计。
+ * - 调用者可先预留队列槽位、把 payload 直接格式化进去再提交（uplink_enqueue_reserve/commit），省去中间缓冲与拷贝。
+ * - 尚未发出的消息可原地改写 payload（uplink_update_json），供业务层把重复事件合并进已排队的记录。
+ * - 热队列放不下的消息溢出到 SDRAM 后备队列（见 uplink_backlog.h），热队列降到低水位时按顺序回填。
+ * - 同步发送可把多条已到期消息合并进一次 POST，并按 heatshrink 码流压缩请求 body（cfg.batch，见 uplink_lzss.h）。
  *
  * @note 预留：
  * - 服务器地址/端口/路径全部来自 uplink_config_t，没写死。
@@ -24,17 +30,90 @@ extern "C"
 {
 #endif
 
+#include "uplink_breaker.h"
+#include "uplink_backlog.h"
 #include "uplink_codec_json.h"
 #include "uplink_config.h"
+#include "uplink_failover.h"
+#include "uplink_lzss.h"
+#include "uplink_msgid.h"
 #include "uplink_platform.h"
 #include "uplink_queue.h"
 #include "uplink_retry.h"
+#include "uplink_sched.h"
+#include "uplink_sign.h"
 #include "uplink_transport_http_netconn.h"
+#include "uplink_transport_mqtt_netconn.h"
 
 /* lwIP 系统抽象：用于互斥量（当前 NO_SYS=0） */
 #include "err.h"
 #include "sys.h"
 
+/** 异步流水模式下每次 poll 等待确认的时长（毫秒），不宜过大以免拖慢任务周期 */
+#ifndef UPLINK_PIPELINE_ACK_WAIT_MS
+#define UPLINK_PIPELINE_ACK_WAIT_MS 5U
+#endif
+
+/** uplink_enqueue_json_ttl 的 ttl_ms 取此值时使用类别默认存活时长（cfg.classes[prio].ttl_ms） */
+#define UPLINK_TTL_CLASS_DEFAULT 0xFFFFFFFFU
+
+/** 同步模式自适应接收超时下限（毫秒）；尚无 RTT 样本时使用 cfg.recv_timeout_ms */
+#ifndef UPLINK_RTO_MIN_MS
+#define UPLINK_RTO_MIN_MS 300U
+#endif
+
+/** 同步模式自适应接收超时上限（毫秒） */
+#ifndef UPLINK_RTO_MAX_MS
+#define UPLINK_RTO_MAX_MS 8000U
+#endif
+
+    /**
+     * @brief uplink 各优先级类别的累计统计（下标为 uplink_prio_t）
+     *
+     */
+    typedef struct
+    {
+        uint32_t enqueued[UPLINK_PRIO_COUNT];       /* 成功入队数 */
+        uint32_t rejected[UPLINK_PRIO_COUNT];       /* 入队被拒数（类别满且拒绝新消息 / 队列满且无可挤掉的消息） */
+        uint32_t evicted[UPLINK_PRIO_COUNT];        /* 被挤掉数（本类别 DROP_OLDEST 或被更高类别抢占） */
+        uint32_t exhausted[UPLINK_PRIO_COUNT];      /* 超过最大尝试次数被丢弃数 */
+        uint32_t expired[UPLINK_PRIO_COUNT];        /* 超过截止时刻未送达被丢弃数 */
+        uint32_t delivered[UPLINK_PRIO_COUNT];      /* 确认送达数 */
+        uint32_t max_latency_ms[UPLINK_PRIO_COUNT]; /* 入队到确认送达的最大时延（毫秒） */
+
+        /* 后备队列（cfg.backlog 未启用时全为 0） */
+        uint32_t spilled[UPLINK_PRIO_COUNT];           /* 进入后备队列数（热队列放不下的新消息 + 被高类别挤出热队列的消息） */
+        uint32_t refilled[UPLINK_PRIO_COUNT];          /* 从后备队列回填到热队列数 */
+        uint32_t backlog_full[UPLINK_PRIO_COUNT];      /* 后备队列也满、只能按类别策略挤掉/拒绝的次数 */
+        uint32_t backlog_depth[UPLINK_PRIO_COUNT];     /* 后备队列当前深度（读取统计时的快照） */
+        uint32_t backlog_max_depth[UPLINK_PRIO_COUNT]; /* 后备队列历史最大深度 */
+
+        /* 同步发送的请求 body（两项之比即压缩率；cfg.batch.compress=0 时相等） */
+        uint32_t posts;            /* 发出的 POST 数（合并上报时一次 POST 含多条消息） */
+        uint32_t body_plain_bytes; /* 请求 body 明文累计字节 */
+        uint32_t body_wire_bytes;  /* 请求 body 实际发出累计字节 */
+        uint32_t server_holds;     /* 上级要求暂缓（Retry-After）的应答数 */
+        uint32_t parallel_posts;   /* 积压时以并发方式发出的 POST 数（含在 posts 内） */
+
+        /* 消息 ID 纪元（见 uplink_msgid.h） */
+        uint32_t id_claim_failures; /* 纪元申请失败次数 */
+        uint32_t id_unavailable;    /* 因没有可用纪元被拒绝的入队数 */
+    } uplink_stats_t;
+
+    /**
+     * @brief 同步发送中的一路 POST（积压并发时最多 UPLINK_MAX_PARALLEL 路，平时只用第 0 路）
+     *
+     */
+    typedef struct
+    {
+        uint32_t ids[UPLINK_MAX_BATCH_EVENTS];   /* 携带的消息 ID（按发送顺序） */
+        uint16_t n;                              /* 携带的消息数 */
+        size_t plain_len;                        /* 请求 body 压缩前长度 */
+        size_t body_len;                         /* 请求 body 实际长度 */
+        char body[UPLINK_MAX_BATCH_BODY_LEN];    /* 请求 body（单个事件对象、JSON 数组或压缩码流） */
+        char response[UPLINK_MAX_HTTP_BODY_LEN]; /* 响应 body */
+    } uplink_request_t;
+
     /**
      * @brief uplink 模块运行时上下文
      *
@@ -53,16 +132,36 @@ extern "C"
         uplink_platform_t platform; /* 平台回调（初始化时拷贝/补全默认值） */
 
         uplink_queue_t queue; /* 待发送队列 */
+        uplink_sched_t sched; /* 优先级准入与加权公平出队 */
+        uplink_stats_t stats; /* 各类别统计（mutex 保护） */
 
-        /* 传输层：当前绑定 netconn HTTP 实现 */
+        uplink_backlog_t backlog; /* SDRAM 后备队列（mutex 保护） */
+        uint8_t backlog_warned;   /* 已告警的类别（位图，按 UPLINK_BACKLOG_WARN_PCT/CLEAR_PCT 迟滞） */
+
+        /* 传输层：按 endpoint.scheme 绑定 netconn HTTP 或 MQTT 实现 */
         uplink_transport_t transport;
         uplink_transport_http_netconn_ctx_t http_ctx;
+        uplink_transport_mqtt_netconn_ctx_t mqtt_ctx;
+        uplink_signer_t signer; /* HTTP 请求签名器（MQTT 不使用） */
+        uplink_failover_t failover; /* 上级端点选择器（STICKY：连续失败才切换） */
 
-        uint32_t next_message_id; /* 递增消息 ID 生成器 */
+        uplink_msgid_t msgid;     /* 消息 ID 生成器（跨重启不重复，见 uplink_msgid.h） */
+        uint32_t epoch_retry_ms;  /* 纪元申请失败后下次重试的时刻（0=不限） */
+        uplink_msg_t *reserved;   /* uplink_enqueue_reserve 预留中的槽位（预留期间持有 mutex） */
+        uint8_t reserved_backlog; /* 1=预留槽位在后备队列尾部；0=在热队列 */
 
         /* 发送/接收缓冲（放在上下文里，避免占用任务栈） */
-        char event_json[UPLINK_MAX_EVENT_JSON_LEN];
-        char response_body[UPLINK_MAX_HTTP_BODY_LEN];
+        char event_json[UPLINK_MAX_EVENT_JSON_LEN];      /* 单条事件编码缓冲（各路依次编码，共用） */
+#if UPLINK_LZSS_ENABLE
+        uplink_lzss_t lzss; /* 请求 body 压缩器（cfg.batch.compress，各路共用） */
+#endif
+        uplink_request_t requests[UPLINK_MAX_PARALLEL]; /* 各路请求/响应缓冲 */
+
+        /* 积压并发（cfg.parallel.max_requests>1 且传输为 HTTP 时使用） */
+        uplink_post_t posts[UPLINK_MAX_PARALLEL]; /* 交给 transport 的各路请求 */
+#if UPLINK_MAX_PARALLEL > 1
+        uplink_http_req_t http_parallel[UPLINK_MAX_PARALLEL]; /* HTTP 并发工作区 */
+#endif
 
     } uplink_t;
 
@@ -70,10 +169,34 @@ extern "C"
 
     uplink_err_t uplink_enqueue_json(uplink_t *u, const char *type, const char *payload_json);
 
+    uplink_err_t uplink_enqueue_json_prio(uplink_t *u, const char *type, const char *payload_json, uplink_prio_t prio);
+
+    uplink_err_t uplink_enqueue_json_ttl(uplink_t *u,
+                                         const char *type,
+                                         const char *payload_json,
+                                         uplink_prio_t prio,
+                                         uint32_t ttl_ms,
+                                         uint32_t *out_message_id);
+
+    uplink_err_t uplink_enqueue_reserve(uplink_t *u,
+                                        const char *type,
+                                        uplink_prio_t prio,
+                                        uint32_t ttl_ms,
+                                        char **out_payload,
+                                        size_t *out_cap);
+
+    uplink_err_t uplink_enqueue_commit(uplink_t *u, uint32_t *out_message_id);
+
+    void uplink_enqueue_abort(uplink_t *u);
+
+    uplink_err_t uplink_update_json(uplink_t *u, uint32_t message_id, const char *payload_json);
+
     void uplink_poll(uplink_t *u);
 
     uint16_t uplink_get_queue_depth(uplink_t *u);
 
+    void uplink_get_stats(uplink_t *u, uplink_stats_t *out_stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,116 @@
+/**
+ * @file    uplink_backlog.h
+ * @author  Yukikaze
+ * @brief   Uplink 外部 SDRAM 后备队列（二级积压，队列层）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 热队列（uplink_queue_t，内部 SRAM）只有 UPLINK_QUEUE_MAX_LEN 个槽位，上级长时间不可用时很快占满，
+ *   之后的消息只能被挤掉或拒绝。本层在外部 SDRAM 上为每个优先级类别各开一个定长环形队列，
+ *   容纳热队列放不下的消息（数千条），上级恢复后再按顺序回填热队列发送。
+ * - 每个类别的槽位数 = 内存区可容纳的消息数 × share_pct[类别] / 100；share_pct 为 0 的类别不使用后备队列。
+ * - 同一类别内，热队列中的消息总比后备队列中的旧：后备队列非空时新消息一律排到后备队列尾部，
+ *   回填只取后备队列队头，被更高类别挤出热队列的消息放回后备队列队头。
+ *   因此每个后备队列内 message_id 单调递增，可按 ID 二分查找（uplink_backlog_find）。
+ * - 本层不加锁、不做过期与统计，由 uplink.c 在持有队列互斥量时调用。
+ *
+ * @note 内存区：
+ * - 默认使用 SDRAM 0xD0200000 起 4MB（LVGL heap 之后，地址布局见 lv_conf.h）；
+ *   也可在 uplink_config_t.backlog 中指定任意内存区（例如主机测试用 malloc 出来的模拟区域）。
+ * - SDRAM 由 LCD_Init 初始化（Task_Lvgl_Init 中）。init 只记录地址、不访问内存，
+ *   首次写入发生在热队列满之后，此时各任务已启动，SDRAM 早已可用。
+ * - 掉电即丢失：它解决的是“上级长时间不可用”，不是“设备重启”。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_BACKLOG_H
+#define __UPLINK_BACKLOG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_types.h"
+
+/** 是否默认启用 SDRAM 后备队列（1=uplink_config_set_defaults 填入下面的内存区；0=不启用） */
+#ifndef UPLINK_BACKLOG_ENABLE
+#define UPLINK_BACKLOG_ENABLE 1
+#endif
+
+/** 后备队列内存区起始地址（外部 SDRAM，LVGL heap 之后） */
+#ifndef UPLINK_BACKLOG_ADDR
+#define UPLINK_BACKLOG_ADDR 0xD0200000U
+#endif
+
+/** 后备队列内存区大小（4MB，按 uplink_msg_t 约 320B 计约 13000 条） */
+#ifndef UPLINK_BACKLOG_SIZE
+#define UPLINK_BACKLOG_SIZE (4U * 1024U * 1024U)
+#endif
+
+/** 回填低水位：热队列消息数（含在途）降到此值及以下时才开始回填，避免每发一条就搬一条 */
+#ifndef UPLINK_BACKLOG_REFILL_LOW
+#define UPLINK_BACKLOG_REFILL_LOW 2U
+#endif
+
+/** 回填高水位：回填后热队列至少空出的槽位数（留给新到的 HIGH 类别消息，不必先挤掉别人） */
+#ifndef UPLINK_BACKLOG_HOT_RESERVE
+#define UPLINK_BACKLOG_HOT_RESERVE 2U
+#endif
+
+/** 积压告警水位（占本类别容量的百分比）：超过时打一条告警日志 */
+#ifndef UPLINK_BACKLOG_WARN_PCT
+#define UPLINK_BACKLOG_WARN_PCT 75U
+#endif
+
+/** 积压告警解除水位（百分比）：降到此值以下才重新允许告警（迟滞，避免在水位线附近反复刷日志） */
+#ifndef UPLINK_BACKLOG_CLEAR_PCT
+#define UPLINK_BACKLOG_CLEAR_PCT 50U
+#endif
+
+    /**
+     * @brief 单个类别的环形后备队列
+     *
+     */
+    typedef struct
+    {
+        uplink_msg_t *slots; /* 槽位数组（位于外部内存区） */
+        uint32_t capacity;   /* 槽位数（0=本类别不使用后备队列） */
+        uint32_t head;       /* 队头下标（最旧） */
+        uint32_t count;      /* 当前消息数 */
+    } uplink_backlog_ring_t;
+
+    /**
+     * @brief 后备队列（各类别一个环形队列，共享一块内存区）
+     *
+     */
+    typedef struct
+    {
+        uplink_backlog_ring_t rings[UPLINK_PRIO_COUNT];
+    } uplink_backlog_t;
+
+    void uplink_backlog_init(uplink_backlog_t *b, void *mem, uint32_t size, const uint8_t share_pct[UPLINK_PRIO_COUNT]);
+
+    uint32_t uplink_backlog_capacity(const uplink_backlog_t *b, uint8_t prio);
+
+    uint32_t uplink_backlog_count(const uplink_backlog_t *b, uint8_t prio);
+
+    uplink_err_t uplink_backlog_push_slot(uplink_backlog_t *b, uint8_t prio, uplink_msg_t **out_slot);
+
+    uplink_err_t uplink_backlog_push_front(uplink_backlog_t *b, const uplink_msg_t *msg);
+
+    uplink_err_t uplink_backlog_peek(uplink_backlog_t *b, uint8_t prio, uplink_msg_t **out_msg);
+
+    uplink_err_t uplink_backlog_pop(uplink_backlog_t *b, uint8_t prio);
+
+    uplink_err_t uplink_backlog_drop_tail(uplink_backlog_t *b, uint8_t prio);
+
+    uplink_msg_t *uplink_backlog_find(uplink_backlog_t *b, uint32_t message_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_BACKLOG_H */
@@ -0,0 +1,89 @@
+/**
+ * @file    uplink_breaker.h
+ * @author  Yukikaze
+ * @brief   上级健康熔断器（工具层，鉴权与上报共享）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 三态：CLOSED（正常放行）-> OPEN（熔断，直接拒绝）-> HALF_OPEN（只放行一个探测请求）。
+ * - 鉴权（app_auth）与上报（uplink）都向同一个熔断器反馈结果：任一路径连续失败达到阈值即熔断，
+ *   熔断期间鉴权立即返回 NET_FAIL、上报暂停，不再各自等满超时、各按各的节奏重试。
+ * - 熔断时长到期后第一个请求成为探测：成功则回到 CLOSED；失败则重新熔断，时长翻倍（封顶 MAX）。
+ * - “失败”指上级整体不可用（超时/断开/5xx）；配置了备用上级时，由调用方在所有端点都不可用后才记失败。
+ *
+ * @note 并发：
+ * - 状态是模块内静态变量，鉴权任务、上报任务、LVGL 任务共享，读写用 SYS_ARCH_PROTECT 短临界区保护。
+ * - 探测请求持有者必须调用 uplink_breaker_report 反馈结果（没有发出请求时调用 uplink_breaker_release 归还）；
+ *   若迟迟不反馈（例如任务被删除），超过 UPLINK_BREAKER_PROBE_TIMEOUT_MS 后重新放出探测名额。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_BREAKER_H
+#define __UPLINK_BREAKER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_types.h"
+
+/** 连续失败多少次后熔断 */
+#ifndef UPLINK_BREAKER_FAIL_THRESHOLD
+#define UPLINK_BREAKER_FAIL_THRESHOLD 3U
+#endif
+
+/** 熔断时长：首次（毫秒） */
+#ifndef UPLINK_BREAKER_OPEN_BASE_MS
+#define UPLINK_BREAKER_OPEN_BASE_MS 5000U
+#endif
+
+/** 熔断时长：上限（毫秒），决定上级恢复后最迟多久能重新刷卡开门 */
+#ifndef UPLINK_BREAKER_OPEN_MAX_MS
+#define UPLINK_BREAKER_OPEN_MAX_MS 30000U
+#endif
+
+/** 探测请求最长占用时间（毫秒），超时未反馈则重新放出探测名额 */
+#ifndef UPLINK_BREAKER_PROBE_TIMEOUT_MS
+#define UPLINK_BREAKER_PROBE_TIMEOUT_MS 10000U
+#endif
+
+    /**
+     * @brief 熔断器状态
+     *
+     */
+    typedef enum
+    {
+        UPLINK_BREAKER_CLOSED = 0,   /* 正常：请求全部放行 */
+        UPLINK_BREAKER_OPEN = 1,     /* 熔断：请求直接拒绝 */
+        UPLINK_BREAKER_HALF_OPEN = 2 /* 半开：只放行一个探测请求 */
+    } uplink_breaker_state_t;
+
+    /**
+     * @brief 熔断器统计
+     *
+     */
+    typedef struct
+    {
+        uint32_t opens;    /* 进入 OPEN 的次数 */
+        uint32_t rejected; /* 被拒绝的请求数 */
+        uint32_t probes;   /* 放出的探测请求数 */
+    } uplink_breaker_stats_t;
+
+    uint8_t uplink_breaker_allow(uint32_t now_ms);
+
+    void uplink_breaker_report(uint8_t ok, uint32_t now_ms);
+
+    void uplink_breaker_release(void);
+
+    uplink_breaker_state_t uplink_breaker_get_state(void);
+
+    void uplink_breaker_get_stats(uplink_breaker_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_BREAKER_H */
@@ -18,6 +18,12 @@
  *     "type":"RFID_AUDIT",
  *     "payload":{ ... }
  *  }
+ *
+ * @note 序列化：
+ * - 事件与载荷不用 snprintf 拼接，而是用无分配的 JSON 写入器（uplink_json_writer_t）按字段写入：
+ *   整数直接转十进制，字符串按 JSON 规则转义（'"'、'\\'、控制字符）。
+ * - 每种载荷的字段只定义一次（X-macro 表），由 UPLINK_JSON_SCHEMA_DEFINE 生成对应结构体与写函数，
+ *   字段顺序即表中顺序；对纯 ASCII 标识符输入，输出与原 snprintf 格式逐字节一致。
  * 
  * @copyright Copyright (c) 2025 Yukikaze
  * 
@@ -35,6 +41,65 @@ extern "C"
 
 #include "uplink_types.h"
 
+/**
+ * @brief 定长缓冲 JSON 写入器
+ *
+ * @note 溢出后按 snprintf 语义保留能放下的前缀（'\0' 结尾），并置 overflow，后续写入全部忽略。
+ */
+typedef struct
+{
+    char *buf;
+    size_t cap;       /* 缓冲区容量（含结尾 '\0'） */
+    size_t len;       /* 已写入长度 */
+    uint8_t overflow; /* 1=缓冲不足 */
+    uint8_t fields;   /* 当前对象已写字段数（决定字段前是否补逗号） */
+} uplink_json_writer_t;
+
+/* 字段类型 → 结构体成员类型（X-macro 表的第一列） */
+#define UPLINK_JSON_CTYPE_str const char *
+#define UPLINK_JSON_CTYPE_u32 uint32_t
+#define UPLINK_JSON_CTYPE_i32 int32_t
+#define UPLINK_JSON_CTYPE_json const char *
+
+#define UPLINK_JSON_X_MEMBER(kind, key, member) UPLINK_JSON_CTYPE_##kind member;
+#define UPLINK_JSON_X_WRITE(kind, key, member)                             \
+    uplink_json_put_key(w, "\"" #key "\":", sizeof("\"" #key "\":") - 1U); \
+    uplink_json_put_##kind(w, in->member);
+
+/**
+ * @brief 由字段表生成载荷结构体 name##_t 与写函数 name##_write(w, in)
+ *
+ * @note 字段表形如 `#define XXX_FIELDS(X) X(str, lockerId, locker_id) X(u32, sessionId, session_id)`，
+ *       列依次为：字段类型（str/u32/i32/json）、JSON 键名、结构体成员名。写函数只写字段，不写花括号，
+ *       同一对象可以依次调用多个写函数（例如基础字段 + 可选的聚合字段）。
+ */
+#define UPLINK_JSON_SCHEMA_DEFINE(name, FIELDS)                                  \
+    typedef struct                                                               \
+    {                                                                            \
+        FIELDS(UPLINK_JSON_X_MEMBER)                                             \
+    } name##_t;                                                                  \
+    static inline void name##_write(uplink_json_writer_t *w, const name##_t *in) \
+    {                                                                            \
+        FIELDS(UPLINK_JSON_X_WRITE)                                              \
+    }
+
+void uplink_json_writer_init(uplink_json_writer_t *w, char *buf, size_t cap);
+
+void uplink_json_obj_begin(uplink_json_writer_t *w);
+
+void uplink_json_obj_end(uplink_json_writer_t *w);
+
+void uplink_json_put_key(uplink_json_writer_t *w, const char *quoted_key, size_t len);
+
+void uplink_json_put_str(uplink_json_writer_t *w, const char *s);
+
+void uplink_json_put_u32(uplink_json_writer_t *w, uint32_t v);
+
+void uplink_json_put_i32(uplink_json_writer_t *w, int32_t v);
+
+void uplink_json_put_json(uplink_json_writer_t *w, const char *s);
+
+uplink_err_t uplink_json_writer_finish(uplink_json_writer_t *w, size_t *out_len);
 
 uplink_err_t uplink_codec_json_build_event(char *out_json,
                                            size_t out_json_len,
@@ -49,6 +114,17 @@ uplink_err_t uplink_codec_json_parse_app_code(const char *body,
                                               size_t body_len,
                                               int32_t *out_code);
 
+uplink_err_t uplink_codec_json_parse_u32(const char *body,
+                                         size_t body_len,
+                                         const char *key,
+                                         uint32_t *out_value);
+
+uplink_err_t uplink_codec_json_parse_str(const char *body,
+                                         size_t body_len,
+                                         const char *key,
+                                         char *out_str,
+                                         size_t out_str_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,11 +33,11 @@ extern "C"
      *
      * @note 说明：
      * - 该结构体可整体拷贝，内部不使用动态内存，便于静态分配。
-     * - TLS 相关字段为未来预留，当前 HTTP 模式不会使用它们。
+     * - TLS 相关字段为未来预留，当前不会使用；mqtt 只在 MQTT 下使用；sign 对 HTTP 生效。
      */
     typedef struct
     {
-        uplink_endpoint_t endpoint;               /* 上报服务器端点 */
+        uplink_endpoint_t endpoint;               /* 上报服务器端点（首选上级） */
         char device_id[UPLINK_MAX_DEVICE_ID_LEN]; /* 设备唯一标识（后端用来区分设备） */
 
         uint16_t queue_len; /* 队列长度（1..UPLINK_QUEUE_MAX_LEN） */
@@ -47,6 +47,8 @@ extern "C"
 
         uplink_retry_policy_t retry; /* 重试策略（指数退避） */
 
+        uplink_class_policy_t classes[UPLINK_PRIO_COUNT]; /* 各优先级类别的容量/权重/丢弃策略（下标为 uplink_prio_t） */
+
         /**
          * @brief TLS 相关配置（预留）
          *
@@ -61,6 +63,91 @@ extern "C"
             char sni_host[UPLINK_MAX_HOST_LEN]; /* SNI 主机名（域名证书场景常用） */
         } tls;
 
+        /**
+         * @brief MQTT 相关配置（仅 endpoint.scheme == UPLINK_SCHEME_MQTT 时使用）
+         *
+         * @note 说明：
+         * - 客户端 ID 使用 device_id，发布主题使用 endpoint.path，QoS 固定为 1。
+         * - 会话为持久会话（CleanSession=0），断线重连后未确认的消息以相同 packetId 重发。
+         */
+        struct
+        {
+            uint16_t keepalive_s; /* 心跳周期（秒），空闲超过一半周期发送 PINGREQ */
+            uint8_t max_inflight; /* 同时在途的 PUBLISH 数（1..UPLINK_MAX_INFLIGHT） */
+        } mqtt;
+
+        /**
+         * @brief 请求签名配置（HTTP，对应服务端 security.verify_signature）
+         *
+         * @note 说明：
+         * - secret 与服务端 devices.secret 一致；X-Device-Id 使用 device_id。
+         * - 密钥只在 uplink_init 时预计算一次，运行中修改 secret 需重新 uplink_init。
+         */
+        struct
+        {
+            uint8_t enable;                     /* 1=请求携带签名头，0=不签名 */
+            char secret[UPLINK_MAX_SECRET_LEN]; /* 设备密钥 */
+        } sign;
+
+        /**
+         * @brief 备用上级端点（按优先顺序排在 endpoint 之后，见 uplink_failover.h）
+         *
+         * @note 说明：
+         * - scheme 必须与 endpoint 相同（传输实现只在 uplink_init 时绑定一次）；path 为空时沿用 endpoint.path。
+         * - 同步发送（HTTP）时生效；MQTT 异步流水维持单一长连接，只使用 endpoint。
+         */
+        struct
+        {
+            uint8_t count;                                   /* 备用端点数（0=不启用故障切换） */
+            uplink_endpoint_t list[UPLINK_MAX_ENDPOINTS - 1]; /* 备用端点 */
+        } fallback;
+
+        /**
+         * @brief 二级后备队列（热队列放不下的消息暂存在这块内存区，见 uplink_backlog.h）
+         *
+         * @note 说明：
+         * - 默认指向外部 SDRAM（UPLINK_BACKLOG_ADDR/UPLINK_BACKLOG_SIZE）；mem=NULL 或 size=0 表示不启用。
+         * - 内存区需在 uplink 生命周期内一直有效，且不与 LCD/LVGL 等区域重叠。
+         */
+        struct
+        {
+            void *mem;                            /* 内存区起始地址 */
+            uint32_t size;                        /* 内存区大小（字节） */
+            uint8_t share_pct[UPLINK_PRIO_COUNT]; /* 各类别占内存区的百分比（下标为 uplink_prio_t，总和 <=100，0=该类别不使用） */
+        } backlog;
+
+        /**
+         * @brief 合并上报与压缩（同步发送 HTTP 时生效；MQTT 异步流水逐条发布，忽略此项）
+         *
+         * @note 说明：
+         * - max_events>1 时一次 POST 把最多 max_events 条已到发送时间的消息打成 JSON 数组，服务端整批应答。
+         * - compress=1 时请求 body 按 heatshrink 码流压缩并带 Content-Encoding（见 uplink_lzss.h），签名覆盖压缩后的字节。
+         * - 两项都需要服务端支持（server/app/content_encoding.py 与 router_uplink.py 的批量入口），默认关闭以兼容旧服务端。
+         * - max_events>1 需编译期 UPLINK_BATCH_ENABLE=1，compress=1 需 UPLINK_LZSS_ENABLE=1；默认都不编译，不占批量缓冲与编码器状态。
+         */
+        struct
+        {
+            uint8_t max_events; /* 每次 POST 最多合并的事件数（1=不合并，1..UPLINK_MAX_BATCH_EVENTS） */
+            uint8_t compress;   /* 1=压缩请求 body，0=明文 JSON */
+        } batch;
+
+        /**
+         * @brief 积压时并发发送（同步发送且 transport 支持 post_json_parallel 时生效，目前只有 HTTP）
+         *
+         * @note 说明：
+         * - 待发送消息数（热队列 + 后备队列）达到 threshold 时，一次 poll 最多同时发出 max_requests 个 POST，
+         *   每个 POST 各用一条连接、各自携带一批消息（见 batch），按各自的应答确认或重试。
+         * - 低于阈值时仍是一次一个 POST，平时的行为与连接占用不变。
+         * - 各路的消息都取自热队列，实际路数不超过热队列里能凑出的批数（受 UPLINK_QUEUE_MAX_LEN 与类别容量限制）。
+         * - 熔断器不在关闭状态（半开探测）或上级要求暂缓时不并发。
+         * - MQTT 本身是异步流水，忽略此项。
+         */
+        struct
+        {
+            uint8_t max_requests; /* 同时在途的 POST 数（1=不并发，1..UPLINK_MAX_PARALLEL） */
+            uint16_t threshold;   /* 积压消息数达到此值才并发 */
+        } parallel;
+
     } uplink_config_t;
 
     void uplink_config_set_defaults(uplink_config_t *cfg);
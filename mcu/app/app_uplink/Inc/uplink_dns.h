@@ -0,0 +1,81 @@
+/**
+ * @file    uplink_dns.h
+ * @author  Yukikaze
+ * @brief   主机名解析与共享缓存（工具层）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 所有传输实现（HTTP/UDP/MQTT）与推送通道统一调用 uplink_dns_resolve，
+ *   app_auth 与 uplink 解析同一域名时共享一条缓存，稳态请求不再调用 netconn_gethostbyname。
+ * - endpoint.use_dns=0 时按 IP 字符串直转，不经过缓存。
+ * - 正缓存：解析成功后保留 UPLINK_DNS_TTL_MS；netconn API 拿不到记录本身的 TTL，这里用固定值。
+ * - 负缓存：解析失败后 UPLINK_DNS_NEG_TTL_MS 内直接返回失败，避免每次请求都卡在 DNS 超时上。
+ * - 后台刷新：uplink_dns_refresh 由 Task_Uplink 周期调用，对即将过期且近期使用过的条目提前重新解析；
+ *   刷新失败时继续使用旧地址（serve-stale），不影响请求路径。
+ *
+ * @note 并发：
+ * - 缓存表在 app_auth（鉴权任务）、uplink（上报任务）、推送任务之间共享，
+ *   读写表项用 SYS_ARCH_PROTECT 短临界区保护；阻塞的解析调用在临界区之外进行。
+ * - 依赖 LWIP_DNS=1；未开启时 use_dns=1 的端点返回 UPLINK_ERR_UNSUPPORTED（与原行为一致）。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_DNS_H
+#define __UPLINK_DNS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_types.h"
+
+#include "ip_addr.h"
+
+/** 缓存条目数（上级地址通常只有 1~2 个域名） */
+#ifndef UPLINK_DNS_CACHE_SIZE
+#define UPLINK_DNS_CACHE_SIZE 4U
+#endif
+
+/** 正缓存有效期（毫秒） */
+#ifndef UPLINK_DNS_TTL_MS
+#define UPLINK_DNS_TTL_MS 300000U
+#endif
+
+/** 负缓存有效期（毫秒） */
+#ifndef UPLINK_DNS_NEG_TTL_MS
+#define UPLINK_DNS_NEG_TTL_MS 10000U
+#endif
+
+/** 提前刷新窗口（毫秒）：剩余有效期小于该值时由后台刷新 */
+#ifndef UPLINK_DNS_REFRESH_AHEAD_MS
+#define UPLINK_DNS_REFRESH_AHEAD_MS 30000U
+#endif
+
+    /**
+     * @brief DNS 缓存统计
+     *
+     */
+    typedef struct
+    {
+        uint32_t hits;         /* 命中正缓存 */
+        uint32_t neg_hits;     /* 命中负缓存（直接返回失败） */
+        uint32_t lookups;      /* 实际调用解析器次数（含后台刷新） */
+        uint32_t failures;     /* 解析器失败次数 */
+        uint32_t refreshes;    /* 后台刷新成功次数 */
+        uint32_t stale_served; /* 解析失败但沿用旧地址的次数 */
+    } uplink_dns_stats_t;
+
+    uplink_err_t uplink_dns_resolve(const uplink_endpoint_t *endpoint, ip_addr_t *out_addr);
+
+    void uplink_dns_refresh(void);
+
+    void uplink_dns_get_stats(uplink_dns_stats_t *out_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_DNS_H */
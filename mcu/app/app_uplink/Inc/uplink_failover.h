@@ -0,0 +1,165 @@
+/**
+ * @file    uplink_failover.h
+ * @author  Yukikaze
+ * @brief   多上级端点选择与故障切换（工具层）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 端点按优先顺序登记（例如 0=RK3568 主上级，1=PC 备用上级），每个端点维护健康度：
+ *   平滑 RTT（SRTT）与 RTT 偏差（RTTVAR，Jacobson/Karels，同 TCP）、连续失败次数、冷却截止时刻。
+ * - 评分 = SRTT + 顺序偏置（靠前的端点优先）+ 连续失败惩罚，分数越低越好；冷却中的端点不参与选择。
+ * - 连续失败达到阈值后进入冷却，冷却时长指数增长（UPLINK_FAILOVER_COOLDOWN_BASE_MS 起，封顶 MAX）。
+ * - 冷却结束的端点重新参与选择（试探）；仍然失败则冷却翻倍，成功则恢复正常评分。
+ * - 自适应超时：RTO = SRTT + 4 × RTTVAR，夹在调用者给的 [min, max] 内；没有样本时用调用者给的初始值（通常为静态超时）。
+ *   - 连续失败时按 2^n 退避（最多 2^UPLINK_FAILOVER_RTO_BACKOFF_MAX）：上级变慢但存活时能等到应答并重新学习 RTT。
+ *   - 退避用尽仍失败视为明显不可达：回到基础 RTO 快速失败，每 UPLINK_FAILOVER_RTO_PROBE_EVERY 次失败再做一次长等待探测。
+ *
+ * @note 两种选择策略：
+ * - FAST（同步鉴权）：每次请求都选当前分数最低的端点，失败 1 次即冷却，调用方在同一次鉴权内立刻换下一个端点重试。
+ * - STICKY（异步上报）：一直使用当前端点，连续失败达到阈值才切换，避免在两个上级之间来回跳；
+ *   停留在备用端点超过 UPLINK_FAILOVER_FAILBACK_MS 后尝试回到更靠前的端点（失败则按冷却规则再切回）。
+ *
+ * @note 暂缓（上级过载时给出的 Retry-After）：
+ * - 与冷却不同，暂缓说明上级活着、只是要求晚点再来，不算失败，不影响评分；
+ * - 发送前用 uplink_failover_pick_sendable 选端点：检查的是真正要发往的端点，
+ *   它在暂缓中而另有可用且未暂缓的端点时改发那个端点，否则整体等待。
+ *
+ * @note 并发：
+ * - 一个选择器只由一个任务使用（鉴权任务、上报任务各持一份），内部不加锁。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_FAILOVER_H
+#define __UPLINK_FAILOVER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_types.h"
+
+/** 没有 RTT 样本时使用的默认 SRTT（毫秒） */
+#ifndef UPLINK_FAILOVER_DEFAULT_RTT_MS
+#define UPLINK_FAILOVER_DEFAULT_RTT_MS 200U
+#endif
+
+/** 顺序偏置（毫秒/位次）：备用端点需要比主端点快这么多才会在 FAST 模式下被优先选择 */
+#ifndef UPLINK_FAILOVER_ORDER_BIAS_MS
+#define UPLINK_FAILOVER_ORDER_BIAS_MS 100U
+#endif
+
+/** 每次连续失败的评分惩罚（毫秒） */
+#ifndef UPLINK_FAILOVER_FAIL_PENALTY_MS
+#define UPLINK_FAILOVER_FAIL_PENALTY_MS 1000U
+#endif
+
+/** STICKY 模式：连续失败多少次后切换端点 */
+#ifndef UPLINK_FAILOVER_STICKY_THRESHOLD
+#define UPLINK_FAILOVER_STICKY_THRESHOLD 3U
+#endif
+
+/** 冷却时长：首次（毫秒） */
+#ifndef UPLINK_FAILOVER_COOLDOWN_BASE_MS
+#define UPLINK_FAILOVER_COOLDOWN_BASE_MS 5000U
+#endif
+
+/** 冷却时长：上限（毫秒） */
+#ifndef UPLINK_FAILOVER_COOLDOWN_MAX_MS
+#define UPLINK_FAILOVER_COOLDOWN_MAX_MS 60000U
+#endif
+
+/** RTO 连续失败退避的最大移位（4 = 最多 ×16，实际还受调用者给的上限约束） */
+#ifndef UPLINK_FAILOVER_RTO_BACKOFF_MAX
+#define UPLINK_FAILOVER_RTO_BACKOFF_MAX 4U
+#endif
+
+/** 退避用尽后（明显不可达），每隔多少次失败做一次长等待探测 */
+#ifndef UPLINK_FAILOVER_RTO_PROBE_EVERY
+#define UPLINK_FAILOVER_RTO_PROBE_EVERY 8U
+#endif
+
+/** 单次暂缓上限（毫秒）：防止异常的 Retry-After 让设备长时间不上报 */
+#ifndef UPLINK_FAILOVER_HOLD_MAX_MS
+#define UPLINK_FAILOVER_HOLD_MAX_MS 60000U
+#endif
+
+/** STICKY 模式：停留在非首选端点多久后尝试回切（毫秒） */
+#ifndef UPLINK_FAILOVER_FAILBACK_MS
+#define UPLINK_FAILOVER_FAILBACK_MS 60000U
+#endif
+
+    /**
+     * @brief 选择策略
+     *
+     */
+    typedef enum
+    {
+        UPLINK_FAILOVER_FAST = 0,  /* 每次选最优，失败立即冷却（同步鉴权） */
+        UPLINK_FAILOVER_STICKY = 1 /* 粘住当前端点，连续失败才切换（异步上报） */
+    } uplink_failover_mode_t;
+
+    /**
+     * @brief 单个端点的健康度
+     *
+     */
+    typedef struct
+    {
+        uint32_t srtt_x8;       /* 平滑 RTT × 8（毫秒，定点，0=尚无样本） */
+        uint32_t rttvar_x4;     /* RTT 平均偏差 × 4（毫秒，定点） */
+        uint16_t fail_streak;   /* 连续失败次数 */
+        uint32_t down_until_ms; /* 冷却截止时刻（在此之前不参与选择） */
+        uint32_t hold_until_ms; /* 暂缓截止时刻（上级要求，0=无） */
+        uint32_t successes;     /* 累计成功次数 */
+        uint32_t failures;      /* 累计失败次数 */
+    } uplink_endpoint_health_t;
+
+    /**
+     * @brief 端点选择器
+     *
+     */
+    typedef struct
+    {
+        uplink_failover_mode_t mode;
+        uint8_t count;                   /* 已登记端点数 */
+        uint8_t current;                 /* STICKY：当前端点下标 */
+        uint32_t current_since_ms;       /* STICKY：切到当前端点的时刻 */
+        uint32_t switches;               /* 端点切换次数 */
+
+        uplink_endpoint_t endpoints[UPLINK_MAX_ENDPOINTS];
+        uplink_endpoint_health_t health[UPLINK_MAX_ENDPOINTS];
+    } uplink_failover_t;
+
+    void uplink_failover_init(uplink_failover_t *fo, uplink_failover_mode_t mode);
+
+    uplink_err_t uplink_failover_add(uplink_failover_t *fo, const uplink_endpoint_t *endpoint);
+
+    uint8_t uplink_failover_pick(uplink_failover_t *fo, uint32_t now_ms, uint32_t exclude_mask);
+
+    void uplink_failover_report(uplink_failover_t *fo, uint8_t index, uint8_t ok, uint32_t rtt_ms, uint32_t now_ms);
+
+    const uplink_endpoint_t *uplink_failover_endpoint(const uplink_failover_t *fo, uint8_t index);
+
+    uint8_t uplink_failover_is_available(const uplink_failover_t *fo, uint8_t index, uint32_t now_ms);
+
+    uint8_t uplink_failover_has_alternative(const uplink_failover_t *fo, uint8_t index, uint32_t now_ms);
+
+    void uplink_failover_hold(uplink_failover_t *fo, uint8_t index, uint32_t hold_ms, uint32_t now_ms);
+
+    uint32_t uplink_failover_hold_remaining(const uplink_failover_t *fo, uint8_t index, uint32_t now_ms);
+
+    uint32_t uplink_failover_pick_sendable(uplink_failover_t *fo, uint32_t now_ms, uint8_t *out_index);
+
+    uint32_t uplink_failover_timeout_ms(const uplink_failover_t *fo,
+                                        uint8_t index,
+                                        uint32_t initial_ms,
+                                        uint32_t min_ms,
+                                        uint32_t max_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_FAILOVER_H */
@@ -0,0 +1,86 @@
+/**
+ * @file    uplink_lzss.h
+ * @author  Yukikaze
+ * @brief   LZSS 流式压缩编码器（工具层，用于合并上报的请求 body）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 合并上报的一批审计事件字段名、设备 ID、事件名大量重复，用小窗口 LZ77 就能压掉一大半。
+ * - 码流与 heatshrink（window_sz2=8，lookahead_sz2=4）相同，HTTP 头为 Content-Encoding: x-heatshrink，
+ *   服务端解码见 server/app/content_encoding.py：
+ *   - 按位从高到低读；标志位 1 = 字面量，后跟 8 位原字节；
+ *   - 标志位 0 = 回溯引用，后跟 WINDOW_BITS 位 (距离-1) 与 LOOKAHEAD_BITS 位 (长度-1)；
+ *   - 最后一个字节不足 8 位时低位补 0（解码端位数不够一个完整记号即结束）。
+ * - 流式：可分多次 uplink_lzss_write 喂入，编码器自己保留最近一个窗口的历史，调用者不必拼出完整明文。
+ * - 状态约 2KB（两个窗口的工作区 512B + 匹配索引 1.5KB），输出写进调用者提供的缓冲区，不使用动态内存。
+ * - 纯软件实现，不依赖 lwIP/FreeRTOS，可在主机上直接编译。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_LZSS_H
+#define __UPLINK_LZSS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_types.h"
+
+/** 回溯窗口位数（窗口 = 2^8 = 256B；改动后服务端解码参数必须同步修改） */
+#define UPLINK_LZSS_WINDOW_BITS 8U
+
+/** 最长匹配位数（最长匹配 = 2^4 = 16B；改动后服务端解码参数必须同步修改） */
+#define UPLINK_LZSS_LOOKAHEAD_BITS 4U
+
+#define UPLINK_LZSS_WINDOW (1U << UPLINK_LZSS_WINDOW_BITS)
+#define UPLINK_LZSS_LOOKAHEAD (1U << UPLINK_LZSS_LOOKAHEAD_BITS)
+
+/** 最短匹配：引用 13 位，2 个字面量 18 位，长度 2 起即有收益 */
+#define UPLINK_LZSS_MIN_MATCH 2U
+
+/** 索引链散列桶数（按开头两个字节分桶） */
+#define UPLINK_LZSS_HASH_SIZE 256U
+
+/** 索引链空指针 */
+#define UPLINK_LZSS_NIL 0xFFFFU
+
+/** HTTP Content-Encoding 取值 */
+#define UPLINK_LZSS_CONTENT_ENCODING "x-heatshrink"
+
+    /**
+     * @brief 编码器状态
+     *
+     */
+    typedef struct
+    {
+        uint8_t buf[2U * UPLINK_LZSS_WINDOW]; /* [0,pos) 为历史，[pos,end) 为待编码输入 */
+        uint16_t pos;                         /* 下一个待编码字节 */
+        uint16_t end;                         /* 已喂入数据的末尾 */
+
+        uint16_t head[UPLINK_LZSS_HASH_SIZE];  /* 各散列桶最近一次出现的位置 */
+        uint16_t prev[2U * UPLINK_LZSS_WINDOW]; /* 同一散列桶内上一次出现的位置 */
+
+        uint8_t *out;     /* 输出缓冲（调用者提供） */
+        size_t out_cap;   /* 输出缓冲容量 */
+        size_t out_len;   /* 已写出的完整字节数 */
+        uint32_t acc;     /* 位累加器（低 acc_bits 位有效） */
+        uint8_t acc_bits; /* 累加器中尚未写出的位数（<8） */
+        uint8_t overflow; /* 1=输出缓冲已不够，后续写入全部失败 */
+    } uplink_lzss_t;
+
+    void uplink_lzss_init(uplink_lzss_t *z, uint8_t *out, size_t out_cap);
+
+    uint8_t uplink_lzss_fits(const uplink_lzss_t *z, size_t len);
+
+    uplink_err_t uplink_lzss_write(uplink_lzss_t *z, const void *data, size_t len);
+
+    uplink_err_t uplink_lzss_finish(uplink_lzss_t *z, size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_LZSS_H */
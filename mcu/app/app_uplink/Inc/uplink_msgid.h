@@ -0,0 +1,86 @@
+/**
+ * @file    uplink_msgid.h
+ * @author  Yukikaze
+ * @brief   跨重启不重复的消息 ID 生成器（工具层）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 服务端按 (deviceId, messageId) 幂等：重复的鉴权请求回放首次结论，重复的审计事件直接忽略。
+ *   若每次启动都从 1 开始编号，重启后的新消息会撞上重启前的旧消息，被当成重发。
+ * - messageId = (纪元 << 16) | 序号，序号 1..65535；纪元由平台回调 uplink_id_epoch_fn 申请
+ *   （STM32 上持久化在 SPI flash，见 app_epoch.h），每次启动申请一个，序号用完换到下一个。
+ * - 下一个纪元提前申请：剩余序号不足 UPLINK_MSGID_PREFETCH_LEFT 时 uplink_msgid_epoch_due 返回 1，
+ *   调用者在自己的锁外调用回调（可能擦写 flash），再用 uplink_msgid_epoch_put 存入；
+ *   uplink_msgid_next 只切换到已申请好的纪元，自身从不调用回调。没有锁顾虑的调用者用 uplink_msgid_refill 一步完成。
+ * - 失败即停发（fail closed）：有纪元回调但还没有可用纪元（启动时申请失败，或序号用完时没有预申请的纪元）时
+ *   uplink_msgid_next 返回 0，调用者不得发出请求；uplink_msgid_epoch_due 持续返回 1，由调用者重试申请，
+ *   申请到即恢复。绝不退回顺序编号：那会占用以后启动才申请的纪元的 ID 段，重新带来跨重启重复。
+ * - 同一生成器产生的 ID 严格递增（纪元回绕前），uplink 后备队列的二分查找依赖这一点。
+ * - 不提供纪元回调时（主机测试等）保持原来的行为：从 1 开始逐个递增。
+ * - 仍是 32 位：UDP 鉴权帧、MQTT packetId 映射与 JSON 解析都不用改。
+ * - 本层不加锁，由调用者保证串行调用。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_MSGID_H
+#define __UPLINK_MSGID_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_platform.h"
+
+/** 序号位数（每个纪元 65535 个 ID） */
+#define UPLINK_MSGID_SEQ_BITS 16U
+
+/** 最大序号 */
+#define UPLINK_MSGID_SEQ_MAX ((1UL << UPLINK_MSGID_SEQ_BITS) - 1UL)
+
+/** 最大纪元（纪元回调的返回值范围为 1..此值） */
+#define UPLINK_MSGID_EPOCH_MAX ((1UL << (32U - UPLINK_MSGID_SEQ_BITS)) - 1UL)
+
+/** 纪元申请失败后的重试间隔（毫秒，由调用者按此节奏重试） */
+#ifndef UPLINK_MSGID_RETRY_MS
+#define UPLINK_MSGID_RETRY_MS 1000UL
+#endif
+
+/** 本纪元剩余序号少于此值时预申请下一个纪元 */
+#ifndef UPLINK_MSGID_PREFETCH_LEFT
+#define UPLINK_MSGID_PREFETCH_LEFT 4096UL
+#endif
+
+    /**
+     * @brief 消息 ID 生成器
+     *
+     */
+    typedef struct
+    {
+        uint32_t next;               /* 下一个 ID（0=没有可用纪元，停发） */
+        uint32_t last;               /* 本纪元最后一个 ID（0=无纪元，不限） */
+        uint32_t spare;              /* 预申请的下一个纪元（0=还没有） */
+        uplink_id_epoch_fn epoch_fn; /* 纪元申请回调（可为 NULL） */
+        void *user_ctx;              /* 透传给回调的上下文 */
+        uint32_t claim_failures;     /* 纪元申请失败次数（回调返回 0） */
+    } uplink_msgid_t;
+
+    void uplink_msgid_init(uplink_msgid_t *g, uplink_id_epoch_fn epoch_fn, void *user_ctx);
+
+    uint32_t uplink_msgid_next(uplink_msgid_t *g);
+
+    uint8_t uplink_msgid_ready(const uplink_msgid_t *g);
+
+    uint8_t uplink_msgid_epoch_due(const uplink_msgid_t *g);
+
+    void uplink_msgid_epoch_put(uplink_msgid_t *g, uint32_t epoch);
+
+    void uplink_msgid_refill(uplink_msgid_t *g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_MSGID_H */
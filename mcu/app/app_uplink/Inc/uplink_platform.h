@@ -13,6 +13,7 @@
  * - now_ms：优先使用 lwIP 的 sys_now()
  * - rand_u32：使用简易 xorshift32 伪随机
  * - log：默认不输出（除非提供 log 回调）
+ * - id_epoch：默认不提供，消息 ID 每次启动从 1 开始（见 uplink_msgid.h）
  * 
  * @copyright Copyright (c) 2025 Yukikaze
  * 
@@ -58,6 +59,17 @@ typedef uint32_t (*uplink_rand_u32_fn)(void *user_ctx);
  */
 typedef void (*uplink_log_fn)(void *user_ctx, uplink_log_level_t level, const char *message);
 
+/**
+ * @brief 申请一个新的消息 ID 纪元（可选）
+ *
+ * @param user_ctx 用户上下文指针（由 uplink_platform_t.user_ctx 提供）
+ * @return uint32_t 纪元（1..UPLINK_MSGID_EPOCH_MAX，跨重启不重复）；0=无法持久化
+ *
+ * @note 每次调用都要返回一个从未返回过的值（通常持久化在 flash 中），
+ *       调用时机是初始化与每用完一个纪元的序号时，频率很低，允许阻塞几百毫秒。
+ */
+typedef uint32_t (*uplink_id_epoch_fn)(void *user_ctx);
+
 /**
  * @brief 平台适配集合
  * 
@@ -68,6 +80,7 @@ typedef struct
     uplink_now_ms_fn now_ms;     /* 获取毫秒时间戳 */
     uplink_rand_u32_fn rand_u32; /* 获取随机数 */
     uplink_log_fn log;           /* 日志输出（可选） */
+    uplink_id_epoch_fn id_epoch; /* 申请消息 ID 纪元（可选，NULL=每次启动从 1 开始） */
 } uplink_platform_t;
 
 #ifdef __cplusplus
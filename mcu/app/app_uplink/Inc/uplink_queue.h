@@ -47,10 +47,16 @@ uint16_t uplink_queue_size(const uplink_queue_t *q);
 
 uplink_err_t uplink_queue_push(uplink_queue_t *q, const uplink_msg_t *msg);
 
+uplink_err_t uplink_queue_push_slot(uplink_queue_t *q, uplink_msg_t **out_slot);
+
 uplink_err_t uplink_queue_peek(uplink_queue_t *q, uplink_msg_t **out_msg);
 
 uplink_err_t uplink_queue_pop(uplink_queue_t *q);
 
+uplink_err_t uplink_queue_at(uplink_queue_t *q, uint16_t index, uplink_msg_t **out_msg);
+
+uplink_err_t uplink_queue_remove_id(uplink_queue_t *q, uint32_t message_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,69 @@
+/**
+ * @file    uplink_sched.h
+ * @author  Yukikaze
+ * @brief   Uplink 优先级入队准入与加权公平出队（调度层）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 队列层仍是一个共享的环形队列；本层在其上按消息的优先级类别（uplink_msg_t.prio）做：
+ *   - 准入：每个类别有容量上限与丢弃策略（uplink_class_policy_t）；队列整体已满时，
+ *     高类别消息可以挤掉最低类别里最新的一条未在途消息，低类别永远不能挤掉高类别。
+ *   - 出队：平滑加权轮询（Smooth Weighted Round Robin，同 nginx upstream）。只在“有可发送消息”的类别间轮转，
+ *     每轮给各类别累加权重、选当前值最大者、再减去参与类别的权重和；
+ *     同一类别内截止时刻最早者优先（EDF），无截止的消息排在有截止的之后，同截止按入队顺序。
+ *   - 过期：截止时刻已过、仍未送达的消息在挑选前清除（uplink_sched_expire），不再与新消息争抢发送机会。
+ * - 效果：CARD_READ 审计洪峰最多占用 BULK 类别容量、最多分到 1/7 的发送机会，
+ *   告警类消息的等待时间只取决于本类别积压，而不取决于审计积压。
+ * - 本层不加锁、不发送网络，由 uplink.c 在持有队列互斥量时调用。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_SCHED_H
+#define __UPLINK_SCHED_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_queue.h"
+
+    /**
+     * @brief 调度器状态
+     *
+     */
+    typedef struct
+    {
+        uplink_class_policy_t classes[UPLINK_PRIO_COUNT]; /* 各类别策略（init 时从配置拷贝） */
+        int16_t current[UPLINK_PRIO_COUNT];               /* 平滑加权轮询的当前值 */
+    } uplink_sched_t;
+
+    /**
+     * @brief 准入时被挤掉的消息（只保留统计与日志需要的字段，不拷贝整条消息）
+     *
+     */
+    typedef struct
+    {
+        uint32_t message_id; /* 0=没有挤掉任何消息 */
+        uint8_t prio;
+    } uplink_evicted_t;
+
+    void uplink_sched_init(uplink_sched_t *s, const uplink_class_policy_t classes[UPLINK_PRIO_COUNT]);
+
+    uint16_t uplink_sched_class_count(uplink_queue_t *q, uint8_t prio);
+
+    uplink_err_t uplink_sched_select_victim(uplink_sched_t *s, uplink_queue_t *q, uint8_t prio, uplink_msg_t **out_victim);
+
+    uplink_err_t uplink_sched_admit(uplink_sched_t *s, uplink_queue_t *q, uint8_t prio, uplink_evicted_t *out_evicted);
+
+    uint16_t uplink_sched_expire(uplink_queue_t *q, uint32_t now_ms, uint16_t out_counts[UPLINK_PRIO_COUNT]);
+
+    uplink_msg_t *uplink_sched_pick(uplink_sched_t *s, uplink_queue_t *q, uint32_t now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_SCHED_H */
@@ -0,0 +1,92 @@
+/**
+ * @file    uplink_sha256.h
+ * @author  Yukikaze
+ * @brief   SHA-256 / HMAC-SHA256 软件实现（工具层）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 工具层（Crypto）：为 UDP 鉴权报文认证、请求签名提供摘要能力。
+ * - 纯软件实现，不依赖 lwIP/FreeRTOS/硬件 HASH 外设，可在主机上直接编译。
+ * - 上下文全部由调用者分配（静态区或栈），不使用动态内存。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_SHA256_H
+#define __UPLINK_SHA256_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** SHA-256 分组长度（字节） */
+#define UPLINK_SHA256_BLOCK_LEN 64U
+
+/** SHA-256 摘要长度（字节） */
+#define UPLINK_SHA256_DIGEST_LEN 32U
+
+    /**
+     * @brief SHA-256 流式计算上下文
+     *
+     */
+    typedef struct
+    {
+        uint32_t state[8];                        /* 中间哈希值 */
+        uint64_t total_len;                       /* 已输入总字节数 */
+        uint8_t buffer[UPLINK_SHA256_BLOCK_LEN];  /* 未满一个分组的缓存 */
+        uint8_t buffer_used;                      /* buffer 已用字节数 */
+    } uplink_sha256_ctx_t;
+
+    /**
+     * @brief HMAC-SHA256 预计算密钥
+     *
+     * @note 说明：
+     * - inner/outer 分别是已吸收 (key ^ ipad)、(key ^ opad) 一个分组后的中间状态。
+     * - 同一密钥只需计算一次；之后每条消息比从原始密钥开始少 2 次分组压缩。
+     */
+    typedef struct
+    {
+        uplink_sha256_ctx_t inner;
+        uplink_sha256_ctx_t outer;
+    } uplink_hmac_sha256_key_t;
+
+    /**
+     * @brief HMAC-SHA256 流式计算上下文
+     *
+     * @note 说明：
+     * - 结构与预计算密钥相同：inner 继续吸收消息，final 时在 outer 的副本上补完外层哈希。
+     */
+    typedef uplink_hmac_sha256_key_t uplink_hmac_sha256_ctx_t;
+
+    void uplink_sha256_init(uplink_sha256_ctx_t *ctx);
+
+    void uplink_sha256_update(uplink_sha256_ctx_t *ctx, const void *data, size_t len);
+
+    void uplink_sha256_final(uplink_sha256_ctx_t *ctx, uint8_t out_digest[UPLINK_SHA256_DIGEST_LEN]);
+
+    void uplink_hmac_sha256_key_init(uplink_hmac_sha256_key_t *out_key, const void *key, size_t key_len);
+
+    void uplink_hmac_sha256_start(uplink_hmac_sha256_ctx_t *ctx, const uplink_hmac_sha256_key_t *key);
+
+    void uplink_hmac_sha256_init(uplink_hmac_sha256_ctx_t *ctx, const void *key, size_t key_len);
+
+    void uplink_hmac_sha256_update(uplink_hmac_sha256_ctx_t *ctx, const void *data, size_t len);
+
+    void uplink_hmac_sha256_final(uplink_hmac_sha256_ctx_t *ctx, uint8_t out_mac[UPLINK_SHA256_DIGEST_LEN]);
+
+    void uplink_hmac_sha256(const void *key,
+                            size_t key_len,
+                            const void *data,
+                            size_t data_len,
+                            uint8_t out_mac[UPLINK_SHA256_DIGEST_LEN]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_SHA256_H */
@@ -0,0 +1,90 @@
+/**
+ * @file    uplink_sign.h
+ * @author  Yukikaze
+ * @brief   HTTP 请求签名（工具层），与服务端 security.verify_signature 对齐
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 签名头：X-Device-Id / X-Timestamp / X-Nonce / X-Signature。
+ * - 签名原文：timestamp + "\n" + nonce + "\n" + body，算法 HMAC-SHA256，输出 64 位小写十六进制。
+ * - 原文不拼接：HMAC 依次吸收 timestamp、nonce、body，不需要额外的暂存缓冲。
+ * - 密钥在初始化时预计算 ipad/opad 中间状态，每次签名只做消息分组 + 1 次外层压缩。
+ *
+ * @note 时间戳：
+ * - 设备没有 RTC/SNTP，X-Timestamp = 服务端时间偏移 + 本地毫秒计数 / 1000。
+ * - 偏移从 HTTP 响应头 `Date:` 估计（秒级精度，服务端允许 ±SIGNATURE_MAX_SKEW_SEC），每次响应都会刷新。
+ * - 尚未对时（clock_synced=0）时不签名：服务端 SIGNATURE_REQUIRED=0 时照常放行；
+ *   强制签名时服务端拒绝（/api/uplink 为 HTTP 200 + code=5001 msg=signature_*，推送流为 401），
+ *   传输层从这次响应的 Date 对时后立即签名重发一次（见 uplink_signer_rejected）。
+ *
+ * @note nonce：
+ * - nonce = 时间戳(8 hex) + lane(2 hex) + 计数器(6 hex)，无需随机数发生器。
+ * - 时间戳部分保证重启后不会与重启前的 nonce 重复；lane 区分同一设备上的多个签名实例（如 uplink 与 app_auth）。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_SIGN_H
+#define __UPLINK_SIGN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_sha256.h"
+#include "uplink_types.h"
+
+/** nonce 长度（十六进制字符数，不含 '\0'） */
+#define UPLINK_SIGN_NONCE_LEN 16U
+
+/** nonce lane 分配：同一设备上每个签名器一个编号，保证 nonce 互不重复 */
+#define UPLINK_SIGN_LANE_UPLINK 0U
+#define UPLINK_SIGN_LANE_PUSH 1U
+#define UPLINK_SIGN_LANE_AUTH 2U
+
+/** 签名头最大长度（4 行 "Name: value\r\n"，含结尾 '\0'） */
+#define UPLINK_SIGN_HEADERS_MAX_LEN ((15U + UPLINK_MAX_DEVICE_ID_LEN) + (15U + 10U) + (11U + UPLINK_SIGN_NONCE_LEN) + (15U + 64U))
+
+    /**
+     * @brief 请求签名器
+     *
+     * @note 说明：
+     * - 由持有者（uplink_t / app_auth）静态分配，传输层只持有指针。
+     * - 同一签名器只允许在一个任务中使用（计数器与对时状态不加锁）。
+     */
+    typedef struct
+    {
+        uint8_t enabled;                          /* 1=启用签名 */
+        uint8_t lane;                             /* nonce 中的实例编号 */
+        uint8_t clock_synced;                     /* 1=已从服务端 Date 对时 */
+        char device_id[UPLINK_MAX_DEVICE_ID_LEN]; /* X-Device-Id */
+        uplink_hmac_sha256_key_t key;             /* 预计算密钥 */
+        uint32_t epoch_at_boot_s;                 /* 服务端 Unix 时间 - 本地运行秒数 */
+        uint32_t counter;                         /* nonce 计数器 */
+    } uplink_signer_t;
+
+    void uplink_signer_init(uplink_signer_t *signer, const char *device_id, const char *secret, uint8_t lane);
+
+    uint8_t uplink_signer_need_clock(const uplink_signer_t *signer);
+
+    uint8_t uplink_signer_rejected(const uplink_ack_t *ack, const char *body, size_t body_len);
+
+    void uplink_signer_observe_response(uplink_signer_t *signer, const char *header, size_t header_len, uint32_t now_ms);
+
+    uplink_err_t uplink_signer_append_headers(uplink_signer_t *signer,
+                                              uint32_t now_ms,
+                                              const char *body,
+                                              size_t body_len,
+                                              char *out_buf,
+                                              size_t out_buf_len,
+                                              size_t *out_len);
+
+    uint8_t uplink_sign_parse_http_date(const char *value, uint32_t *out_epoch_s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_SIGN_H */
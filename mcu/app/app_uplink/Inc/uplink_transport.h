@@ -7,6 +7,10 @@
  * @note 说明：
  * - 传输层（Transport）：负责“把一段 JSON 可靠地发到服务器，并拿到 HTTP 状态码 + body”。
  * - 业务层不直接依赖 lwIP/mbedTLS；未来切换 HTTPS(443) 时，只需要新增/替换 transport 实现。
+ * - 可选的异步流水接口（submit_json/poll_acks）供长连接协议（如 MQTT QoS1）使用：
+ *   允许多条消息同时在途，按 messageId 逐条确认；不支持的实现将其置 NULL 即可。
+ * - 可选的并发接口（post_json_parallel）供短连接协议在积压时使用：多路互相独立的请求各用一条连接同时在途，
+ *   每路有自己的状态码与 body；不支持的实现置 NULL，uplink 核心退回一次一个 post_json。
  *
  * @copyright Copyright (c) 2025 Yukikaze
  *
@@ -23,12 +27,31 @@ extern "C"
 #include "uplink_platform.h"
 #include "uplink_types.h"
 
+    /**
+     * @brief 并发请求中的一路（post_json_parallel 的输入/输出）
+     *
+     */
+    typedef struct
+    {
+        const char *json;    /* 输入：请求 body */
+        size_t json_len;     /* 输入：请求 body 长度（字节） */
+        char *body;          /* 输入：响应 body 缓冲（由调用者提供） */
+        size_t body_cap;     /* 输入：响应 body 缓冲总长度 */
+        size_t body_len;     /* 输出：响应 body 长度（不含结尾 '\0'） */
+        uplink_ack_t ack;    /* 输出：HTTP 状态码 / Retry-After */
+        uplink_err_t result; /* 输出：含义同 post_json 返回值 */
+        uint32_t start_ms;   /* 输出：发出时刻（建连前） */
+        uint32_t done_ms;    /* 输出：结束时刻 */
+    } uplink_post_t;
+
     /**
      * @brief 传输层接口（函数表）
      *
      * @note 说明：
      * - ctx：由具体实现自行定义的上下文（例如 netconn/mbedTLS 句柄、统计信息等）。
      * - post_json：完成一次 HTTP/HTTPS POST 请求（建议每次请求新建连接，简单可靠）。
+     * - submit_json/poll_acks：可选，非 NULL 时 uplink 核心切换为异步流水模式，
+     *   最多 max_inflight 条消息同时在途。
      */
     typedef struct
     {
@@ -64,6 +87,79 @@ extern "C"
                                   char *response_body_buf,
                                   size_t response_body_buf_len,
                                   size_t *out_response_body_len);
+
+        /** 异步流水模式下允许同时在途的消息数（1..UPLINK_MAX_INFLIGHT；仅 submit_json 非 NULL 时有效） */
+        uint16_t max_inflight;
+
+        /**
+         * @brief 异步提交一条 JSON（只负责发出，不等待确认）
+         *
+         * @param ctx             实现私有上下文
+         * @param endpoint        服务器端点
+         * @param platform        平台回调（可为 NULL）
+         * @param message_id      消息 ID（确认时按此 ID 回报；同一 ID 重复提交视为重发）
+         * @param json            待发送的 JSON 字符串
+         * @param json_len        JSON 长度（字节）
+         * @param send_timeout_ms 发送/建连超时（毫秒）
+         *
+         * @return uplink_err_t
+         * - UPLINK_OK：已交给网络栈
+         * - UPLINK_ERR_*：连接/发送失败（该消息未发出，由上层按重试策略处理）
+         */
+        uplink_err_t (*submit_json)(void *ctx,
+                                    const uplink_endpoint_t *endpoint,
+                                    const uplink_platform_t *platform,
+                                    uint32_t message_id,
+                                    const char *json,
+                                    size_t json_len,
+                                    uint32_t send_timeout_ms);
+
+        /**
+         * @brief 收取已确认的消息 ID，并顺带维持连接（心跳等）
+         *
+         * @param ctx           实现私有上下文
+         * @param endpoint      服务器端点
+         * @param platform      平台回调（可为 NULL）
+         * @param wait_ms       最长等待时间（毫秒，>=1）
+         * @param out_acked_ids 输出：已确认的消息 ID 数组
+         * @param max_ids       out_acked_ids 容量
+         * @param out_count     输出：实际写入的 ID 数
+         *
+         * @return uplink_err_t
+         * - UPLINK_OK：正常（可能 0 条确认）
+         * - UPLINK_ERR_TRANSPORT：连接已断开，所有在途消息需由上层重新提交
+         */
+        uplink_err_t (*poll_acks)(void *ctx,
+                                  const uplink_endpoint_t *endpoint,
+                                  const uplink_platform_t *platform,
+                                  uint32_t wait_ms,
+                                  uint32_t *out_acked_ids,
+                                  uint16_t max_ids,
+                                  uint16_t *out_count);
+
+        /** post_json_parallel 一次最多的路数（1..UPLINK_MAX_PARALLEL；post_json_parallel 为 NULL 时无效） */
+        uint8_t max_parallel;
+
+        /**
+         * @brief 并发发送多路互相独立的 JSON 请求（每路一条连接），全部结束后返回
+         *
+         * @param ctx             实现私有上下文
+         * @param endpoint        服务器端点（各路相同）
+         * @param platform        平台回调（可为 NULL）
+         * @param posts           各路请求（输入/输出见 uplink_post_t）
+         * @param count           路数（1..max_parallel）
+         * @param send_timeout_ms 发送超时（毫秒）
+         * @param recv_timeout_ms 每一路从发出到收完应答的时限（毫秒）
+         *
+         * @note 各路结果互不影响：一路失败不会中断其他路，调用者按 posts[i].result/ack 逐路处理。
+         */
+        void (*post_json_parallel)(void *ctx,
+                                   const uplink_endpoint_t *endpoint,
+                                   const uplink_platform_t *platform,
+                                   uplink_post_t *posts,
+                                   uint8_t count,
+                                   uint32_t send_timeout_ms,
+                                   uint32_t recv_timeout_ms);
     } uplink_transport_t;
 
 #ifdef __cplusplus
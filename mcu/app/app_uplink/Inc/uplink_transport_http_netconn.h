@@ -11,6 +11,10 @@
  * @note 重要说明：
  * - 该实现提供“明文 HTTP POST”能力，用于在局域网用 8080 测试链路。
  * - 未来升级 HTTPS(443) 时，应新增另一个实现（例如 mbedTLS），业务层无需改动。
+ * - 对冲请求（post_json_hedged）：首选端点超过阈值仍未应答时，把同一请求发往备用端点，先到的有效应答胜出；
+ *   两个连接都是阻塞建连，备用端点需由调用者确认可用（不在冷却中），否则建连阻塞会拖住首选端点的应答。
+ * - 并发请求（post_json_parallel，需 uplink_transport_http_netconn_enable_parallel 提供工作区）：
+ *   多路互相独立的请求依次建连发出后一起等待应答，积压时用来成倍缩短排空时间；每路占一个 netconn/TCP PCB。
  *
  * @copyright Copyright (c) 2025 Yukikaze
  *
@@ -24,23 +28,108 @@ extern "C"
 {
 #endif
 
+#include "uplink_sign.h"
 #include "uplink_transport.h"
 
+    struct uplink_http_req_s;
+
     /**
-     * @brief netconn HTTP 传输层私有上下文（目前预留）
+     * @brief netconn HTTP 传输层私有上下文
      *
      * @note 说明：
-     * - 当前实现没有必须的状态，所以结构体留作扩展位（例如统计信息、连接复用参数等）。
-     * - 之所以保留 ctx，是为了未来扩展而不破坏 uplink_transport_t 接口。
+     * - signer 为 NULL 时不签名；签名器由上层（uplink、app_auth、app_push 各一个 lane）持有，这里只保存指针。
+     * - content_encoding 非 NULL 时每个请求都带 Content-Encoding 头，body 由上层事先编码（签名覆盖编码后的字节）。
+     * - parallel_work 为并发请求的工作区（每路一个请求状态），由 enable_parallel 挂接，未挂接时不支持并发。
      */
     typedef struct
     {
-        uint32_t reserved; /* 预留字段（当前未使用） */
+        uplink_signer_t *signer;                 /* 请求签名器（可为 NULL） */
+        const char *content_encoding;            /* 请求 body 的 Content-Encoding（NULL=明文 JSON） */
+        struct uplink_http_req_s *parallel_work; /* 并发请求工作区（可为 NULL） */
+        uint8_t parallel_count;                  /* 工作区路数 */
     } uplink_transport_http_netconn_ctx_t;
 
+/** 对冲/并发模式下同时等待多个连接时的轮询粒度（毫秒），决定“先到先用”的判定延迟 */
+#ifndef UPLINK_HTTP_HEDGE_POLL_MS
+#define UPLINK_HTTP_HEDGE_POLL_MS 5U
+#endif
+
+/** 单个 HTTP 请求的状态 */
+#define UPLINK_HTTP_REQ_IDLE 0U   /* 未发出 */
+#define UPLINK_HTTP_REQ_ACTIVE 1U /* 已发出，等待响应 */
+#define UPLINK_HTTP_REQ_DONE 2U   /* 已结束（result 有效）或被放弃 */
+
+    struct netconn;
+
+    /**
+     * @brief 单个 HTTP 请求的收发状态（一问一答短连接）
+     *
+     * @note 说明：
+     * - 普通请求放在栈上；对冲请求的两份状态放在 uplink_http_hedge_t 工作区里，并发请求的放在调用者挂接的数组里。
+     * - 调用者只读 state/result/cancelled/start_ms/done_ms/ack，用于反馈端点健康度。
+     */
+    typedef struct uplink_http_req_s
+    {
+        struct netconn *conn; /* 当前连接（NULL=已关闭） */
+        uplink_ack_t *ack;    /* 输出：HTTP 状态码 */
+        char *body;           /* 输出：响应 body 缓冲 */
+        size_t body_cap;      /* body 缓冲总长度 */
+        size_t body_used;     /* 已写入 body 长度 */
+        uint8_t body_truncated;
+
+        char header_buf[512]; /* 响应头（只需要到 \r\n\r\n 为止） */
+        size_t header_used;
+        uint8_t header_done;
+        uint32_t marker; /* 检测 \r\n\r\n 的滑动窗口 */
+
+        uint8_t state;       /* UPLINK_HTTP_REQ_* */
+        uint8_t cancelled;   /* 1=对冲中落后被放弃（不代表端点故障） */
+        uplink_err_t result; /* state==DONE 时的结果 */
+        uint32_t start_ms;   /* 发出时刻 */
+        uint32_t done_ms;    /* 结束时刻 */
+    } uplink_http_req_t;
+
+    /**
+     * @brief 对冲请求工作区（由调用者静态分配，避免占用任务栈）
+     *
+     * @note req[0] 为首选端点请求，req[1] 为对冲（备用端点）请求。
+     */
+    typedef struct
+    {
+        uplink_http_req_t req[2];
+        uplink_ack_t hedge_ack;                    /* 对冲请求的状态码 */
+        char hedge_body[UPLINK_MAX_HTTP_BODY_LEN]; /* 对冲请求的响应 body */
+    } uplink_http_hedge_t;
+
     void uplink_transport_http_netconn_bind(uplink_transport_t *out_transport,
                                             uplink_transport_http_netconn_ctx_t *ctx);
 
+    void uplink_transport_http_netconn_set_signer(uplink_transport_http_netconn_ctx_t *ctx, uplink_signer_t *signer);
+
+    void uplink_transport_http_netconn_set_content_encoding(uplink_transport_http_netconn_ctx_t *ctx,
+                                                            const char *content_encoding);
+
+    void uplink_transport_http_netconn_enable_parallel(uplink_transport_t *transport,
+                                                       uplink_transport_http_netconn_ctx_t *ctx,
+                                                       uplink_http_req_t *work,
+                                                       uint8_t count);
+
+    uplink_err_t uplink_transport_http_netconn_post_json_hedged(uplink_transport_http_netconn_ctx_t *ctx,
+                                                                uplink_http_hedge_t *work,
+                                                                const uplink_endpoint_t *primary,
+                                                                const uplink_endpoint_t *secondary,
+                                                                const uplink_platform_t *platform,
+                                                                const char *json,
+                                                                size_t json_len,
+                                                                uint32_t send_timeout_ms,
+                                                                uint32_t recv_timeout_ms,
+                                                                uint32_t hedge_after_ms,
+                                                                uplink_ack_t *ack,
+                                                                char *response_body_buf,
+                                                                size_t response_body_buf_len,
+                                                                size_t *out_response_body_len,
+                                                                uint8_t *out_winner);
+
 #ifdef __cplusplus
 }
 #endif
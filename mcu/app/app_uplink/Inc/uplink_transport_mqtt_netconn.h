@@ -0,0 +1,99 @@
+/**
+ * @file    uplink_transport_mqtt_netconn.h
+ * @author  Yukikaze
+ * @brief   基于 lwIP Netconn TCP 的 MQTT 3.1.1 传输层实现（传输层-实现）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 传输层实现（Transport Impl）：把 uplink 事件 JSON 以 QoS1 PUBLISH 发布到 broker，
+ *   以 PUBACK 作为“已送达”的确认。
+ * - 长连接 + 持久会话（CleanSession=0）：只在首次发送或断线后建连，省去每条消息的 TCP 握手/挥手。
+ * - 支持异步流水：最多 max_inflight 条 PUBLISH 同时在途，PUBACK 可乱序到达。
+ * - 心跳：空闲超过 keepalive/2 发送 PINGREQ，再过 keepalive/2 未收到 PINGRESP 视为断线。
+ *
+ * @note messageId 与 packetId 映射：
+ * - packetId = ((messageId - 1) % 65535) + 1，范围 1..65535，同一 messageId 永远得到同一 packetId，
+ *   重发时 broker/订阅端可按 packetId + DUP 识别重复；后端仍以 messageId 做幂等。
+ * - PUBACK 只携带 packetId，因此内部维护一张在途表反查 messageId。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_TRANSPORT_MQTT_NETCONN_H
+#define __UPLINK_TRANSPORT_MQTT_NETCONN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_transport.h"
+
+/** 接收缓冲长度：本实现只处理 CONNACK/PUBACK/PINGRESP 等短报文 */
+#ifndef UPLINK_MQTT_RX_BUF_LEN
+#define UPLINK_MQTT_RX_BUF_LEN 64U
+#endif
+
+/** PUBLISH 报文头缓冲长度：固定头(<=5) + 主题(2+len) + packetId(2) */
+#define UPLINK_MQTT_PUB_HDR_LEN (5U + 2U + UPLINK_MAX_PATH_LEN + 2U)
+
+    /** 前向声明：避免在头文件中引入 lwIP api.h */
+    struct netconn;
+
+    /**
+     * @brief 在途表项（packetId -> messageId）
+     *
+     */
+    typedef struct
+    {
+        uint8_t used;        /* 1=表项有效 */
+        uint8_t sent;        /* 1=至少发出过一次（再次发送需置 DUP） */
+        uint8_t acked;       /* 1=已收到 PUBACK，等待 poll_acks 交给上层 */
+        uint16_t packet_id;  /* MQTT packetId */
+        uint32_t message_id; /* uplink messageId */
+        uint32_t seq;        /* 写入序号（表满时淘汰最旧项） */
+    } uplink_mqtt_inflight_t;
+
+    /**
+     * @brief netconn MQTT 传输层私有上下文
+     *
+     * @note 说明：
+     * - 连接句柄与会话状态都保存在上下文中，跨多次 uplink_poll 复用。
+     * - 统计字段只增不减，用于对比 HTTP 短连接与 MQTT 长连接的吞吐。
+     */
+    typedef struct
+    {
+        struct netconn *conn;                       /* 当前连接（NULL=未连接） */
+        char client_id[UPLINK_MAX_DEVICE_ID_LEN];   /* 客户端 ID（取 device_id） */
+        uint16_t keepalive_s;                       /* 心跳周期（秒） */
+        uint8_t session_present;                    /* 最近一次 CONNACK 的 SessionPresent 标志 */
+        uint8_t ping_outstanding;                   /* 1=已发 PINGREQ 尚未收到 PINGRESP */
+        uint32_t last_tx_ms;                        /* 最近一次发送时间（毫秒） */
+        uint32_t ping_sent_ms;                      /* 最近一次 PINGREQ 时间（毫秒） */
+
+        uplink_mqtt_inflight_t inflight[UPLINK_MAX_INFLIGHT]; /* 在途表 */
+        uint32_t inflight_seq;                                /* 在途表写入序号 */
+
+        uint32_t tx_publish;  /* 已发送 PUBLISH 数（含重发） */
+        uint32_t tx_dup;      /* 其中带 DUP 的重发数 */
+        uint32_t rx_puback;   /* 已收到且匹配的 PUBACK 数 */
+        uint32_t connects;    /* 建连成功次数 */
+        uint32_t disconnects; /* 断线次数（含心跳超时、协议错误） */
+
+        uint8_t tx_hdr[UPLINK_MQTT_PUB_HDR_LEN]; /* 报文头组装缓冲 */
+        uint8_t rx_buf[UPLINK_MQTT_RX_BUF_LEN];  /* 接收拼包缓冲（TCP 流可能拆包/粘包） */
+        uint16_t rx_used;                        /* rx_buf 已用字节数 */
+    } uplink_transport_mqtt_netconn_ctx_t;
+
+    void uplink_transport_mqtt_netconn_bind(uplink_transport_t *out_transport,
+                                            uplink_transport_mqtt_netconn_ctx_t *ctx,
+                                            const char *client_id,
+                                            uint16_t keepalive_s,
+                                            uint8_t max_inflight);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_TRANSPORT_MQTT_NETCONN_H */
@@ -0,0 +1,123 @@
+/**
+ * @file    uplink_transport_udp_netconn.h
+ * @author  Yukikaze
+ * @brief   基于 lwIP Netconn UDP 的单往返鉴权传输实现（传输层-实现）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 传输层实现（Transport Impl）：对 uplink_transport_t 的另一种实现，面向同步鉴权（RFID_AUTH_REQ）。
+ * - 一次鉴权只需一个请求报文 + 一个应答报文，省去 TCP 三次握手、FIN 往返。
+ * - 参考 CoAP 的“可确认消息（CON）”语义：以 messageId 作为匹配键，超时按 RTO 指数退避重传。
+ * - 每个报文都带 HMAC-SHA256 认证标签（截断 16 字节），密钥为设备共享密钥。
+ *
+ * @note 报文格式（大端）：
+ *  +------+-------+------------+-----------+----------+-----------+-------------+-----------------+
+ *  | 0x55 | V | T | messageId  | timestamp | nonce    | json_len  | JSON        | HMAC[0..15]     |
+ *  | 1B   | 1B    | 4B         | 4B        | 4B       | 2B        | json_len B  | 16B             |
+ *  +------+-------+------------+-----------+----------+-----------+-------------+-----------------+
+ * - V：高 4 位版本号（当前 2）；T：低 4 位类型（0=CON 请求，2=ACK 应答，3=TIME 对时应答）。
+ * - HMAC 覆盖“头部 16 字节 + JSON”，服务端按 deviceId 查密钥后校验。
+ * - ACK 的 JSON 与 HTTP 响应 body 相同（code/msg/traceId），收到合法 ACK 时 http_status 记为 200，
+ *   上层（app_auth）无需区分传输方式。
+ *
+ * @note 新鲜度（与 HTTP 签名的时间戳 + nonce 对应）：
+ * - CON 的 timestamp 为设备估计的服务端 Unix 秒；服务端超出 ±SIGNATURE_MAX_SKEW_SEC 不判定，
+ *   回一个 TIME 报文（无 JSON，timestamp=服务端时间，nonce 回显），设备对时后换新 timestamp/nonce 立即重发。
+ * - 尚未对时的设备 timestamp 填 0，第一次鉴权总是先拿到 TIME：未对时期间只接受 TIME，不接受判定。
+ * - nonce 由设备生成，同一请求的重传不变；已对时后为 (timestamp 低 24 位 << 8) | 计数器，
+ *   每次收到 TIME 时计数器按毫秒计数打散，重启前后的 nonce 只可能在同一秒内碰上。
+ * - 服务端按 (deviceId, timestamp, nonce) 防重放：时间窗内重复的新请求不判定，同样回 TIME，设备换 nonce 重发。
+ * - ACK/TIME 回显请求的 nonce、带服务端时间：设备只接受 messageId 与 nonce 都匹配、时间在窗口内的应答，
+ *   截获的旧 ACK 即使 messageId 相同（纪元重复）也因 nonce 不同被丢弃。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#ifndef __UPLINK_TRANSPORT_UDP_NETCONN_H
+#define __UPLINK_TRANSPORT_UDP_NETCONN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "uplink_sha256.h"
+#include "uplink_transport.h"
+
+/** 报文魔数 */
+#define UPLINK_UDP_MAGIC 0x55U
+
+/** 协议版本 */
+#define UPLINK_UDP_VERSION 2U
+
+/** 报文类型：可确认请求 */
+#define UPLINK_UDP_TYPE_CON 0U
+
+/** 报文类型：应答 */
+#define UPLINK_UDP_TYPE_ACK 2U
+
+/** 报文类型：对时应答（请求时间戳超出窗口，未判定） */
+#define UPLINK_UDP_TYPE_TIME 3U
+
+/** 固定头部长度 */
+#define UPLINK_UDP_HEADER_LEN 16U
+
+/** 认证标签长度（HMAC-SHA256 截断） */
+#define UPLINK_UDP_TAG_LEN 16U
+
+/** 单个报文最大长度（头部 + 最大 JSON + 标签） */
+#define UPLINK_UDP_MAX_DATAGRAM_LEN (UPLINK_UDP_HEADER_LEN + UPLINK_MAX_EVENT_JSON_LEN + UPLINK_UDP_TAG_LEN)
+
+/** 默认初始 RTO（毫秒），局域网 RTT 通常 < 10ms */
+#ifndef UPLINK_UDP_DEFAULT_ACK_TIMEOUT_MS
+#define UPLINK_UDP_DEFAULT_ACK_TIMEOUT_MS 250U
+#endif
+
+/** 默认最大重传次数（不含首次发送） */
+#ifndef UPLINK_UDP_DEFAULT_MAX_RETRANSMIT
+#define UPLINK_UDP_DEFAULT_MAX_RETRANSMIT 3U
+#endif
+
+/** ACK 时间戳与本地估计允许的偏差（秒），与服务端 SIGNATURE_MAX_SKEW_SEC 一致 */
+#ifndef UPLINK_UDP_MAX_SKEW_S
+#define UPLINK_UDP_MAX_SKEW_S 120U
+#endif
+
+    /**
+     * @brief netconn UDP 传输层私有上下文
+     *
+     * @note 说明：
+     * - 报文收发缓冲放在上下文里，避免占用调用任务的栈。
+     * - 统计字段只增不减，用于对比“每次决策的报文数”。
+     */
+    typedef struct
+    {
+        uplink_hmac_sha256_key_t hmac_key; /* 设备共享密钥的 HMAC 预计算状态 */
+
+        uint32_t ack_timeout_ms; /* 初始 RTO（毫秒） */
+        uint8_t max_retransmit;  /* 最大重传次数 */
+
+        uint8_t clock_synced;     /* 1=已从 ACK/TIME 对时 */
+        uint32_t epoch_at_boot_s; /* 服务端 Unix 时间 - 本地运行秒数 */
+        uint32_t nonce_counter;   /* nonce 低 8 位计数器 */
+
+        uint32_t tx_datagrams; /* 已发送报文数（含重传） */
+        uint32_t rx_datagrams; /* 已接收报文数（含被丢弃的） */
+        uint32_t retransmits;  /* 重传次数 */
+        uint32_t rx_rejected;  /* 校验失败/不匹配（含 nonce/时间不符）而丢弃的报文数 */
+        uint32_t time_resyncs; /* 收到 TIME 后对时重发的次数 */
+
+        uint8_t tx_buf[UPLINK_UDP_MAX_DATAGRAM_LEN];
+        uint8_t rx_buf[UPLINK_UDP_MAX_DATAGRAM_LEN];
+    } uplink_transport_udp_netconn_ctx_t;
+
+    void uplink_transport_udp_netconn_bind(uplink_transport_t *out_transport,
+                                           uplink_transport_udp_netconn_ctx_t *ctx,
+                                           const char *secret);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UPLINK_TRANSPORT_UDP_NETCONN_H */
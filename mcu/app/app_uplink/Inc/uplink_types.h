@@ -47,6 +47,11 @@ extern "C"
 #define UPLINK_MAX_DEVICE_ID_LEN 32
 #endif
 
+/** 设备共享密钥最大长度（含结尾 '\0'），用于报文认证/请求签名 */
+#ifndef UPLINK_MAX_SECRET_LEN
+#define UPLINK_MAX_SECRET_LEN 64
+#endif
+
 /** 事件类型字符串最大长度（含结尾 '\0'），例如 "RFID_AUTH_REQ"、"RFID_AUDIT" */
 #ifndef UPLINK_MAX_TYPE_LEN
 #define UPLINK_MAX_TYPE_LEN 32
@@ -71,11 +76,63 @@ extern "C"
 #define UPLINK_MAX_HTTP_BODY_LEN 512
 #endif
 
-/** uplink 内部队列最大长度（环形队列容量上限） */
+/** 合并上报（cfg.batch.max_events>1）：1=编译进 2KB 的批量请求 body 缓冲；0=每次 POST 只带一条，缓冲只按一条事件分配 */
+#ifndef UPLINK_BATCH_ENABLE
+#define UPLINK_BATCH_ENABLE 0
+#endif
+
+/** 请求 body 压缩（cfg.batch.compress=1）：1=编译进 LZSS 编码器（状态约 2KB）；0=不编译，compress=1 时配置校验返回 UPLINK_ERR_UNSUPPORTED */
+#ifndef UPLINK_LZSS_ENABLE
+#define UPLINK_LZSS_ENABLE 0
+#endif
+
+/** 合并上报时一次 POST 最多携带的事件数（见 uplink_config_t.batch） */
+#ifndef UPLINK_MAX_BATCH_EVENTS
+#if UPLINK_BATCH_ENABLE
+#define UPLINK_MAX_BATCH_EVENTS 8
+#else
+#define UPLINK_MAX_BATCH_EVENTS 1
+#endif
+#endif
+
+/** 请求 body 缓冲长度（明文或压缩后；至少放得下一条最长事件按字面量最坏情况压缩的结果：每字节 9 位） */
+#ifndef UPLINK_MAX_BATCH_BODY_LEN
+#if UPLINK_BATCH_ENABLE
+#define UPLINK_MAX_BATCH_BODY_LEN 2048
+#elif UPLINK_LZSS_ENABLE
+#define UPLINK_MAX_BATCH_BODY_LEN (UPLINK_MAX_EVENT_JSON_LEN + (UPLINK_MAX_EVENT_JSON_LEN / 8) + 8)
+#else
+#define UPLINK_MAX_BATCH_BODY_LEN UPLINK_MAX_EVENT_JSON_LEN
+#endif
+#endif
+
+/** uplink 内部队列最大长度（环形队列容量上限，每槽 320 字节内部 SRAM）；突发由 SDRAM 后备队列吸收 */
 #ifndef UPLINK_QUEUE_MAX_LEN
 #define UPLINK_QUEUE_MAX_LEN 8
 #endif
 
+/** 异步流水模式下同时在途（已发送、未确认）的消息数上限，例如 MQTT QoS1 的未确认 PUBLISH */
+#ifndef UPLINK_MAX_INFLIGHT
+#define UPLINK_MAX_INFLIGHT 4
+#endif
+
+/**
+ * 同步发送积压时同时在途的 POST 数上限（见 uplink_config_t.parallel；默认 1=不并发）
+ * 每多一路：内部 SRAM 约 2.2KB（请求/响应缓冲与 HTTP 工作区；UPLINK_BATCH_ENABLE=1 时约 3.8KB），
+ * lwIP 多占 1 个 netconn（52B）与 1 个 TCP PCB（152B），需同步加大 lwipopts.h 的 MEMP_NUM_NETCONN / MEMP_NUM_TCP_PCB。
+ */
+#ifndef UPLINK_MAX_PARALLEL
+#define UPLINK_MAX_PARALLEL 1
+#endif
+
+/** 上级端点数上限（首选 + 备用），见 uplink_failover.h */
+#ifndef UPLINK_MAX_ENDPOINTS
+#define UPLINK_MAX_ENDPOINTS 3
+#endif
+
+/** 消息优先级类别数（见 uplink_prio_t） */
+#define UPLINK_PRIO_COUNT 3
+
     /**
      * @brief Uplink 统一返回码
      *
@@ -95,16 +152,18 @@ extern "C"
         UPLINK_ERR_TRANSPORT = 7,        /* 传输层失败（连接/发送/接收等） */
         UPLINK_ERR_CODEC = 8,            /* 编解码失败（JSON 生成/解析失败） */
         UPLINK_ERR_INTERNAL = 9,         /* 内部错误（不应发生） */
+        UPLINK_ERR_NO_ID = 10,           /* 暂无可用消息 ID（纪元申请失败，停发中，见 uplink_msgid.h） */
     } uplink_err_t;
 
     /**
-     * @brief URL scheme（支持 HTTP；HTTPS 预留）
+     * @brief URL scheme（支持 HTTP/MQTT；HTTPS 预留）
      *
      */
     typedef enum
     {
-        UPLINK_SCHEME_HTTP = 0, /* 明文 HTTP（先用 8080 测试链路） */
-        UPLINK_SCHEME_HTTPS = 1 /* HTTPS（未来引入 TLS 后启用，端口 443） */
+        UPLINK_SCHEME_HTTP = 0,  /* 明文 HTTP（先用 8080 测试链路） */
+        UPLINK_SCHEME_HTTPS = 1, /* HTTPS（未来引入 TLS 后启用，端口 443） */
+        UPLINK_SCHEME_MQTT = 2   /* MQTT 3.1.1（QoS1，端口 1883；path 作为发布主题） */
     } uplink_scheme_t;
 
     /**
@@ -123,7 +182,7 @@ extern "C"
      * @brief 上报端点信息（host/port/path）
      *
      * @note 说明：
-     * - host 可以是 IP 字符串（推荐先用 IP，避免 DNS 依赖），也可以是域名（需开启 LWIP_DNS 并实现解析）。
+     * - host 可以是 IP 字符串（推荐先用 IP，避免 DNS 依赖），也可以是域名（需开启 LWIP_DNS，解析结果由 uplink_dns 共享缓存）。
      * - path 为 HTTP 路径，不包含 host/port，例如 "/api/uplink"。
      */
     typedef struct
@@ -131,7 +190,7 @@ extern "C"
         uplink_scheme_t scheme;         /* HTTP 或 HTTPS */
         char host[UPLINK_MAX_HOST_LEN]; /* 服务器地址（IP 或域名） */
         uint16_t port;                  /* 服务器端口（HTTP 常用 8080/80；HTTPS 常用 443） */
-        char path[UPLINK_MAX_PATH_LEN]; /* HTTP 路径 */
+        char path[UPLINK_MAX_PATH_LEN]; /* HTTP 路径（MQTT 模式下为发布主题） */
         uint8_t use_dns;                /* 是否使用 DNS 解析 host（1=域名；0=直接按 IP 解析） */
     } uplink_endpoint_t;
 
@@ -142,12 +201,14 @@ extern "C"
  * - http_status：HTTP 状态码，如 200/404/500。0 表示未获取到（例如解析失败）。
  * - app_code：业务 code（来自 JSON body），用于业务幂等/错误码判断。
  *   若 body 中未找到 code 字段，可使用 UPLINK_APP_CODE_UNKNOWN 表示“未知/未提供”。
+ * - retry_after_ms：上级要求的暂缓时长（HTTP 传输从 Retry-After 头解析，秒数形式；0=未给出）。
  */
 #define UPLINK_APP_CODE_UNKNOWN ((int32_t)0x7fffffff)
     typedef struct
     {
-        uint16_t http_status; /* HTTP 状态码 */
-        int32_t app_code;     /* 业务 code（0 表示成功） */
+        uint16_t http_status;    /* HTTP 状态码 */
+        int32_t app_code;        /* 业务 code（0 表示成功） */
+        uint32_t retry_after_ms; /* 上级要求的暂缓时长（毫秒，0=未给出） */
     } uplink_ack_t;
 
     /**
@@ -167,6 +228,47 @@ extern "C"
         uint8_t jitter_pct;
     } uplink_retry_policy_t;
 
+    /**
+     * @brief 消息优先级类别（数值越小越优先）
+     *
+     * @note 说明：
+     * - 各类别有独立的容量上限与丢弃策略，出队按权重公平调度（见 uplink_sched.h），
+     *   低优先级的突发（如大量 CARD_READ 审计）不会无限拖延告警类事件。
+     */
+    typedef enum
+    {
+        UPLINK_PRIO_HIGH = 0,   /* 告警/健康（开门失败、鉴权网络失败、远程开门） */
+        UPLINK_PRIO_NORMAL = 1, /* 一般业务审计（开门成功、拒绝、会话结束） */
+        UPLINK_PRIO_BULK = 2    /* 批量/可聚合（刷卡读卡记录） */
+    } uplink_prio_t;
+
+    /**
+     * @brief 类别满时的丢弃策略
+     *
+     */
+    typedef enum
+    {
+        UPLINK_DROP_NEWEST = 0, /* 拒绝新消息（保留最早的记录） */
+        UPLINK_DROP_OLDEST = 1  /* 挤掉本类别最旧的未在途消息（保留最新的记录） */
+    } uplink_drop_policy_t;
+
+    /**
+     * @brief 单个优先级类别的队列策略
+     *
+     * @note 说明：
+     * - capacity：本类别最多占用的队列槽位（超过 queue_len 时按 queue_len 计）；低类别容量小于队列长度，
+     *   相当于给高类别预留了槽位。
+     * - weight：加权公平出队的权重，各类别都有待发消息时按权重比例轮流发送。
+     * - ttl_ms：入队后的默认存活时长，超过截止时刻仍未送达的消息直接丢弃（计入 stats.expired）；0=不过期。
+     */
+    typedef struct
+    {
+        uint16_t capacity;
+        uint8_t weight;
+        uint8_t drop_policy; /* uplink_drop_policy_t */
+        uint32_t ttl_ms;
+    } uplink_class_policy_t;
+
     /**
      * @brief 队列中的“待发送消息”
      *
@@ -180,9 +282,14 @@ extern "C"
         uint32_t created_ms;                       /* 入队时间戳（毫秒，来自 now_ms） */
         char type[UPLINK_MAX_TYPE_LEN];            /* 事件类型 */
         char payload_json[UPLINK_MAX_PAYLOAD_LEN]; /* payload(JSON 子对象) */
+        uint8_t prio;                              /* 优先级类别（uplink_prio_t） */
+        uint32_t deadline_ms;                      /* 送达截止时刻（毫秒，0=无截止），过期未送达即丢弃 */
 
         uint16_t attempt;       /* 已尝试发送次数（0=从未发送） */
         uint32_t next_retry_ms; /* 下次允许发送的时间戳（毫秒） */
+
+        uint8_t inflight;         /* 1=已提交给传输层、等待确认（同步模式为“正在发送”） */
+        uint32_t ack_deadline_ms; /* 在途消息的确认截止时间（毫秒），超时后按重试策略重发 */
     } uplink_msg_t;
 
 #ifdef __cplusplus
@@ -9,6 +9,9 @@
  * - 对外提供 `uplink_init / uplink_enqueue_json / uplink_poll`。
  * - 对内负责：队列管理、重试退避、HTTP 发送、响应解析、成功判定。
  * - 当前使用 HTTP(netconn)；后续可通过 transport 层平滑切换 HTTPS。
+ * - transport 提供 submit_json/poll_acks 时（如 MQTT）走异步流水：多条消息同时在途，按 messageId 确认出队。
+ * - 热队列放不下的消息进 SDRAM 后备队列，挑选下一条消息前按水位回填（见 uplink_refill）。
+ * - 同步模式可把多条到期消息合并成一个 JSON 数组发送，并流式压缩 body（见 uplink_build_body）。
  *
  * @copyright Copyright (c) 2025 Yukikaze
  */
@@ -183,72 +186,1370 @@ uplink_err_t uplink_init(uplink_t *u, const uplink_config_t *cfg, const uplink_p
     }
 
     uplink_queue_init(&u->queue, u->cfg.queue_len);
-    u->next_message_id = 1U;
+    uplink_sched_init(&u->sched, u->cfg.classes);
+    uplink_backlog_init(&u->backlog, u->cfg.backlog.mem, u->cfg.backlog.size, u->cfg.backlog.share_pct);
+    uplink_msgid_init(&u->msgid, u->platform.id_epoch, u->platform.user_ctx);
+    if (uplink_msgid_ready(&u->msgid) == 0U)
+    {
+        /* 纪元没申请到：入队返回 UPLINK_ERR_NO_ID，uplink_poll 按 UPLINK_MSGID_RETRY_MS 重试 */
+        uplink_logf(u, UPLINK_LOG_ERROR, "[uplink] msgid epoch claim failed, enqueue paused\r\n");
+    }
+
+    /* 签名密钥在此预计算一次；sign.enable=0 时签名器保持禁用，请求不带签名头 */
+    uplink_signer_init(&u->signer,
+                       u->cfg.device_id,
+                       (u->cfg.sign.enable != 0U) ? u->cfg.sign.secret : NULL,
+                       UPLINK_SIGN_LANE_UPLINK);
+
+    if (u->cfg.endpoint.scheme == UPLINK_SCHEME_HTTP)
+    {
+        uplink_transport_http_netconn_bind(&u->transport, &u->http_ctx);
+        uplink_transport_http_netconn_set_signer(&u->http_ctx, &u->signer);
+        if (u->cfg.batch.compress != 0U)
+        {
+            uplink_transport_http_netconn_set_content_encoding(&u->http_ctx, UPLINK_LZSS_CONTENT_ENCODING);
+        }
+#if UPLINK_MAX_PARALLEL > 1
+        if (u->cfg.parallel.max_requests > 1U)
+        {
+            uplink_transport_http_netconn_enable_parallel(&u->transport,
+                                                          &u->http_ctx,
+                                                          u->http_parallel,
+                                                          u->cfg.parallel.max_requests);
+        }
+#endif
+    }
+    else if (u->cfg.endpoint.scheme == UPLINK_SCHEME_MQTT)
+    {
+        uplink_transport_mqtt_netconn_bind(&u->transport,
+                                           &u->mqtt_ctx,
+                                           u->cfg.device_id,
+                                           u->cfg.mqtt.keepalive_s,
+                                           u->cfg.mqtt.max_inflight);
+    }
+    else
+    {
+        return UPLINK_ERR_UNSUPPORTED;
+    }
+
+    /* 端点列表：首选 + 备用（备用 path 为空时沿用首选 path）；config 已校验，add 不会失败 */
+    uplink_failover_init(&u->failover, UPLINK_FAILOVER_STICKY);
+    (void)uplink_failover_add(&u->failover, &u->cfg.endpoint);
+    {
+        uint8_t i;
+        for (i = 0U; i < u->cfg.fallback.count; i++)
+        {
+            uplink_endpoint_t fb = u->cfg.fallback.list[i];
+
+            if (fb.path[0] == '\0')
+            {
+                (void)memcpy(fb.path, u->cfg.endpoint.path, sizeof(fb.path));
+            }
+            (void)uplink_failover_add(&u->failover, &fb);
+        }
+    }
+
+    u->inited = 1U;
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 清除过期消息并计入统计（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param now_ms 当前时间（ms）
+ */
+static void uplink_expire(uplink_t *u, uint32_t now_ms)
+{
+    uint16_t expired[UPLINK_PRIO_COUNT] = {0U};
+    uint8_t c;
+
+    if (uplink_sched_expire(&u->queue, now_ms, expired) == 0U)
+    {
+        return;
+    }
+
+    for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+    {
+        u->stats.expired[c] += expired[c];
+    }
+
+    uplink_logf(u,
+                UPLINK_LOG_WARN,
+                "[uplink] expired: high=%u normal=%u bulk=%u\r\n",
+                (unsigned)expired[UPLINK_PRIO_HIGH],
+                (unsigned)expired[UPLINK_PRIO_NORMAL],
+                (unsigned)expired[UPLINK_PRIO_BULK]);
+}
+
+/**
+ * @brief 丢弃一条被挤掉的消息：记统计与日志（调用者已持锁，负责从所在队列移除）
+ *
+ * @param u uplink 上下文
+ * @param message_id 被挤掉的消息 ID
+ * @param victim_prio 被挤掉的消息类别
+ * @param prio 新消息类别
+ */
+static void uplink_note_evicted(uplink_t *u, uint32_t message_id, uint8_t victim_prio, uint8_t prio)
+{
+    u->stats.evicted[victim_prio]++;
+    uplink_logf(u,
+                UPLINK_LOG_WARN,
+                "[uplink] evict: id=%lu prio=%u for prio=%u\r\n",
+                (unsigned long)message_id,
+                (unsigned)victim_prio,
+                (unsigned)prio);
+}
+
+/**
+ * @brief 一条消息进入了后备队列：记统计，积压越过告警水位时打一条日志（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param prio 类别
+ */
+static void uplink_note_spilled(uplink_t *u, uint8_t prio)
+{
+    uint32_t depth = uplink_backlog_count(&u->backlog, prio);
+    uint32_t cap = uplink_backlog_capacity(&u->backlog, prio);
+
+    u->stats.spilled[prio]++;
+    if (depth > u->stats.backlog_max_depth[prio])
+    {
+        u->stats.backlog_max_depth[prio] = depth;
+    }
+
+    if (((u->backlog_warned & (1U << prio)) == 0U) && ((depth * 100U) >= (cap * UPLINK_BACKLOG_WARN_PCT)))
+    {
+        u->backlog_warned |= (uint8_t)(1U << prio);
+        uplink_logf(u,
+                    UPLINK_LOG_WARN,
+                    "[uplink] backlog high: prio=%u depth=%lu/%lu\r\n",
+                    (unsigned)prio,
+                    (unsigned long)depth,
+                    (unsigned long)cap);
+    }
+}
+
+/**
+ * @brief 在 prio 类别的后备队列尾部占用槽位（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param prio 类别（后备队列容量非 0）
+ * @param out_slot 输出：槽位
+ * @return uplink_err_t UPLINK_OK / UPLINK_ERR_QUEUE_FULL（后备队列也满且策略为拒绝新消息）
+ *
+ * @note 后备队列也满时按类别策略处理：DROP_OLDEST 丢掉后备队列里最旧的一条，DROP_NEWEST 拒绝新消息。
+ */
+static uplink_err_t uplink_spill_slot(uplink_t *u, uint8_t prio, uplink_msg_t **out_slot)
+{
+    uplink_msg_t *oldest = NULL;
+
+    if (uplink_backlog_push_slot(&u->backlog, prio, out_slot) != UPLINK_OK)
+    {
+        u->stats.backlog_full[prio]++;
+
+        if ((u->cfg.classes[prio].drop_policy != (uint8_t)UPLINK_DROP_OLDEST) ||
+            (uplink_backlog_peek(&u->backlog, prio, &oldest) != UPLINK_OK))
+        {
+            return UPLINK_ERR_QUEUE_FULL;
+        }
+
+        uplink_note_evicted(u, oldest->message_id, prio, prio);
+        (void)uplink_backlog_pop(&u->backlog, prio);
+        (void)uplink_backlog_push_slot(&u->backlog, prio, out_slot);
+    }
+
+    u->reserved_backlog = 1U;
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 为一条 prio 类别的新消息占用槽位（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param prio 新消息类别
+ * @param out_slot 输出：槽位（u->reserved_backlog 标明在热队列还是后备队列）
+ * @return uplink_err_t UPLINK_OK / UPLINK_ERR_QUEUE_FULL
+ *
+ * @note 顺序：
+ * 1) 本类别后备队列非空（新消息必须排在积压之后），或热队列要为它挤掉本类别消息、拒绝它：新消息进后备队列。
+ * 2) 热队列要挤掉更低类别的消息：被挤的消息退回它的后备队列队头，后备队列满或该类别不使用后备队列时才丢弃。
+ * 3) 其余情况与没有后备队列时一致。
+ */
+static uplink_err_t uplink_admit_slot(uplink_t *u, uint8_t prio, uplink_msg_t **out_slot)
+{
+    uplink_msg_t *victim = NULL;
+    uplink_err_t r;
+
+    u->reserved_backlog = 0U;
+    r = uplink_sched_select_victim(&u->sched, &u->queue, prio, &victim);
+
+    if ((uplink_backlog_capacity(&u->backlog, prio) != 0U) &&
+        ((uplink_backlog_count(&u->backlog, prio) != 0U) || (r != UPLINK_OK) ||
+         ((victim != NULL) && (victim->prio == prio))))
+    {
+        return uplink_spill_slot(u, prio, out_slot);
+    }
+
+    if (r != UPLINK_OK)
+    {
+        return r;
+    }
+
+    if (victim != NULL)
+    {
+        uint32_t victim_id = victim->message_id;
+        uint8_t victim_prio = victim->prio;
+
+        if (uplink_backlog_push_front(&u->backlog, victim) == UPLINK_OK)
+        {
+            uplink_note_spilled(u, victim_prio);
+        }
+        else
+        {
+            if (uplink_backlog_capacity(&u->backlog, victim_prio) != 0U)
+            {
+                u->stats.backlog_full[victim_prio]++;
+            }
+            uplink_note_evicted(u, victim_id, victim_prio, prio);
+        }
+        (void)uplink_queue_remove_id(&u->queue, victim_id);
+    }
+
+    return uplink_queue_push_slot(&u->queue, out_slot);
+}
+
+/**
+ * @brief 热队列降到低水位时从后备队列按顺序回填（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param now_ms 当前时间（ms）
+ *
+ * @note 说明：
+ * - 热队列消息数（含在途）<= UPLINK_BACKLOG_REFILL_LOW 才开始，回填到只剩 UPLINK_BACKLOG_HOT_RESERVE 个空位为止；
+ *   各类别轮流每次搬一条，且不超过类别容量，回填后的发送顺序仍由调度器按权重决定。
+ * - 后备队列只检查队头是否过期：同一类别通常使用相同存活时长，队头最先到期；其余的轮到队头时再清除。
+ */
+static void uplink_refill(uplink_t *u, uint32_t now_ms)
+{
+    uint32_t expired[UPLINK_PRIO_COUNT] = {0U};
+    uint16_t high;
+    uint8_t moved = 1U;
+    uint8_t c;
+
+    if (uplink_queue_size(&u->queue) > (uint16_t)UPLINK_BACKLOG_REFILL_LOW)
+    {
+        return;
+    }
+
+    high = (u->queue.capacity > (uint16_t)UPLINK_BACKLOG_HOT_RESERVE)
+               ? (uint16_t)(u->queue.capacity - (uint16_t)UPLINK_BACKLOG_HOT_RESERVE)
+               : 1U;
+
+    while (moved != 0U)
+    {
+        moved = 0U;
+        for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+        {
+            uplink_msg_t *src = NULL;
+            uplink_msg_t *dst = NULL;
+
+            if (uplink_backlog_peek(&u->backlog, c, &src) != UPLINK_OK)
+            {
+                continue;
+            }
+
+            if ((src->deadline_ms != 0U) && (uplink_time_is_due(now_ms, src->deadline_ms) != 0U))
+            {
+                expired[c]++;
+                (void)uplink_backlog_pop(&u->backlog, c);
+                moved = 1U;
+                continue;
+            }
+
+            if ((uplink_queue_size(&u->queue) >= high) ||
+                (uplink_sched_class_count(&u->queue, c) >= u->cfg.classes[c].capacity) ||
+                (uplink_queue_push_slot(&u->queue, &dst) != UPLINK_OK))
+            {
+                continue;
+            }
+
+            *dst = *src;
+            (void)uplink_backlog_pop(&u->backlog, c);
+            u->stats.refilled[c]++;
+            moved = 1U;
+        }
+    }
+
+    for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+    {
+        u->stats.expired[c] += expired[c];
+
+        if (((u->backlog_warned & (1U << c)) != 0U) &&
+            ((uplink_backlog_count(&u->backlog, c) * 100U) <=
+             (uplink_backlog_capacity(&u->backlog, c) * UPLINK_BACKLOG_CLEAR_PCT)))
+        {
+            u->backlog_warned &= (uint8_t)~(1U << c);
+        }
+    }
+
+    if ((expired[UPLINK_PRIO_NORMAL] != 0U) || (expired[UPLINK_PRIO_BULK] != 0U) || (expired[UPLINK_PRIO_HIGH] != 0U))
+    {
+        uplink_logf(u,
+                    UPLINK_LOG_WARN,
+                    "[uplink] backlog expired: high=%lu normal=%lu bulk=%lu\r\n",
+                    (unsigned long)expired[UPLINK_PRIO_HIGH],
+                    (unsigned long)expired[UPLINK_PRIO_NORMAL],
+                    (unsigned long)expired[UPLINK_PRIO_BULK]);
+    }
+}
+
+/**
+ * @brief 入队一条 JSON 事件（NORMAL 类别，仅入队，不立即发送）
+ *
+ * @param u uplink 上下文
+ * @param type 事件类型（如 `RFID_AUDIT`）
+ * @param payload_json 事件 payload（JSON 子对象字符串）
+ * @return uplink_err_t 入队结果
+ */
+uplink_err_t uplink_enqueue_json(uplink_t *u, const char *type, const char *payload_json)
+{
+    return uplink_enqueue_json_prio(u, type, payload_json, UPLINK_PRIO_NORMAL);
+}
+
+/**
+ * @brief 按优先级类别入队一条 JSON 事件（使用类别默认存活时长，仅入队，不立即发送）
+ *
+ * @param u uplink 上下文
+ * @param type 事件类型（如 `RFID_AUDIT`）
+ * @param payload_json 事件 payload（JSON 子对象字符串）
+ * @param prio 优先级类别
+ * @return uplink_err_t 入队结果（同 uplink_enqueue_json_ttl）
+ */
+uplink_err_t uplink_enqueue_json_prio(uplink_t *u, const char *type, const char *payload_json, uplink_prio_t prio)
+{
+    return uplink_enqueue_json_ttl(u, type, payload_json, prio, UPLINK_TTL_CLASS_DEFAULT, NULL);
+}
+
+/**
+ * @brief 预留一个队列槽位，供调用者把 payload 直接格式化进去（与 uplink_enqueue_commit/abort 配对）
+ *
+ * @param u uplink 上下文
+ * @param type 事件类型（如 `RFID_AUDIT`）
+ * @param prio 优先级类别
+ * @param ttl_ms 存活时长（毫秒）：0=不过期；UPLINK_TTL_CLASS_DEFAULT=使用 cfg.classes[prio].ttl_ms
+ * @param out_payload 输出：槽位内 payload 缓冲区（已置为空串；热队列放不下时位于 SDRAM 后备队列）
+ * @param out_cap 输出：payload 缓冲区容量（含结尾 '\0'）
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：已预留，调用者必须随后调用 uplink_enqueue_commit 或 uplink_enqueue_abort
+ * - UPLINK_ERR_QUEUE_FULL：按类别策略拒绝（计入 stats.rejected），不需要 commit/abort
+ * - UPLINK_ERR_NO_ID：没有可用的消息 ID 纪元（计入 stats.id_unavailable），不需要 commit/abort
+ *
+ * @note 说明：
+ * - 过期清除、类别准入（可能挤掉一条消息）与占用槽位在同一临界区内完成，不存在“先查深度再入队”的窗口。
+ * - 启用后备队列时，热队列放不下的消息进后备队列而不是被拒绝/挤掉，见 uplink_admit_slot。
+ * - 预留成功后一直持有队列互斥量直到 commit/abort：槽位指针在队列被修改前才有效。
+ *   期间只做格式化，不要阻塞，也不要调用其他 uplink 接口（包括对同一上下文再次预留）。
+ */
+uplink_err_t uplink_enqueue_reserve(uplink_t *u,
+                                    const char *type,
+                                    uplink_prio_t prio,
+                                    uint32_t ttl_ms,
+                                    char **out_payload,
+                                    size_t *out_cap)
+{
+    uplink_msg_t *slot = NULL;
+    uint32_t now_ms;
+    uint32_t deadline_ms = 0U;
+    uplink_err_t r;
+
+    if ((u == NULL) || (type == NULL) || (out_payload == NULL) || (out_cap == NULL) ||
+        ((uint32_t)prio >= (uint32_t)UPLINK_PRIO_COUNT))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (u->inited == 0U)
+    {
+        return UPLINK_ERR_NOT_INIT;
+    }
+
+    if (strlen(type) >= UPLINK_MAX_TYPE_LEN)
+    {
+        return UPLINK_ERR_BUFFER_TOO_SMALL;
+    }
+
+    now_ms = u->platform.now_ms(u->platform.user_ctx);
+
+    if (ttl_ms == UPLINK_TTL_CLASS_DEFAULT)
+    {
+        ttl_ms = u->cfg.classes[prio].ttl_ms;
+    }
+    if (ttl_ms != 0U)
+    {
+        /* 0 表示“无截止”，恰好回绕到 0 时顺延 1ms */
+        deadline_ms = now_ms + ttl_ms;
+        if (deadline_ms == 0U)
+        {
+            deadline_ms = 1U;
+        }
+    }
+
+    /* 队列并发访问需加锁：业务入队与 poll 会并发操作队列 */
+    sys_mutex_lock(&u->mutex);
+
+    /* 纪元未申请到时停发：不能编出可能与其他启动重复的 ID（在准入之前判断，不挤掉已排队的消息） */
+    if (uplink_msgid_ready(&u->msgid) == 0U)
+    {
+        u->stats.id_unavailable++;
+        sys_mutex_unlock(&u->mutex);
+        return UPLINK_ERR_NO_ID;
+    }
+
+    /* 先清过期：过时消息占着的槽位让给新消息 */
+    uplink_expire(u, now_ms);
+    r = uplink_admit_slot(u, (uint8_t)prio, &slot);
+
+    if (r != UPLINK_OK)
+    {
+        u->stats.rejected[prio]++;
+        sys_mutex_unlock(&u->mutex);
+        return r;
+    }
+
+    /* 就地填写消息头；payload 由调用者写入 */
+    slot->message_id = uplink_msgid_next(&u->msgid);
+    slot->created_ms = now_ms;
+    (void)memcpy(slot->type, type, strlen(type) + 1U);
+    slot->payload_json[0] = '\0';
+    slot->prio = (uint8_t)prio;
+    slot->deadline_ms = deadline_ms;
+    slot->attempt = 0U;
+    slot->next_retry_ms = now_ms;
+    slot->inflight = 0U;
+    slot->ack_deadline_ms = 0U;
+
+    u->reserved = slot;
+    *out_payload = slot->payload_json;
+    *out_cap = sizeof(slot->payload_json);
+
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 提交预留的槽位（消息对发送端可见）并释放队列互斥量
+ *
+ * @param u uplink 上下文
+ * @param out_message_id 输出：消息 ID（可为 NULL），供 uplink_update_json 使用
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：已入队
+ * - UPLINK_ERR_BUFFER_TOO_SMALL：payload 没有在容量内以 '\0' 结尾（按 abort 处理，消息不入队）
+ * - UPLINK_ERR_INVALID_ARG：没有预留中的槽位
+ */
+uplink_err_t uplink_enqueue_commit(uplink_t *u, uint32_t *out_message_id)
+{
+    uplink_msg_t *slot;
+
+    if ((u == NULL) || (u->reserved == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    slot = u->reserved;
+    if (memchr(slot->payload_json, '\0', sizeof(slot->payload_json)) == NULL)
+    {
+        uplink_enqueue_abort(u);
+        return UPLINK_ERR_BUFFER_TOO_SMALL;
+    }
+
+    u->stats.enqueued[slot->prio]++;
+    if (u->reserved_backlog != 0U)
+    {
+        uplink_note_spilled(u, slot->prio);
+    }
+    if (out_message_id != NULL)
+    {
+        *out_message_id = slot->message_id;
+    }
+
+    u->reserved = NULL;
+    sys_mutex_unlock(&u->mutex);
+
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 放弃预留的槽位（例如格式化失败）并释放队列互斥量
+ *
+ * @param u uplink 上下文
+ *
+ * @note 预留时若已挤掉一条消息，该消息不会恢复（已计入 stats.evicted）。
+ */
+void uplink_enqueue_abort(uplink_t *u)
+{
+    if ((u == NULL) || (u->reserved == NULL))
+    {
+        return;
+    }
+
+    /* 预留槽位在热队列或后备队列的队尾；消息 ID 不回收 */
+    u->stats.rejected[u->reserved->prio]++;
+    if (u->reserved_backlog != 0U)
+    {
+        (void)uplink_backlog_drop_tail(&u->backlog, u->reserved->prio);
+    }
+    else
+    {
+        (void)uplink_queue_remove_id(&u->queue, u->reserved->message_id);
+    }
+
+    u->reserved = NULL;
+    sys_mutex_unlock(&u->mutex);
+}
+
+/**
+ * @brief 按优先级类别与存活时长入队一条 JSON 事件（仅入队，不立即发送）
+ *
+ * @param u uplink 上下文
+ * @param type 事件类型（如 `RFID_AUDIT`）
+ * @param payload_json 事件 payload（JSON 子对象字符串）
+ * @param prio 优先级类别
+ * @param ttl_ms 存活时长（毫秒）：0=不过期；UPLINK_TTL_CLASS_DEFAULT=使用 cfg.classes[prio].ttl_ms
+ * @param out_message_id 输出：分配的消息 ID（可为 NULL），供 uplink_update_json 使用
+ * @return uplink_err_t 入队结果
+ * - UPLINK_OK：已入队（可能挤掉了一条本类别最旧或更低类别的消息，计入 stats.evicted）
+ * - UPLINK_ERR_QUEUE_FULL：按类别策略拒绝（计入 stats.rejected）
+ *
+ * @note 截止时刻 = 入队时刻 + ttl_ms；到期仍未送达（含重试中）的消息在下次挑选前丢弃，计入 stats.expired。
+ * @note payload 只拷贝一次（直接拷进预留的队列槽位）；能边格式化边入队的调用者应直接用 uplink_enqueue_reserve。
+ */
+uplink_err_t uplink_enqueue_json_ttl(uplink_t *u,
+                                     const char *type,
+                                     const char *payload_json,
+                                     uplink_prio_t prio,
+                                     uint32_t ttl_ms,
+                                     uint32_t *out_message_id)
+{
+    char *buf = NULL;
+    size_t cap = 0U;
+    size_t len;
+    uplink_err_t r;
+
+    if (payload_json == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    /* 过长的 payload 在加锁前就拒绝，不占用（也不挤掉）任何槽位 */
+    len = strlen(payload_json);
+    if (len >= UPLINK_MAX_PAYLOAD_LEN)
+    {
+        return UPLINK_ERR_BUFFER_TOO_SMALL;
+    }
+
+    r = uplink_enqueue_reserve(u, type, prio, ttl_ms, &buf, &cap);
+    if (r != UPLINK_OK)
+    {
+        return r;
+    }
+
+    (void)memcpy(buf, payload_json, len + 1U);
+    return uplink_enqueue_commit(u, out_message_id);
+}
+
+/**
+ * @brief 按 message_id 查找队列中的消息（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param message_id 消息 ID
+ * @param out_msg 输出：消息指针
+ * @return uint8_t 1=找到；0=不存在（可能已确认出队）
+ */
+static uint8_t uplink_find_msg(uplink_t *u, uint32_t message_id, uplink_msg_t **out_msg)
+{
+    uint16_t i;
+
+    for (i = 0U; uplink_queue_at(&u->queue, i, out_msg) == UPLINK_OK; i++)
+    {
+        if ((*out_msg)->message_id == message_id)
+        {
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/**
+ * @brief 改写一条尚未发出的消息的 payload（用于合并重复事件）
+ *
+ * @param u uplink 上下文
+ * @param message_id 消息 ID（入队时由 uplink_enqueue_json_ttl 返回）
+ * @param payload_json 新 payload（JSON 子对象字符串）
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：已改写，消息保持原队列位置、类别与截止时刻（热队列或后备队列）
+ * - UPLINK_ERR_QUEUE_EMPTY：消息已不在队列（已送达/被丢弃）或正在发送；调用者应改为入队一条新消息
+ * - UPLINK_ERR_BUFFER_TOO_SMALL：payload 过长，原消息不变
+ *
+ * @note 只改写从未发送过的消息（attempt=0）：发送失败待重试的消息可能已被上级收下（只是确认丢失），
+ *       改写后以同一 messageId 重发会被后端按幂等去重丢掉新内容。
+ */
+uplink_err_t uplink_update_json(uplink_t *u, uint32_t message_id, const char *payload_json)
+{
+    uplink_msg_t *msg = NULL;
+    uplink_err_t r = UPLINK_ERR_QUEUE_EMPTY;
+
+    if ((u == NULL) || (payload_json == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (u->inited == 0U)
+    {
+        return UPLINK_ERR_NOT_INIT;
+    }
+
+    if (strlen(payload_json) >= UPLINK_MAX_PAYLOAD_LEN)
+    {
+        return UPLINK_ERR_BUFFER_TOO_SMALL;
+    }
+
+    sys_mutex_lock(&u->mutex);
+
+    if (uplink_find_msg(u, message_id, &msg) == 0U)
+    {
+        msg = uplink_backlog_find(&u->backlog, message_id);
+    }
+
+    if ((msg != NULL) && (msg->inflight == 0U) && (msg->attempt == 0U))
+    {
+        (void)uplink_copy_str_checked(msg->payload_json, sizeof(msg->payload_json), payload_json);
+        r = UPLINK_OK;
+    }
+
+    sys_mutex_unlock(&u->mutex);
+
+    return r;
+}
+
+/**
+ * @brief 消息确认送达：记统计并移出队列（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param message_id 消息 ID
+ * @param now_ms 当前时间（ms）
+ */
+static void uplink_msg_delivered(uplink_t *u, uint32_t message_id, uint32_t now_ms)
+{
+    uplink_msg_t *msg = NULL;
+    uint32_t latency;
+
+    if (uplink_find_msg(u, message_id, &msg) == 0U)
+    {
+        return;
+    }
+
+    latency = now_ms - msg->created_ms;
+    u->stats.delivered[msg->prio]++;
+    if (latency > u->stats.max_latency_ms[msg->prio])
+    {
+        u->stats.max_latency_ms[msg->prio] = latency;
+    }
+
+    (void)uplink_queue_remove_id(&u->queue, message_id);
+}
+
+/**
+ * @brief 按调度器选出下一条可发送消息，顺带丢弃已过期、已超过最大尝试次数的消息（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param now_ms 当前时间（ms）
+ * @return uplink_msg_t* 选中的消息（仍在队列中）；没有返回 NULL
+ *
+ * @note 在熔断检查之前调用：上级不可用期间过期清除照常进行，恢复后不会先发一批过时消息。
+ * @note 挑选前先按水位从后备队列回填热队列。
+ */
+static uplink_msg_t *uplink_pick_next(uplink_t *u, uint32_t now_ms)
+{
+    uplink_msg_t *msg;
+
+    uplink_expire(u, now_ms);
+    uplink_refill(u, now_ms);
+
+    while ((msg = uplink_sched_pick(&u->sched, &u->queue, now_ms)) != NULL)
+    {
+        if (uplink_retry_is_attempt_allowed(&u->cfg.retry, (uint16_t)(msg->attempt + 1U)) != 0U)
+        {
+            break;
+        }
+
+        u->stats.exhausted[msg->prio]++;
+        (void)uplink_queue_remove_id(&u->queue, msg->message_id);
+    }
+
+    return msg;
+}
+
+/**
+ * @brief 上级整体不可用时，本次失败的发送不计入消息的尝试次数（调用者已持锁，已向熔断器反馈本次结果）
+ *
+ * @param msg 队列中的消息
+ *
+ * @note 熔断器处于 OPEN 说明失败来自上级而不是消息本身：长时间断网期间，半开探测每次都会落在某条消息上，
+ *       若照常计数，几小时内排队的消息会陆续“超过最大尝试次数”被丢弃。被上级明确拒绝（4xx、业务码非 0）
+ *       的消息不会让熔断器打开，仍按 max_attempts 丢弃。
+ */
+static void uplink_uncharge_if_down(uplink_msg_t *msg)
+{
+    if ((uplink_breaker_get_state() == UPLINK_BREAKER_OPEN) && (msg->attempt > 0U))
+    {
+        msg->attempt--;
+    }
+}
+
+/**
+ * @brief 在途消息发送失败/超时：取消在途标记并按重试策略安排下次发送
+ *
+ * @param u uplink 上下文（调用者已持锁）
+ * @param msg 队列中的消息
+ * @param now_ms 当前时间（ms）
+ */
+static void uplink_inflight_reschedule(uplink_t *u, uplink_msg_t *msg, uint32_t now_ms)
+{
+    uint32_t delay = uplink_retry_calc_delay_ms(&u->cfg.retry,
+                                                msg->attempt,
+                                                u->platform.rand_u32(u->platform.user_ctx));
+
+    msg->inflight = 0U;
+    msg->next_retry_ms = now_ms + delay;
+    uplink_uncharge_if_down(msg);
+}
+
+/**
+ * @brief 异步流水发送（transport 提供 submit_json/poll_acks 时使用）
+ *
+ * @param u uplink 上下文
+ *
+ * @note
+ * - 先收确认：按 messageId 从队列任意位置移除（确认可能乱序）。
+ * - 再查超时：在途超过 recv_timeout_ms 仍未确认的，按重试策略重发（同一 messageId）。
+ * - 最后补发：在途数未达 transport->max_inflight 时，按调度器（优先级加权公平）依次提交已到期的消息。
+ * - 网络 I/O 全部在锁外进行；sending 标志保证同一时刻只有一个 poll 在操作 transport。
+ */
+static void uplink_poll_pipelined(uplink_t *u)
+{
+    uint32_t acked_ids[UPLINK_MAX_INFLIGHT];
+    uint16_t acked_count = 0U;
+    uplink_err_t pr;
+    uint16_t i;
+
+    /* 1. 收确认 / 维持连接 */
+    pr = u->transport.poll_acks(u->transport.ctx,
+                                &u->cfg.endpoint,
+                                &u->platform,
+                                UPLINK_PIPELINE_ACK_WAIT_MS,
+                                acked_ids,
+                                (uint16_t)UPLINK_MAX_INFLIGHT,
+                                &acked_count);
+
+    /* 熔断器：收到确认说明上级可用；断线说明不可用（没有在途报文、也没有连接时 poll_acks 返回成功） */
+    if ((pr != UPLINK_OK) || (acked_count != 0U))
+    {
+        uplink_breaker_report((pr == UPLINK_OK) ? 1U : 0U, u->platform.now_ms(u->platform.user_ctx));
+    }
+
+    sys_mutex_lock(&u->mutex);
+    for (i = 0U; i < acked_count; i++)
+    {
+        uplink_msg_delivered(u, acked_ids[i], u->platform.now_ms(u->platform.user_ctx));
+    }
+
+    /* 2. 断线或确认超时：在途消息退回“待发送” */
+    {
+        uint32_t now_ms = u->platform.now_ms(u->platform.user_ctx);
+        uplink_msg_t *msg = NULL;
+
+        for (i = 0U; uplink_queue_at(&u->queue, i, &msg) == UPLINK_OK; i++)
+        {
+            if (msg->inflight == 0U)
+            {
+                continue;
+            }
+
+            if (pr != UPLINK_OK)
+            {
+                /* 连接已断：立即允许重发，重连后以同一 messageId 补发 */
+                msg->inflight = 0U;
+                msg->next_retry_ms = now_ms;
+                uplink_uncharge_if_down(msg);
+            }
+            else if (uplink_time_is_due(now_ms, msg->ack_deadline_ms) != 0U)
+            {
+                uplink_breaker_report(0U, now_ms);
+                uplink_inflight_reschedule(u, msg, now_ms);
+                uplink_logf(u,
+                            UPLINK_LOG_WARN,
+                            "[uplink] ack timeout: id=%lu attempt=%u\r\n",
+                            (unsigned long)msg->message_id,
+                            (unsigned)msg->attempt);
+            }
+        }
+    }
+    sys_mutex_unlock(&u->mutex);
+
+    /* 3. 补发：在途数未满时，每次由调度器挑选一条已到期消息提交 */
+    for (i = 0U; i < u->transport.max_inflight; i++)
+    {
+        uplink_msg_t *msg = NULL;
+        uplink_msg_t *candidate = NULL;
+        uplink_msg_t msg_copy;
+        uint16_t inflight = 0U;
+        uint32_t now_ms;
+        size_t event_len = 0U;
+        uplink_err_t r;
+        uint16_t k;
+
+        sys_mutex_lock(&u->mutex);
+        now_ms = u->platform.now_ms(u->platform.user_ctx);
+
+        for (k = 0U; uplink_queue_at(&u->queue, k, &msg) == UPLINK_OK; k++)
+        {
+            if (msg->inflight != 0U)
+            {
+                inflight++;
+            }
+        }
+
+        if (inflight >= u->transport.max_inflight)
+        {
+            sys_mutex_unlock(&u->mutex);
+            break;
+        }
+
+        /* 超过最大尝试次数的消息在挑选时丢弃（与同步模式一致） */
+        candidate = uplink_pick_next(u, now_ms);
+        if (candidate == NULL)
+        {
+            sys_mutex_unlock(&u->mutex);
+            break;
+        }
+
+        /* 熔断中暂停提交；半开时只提交一条作为探测，由它的确认/超时决定是否恢复 */
+        if (uplink_breaker_allow(now_ms) == 0U)
+        {
+            sys_mutex_unlock(&u->mutex);
+            break;
+        }
+
+        candidate->attempt++;
+        candidate->inflight = 1U;
+        candidate->ack_deadline_ms = now_ms + u->cfg.recv_timeout_ms;
+        msg_copy = *candidate;
+        sys_mutex_unlock(&u->mutex);
+
+        r = uplink_codec_json_build_event(u->event_json,
+                                          sizeof(u->event_json),
+                                          u->cfg.device_id,
+                                          msg_copy.message_id,
+                                          msg_copy.created_ms,
+                                          msg_copy.type,
+                                          msg_copy.payload_json,
+                                          &event_len);
+        if (r == UPLINK_OK)
+        {
+            r = u->transport.submit_json(u->transport.ctx,
+                                         &u->cfg.endpoint,
+                                         &u->platform,
+                                         msg_copy.message_id,
+                                         u->event_json,
+                                         event_len,
+                                         u->cfg.send_timeout_ms);
+        }
+
+        if (r != UPLINK_OK)
+        {
+            uplink_breaker_report(0U, u->platform.now_ms(u->platform.user_ctx));
+
+            sys_mutex_lock(&u->mutex);
+            if (uplink_find_msg(u, msg_copy.message_id, &msg) != 0U)
+            {
+                uplink_inflight_reschedule(u, msg, u->platform.now_ms(u->platform.user_ctx));
+            }
+            sys_mutex_unlock(&u->mutex);
+
+            uplink_logf(u,
+                        UPLINK_LOG_WARN,
+                        "[uplink] submit failed: id=%lu err=%d attempt=%u\r\n",
+                        (unsigned long)msg_copy.message_id,
+                        (int)r,
+                        (unsigned)msg_copy.attempt);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 同步模式本次请求的接收超时（按端点 RTT 自适应）
+ *
+ * @param u uplink 上下文
+ * @param ep_index 端点下标
+ * @return uint32_t 超时（ms）
+ */
+static uint32_t uplink_recv_timeout_ms(const uplink_t *u, uint8_t ep_index)
+{
+    return uplink_failover_timeout_ms(&u->failover,
+                                      ep_index,
+                                      u->cfg.recv_timeout_ms,
+                                      UPLINK_RTO_MIN_MS,
+                                      UPLINK_RTO_MAX_MS);
+}
+
+/**
+ * @brief 取出本次同步发送的一批消息并标记在途（调用者已持锁，head 已由 uplink_pick_next 选出）
+ *
+ * @param u uplink 上下文
+ * @param head 调度器选出的第一条消息
+ * @param now_ms 当前时间（ms）
+ * @param ids 输出：消息 ID（按发送顺序）
+ * @return uint16_t 消息数（1..cfg.batch.max_events）
+ *
+ * @note 后续消息同样由 uplink_pick_next 挑选：已标记在途的不会被再次选中，
+ *       因此一批之内仍按类别权重轮转、类别内按截止时刻先后。
+ */
+static uint16_t uplink_batch_collect(uplink_t *u, uplink_msg_t *head, uint32_t now_ms, uint32_t ids[UPLINK_MAX_BATCH_EVENTS])
+{
+    uint16_t n = 0U;
+    uplink_msg_t *msg = head;
 
-    if (u->cfg.endpoint.scheme == UPLINK_SCHEME_HTTP)
+    while (msg != NULL)
     {
-        uplink_transport_http_netconn_bind(&u->transport, &u->http_ctx);
+        msg->attempt++;
+        msg->inflight = 1U;
+        ids[n++] = msg->message_id;
+
+        if (n >= (uint16_t)u->cfg.batch.max_events)
+        {
+            break;
+        }
+        msg = uplink_pick_next(u, now_ms);
+    }
+
+    return n;
+}
+
+/**
+ * @brief 撤销一条消息的在途标记（加锁）
+ *
+ * @param u uplink 上下文
+ * @param message_id 消息 ID
+ * @param delay_ms 0=本次根本没有发出，退回尝试次数、下次 poll 可立即再选；
+ *                 非 0=按失败处理，delay_ms 后重试
+ */
+static void uplink_batch_unmark(uplink_t *u, uint32_t message_id, uint32_t delay_ms)
+{
+    uplink_msg_t *msg = NULL;
+
+    sys_mutex_lock(&u->mutex);
+    if (uplink_find_msg(u, message_id, &msg) != 0U)
+    {
+        msg->inflight = 0U;
+        if (delay_ms == 0U)
+        {
+            msg->attempt--;
+        }
+        else
+        {
+            msg->next_retry_ms = u->platform.now_ms(u->platform.user_ctx) + delay_ms;
+        }
+    }
+    sys_mutex_unlock(&u->mutex);
+}
+
+/**
+ * @brief 按发送顺序逐条编码事件 JSON，拼成一路请求的 body（需要时边拼边压缩）
+ *
+ * @param u uplink 上下文（u->sending=1，不持锁）
+ * @param req 输入：ids/n 为本路消息；输出：ids/n 为实际放进 body 的消息（n=0 表示一条都没编出来），
+ *            body/body_len/plain_len 为请求 body
+ *
+ * @note 说明：
+ * - 每次只拷贝一条消息出来编码，锁内只做查找与拷贝；在途消息不会被挤掉或过期，按 ID 总能找到。
+ * - 多条时 body 为 JSON 数组 [ev,ev,...]；单条时仍是单个事件对象，与不合并时完全一致。
+ * - 编码失败的消息按重试策略延后（与原逐条发送一致）；放不下的消息退回队列，留给下一批。
+ * - event_json 与压缩器由各路依次共用，body 必须落到本路自己的缓冲里（并发发送时几路同时在途）。
+ */
+static void uplink_build_body(uplink_t *u, uplink_request_t *req)
+{
+    uint8_t as_array = (req->n > 1U) ? 1U : 0U;
+#if UPLINK_LZSS_ENABLE
+    uint8_t compress = u->cfg.batch.compress;
+#else
+    const uint8_t compress = 0U; /* 未编译压缩器，配置校验已拒绝 compress=1 */
+#endif
+    size_t plain = 0U;
+    uint16_t kept = 0U;
+    uint16_t k;
+
+    req->body_len = 0U;
+    req->plain_len = 0U;
+
+#if UPLINK_LZSS_ENABLE
+    if (compress != 0U)
+    {
+        uplink_lzss_init(&u->lzss, (uint8_t *)req->body, sizeof(req->body));
+    }
+#endif
+
+    for (k = 0U; k < req->n; k++)
+    {
+        uplink_msg_t msg_copy;
+        uplink_msg_t *msg = NULL;
+        size_t event_len = 0U;
+        size_t need;
+        uint8_t found;
+
+        sys_mutex_lock(&u->mutex);
+        found = uplink_find_msg(u, req->ids[k], &msg);
+        if (found != 0U)
+        {
+            msg_copy = *msg;
+        }
+        sys_mutex_unlock(&u->mutex);
+
+        if (found == 0U)
+        {
+            continue;
+        }
+
+        /* 编码事件 JSON（统一外层格式 + 业务 payload） */
+        if (uplink_codec_json_build_event(u->event_json,
+                                          sizeof(u->event_json),
+                                          u->cfg.device_id,
+                                          msg_copy.message_id,
+                                          msg_copy.created_ms,
+                                          msg_copy.type,
+                                          msg_copy.payload_json,
+                                          &event_len) != UPLINK_OK)
+        {
+            uplink_batch_unmark(u,
+                                req->ids[k],
+                                uplink_retry_calc_delay_ms(&u->cfg.retry,
+                                                           msg_copy.attempt,
+                                                           u->platform.rand_u32(u->platform.user_ctx)));
+            continue;
+        }
+
+        if ((as_array == 0U) && (compress == 0U))
+        {
+            (void)memcpy(req->body, u->event_json, event_len);
+            req->body_len = event_len;
+            req->plain_len = event_len;
+            req->ids[kept++] = req->ids[k];
+            break;
+        }
+
+        /* 放不下（含分隔符与结尾 ']'）：本条及之后的消息退回队列，第一条总放得下 */
+        need = event_len + ((as_array != 0U) ? 2U : 0U);
+        if ((kept != 0U) &&
+#if UPLINK_LZSS_ENABLE
+            (((compress != 0U) && (uplink_lzss_fits(&u->lzss, need) == 0U)) ||
+             ((compress == 0U) && ((plain + need) > sizeof(req->body)))))
+#else
+            ((plain + need) > sizeof(req->body)))
+#endif
+        {
+            for (; k < req->n; k++)
+            {
+                uplink_batch_unmark(u, req->ids[k], 0U);
+            }
+            break;
+        }
+
+        if (as_array != 0U)
+        {
+            char sep = (kept == 0U) ? '[' : ',';
+
+#if UPLINK_LZSS_ENABLE
+            if (compress != 0U)
+            {
+                (void)uplink_lzss_write(&u->lzss, &sep, 1U);
+            }
+            else
+#endif
+            {
+                req->body[plain] = sep;
+            }
+            plain++;
+        }
+
+#if UPLINK_LZSS_ENABLE
+        if (compress != 0U)
+        {
+            (void)uplink_lzss_write(&u->lzss, u->event_json, event_len);
+        }
+        else
+#endif
+        {
+            (void)memcpy(&req->body[plain], u->event_json, event_len);
+        }
+        plain += event_len;
+        req->ids[kept++] = req->ids[k];
+    }
+
+    req->n = kept;
+    if ((kept == 0U) || (req->body_len != 0U))
+    {
+        return;
+    }
+
+    if (as_array != 0U)
+    {
+#if UPLINK_LZSS_ENABLE
+        if (compress != 0U)
+        {
+            (void)uplink_lzss_write(&u->lzss, "]", 1U);
+        }
+        else
+#endif
+        {
+            req->body[plain] = ']';
+        }
+        plain++;
+    }
+
+    req->plain_len = plain;
+#if UPLINK_LZSS_ENABLE
+    if (compress != 0U)
+    {
+        (void)uplink_lzss_finish(&u->lzss, &req->body_len);
     }
     else
+#endif
     {
-        return UPLINK_ERR_UNSUPPORTED;
+        req->body_len = plain;
     }
+}
 
-    u->inited = 1U;
-    return UPLINK_OK;
+/**
+ * @brief 待发送消息数：热队列 + 后备队列（调用者已持锁）
+ */
+static uint32_t uplink_pending_locked(const uplink_t *u)
+{
+    uint32_t depth = uplink_queue_size(&u->queue);
+    uint8_t c;
+
+    for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+    {
+        depth += uplink_backlog_count(&u->backlog, c);
+    }
+
+    return depth;
 }
 
 /**
- * @brief 入队一条 JSON 事件（仅入队，不立即发送）
+ * @brief 本次同步发送的路数（调用者已持锁）
  *
  * @param u uplink 上下文
- * @param type 事件类型（如 `RFID_AUDIT`）
- * @param payload_json 事件 payload（JSON 子对象字符串）
- * @return uplink_err_t 入队结果
+ * @return uint8_t 1=一次一个 POST；>1=积压并发
+ *
+ * @note 熔断器不在关闭状态时只发一个：半开期间只放行一个探测请求。
  */
-uplink_err_t uplink_enqueue_json(uplink_t *u, const char *type, const char *payload_json)
+static uint8_t uplink_request_width(const uplink_t *u)
 {
-    uplink_msg_t msg;
-    uint32_t now_ms;
-    uplink_err_t r;
+    uint8_t width = u->cfg.parallel.max_requests;
 
-    if ((u == NULL) || (type == NULL))
+    if ((width <= 1U) || (u->transport.post_json_parallel == NULL))
     {
-        return UPLINK_ERR_INVALID_ARG;
+        return 1U;
     }
 
-    if (u->inited == 0U)
+    if (width > u->transport.max_parallel)
     {
-        return UPLINK_ERR_NOT_INIT;
+        width = u->transport.max_parallel;
     }
 
-    now_ms = u->platform.now_ms(u->platform.user_ctx);
+    if ((uplink_breaker_get_state() != UPLINK_BREAKER_CLOSED) ||
+        (uplink_pending_locked(u) < (uint32_t)u->cfg.parallel.threshold))
+    {
+        return 1U;
+    }
+
+    return width;
+}
+
+/**
+ * @brief 一路 POST 结束后的端点反馈：健康度与熔断上报、解析业务码、上级要求暂缓时暂缓该端点（不持锁）
+ *
+ * @param u uplink 上下文
+ * @param ep_index 端点下标
+ * @param post 本路请求；输出 ack.app_code 为业务码，ack.retry_after_ms 为实际暂缓时长（0=未要求）
+ */
+static void uplink_post_feedback(uplink_t *u, uint8_t ep_index, uplink_post_t *post)
+{
+    uint8_t healthy = ((post->ack.http_status != 0U) && (post->ack.http_status < 500U)) ? 1U : 0U;
+    uint32_t hold_ms = post->ack.retry_after_ms;
+    uint32_t body_hint = 0U;
+    int32_t code = UPLINK_APP_CODE_UNKNOWN;
 
-    (void)memset(&msg, 0, sizeof(msg));
-    msg.message_id = u->next_message_id;
-    msg.created_ms = now_ms;
-    msg.attempt = 0U;
-    msg.next_retry_ms = now_ms;
+    /* 上级有 HTTP 应答（非 5xx）即视为端点健康；4xx 是请求本身的问题，换端点也没用 */
+    uplink_failover_report(&u->failover, ep_index, healthy, post->done_ms - post->start_ms, post->done_ms);
 
-    if (uplink_copy_str_checked(msg.type, sizeof(msg.type), type) != 0U)
+    /* 熔断器只关心上级整体：还有别的端点可切换时，单个端点的失败交给 failover 处理 */
+    if ((healthy != 0U) || (uplink_failover_has_alternative(&u->failover, ep_index, post->done_ms) == 0U))
     {
-        return UPLINK_ERR_BUFFER_TOO_SMALL;
+        uplink_breaker_report(healthy, post->done_ms);
+    }
+    else
+    {
+        /* 不记失败，但若这次是半开探测，归还名额，下一次换端点后立即探测 */
+        uplink_breaker_release();
     }
 
-    if (uplink_copy_str_checked(msg.payload_json, sizeof(msg.payload_json), payload_json) != 0U)
+    /* 解析响应业务码 */
+    (void)uplink_codec_json_parse_app_code(post->body, post->body_len, &code);
+    post->ack.app_code = code;
+
+    /* 上级给出暂缓时长（Retry-After 头或 body 的 retryAfterMs，取较大者）：
+     * 暂缓该端点，并只往后加抖动，避免一批设备在同一时刻一起回来 */
+    if ((uplink_codec_json_parse_u32(post->body, post->body_len, "retryAfterMs", &body_hint) == UPLINK_OK) &&
+        (body_hint > hold_ms))
     {
-        return UPLINK_ERR_BUFFER_TOO_SMALL;
+        hold_ms = body_hint;
+    }
+    if (hold_ms != 0U)
+    {
+        uint32_t spread = (hold_ms / 100U) * (uint32_t)u->cfg.retry.jitter_pct;
+        if (spread != 0U)
+        {
+            hold_ms += u->platform.rand_u32(u->platform.user_ctx) % (spread + 1U);
+        }
+        uplink_failover_hold(&u->failover, ep_index, hold_ms, post->done_ms);
     }
+    post->ack.retry_after_ms = hold_ms;
+}
+
+/**
+ * @brief 按一路 POST 的应答确认或安排重试本路携带的消息（调用者已持锁）
+ *
+ * @param u uplink 上下文
+ * @param req 本路请求（ids/n/body 长度）
+ * @param post 本路应答（已经过 uplink_post_feedback）
+ * @param retry 失败时使用的重试策略
+ * @param now_ms 当前时间（ms）
+ *
+ * @note 判定成功：HTTP 2xx 且（code==0 或 code 缺失）；一路之内整批成功或整批按失败重试。
+ */
+static void uplink_post_complete(uplink_t *u,
+                                 const uplink_request_t *req,
+                                 const uplink_post_t *post,
+                                 const uplink_retry_policy_t *retry,
+                                 uint32_t now_ms)
+{
+    const uplink_ack_t *ack = &post->ack;
+    uint8_t http_ok = (ack->http_status >= 200U && ack->http_status < 300U) ? 1U : 0U;
+    uint8_t app_ok = ((ack->app_code == 0) || (ack->app_code == UPLINK_APP_CODE_UNKNOWN)) ? 1U : 0U;
+    uint8_t success = (http_ok != 0U && app_ok != 0U) ? 1U : 0U;
+    uplink_msg_t *msg = NULL;
+    uint16_t k;
+
+    u->stats.posts++;
+    if (ack->retry_after_ms != 0U)
+    {
+        u->stats.server_holds++;
+    }
+    u->stats.body_plain_bytes += (uint32_t)req->plain_len;
+    u->stats.body_wire_bytes += (uint32_t)req->body_len;
+
+    for (k = 0U; k < req->n; k++)
+    {
+        if (uplink_find_msg(u, req->ids[k], &msg) == 0U)
+        {
+            continue;
+        }
+
+        if (success != 0U)
+        {
+            uplink_msg_delivered(u, req->ids[k], now_ms);
+        }
+        else
+        {
+            uint32_t delay = uplink_retry_calc_delay_ms(retry,
+                                                        msg->attempt,
+                                                        u->platform.rand_u32(u->platform.user_ctx));
+
+            /* 上级要求暂缓：至少等到暂缓结束，且这次不算一次失败尝试 */
+            if (ack->retry_after_ms != 0U)
+            {
+                if (delay < ack->retry_after_ms)
+                {
+                    delay = ack->retry_after_ms;
+                }
+                if (msg->attempt > 0U)
+                {
+                    msg->attempt--;
+                }
+            }
+            msg->inflight = 0U;
+            msg->next_retry_ms = now_ms + delay;
+
+            if (k == 0U)
+            {
+                uplink_logf(u,
+                            UPLINK_LOG_WARN,
+                            "[uplink] send failed: http=%u code=%ld events=%u attempt=%u next_delay=%lu ms\r\n",
+                            (unsigned)ack->http_status,
+                            (long)ack->app_code,
+                            (unsigned)req->n,
+                            (unsigned)msg->attempt,
+                            (unsigned long)delay);
+            }
+            uplink_uncharge_if_down(msg);
+        }
+    }
+}
+
+/**
+ * @brief 申请消息 ID 纪元：本纪元序号快用完时预申请下一个，停发中时重试（在 uplink_poll 开头、持锁之前调用）
+ *
+ * @param u uplink 上下文
+ * @param now_ms 当前时间（ms）
+ *
+ * @note 说明：
+ * - 纪元回调可能擦写 flash（最长一次扇区擦除），只在锁外调用；锁内的 uplink_msgid_next 只做切换，
+ *   入队路径不会因为申请纪元而阻塞。
+ * - 申请失败后每 UPLINK_MSGID_RETRY_MS 重试一次；失败与恢复各记一条日志。
+ */
+static void uplink_epoch_prefetch(uplink_t *u, uint32_t now_ms)
+{
+    uint8_t due;
+    uint32_t epoch;
+    uint32_t retry_ms;
 
-    /* 队列并发访问需加锁：业务入队与 poll 会并发操作队列 */
     sys_mutex_lock(&u->mutex);
+    due = uplink_msgid_epoch_due(&u->msgid);
+    retry_ms = u->epoch_retry_ms;
+    sys_mutex_unlock(&u->mutex);
 
-    msg.message_id = u->next_message_id++;
-    r = uplink_queue_push(&u->queue, &msg);
+    if ((due == 0U) || ((retry_ms != 0U) && ((int32_t)(now_ms - retry_ms) < 0)))
+    {
+        return;
+    }
+
+    epoch = u->platform.id_epoch(u->platform.user_ctx);
 
+    sys_mutex_lock(&u->mutex);
+    uplink_msgid_epoch_put(&u->msgid, epoch);
+    u->epoch_retry_ms = (epoch == 0U) ? ((now_ms + UPLINK_MSGID_RETRY_MS) | 1U) : 0U;
     sys_mutex_unlock(&u->mutex);
 
-    return r;
+    if ((epoch == 0U) && (retry_ms == 0U))
+    {
+        uplink_logf(u, UPLINK_LOG_ERROR, "[uplink] msgid epoch claim failed (%lu so far)\r\n", (unsigned long)u->msgid.claim_failures);
+    }
+    else if ((epoch != 0U) && (retry_ms != 0U))
+    {
+        uplink_logf(u, UPLINK_LOG_WARN, "[uplink] msgid epoch claimed after %lu failures\r\n", (unsigned long)u->msgid.claim_failures);
+    }
 }
 
 /**
@@ -258,18 +1559,29 @@ uplink_err_t uplink_enqueue_json(uplink_t *u, const char *type, const char *payl
  *
  * @note
  * - 建议在独立任务中周期调用（如 50~200ms）。
- * - 每次最多尝试发送队头 1 条，避免长时间阻塞。
+ * - 同步模式：每次发送一个 POST（由调度器按优先级加权公平挑选），避免长时间阻塞；
+ *   cfg.batch.max_events>1 时一个 POST 携带多条到期消息，整批成功或整批按失败重试。
+ * - 积压达到 cfg.parallel.threshold 时一次同时发出最多 cfg.parallel.max_requests 个 POST（各用一条连接），
+ *   各路按自己的应答确认或重试，互不影响；全部结束后本次 poll 才返回。
+ * - 同步模式的接收超时按端点 RTT 自适应（见 uplink_failover_timeout_ms），cfg.recv_timeout_ms 仅作初始值。
+ * - 与鉴权共享熔断器（uplink_breaker）：熔断期间暂停发送，消息留在队列里不消耗尝试次数。
+ * - 上级过载时按其给出的暂缓时长（Retry-After / retryAfterMs）暂停向该端点发送，同样不消耗尝试次数；
+ *   异步流水模式（MQTT）没有应答头与 body，不处理暂缓。
+ * - 消息 ID 的下一个纪元也在这里（锁外）预申请，申请失败时在这里重试，见 uplink_epoch_prefetch()。
+ * - 异步流水模式：见 uplink_poll_pipelined()。
  */
 void uplink_poll(uplink_t *u)
 {
     uplink_msg_t *head = NULL;
-    uplink_msg_t msg_copy;
+    uplink_retry_policy_t retry; /* 本次失败使用的重试策略（基础间隔按端点 RTO 抬高） */
+    uint8_t used[UPLINK_MAX_PARALLEL]; /* 实际发出的各路对应的 requests[] 下标 */
+    uint8_t width;
+    uint8_t taken = 0U;
+    uint8_t count = 0U;
+    uint8_t w;
+    uint8_t ep_index = 0U;
+    uint32_t switches;
     uint32_t now_ms;
-    uint16_t next_attempt;
-
-    uplink_ack_t ack;
-    size_t body_len = 0U;
-    size_t event_len = 0U;
 
     if ((u == NULL) || (u->inited == 0U))
     {
@@ -278,6 +1590,8 @@ void uplink_poll(uplink_t *u)
 
     now_ms = u->platform.now_ms(u->platform.user_ctx);
 
+    uplink_epoch_prefetch(u, now_ms);
+
     /* 锁内只做队列与状态判断，避免长时间占锁 */
     sys_mutex_lock(&u->mutex);
 
@@ -287,135 +1601,176 @@ void uplink_poll(uplink_t *u)
         return;
     }
 
-    if (uplink_queue_peek(&u->queue, &head) != UPLINK_OK || head == NULL)
+    /* 异步流水模式：transport 支持多条在途时走独立流程 */
+    if (u->transport.submit_json != NULL)
     {
+        u->sending = 1U;
+        sys_mutex_unlock(&u->mutex);
+
+        uplink_poll_pipelined(u);
+
+        sys_mutex_lock(&u->mutex);
+        u->sending = 0U;
         sys_mutex_unlock(&u->mutex);
         return;
     }
 
-    if (uplink_time_is_due(now_ms, head->next_retry_ms) == 0U)
+    head = uplink_pick_next(u, now_ms);
+    if (head == NULL)
     {
         sys_mutex_unlock(&u->mutex);
         return;
     }
 
-    next_attempt = (uint16_t)(head->attempt + 1U);
-
-    if (uplink_retry_is_attempt_allowed(&u->cfg.retry, next_attempt) == 0U)
+    /* 先选出真正要发往的端点，再看它是否要求暂缓（Retry-After）：截止前整个队列都不发，不消耗尝试次数 */
+    switches = u->failover.switches;
+    if (uplink_failover_pick_sendable(&u->failover, now_ms, &ep_index) != 0U)
     {
-        (void)uplink_queue_pop(&u->queue);
         sys_mutex_unlock(&u->mutex);
         return;
     }
 
-    head->attempt = next_attempt;
-    msg_copy = *head;
-    u->sending = 1U;
-
-    sys_mutex_unlock(&u->mutex);
+    /*
+     * 熔断中：暂停发送，不消耗尝试次数；熔断到期后这条消息可能成为探测请求。
+     * 放在暂缓检查之后：allow 放行即占用半开探测名额，之后必须真正发出并上报结果。
+     */
+    if (uplink_breaker_allow(now_ms) == 0U)
+    {
+        sys_mutex_unlock(&u->mutex);
+        return;
+    }
 
-    /* 编码事件 JSON（统一外层格式 + 业务 payload） */
-    if (uplink_codec_json_build_event(u->event_json,
-                                      sizeof(u->event_json),
-                                      u->cfg.device_id,
-                                      msg_copy.message_id,
-                                      msg_copy.created_ms,
-                                      msg_copy.type,
-                                      msg_copy.payload_json,
-                                      &event_len) != UPLINK_OK)
+    /* 每一路各取一批并标记在途：入队准入不会挤掉正在发送的消息，下一路也不会再选中它们 */
+    width = uplink_request_width(u);
+    while (head != NULL)
     {
-        sys_mutex_lock(&u->mutex);
-        u->sending = 0U;
-        if (uplink_queue_peek(&u->queue, &head) == UPLINK_OK && head != NULL &&
-            head->message_id == msg_copy.message_id)
+        u->requests[taken].n = uplink_batch_collect(u, head, now_ms, u->requests[taken].ids);
+        taken++;
+        if (taken >= width)
         {
-            uint32_t delay = uplink_retry_calc_delay_ms(&u->cfg.retry,
-                                                        msg_copy.attempt,
-                                                        u->platform.rand_u32(u->platform.user_ctx));
-            head->next_retry_ms = u->platform.now_ms(u->platform.user_ctx) + delay;
+            break;
         }
-        sys_mutex_unlock(&u->mutex);
-        return;
+        head = uplink_pick_next(u, now_ms);
     }
+    u->sending = 1U;
 
-    /* 通过 transport 层发送 HTTP POST */
-    (void)memset(&ack, 0, sizeof(ack));
-    ack.app_code = UPLINK_APP_CODE_UNKNOWN;
-    (void)memset(u->response_body, 0, sizeof(u->response_body));
+    sys_mutex_unlock(&u->mutex);
 
+    /* 编码各路请求 body（单条事件对象，或多条合并的 JSON 数组；需要时压缩）；一条都没编出来的路不发 */
+    for (w = 0U; w < taken; w++)
     {
-        uplink_err_t tr = u->transport.post_json(u->transport.ctx,
-                                                 &u->cfg.endpoint,
-                                                 &u->platform,
-                                                 u->event_json,
-                                                 event_len,
-                                                 u->cfg.send_timeout_ms,
-                                                 u->cfg.recv_timeout_ms,
-                                                 &ack,
-                                                 u->response_body,
-                                                 sizeof(u->response_body),
-                                                 &body_len);
+        uplink_request_t *req = &u->requests[w];
+        uplink_post_t *post;
 
-        if (tr != UPLINK_OK)
+        uplink_build_body(u, req);
+        if (req->n == 0U)
         {
-            ack.http_status = (ack.http_status == 0U) ? 0U : ack.http_status;
+            continue;
         }
+
+        post = &u->posts[count];
+        (void)memset(post, 0, sizeof(*post));
+        post->json = req->body;
+        post->json_len = req->body_len;
+        post->body = req->response;
+        post->body_cap = sizeof(req->response);
+        post->ack.app_code = UPLINK_APP_CODE_UNKNOWN;
+        req->response[0] = '\0';
+        used[count++] = w;
     }
 
-    /* 解析响应业务码 */
+    if (count == 0U)
     {
-        int32_t code = UPLINK_APP_CODE_UNKNOWN;
-        (void)uplink_codec_json_parse_app_code(u->response_body, body_len, &code);
-        ack.app_code = code;
+        /* 没有发出请求：归还可能领到的探测名额 */
+        uplink_breaker_release();
+        sys_mutex_lock(&u->mutex);
+        u->sending = 0U;
+        sys_mutex_unlock(&u->mutex);
+        return;
     }
 
-    /* 判定成功：HTTP 2xx 且（code==0 或 code 缺失） */
+    /* 通过 transport 层发送 HTTP POST（各路发往同一端点） */
+    retry = u->cfg.retry;
     {
-        uint8_t http_ok = (ack.http_status >= 200U && ack.http_status < 300U) ? 1U : 0U;
-        uint8_t app_ok = ((ack.app_code == 0) || (ack.app_code == UPLINK_APP_CODE_UNKNOWN)) ? 1U : 0U;
-        uint8_t success = (http_ok != 0U && app_ok != 0U) ? 1U : 0U;
+        const uplink_endpoint_t *ep = uplink_failover_endpoint(&u->failover, ep_index);
+        uint32_t recv_to = uplink_recv_timeout_ms(u, ep_index);
 
-        sys_mutex_lock(&u->mutex);
-        u->sending = 0U;
+        if (u->failover.switches != switches)
+        {
+            uplink_logf(u, UPLINK_LOG_WARN, "[uplink] switch to endpoint #%u %s:%u\r\n",
+                        (unsigned)ep_index, ep->host, (unsigned)ep->port);
+        }
 
-        if (uplink_queue_peek(&u->queue, &head) == UPLINK_OK && head != NULL &&
-            head->message_id == msg_copy.message_id)
+        if (count == 1U)
         {
-            if (success != 0U)
-            {
-                (void)uplink_queue_pop(&u->queue);
-            }
-            else
-            {
-                uint32_t delay = uplink_retry_calc_delay_ms(&u->cfg.retry,
-                                                            msg_copy.attempt,
-                                                            u->platform.rand_u32(u->platform.user_ctx));
-                uint32_t now2 = u->platform.now_ms(u->platform.user_ctx);
-                head->next_retry_ms = now2 + delay;
+            uplink_post_t *post = &u->posts[0];
+
+            post->start_ms = u->platform.now_ms(u->platform.user_ctx);
+            post->result = u->transport.post_json(u->transport.ctx,
+                                                  ep,
+                                                  &u->platform,
+                                                  post->json,
+                                                  post->json_len,
+                                                  u->cfg.send_timeout_ms,
+                                                  recv_to,
+                                                  &post->ack,
+                                                  post->body,
+                                                  post->body_cap,
+                                                  &post->body_len);
+            post->done_ms = u->platform.now_ms(u->platform.user_ctx);
+        }
+        else
+        {
+            u->transport.post_json_parallel(u->transport.ctx,
+                                            ep,
+                                            &u->platform,
+                                            u->posts,
+                                            count,
+                                            u->cfg.send_timeout_ms,
+                                            recv_to);
+        }
 
-                uplink_logf(u,
-                            UPLINK_LOG_WARN,
-                            "[uplink] send failed: http=%u code=%ld attempt=%u next_delay=%lu ms\r\n",
-                            (unsigned)ack.http_status,
-                            (long)ack.app_code,
-                            (unsigned)msg_copy.attempt,
-                            (unsigned long)delay);
+        for (w = 0U; w < count; w++)
+        {
+            uplink_post_feedback(u, ep_index, &u->posts[w]);
+        }
+
+        /* 重试间隔不短于该端点当前 RTO（含失败退避）：上级变慢时不以固定节奏反复压上去 */
+        recv_to = uplink_recv_timeout_ms(u, ep_index);
+        if (retry.base_delay_ms < recv_to)
+        {
+            retry.base_delay_ms = recv_to;
+            if (retry.max_delay_ms < recv_to)
+            {
+                retry.max_delay_ms = recv_to;
             }
         }
+    }
 
-        sys_mutex_unlock(&u->mutex);
+    /* 各路按自己的应答确认或安排重试 */
+    sys_mutex_lock(&u->mutex);
+    now_ms = u->platform.now_ms(u->platform.user_ctx);
+    for (w = 0U; w < count; w++)
+    {
+        uplink_post_complete(u, &u->requests[used[w]], &u->posts[w], &retry, now_ms);
+    }
+    if (count > 1U)
+    {
+        u->stats.parallel_posts += count;
     }
+    u->sending = 0U;
+    sys_mutex_unlock(&u->mutex);
 }
 
 /**
  * @brief 获取当前队列深度
  *
  * @param u uplink 上下文
- * @return uint16_t 当前待发送消息数
+ * @return uint16_t 当前待发送消息数（热队列 + 后备队列，超过 0xFFFF 时按 0xFFFF 计）
  */
 uint16_t uplink_get_queue_depth(uplink_t *u)
 {
-    uint16_t depth = 0U;
+    uint32_t depth = 0U;
 
     if ((u == NULL) || (u->inited == 0U))
     {
@@ -423,8 +1778,40 @@ uint16_t uplink_get_queue_depth(uplink_t *u)
     }
 
     sys_mutex_lock(&u->mutex);
-    depth = uplink_queue_size(&u->queue);
+    depth = uplink_pending_locked(u);
     sys_mutex_unlock(&u->mutex);
 
-    return depth;
+    return (depth > 0xFFFFU) ? 0xFFFFU : (uint16_t)depth;
+}
+
+/**
+ * @brief 读取各优先级类别的累计统计
+ *
+ * @param u uplink 上下文
+ * @param out_stats 输出：统计快照
+ */
+void uplink_get_stats(uplink_t *u, uplink_stats_t *out_stats)
+{
+    if ((u == NULL) || (out_stats == NULL))
+    {
+        return;
+    }
+
+    if (u->inited == 0U)
+    {
+        (void)memset(out_stats, 0, sizeof(*out_stats));
+        return;
+    }
+
+    sys_mutex_lock(&u->mutex);
+    *out_stats = u->stats;
+    out_stats->id_claim_failures = u->msgid.claim_failures;
+    {
+        uint8_t c;
+        for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+        {
+            out_stats->backlog_depth[c] = uplink_backlog_count(&u->backlog, c);
+        }
+    }
+    sys_mutex_unlock(&u->mutex);
 }
@@ -0,0 +1,312 @@
+/**
+ * @file    uplink_backlog.c
+ * @author  Yukikaze
+ * @brief   Uplink 外部 SDRAM 后备队列实现（队列层）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note 说明：
+ * - 每个类别一个定长环形队列，槽位直接存放 uplink_msg_t，不使用动态内存。
+ * - 内存区按类别顺序切分，起始地址按 4 字节对齐；内存区内容不需要预先清零。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_backlog.h"
+
+#include <string.h>
+
+/**
+ * @brief 取类别对应的环形队列
+ *
+ * @return uplink_backlog_ring_t* 环形队列；类别非法返回 NULL
+ */
+static uplink_backlog_ring_t *uplink_backlog_ring(uplink_backlog_t *b, uint8_t prio)
+{
+    if ((b == NULL) || (prio >= (uint8_t)UPLINK_PRIO_COUNT))
+    {
+        return NULL;
+    }
+
+    return &b->rings[prio];
+}
+
+/**
+ * @brief 环形下标 + 偏移（不取模，避免 32 位除法）
+ */
+static uint32_t uplink_backlog_index(const uplink_backlog_ring_t *r, uint32_t offset)
+{
+    uint32_t i = r->head + offset;
+
+    return (i >= r->capacity) ? (i - r->capacity) : i;
+}
+
+/**
+ * @brief 初始化后备队列，把内存区按类别切分
+ *
+ * @param b 后备队列
+ * @param mem 内存区起始地址（NULL 或 size 过小时所有类别容量为 0，相当于不启用）
+ * @param size 内存区大小（字节）
+ * @param share_pct 各类别占内存区的百分比（下标为 uplink_prio_t，总和不超过 100）
+ *
+ * @note 只记录地址与容量，不访问内存区。
+ */
+void uplink_backlog_init(uplink_backlog_t *b, void *mem, uint32_t size, const uint8_t share_pct[UPLINK_PRIO_COUNT])
+{
+    uintptr_t addr;
+    uint32_t total;
+    uint8_t c;
+
+    if (b == NULL)
+    {
+        return;
+    }
+
+    (void)memset(b, 0, sizeof(*b));
+
+    if ((mem == NULL) || (share_pct == NULL))
+    {
+        return;
+    }
+
+    /* 起始地址按 4 字节对齐（uplink_msg_t 只含 32 位及以下的成员） */
+    addr = ((uintptr_t)mem + 3U) & ~(uintptr_t)3U;
+    if ((uint32_t)(addr - (uintptr_t)mem) >= size)
+    {
+        return;
+    }
+    size -= (uint32_t)(addr - (uintptr_t)mem);
+    total = size / (uint32_t)sizeof(uplink_msg_t);
+
+    for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+    {
+        uplink_backlog_ring_t *r = &b->rings[c];
+
+        r->capacity = (total * (uint32_t)share_pct[c]) / 100U;
+        r->slots = (r->capacity != 0U) ? (uplink_msg_t *)addr : NULL;
+        addr += (uintptr_t)r->capacity * sizeof(uplink_msg_t);
+    }
+}
+
+/**
+ * @brief 类别的后备队列容量
+ *
+ * @return uint32_t 槽位数（0=不使用后备队列）
+ */
+uint32_t uplink_backlog_capacity(const uplink_backlog_t *b, uint8_t prio)
+{
+    if ((b == NULL) || (prio >= (uint8_t)UPLINK_PRIO_COUNT))
+    {
+        return 0U;
+    }
+
+    return b->rings[prio].capacity;
+}
+
+/**
+ * @brief 类别的后备队列当前消息数
+ *
+ * @return uint32_t 消息数
+ */
+uint32_t uplink_backlog_count(const uplink_backlog_t *b, uint8_t prio)
+{
+    if ((b == NULL) || (prio >= (uint8_t)UPLINK_PRIO_COUNT))
+    {
+        return 0U;
+    }
+
+    return b->rings[prio].count;
+}
+
+/**
+ * @brief 在类别后备队列尾部占用一个槽位（不拷贝，由调用者就地填写）
+ *
+ * @param b 后备队列
+ * @param prio 类别
+ * @param out_slot 输出：槽位指针（内容未初始化）
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：成功
+ * - UPLINK_ERR_QUEUE_FULL：已满（或本类别不使用后备队列）
+ * - UPLINK_ERR_INVALID_ARG：参数非法
+ *
+ * @note 调用者填写的 message_id 必须大于本队列中已有的所有消息（新分配的 ID 自然满足）。
+ */
+uplink_err_t uplink_backlog_push_slot(uplink_backlog_t *b, uint8_t prio, uplink_msg_t **out_slot)
+{
+    uplink_backlog_ring_t *r = uplink_backlog_ring(b, prio);
+
+    if ((r == NULL) || (out_slot == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (r->count >= r->capacity)
+    {
+        return UPLINK_ERR_QUEUE_FULL;
+    }
+
+    *out_slot = &r->slots[uplink_backlog_index(r, r->count)];
+    r->count++;
+
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 把一条消息放回其类别后备队列的队头（拷贝）
+ *
+ * @param b 后备队列
+ * @param msg 消息（类别取 msg->prio；message_id 必须小于本队列中已有的所有消息）
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：成功
+ * - UPLINK_ERR_QUEUE_FULL：已满（或本类别不使用后备队列）
+ * - UPLINK_ERR_INVALID_ARG：参数非法
+ */
+uplink_err_t uplink_backlog_push_front(uplink_backlog_t *b, const uplink_msg_t *msg)
+{
+    uplink_backlog_ring_t *r;
+
+    if (msg == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    r = uplink_backlog_ring(b, msg->prio);
+    if (r == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (r->count >= r->capacity)
+    {
+        return UPLINK_ERR_QUEUE_FULL;
+    }
+
+    r->head = (r->head == 0U) ? (r->capacity - 1U) : (r->head - 1U);
+    r->slots[r->head] = *msg;
+    r->count++;
+
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 查看类别后备队列的队头（最旧）消息
+ *
+ * @param b 后备队列
+ * @param prio 类别
+ * @param out_msg 输出：消息指针（仍在队列中）
+ * @return uplink_err_t 结果（UPLINK_ERR_QUEUE_EMPTY=没有消息）
+ */
+uplink_err_t uplink_backlog_peek(uplink_backlog_t *b, uint8_t prio, uplink_msg_t **out_msg)
+{
+    uplink_backlog_ring_t *r = uplink_backlog_ring(b, prio);
+
+    if ((r == NULL) || (out_msg == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (r->count == 0U)
+    {
+        return UPLINK_ERR_QUEUE_EMPTY;
+    }
+
+    *out_msg = &r->slots[r->head];
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 移除类别后备队列的队头消息
+ *
+ * @return uplink_err_t 结果（UPLINK_ERR_QUEUE_EMPTY=没有消息）
+ */
+uplink_err_t uplink_backlog_pop(uplink_backlog_t *b, uint8_t prio)
+{
+    uplink_backlog_ring_t *r = uplink_backlog_ring(b, prio);
+
+    if (r == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (r->count == 0U)
+    {
+        return UPLINK_ERR_QUEUE_EMPTY;
+    }
+
+    r->head = uplink_backlog_index(r, 1U);
+    r->count--;
+
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 移除类别后备队列的队尾消息（撤销刚占用的槽位）
+ *
+ * @return uplink_err_t 结果（UPLINK_ERR_QUEUE_EMPTY=没有消息）
+ */
+uplink_err_t uplink_backlog_drop_tail(uplink_backlog_t *b, uint8_t prio)
+{
+    uplink_backlog_ring_t *r = uplink_backlog_ring(b, prio);
+
+    if (r == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (r->count == 0U)
+    {
+        return UPLINK_ERR_QUEUE_EMPTY;
+    }
+
+    r->count--;
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 按 message_id 在所有类别的后备队列中查找消息
+ *
+ * @param b 后备队列
+ * @param message_id 消息 ID
+ * @return uplink_msg_t* 找到的消息（仍在队列中）；没有返回 NULL
+ *
+ * @note 每个队列内 ID 单调递增（见文件头说明），按 32 位回绕比较做二分查找，数千条也只需十几次比较。
+ */
+uplink_msg_t *uplink_backlog_find(uplink_backlog_t *b, uint32_t message_id)
+{
+    uint8_t c;
+
+    if (b == NULL)
+    {
+        return NULL;
+    }
+
+    for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+    {
+        uplink_backlog_ring_t *r = &b->rings[c];
+        uint32_t lo = 0U;
+        uint32_t hi = r->count;
+
+        while (lo < hi)
+        {
+            uint32_t mid = lo + ((hi - lo) / 2U);
+            uplink_msg_t *msg = &r->slots[uplink_backlog_index(r, mid)];
+            int32_t d = (int32_t)(msg->message_id - message_id);
+
+            if (d == 0)
+            {
+                return msg;
+            }
+            if (d < 0)
+            {
+                lo = mid + 1U;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+    }
+
+    return NULL;
+}
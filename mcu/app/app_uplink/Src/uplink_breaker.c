@@ -0,0 +1,184 @@
+/**
+ * @file    uplink_breaker.c
+ * @author  Yukikaze
+ * @brief   上级健康熔断器（工具层，鉴权与上报共享）实现
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 状态是模块内静态变量，无需初始化（全 0 即 CLOSED）。
+ * - 时间比较使用 (int32_t)(a - b)，sys_now() 回绕后仍然正确。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_breaker.h"
+
+/* lwIP 头文件 */
+#include "sys.h"
+
+/**
+ * 内部类型/变量
+ */
+typedef struct
+{
+    uplink_breaker_state_t state;
+    uint16_t fail_streak;    /* CLOSED：连续失败次数 */
+    uint32_t open_ms;        /* 本轮熔断时长 */
+    uint32_t open_until_ms;  /* OPEN：熔断截止时刻 */
+    uint8_t probe_inflight;  /* HALF_OPEN：探测请求是否已放出 */
+    uint32_t probe_since_ms; /* HALF_OPEN：探测请求放出时刻 */
+    uplink_breaker_stats_t stats;
+} uplink_breaker_t;
+
+static uplink_breaker_t g_breaker;
+
+/**
+ * @brief 进入 OPEN（调用者需已进入临界区）
+ */
+static void uplink_breaker_trip(uint32_t now_ms)
+{
+    if (g_breaker.open_ms == 0U)
+    {
+        g_breaker.open_ms = UPLINK_BREAKER_OPEN_BASE_MS;
+    }
+
+    g_breaker.state = UPLINK_BREAKER_OPEN;
+    g_breaker.open_until_ms = now_ms + g_breaker.open_ms;
+    g_breaker.probe_inflight = 0U;
+    g_breaker.stats.opens++;
+}
+
+/**
+ * @brief 请求前询问是否放行
+ *
+ * @param now_ms 当前时间（毫秒）
+ * @return uint8_t 1=放行（HALF_OPEN 时表示本次请求就是探测，必须 report）；0=拒绝，直接按上级不可用处理
+ */
+uint8_t uplink_breaker_allow(uint32_t now_ms)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+    uint8_t allow = 0U;
+
+    SYS_ARCH_PROTECT(lev);
+
+    if ((g_breaker.state == UPLINK_BREAKER_OPEN) && ((int32_t)(now_ms - g_breaker.open_until_ms) >= 0))
+    {
+        g_breaker.state = UPLINK_BREAKER_HALF_OPEN;
+        g_breaker.probe_inflight = 0U;
+    }
+
+    if (g_breaker.state == UPLINK_BREAKER_CLOSED)
+    {
+        allow = 1U;
+    }
+    else if ((g_breaker.state == UPLINK_BREAKER_HALF_OPEN) &&
+             ((g_breaker.probe_inflight == 0U) ||
+              ((uint32_t)(now_ms - g_breaker.probe_since_ms) >= UPLINK_BREAKER_PROBE_TIMEOUT_MS)))
+    {
+        /* 只放一个探测请求，其余请求继续快速失败，直到探测有结论 */
+        g_breaker.probe_inflight = 1U;
+        g_breaker.probe_since_ms = now_ms;
+        g_breaker.stats.probes++;
+        allow = 1U;
+    }
+    else
+    {
+        g_breaker.stats.rejected++;
+    }
+
+    SYS_ARCH_UNPROTECT(lev);
+    return allow;
+}
+
+/**
+ * @brief 反馈一次请求结果
+ *
+ * @param ok 1=上级有应答（非 5xx）；0=超时/断开/5xx
+ * @param now_ms 当前时间（毫秒）
+ *
+ * @note 说明：
+ * - 任何成功都说明上级可达：立即回到 CLOSED，并把熔断时长复位。
+ * - OPEN 期间到达的失败（熔断前已放出的请求）不再延长熔断。
+ */
+void uplink_breaker_report(uint8_t ok, uint32_t now_ms)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+
+    if (ok != 0U)
+    {
+        g_breaker.state = UPLINK_BREAKER_CLOSED;
+        g_breaker.fail_streak = 0U;
+        g_breaker.open_ms = 0U;
+        g_breaker.probe_inflight = 0U;
+    }
+    else if (g_breaker.state == UPLINK_BREAKER_HALF_OPEN)
+    {
+        /* 探测失败：熔断时长翻倍 */
+        g_breaker.open_ms = (g_breaker.open_ms >= (UPLINK_BREAKER_OPEN_MAX_MS / 2U)) ? UPLINK_BREAKER_OPEN_MAX_MS
+                                                                                     : (g_breaker.open_ms * 2U);
+        uplink_breaker_trip(now_ms);
+    }
+    else if (g_breaker.state == UPLINK_BREAKER_CLOSED)
+    {
+        if (g_breaker.fail_streak < 0xFFFFU)
+        {
+            g_breaker.fail_streak++;
+        }
+        if (g_breaker.fail_streak >= UPLINK_BREAKER_FAIL_THRESHOLD)
+        {
+            g_breaker.fail_streak = 0U;
+            uplink_breaker_trip(now_ms);
+        }
+    }
+
+    SYS_ARCH_UNPROTECT(lev);
+}
+
+/**
+ * @brief 放弃已领到的放行但没有发出请求（例如编码失败），不反馈结果
+ *
+ * @note HALF_OPEN 时归还探测名额，下一个请求可以立即探测，不必等 UPLINK_BREAKER_PROBE_TIMEOUT_MS。
+ */
+void uplink_breaker_release(void)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    if (g_breaker.state == UPLINK_BREAKER_HALF_OPEN)
+    {
+        g_breaker.probe_inflight = 0U;
+    }
+    SYS_ARCH_UNPROTECT(lev);
+}
+
+/**
+ * @brief 读取当前状态（供 UI 显示）
+ *
+ * @return uplink_breaker_state_t 状态；OPEN 到期但还没有请求来探测时仍返回 OPEN
+ */
+uplink_breaker_state_t uplink_breaker_get_state(void)
+{
+    return g_breaker.state;
+}
+
+/**
+ * @brief 读取熔断器统计
+ *
+ * @param out_stats 输出：统计快照
+ */
+void uplink_breaker_get_stats(uplink_breaker_stats_t *out_stats)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    if (out_stats == NULL)
+    {
+        return;
+    }
+
+    SYS_ARCH_PROTECT(lev);
+    *out_stats = g_breaker.stats;
+    SYS_ARCH_UNPROTECT(lev);
+}
@@ -6,16 +6,255 @@
  * @date    2026-03-02
  *
  * @note
- * - 编码职责：把内部消息封装成标准事件 JSON。
+ * - 编码职责：把内部消息封装成标准事件 JSON；提供无分配 JSON 写入器供各业务载荷复用。
  * - 解码职责：从响应 body 中解析业务 code。
  */
 
 #include "uplink_codec_json.h"
 
 #include <ctype.h>
-#include <stdio.h>
 #include <string.h>
 
+/* 事件外层字段表（顺序即输出顺序） */
+#define UPLINK_EVENT_FIELDS(X)    \
+    X(str, deviceId, device_id)   \
+    X(u32, messageId, message_id) \
+    X(u32, ts, ts_ms)             \
+    X(str, type, type)            \
+    X(json, payload, payload_json)
+
+UPLINK_JSON_SCHEMA_DEFINE(uplink_event_json, UPLINK_EVENT_FIELDS)
+
+/**
+ * @brief 初始化写入器
+ *
+ * @param w 写入器
+ * @param buf 输出缓冲
+ * @param cap 输出缓冲容量（含结尾 '\0'）
+ */
+void uplink_json_writer_init(uplink_json_writer_t *w, char *buf, size_t cap)
+{
+    w->buf = buf;
+    w->cap = cap;
+    w->len = 0U;
+    w->fields = 0U;
+    w->overflow = ((buf == NULL) || (cap == 0U)) ? 1U : 0U;
+    if (w->overflow == 0U)
+    {
+        buf[0] = '\0';
+    }
+}
+
+/**
+ * @brief 追加 n 个字节（放不下时写满剩余空间并置 overflow）
+ */
+static void uplink_json_put_bytes(uplink_json_writer_t *w, const char *s, size_t n)
+{
+    size_t room;
+
+    if (w->overflow != 0U)
+    {
+        return;
+    }
+
+    room = w->cap - 1U - w->len;
+    if (n > room)
+    {
+        n = room;
+        w->overflow = 1U;
+    }
+
+    (void)memcpy(&w->buf[w->len], s, n);
+    w->len += n;
+}
+
+/**
+ * @brief 追加单个字符
+ */
+static void uplink_json_put_char(uplink_json_writer_t *w, char c)
+{
+    if ((w->overflow != 0U) || ((w->len + 1U) >= w->cap))
+    {
+        w->overflow = 1U;
+        return;
+    }
+
+    w->buf[w->len++] = c;
+}
+
+/**
+ * @brief 开始一个对象（写 '{'，字段计数清零）
+ */
+void uplink_json_obj_begin(uplink_json_writer_t *w)
+{
+    uplink_json_put_char(w, '{');
+    w->fields = 0U;
+}
+
+/**
+ * @brief 结束当前对象（写 '}'）
+ */
+void uplink_json_obj_end(uplink_json_writer_t *w)
+{
+    uplink_json_put_char(w, '}');
+}
+
+/**
+ * @brief 写字段名（非首个字段先补逗号）
+ *
+ * @param w 写入器
+ * @param quoted_key 已带引号与冒号的键名，例如 `"lockerId":`
+ * @param len quoted_key 长度
+ */
+void uplink_json_put_key(uplink_json_writer_t *w, const char *quoted_key, size_t len)
+{
+    if (w->fields != 0U)
+    {
+        uplink_json_put_char(w, ',');
+    }
+    w->fields++;
+    uplink_json_put_bytes(w, quoted_key, len);
+}
+
+/**
+ * @brief 写字符串值（带引号，按 JSON 规则转义；NULL 视为空串）
+ *
+ * @note 无需转义的连续片段整段拷贝；控制字符输出为 \uXXXX（常见的 \b\f\n\r\t 用短形式）。
+ */
+void uplink_json_put_str(uplink_json_writer_t *w, const char *s)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char *run;
+    char esc[6];
+
+    uplink_json_put_char(w, '"');
+
+    if (s != NULL)
+    {
+        while (*s != '\0')
+        {
+            run = s;
+            while ((*s != '\0') && ((unsigned char)*s >= 0x20U) && (*s != '"') && (*s != '\\'))
+            {
+                s++;
+            }
+            if (s != run)
+            {
+                uplink_json_put_bytes(w, run, (size_t)(s - run));
+            }
+            if (*s == '\0')
+            {
+                break;
+            }
+
+            esc[0] = '\\';
+            switch (*s)
+            {
+            case '"':
+                esc[1] = '"';
+                break;
+            case '\\':
+                esc[1] = '\\';
+                break;
+            case '\b':
+                esc[1] = 'b';
+                break;
+            case '\f':
+                esc[1] = 'f';
+                break;
+            case '\n':
+                esc[1] = 'n';
+                break;
+            case '\r':
+                esc[1] = 'r';
+                break;
+            case '\t':
+                esc[1] = 't';
+                break;
+            default:
+                esc[1] = 'u';
+                esc[2] = '0';
+                esc[3] = '0';
+                esc[4] = hex[((unsigned char)*s >> 4U) & 0x0FU];
+                esc[5] = hex[(unsigned char)*s & 0x0FU];
+                break;
+            }
+            uplink_json_put_bytes(w, esc, (esc[1] == 'u') ? 6U : 2U);
+            s++;
+        }
+    }
+
+    uplink_json_put_char(w, '"');
+}
+
+/**
+ * @brief 写无符号十进制整数
+ */
+void uplink_json_put_u32(uplink_json_writer_t *w, uint32_t v)
+{
+    char tmp[10];
+    size_t i = sizeof(tmp);
+
+    do
+    {
+        tmp[--i] = (char)('0' + (v % 10U));
+        v /= 10U;
+    } while (v != 0U);
+
+    uplink_json_put_bytes(w, &tmp[i], sizeof(tmp) - i);
+}
+
+/**
+ * @brief 写有符号十进制整数
+ */
+void uplink_json_put_i32(uplink_json_writer_t *w, int32_t v)
+{
+    if (v < 0)
+    {
+        uplink_json_put_char(w, '-');
+        /* 先 +1 再取反，INT32_MIN 也不溢出 */
+        uplink_json_put_u32(w, (uint32_t)(-(v + 1)) + 1U);
+        return;
+    }
+
+    uplink_json_put_u32(w, (uint32_t)v);
+}
+
+/**
+ * @brief 原样写入一段 JSON 值（调用者保证合法；NULL 或空串写 `{}`）
+ */
+void uplink_json_put_json(uplink_json_writer_t *w, const char *s)
+{
+    if ((s == NULL) || (s[0] == '\0'))
+    {
+        uplink_json_put_bytes(w, "{}", 2U);
+        return;
+    }
+
+    uplink_json_put_bytes(w, s, strlen(s));
+}
+
+/**
+ * @brief 结束写入：补 '\0' 并返回结果
+ *
+ * @param w 写入器
+ * @param out_len 输出：已写入长度（不含 '\0'；溢出时为截断后的长度），可为 NULL
+ * @return uplink_err_t UPLINK_OK；缓冲不足返回 UPLINK_ERR_BUFFER_TOO_SMALL
+ */
+uplink_err_t uplink_json_writer_finish(uplink_json_writer_t *w, size_t *out_len)
+{
+    if ((w->buf != NULL) && (w->cap != 0U))
+    {
+        w->buf[w->len] = '\0';
+    }
+    if (out_len != NULL)
+    {
+        *out_len = w->len;
+    }
+
+    return (w->overflow != 0U) ? UPLINK_ERR_BUFFER_TOO_SMALL : UPLINK_OK;
+}
+
 uplink_err_t uplink_codec_json_build_event(char *out_json,
                                            size_t out_json_len,
                                            const char *device_id,
@@ -25,8 +264,8 @@ uplink_err_t uplink_codec_json_build_event(char *out_json,
                                            const char *payload_json,
                                            size_t *out_written)
 {
-    int written;
-    const char *payload = payload_json;
+    uplink_json_writer_t w;
+    uplink_event_json_t ev;
 
     if ((out_json == NULL) || (out_json_len == 0U) ||
         (device_id == NULL) || (type == NULL) || (out_written == NULL))
@@ -34,36 +273,18 @@ uplink_err_t uplink_codec_json_build_event(char *out_json,
         return UPLINK_ERR_INVALID_ARG;
     }
 
-    if ((payload == NULL) || (payload[0] == '\0'))
-    {
-        payload = "{}";
-    }
-
-    written = snprintf(out_json,
-                       out_json_len,
-                       "{\"deviceId\":\"%s\",\"messageId\":%lu,\"ts\":%lu,\"type\":\"%s\",\"payload\":%s}",
-                       device_id,
-                       (unsigned long)message_id,
-                       (unsigned long)ts_ms,
-                       type,
-                       payload);
+    ev.device_id = device_id;
+    ev.message_id = message_id;
+    ev.ts_ms = ts_ms;
+    ev.type = type;
+    ev.payload_json = payload_json;
 
-    if (written < 0)
-    {
-        out_json[0] = '\0';
-        *out_written = 0U;
-        return UPLINK_ERR_CODEC;
-    }
+    uplink_json_writer_init(&w, out_json, out_json_len);
+    uplink_json_obj_begin(&w);
+    uplink_event_json_write(&w, &ev);
+    uplink_json_obj_end(&w);
 
-    if ((size_t)written >= out_json_len)
-    {
-        out_json[out_json_len - 1U] = '\0';
-        *out_written = (out_json_len > 0U) ? (out_json_len - 1U) : 0U;
-        return UPLINK_ERR_BUFFER_TOO_SMALL;
-    }
-
-    *out_written = (size_t)written;
-    return UPLINK_OK;
+    return uplink_json_writer_finish(&w, out_written);
 }
 
 uplink_err_t uplink_codec_json_parse_app_code(const char *body,
@@ -157,3 +378,161 @@ uplink_err_t uplink_codec_json_parse_app_code(const char *body,
 
     return UPLINK_OK;
 }
+
+
+/**
+ * @brief 查找 "key": 之后的值起始位置（轻量实现，只匹配首个同名 key，不理解嵌套层级）
+ *
+ * @param body JSON 文本
+ * @param body_len 文本长度
+ * @param key 字段名（不含引号）
+ * @return size_t 值的起始下标（已跳过空白）；未找到返回 (size_t)-1
+ */
+static size_t uplink_codec_json_find_value(const char *body, size_t body_len, const char *key)
+{
+    size_t key_len = strlen(key);
+    size_t i;
+
+    for (i = 0U; (i + key_len + 2U) <= body_len; i++)
+    {
+        size_t pos;
+
+        if ((body[i] != '"') ||
+            (memcmp(&body[i + 1U], key, key_len) != 0) ||
+            (body[i + 1U + key_len] != '"'))
+        {
+            continue;
+        }
+
+        pos = i + key_len + 2U;
+        while (pos < body_len && isspace((unsigned char)body[pos]))
+        {
+            pos++;
+        }
+        if (pos >= body_len || body[pos] != ':')
+        {
+            continue;
+        }
+
+        pos++;
+        while (pos < body_len && isspace((unsigned char)body[pos]))
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+    return (size_t)(-1);
+}
+
+/**
+ * @brief 从 JSON 文本中提取某个无符号整数字段（轻量实现，只匹配首个同名 key）
+ *
+ * @param body JSON 文本
+ * @param body_len 文本长度
+ * @param key 字段名（不含引号），例如 "messageId"
+ * @param out_value 输出：字段值
+ * @return uplink_err_t
+ * - UPLINK_OK：找到并解析成功
+ * - UPLINK_ERR_CODEC：未找到字段或字段不是非负整数
+ */
+uplink_err_t uplink_codec_json_parse_u32(const char *body,
+                                         size_t body_len,
+                                         const char *key,
+                                         uint32_t *out_value)
+{
+    size_t pos;
+    uint32_t value = 0U;
+    uint8_t has_digit = 0U;
+
+    if ((body == NULL) || (key == NULL) || (out_value == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    pos = uplink_codec_json_find_value(body, body_len, key);
+    if (pos == (size_t)(-1))
+    {
+        return UPLINK_ERR_CODEC;
+    }
+
+    while (pos < body_len && body[pos] >= '0' && body[pos] <= '9')
+    {
+        uint32_t digit = (uint32_t)(body[pos] - '0');
+
+        if (value > ((UINT32_MAX - digit) / 10U))
+        {
+            return UPLINK_ERR_CODEC;
+        }
+        value = (value * 10U) + digit;
+        has_digit = 1U;
+        pos++;
+    }
+
+    if (has_digit == 0U)
+    {
+        return UPLINK_ERR_CODEC;
+    }
+
+    *out_value = value;
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 从 JSON 文本中提取某个字符串字段（轻量实现，只匹配首个同名 key）
+ *
+ * @param body JSON 文本
+ * @param body_len 文本长度
+ * @param key 字段名（不含引号），例如 "type"
+ * @param out_str 输出缓冲（保证 '\0' 结尾）
+ * @param out_str_len 输出缓冲长度
+ * @return uplink_err_t
+ * - UPLINK_OK：找到并完整拷贝
+ * - UPLINK_ERR_CODEC：未找到字段、字段不是字符串或含转义字符（设备侧字段均为 ASCII 标识符，不做反转义）
+ * - UPLINK_ERR_BUFFER_TOO_SMALL：输出缓冲不足
+ */
+uplink_err_t uplink_codec_json_parse_str(const char *body,
+                                         size_t body_len,
+                                         const char *key,
+                                         char *out_str,
+                                         size_t out_str_len)
+{
+    size_t pos;
+    size_t n = 0U;
+
+    if ((body == NULL) || (key == NULL) || (out_str == NULL) || (out_str_len == 0U))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    out_str[0] = '\0';
+
+    pos = uplink_codec_json_find_value(body, body_len, key);
+    if ((pos == (size_t)(-1)) || (pos >= body_len) || (body[pos] != '"'))
+    {
+        return UPLINK_ERR_CODEC;
+    }
+
+    for (pos++; pos < body_len; pos++)
+    {
+        if (body[pos] == '"')
+        {
+            out_str[n] = '\0';
+            return UPLINK_OK;
+        }
+        if (body[pos] == '\\')
+        {
+            out_str[0] = '\0';
+            return UPLINK_ERR_CODEC;
+        }
+        if ((n + 1U) >= out_str_len)
+        {
+            out_str[n] = '\0';
+            return UPLINK_ERR_BUFFER_TOO_SMALL;
+        }
+        out_str[n++] = body[pos];
+    }
+
+    out_str[0] = '\0';
+    return UPLINK_ERR_CODEC;
+}
@@ -14,6 +14,7 @@
  */
 
 #include "uplink_config.h"
+#include "uplink_backlog.h"
 
 #include <string.h>
 
@@ -54,6 +55,13 @@ static void uplink_copy_str(char *dst, size_t dst_size, const char *src)
  * - device_id："stm32f4"
  * - 超时：发送/接收 2000ms
  * - 重试：base=500ms，max=10s，最多 10 次（含首次）
+ * - MQTT：keepalive=30s，在途窗口=UPLINK_MAX_INFLIGHT
+ * - 签名：开启，密钥与服务端演示设备 stm32f4 一致
+ * - 备用端点：无（fallback.count=0）
+ * - 优先级类别：容量 HIGH=整队/NORMAL=3/4/BULK=1/2，权重 4:2:1，BULK 满时挤掉最旧；
+ *   存活时长 HIGH 不过期、NORMAL 2min、BULK 30s
+ * - 后备队列：UPLINK_BACKLOG_ENABLE=1 时使用 SDRAM 内存区，HIGH 占 10%，NORMAL/BULK 各占 45%
+ * - 合并上报/压缩：关闭（逐条发送明文 JSON，兼容不支持批量入口的旧服务端）
  */
 void uplink_config_set_defaults(uplink_config_t *cfg)
 {
@@ -89,10 +97,59 @@ void uplink_config_set_defaults(uplink_config_t *cfg)
     cfg->retry.max_attempts = 10U;    /* 最多尝试 10 次（含首次） */
     cfg->retry.jitter_pct = 20U;      /* 抖动 20% */
 
+    /*
+     * 优先级类别：HIGH 可占满队列，NORMAL 最多占 3/4，BULK 最多占一半（给高类别预留槽位）；
+     * 出队权重 4:2:1；BULK 满时挤掉最旧的读卡记录，其余类别满时拒绝新消息；
+     * 告警类不过期，一般审计 2 分钟、读卡记录 30 秒内未送达即视为过时丢弃，把发送机会留给新事件
+     */
+    cfg->classes[UPLINK_PRIO_HIGH].capacity = (uint16_t)UPLINK_QUEUE_MAX_LEN;
+    cfg->classes[UPLINK_PRIO_HIGH].weight = 4U;
+    cfg->classes[UPLINK_PRIO_HIGH].drop_policy = (uint8_t)UPLINK_DROP_NEWEST;
+    cfg->classes[UPLINK_PRIO_HIGH].ttl_ms = 0U;
+    cfg->classes[UPLINK_PRIO_NORMAL].capacity = (uint16_t)((UPLINK_QUEUE_MAX_LEN * 3) / 4);
+    cfg->classes[UPLINK_PRIO_NORMAL].weight = 2U;
+    cfg->classes[UPLINK_PRIO_NORMAL].drop_policy = (uint8_t)UPLINK_DROP_NEWEST;
+    cfg->classes[UPLINK_PRIO_NORMAL].ttl_ms = 120000U;
+    cfg->classes[UPLINK_PRIO_BULK].capacity = (uint16_t)(UPLINK_QUEUE_MAX_LEN / 2);
+    cfg->classes[UPLINK_PRIO_BULK].weight = 1U;
+    cfg->classes[UPLINK_PRIO_BULK].drop_policy = (uint8_t)UPLINK_DROP_OLDEST;
+    cfg->classes[UPLINK_PRIO_BULK].ttl_ms = 30000U;
+
     /* TLS 预留：默认关闭 */
     cfg->tls.enable = 0U;
     cfg->tls.verify_server = 0U;
     uplink_copy_str(cfg->tls.sni_host, sizeof(cfg->tls.sni_host), "");
+
+    /* MQTT：仅在 scheme 切到 MQTT 时生效 */
+    cfg->mqtt.keepalive_s = 30U;
+    cfg->mqtt.max_inflight = (uint8_t)UPLINK_MAX_INFLIGHT;
+
+    /* 签名：服务端 SIGNATURE_REQUIRED=0 时不签名也能通过，默认仍开启以便联调强制签名 */
+    cfg->sign.enable = 1U;
+    uplink_copy_str(cfg->sign.secret, sizeof(cfg->sign.secret), "dev-secret-stm32f4");
+
+    /* 备用端点：默认只有首选上级，由集成方按部署追加（如 PC 备用服务器） */
+    cfg->fallback.count = 0U;
+
+    /* 后备队列：告警类量少（热队列本来就给它预留了槽位），只在热队列被告警占满时才用得上；审计类平分其余部分 */
+#if UPLINK_BACKLOG_ENABLE
+    cfg->backlog.mem = (void *)UPLINK_BACKLOG_ADDR;
+    cfg->backlog.size = (uint32_t)UPLINK_BACKLOG_SIZE;
+#else
+    cfg->backlog.mem = NULL;
+    cfg->backlog.size = 0U;
+#endif
+    cfg->backlog.share_pct[UPLINK_PRIO_HIGH] = 10U;
+    cfg->backlog.share_pct[UPLINK_PRIO_NORMAL] = 45U;
+    cfg->backlog.share_pct[UPLINK_PRIO_BULK] = 45U;
+
+    /* 合并上报/压缩：由集成方确认服务端版本后开启 */
+    cfg->batch.max_events = 1U;
+    cfg->batch.compress = 0U;
+
+    /* 积压并发：默认关闭；开启后积压到 4 个满批（合并上报时）才并发 */
+    cfg->parallel.max_requests = 1U;
+    cfg->parallel.threshold = 32U;
 }
 
 /**
@@ -157,11 +214,99 @@ uplink_err_t uplink_config_validate(const uplink_config_t *cfg)
         return UPLINK_ERR_INVALID_ARG;
     }
 
+    /* 优先级类别：容量与权重不能为 0（否则该类别永远无法入队/出队）；ttl_ms 任意（0=不过期） */
+    {
+        uint8_t c;
+        for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+        {
+            if ((cfg->classes[c].capacity == 0U) || (cfg->classes[c].weight == 0U) ||
+                (cfg->classes[c].drop_policy > (uint8_t)UPLINK_DROP_OLDEST))
+            {
+                return UPLINK_ERR_INVALID_ARG;
+            }
+        }
+    }
+
     /* HTTPS 预留：如果启用 TLS，则 scheme 应为 HTTPS */
     if ((cfg->tls.enable != 0U) && (cfg->endpoint.scheme != UPLINK_SCHEME_HTTPS))
     {
         return UPLINK_ERR_INVALID_ARG;
     }
 
+    /* 启用签名时密钥不能为空 */
+    if ((cfg->sign.enable != 0U) && (cfg->sign.secret[0] == '\0'))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    /* 备用端点：数量不超过上限，且与首选端点使用同一传输 */
+    if (cfg->fallback.count > (uint8_t)(UPLINK_MAX_ENDPOINTS - 1))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    {
+        uint8_t i;
+        for (i = 0U; i < cfg->fallback.count; i++)
+        {
+            const uplink_endpoint_t *fb = &cfg->fallback.list[i];
+
+            if ((fb->host[0] == '\0') || (fb->port == 0U) || (fb->scheme != cfg->endpoint.scheme))
+            {
+                return UPLINK_ERR_INVALID_ARG;
+            }
+        }
+    }
+
+    /* 后备队列：给了大小就必须给地址；各类别份额总和不超过 100% */
+    {
+        uint16_t pct = 0U;
+        uint8_t c;
+
+        if ((cfg->backlog.size != 0U) && (cfg->backlog.mem == NULL))
+        {
+            return UPLINK_ERR_INVALID_ARG;
+        }
+        for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+        {
+            pct = (uint16_t)(pct + cfg->backlog.share_pct[c]);
+        }
+        if (pct > 100U)
+        {
+            return UPLINK_ERR_INVALID_ARG;
+        }
+    }
+
+    /* 合并上报：至少 1 条，不超过批量缓冲能容纳的条数上限（UPLINK_BATCH_ENABLE=0 时只能为 1） */
+    if ((cfg->batch.max_events == 0U) || (cfg->batch.max_events > (uint8_t)UPLINK_MAX_BATCH_EVENTS) ||
+        (cfg->batch.compress > 1U))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+#if !UPLINK_LZSS_ENABLE
+    /* 未编译压缩器 */
+    if (cfg->batch.compress != 0U)
+    {
+        return UPLINK_ERR_UNSUPPORTED;
+    }
+#endif
+
+    /* 积压并发：路数不超过编译期上限（每路一份请求/响应缓冲） */
+    if ((cfg->parallel.max_requests == 0U) || (cfg->parallel.max_requests > (uint8_t)UPLINK_MAX_PARALLEL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    /* MQTT：心跳不能关闭（长连接依赖心跳探活），在途窗口不超过编译期上限 */
+    if (cfg->endpoint.scheme == UPLINK_SCHEME_MQTT)
+    {
+        if ((cfg->mqtt.keepalive_s == 0U) ||
+            (cfg->mqtt.max_inflight == 0U) || (cfg->mqtt.max_inflight > (uint8_t)UPLINK_MAX_INFLIGHT))
+        {
+            return UPLINK_ERR_INVALID_ARG;
+        }
+    }
+
     return UPLINK_OK;
 }
@@ -0,0 +1,279 @@
+/**
+ * @file    uplink_dns.c
+ * @author  Yukikaze
+ * @brief   主机名解析与共享缓存（工具层）实现
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 缓存表是模块内静态数组，无需初始化；条目按最近使用时间淘汰（LRU）。
+ * - 时间比较使用 (int32_t)(a - b)，sys_now() 回绕后仍然正确。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_dns.h"
+
+/* lwIP 头文件 */
+#include "api.h"
+#include "opt.h"
+#include "sys.h"
+
+#include <string.h>
+
+/**
+ * 内部类型/变量
+ */
+static uplink_dns_stats_t g_dns_stats;
+
+#if LWIP_DNS
+typedef struct
+{
+    char host[UPLINK_MAX_HOST_LEN]; /* 域名（空串=空闲条目） */
+    ip_addr_t addr;                 /* 最近一次解析成功的地址 */
+    uint8_t has_addr;               /* 1=addr 有效 */
+    uint8_t negative;               /* 1=负缓存（解析失败且无旧地址可用） */
+    uint32_t expires_ms;            /* 过期时刻 */
+    uint32_t last_use_ms;           /* 最近一次被请求使用的时刻 */
+    uint32_t retry_at_ms;           /* 解析失败后，后台刷新最早的重试时刻 */
+} uplink_dns_entry_t;
+
+static uplink_dns_entry_t g_dns_cache[UPLINK_DNS_CACHE_SIZE];
+
+/**
+ * @brief 查找条目（调用者需已进入临界区）
+ */
+static uplink_dns_entry_t *uplink_dns_find(const char *host)
+{
+    uint32_t i;
+
+    for (i = 0U; i < UPLINK_DNS_CACHE_SIZE; i++)
+    {
+        if ((g_dns_cache[i].host[0] != '\0') && (strcmp(g_dns_cache[i].host, host) == 0))
+        {
+            return &g_dns_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 查找或分配条目：优先空闲条目，否则淘汰最久未使用的条目（调用者需已进入临界区）
+ */
+static uplink_dns_entry_t *uplink_dns_find_or_alloc(const char *host, uint32_t now_ms)
+{
+    uplink_dns_entry_t *e = uplink_dns_find(host);
+    uplink_dns_entry_t *victim = &g_dns_cache[0];
+    uint32_t i;
+
+    if (e != NULL)
+    {
+        return e;
+    }
+
+    for (i = 0U; i < UPLINK_DNS_CACHE_SIZE; i++)
+    {
+        if (g_dns_cache[i].host[0] == '\0')
+        {
+            victim = &g_dns_cache[i];
+            break;
+        }
+
+        if ((uint32_t)(now_ms - g_dns_cache[i].last_use_ms) > (uint32_t)(now_ms - victim->last_use_ms))
+        {
+            victim = &g_dns_cache[i];
+        }
+    }
+
+    (void)memset(victim, 0, sizeof(*victim));
+    (void)strncpy(victim->host, host, sizeof(victim->host) - 1U);
+    victim->last_use_ms = now_ms;
+    victim->retry_at_ms = now_ms;
+    return victim;
+}
+
+/**
+ * @brief 调用解析器并更新缓存
+ *
+ * @param host 域名
+ * @param out_addr 输出：可用地址（新解析结果或沿用的旧地址）
+ * @param is_refresh 1=后台刷新
+ * @return uplink_err_t UPLINK_OK=拿到可用地址
+ */
+static uplink_err_t uplink_dns_lookup(const char *host, ip_addr_t *out_addr, uint8_t is_refresh)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+    uplink_dns_entry_t *e;
+    ip_addr_t addr;
+    err_t err;
+    uint32_t now_ms;
+    uplink_err_t r;
+
+    /* 阻塞调用，放在临界区之外 */
+    err = netconn_gethostbyname(host, &addr);
+    now_ms = (uint32_t)sys_now();
+
+    SYS_ARCH_PROTECT(lev);
+    g_dns_stats.lookups++;
+    e = uplink_dns_find_or_alloc(host, now_ms);
+
+    if (err == ERR_OK)
+    {
+        e->addr = addr;
+        e->has_addr = 1U;
+        e->negative = 0U;
+        e->expires_ms = now_ms + UPLINK_DNS_TTL_MS;
+        e->retry_at_ms = now_ms;
+        *out_addr = addr;
+        if (is_refresh != 0U)
+        {
+            g_dns_stats.refreshes++;
+        }
+        r = UPLINK_OK;
+    }
+    else
+    {
+        g_dns_stats.failures++;
+        e->expires_ms = now_ms + UPLINK_DNS_NEG_TTL_MS;
+        e->retry_at_ms = now_ms + UPLINK_DNS_NEG_TTL_MS;
+
+        if (e->has_addr != 0U)
+        {
+            /* 服务器地址很少变化：DNS 暂时不可用时沿用旧地址，比直接失败更可靠 */
+            *out_addr = e->addr;
+            g_dns_stats.stale_served++;
+            r = UPLINK_OK;
+        }
+        else
+        {
+            e->negative = 1U;
+            r = UPLINK_ERR_TRANSPORT;
+        }
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    return r;
+}
+#endif /* LWIP_DNS */
+
+/**
+ * @brief 解析 endpoint.host 到 ip_addr_t（带共享缓存）
+ *
+ * @param endpoint 服务器端点
+ * @param out_addr 输出：解析得到的 IP 地址
+ * @return uplink_err_t 结果
+ */
+uplink_err_t uplink_dns_resolve(const uplink_endpoint_t *endpoint, ip_addr_t *out_addr)
+{
+    if ((endpoint == NULL) || (out_addr == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    /* 优先支持“IP 字符串直转”（推荐先用 IP，避免 DNS 依赖） */
+    if (endpoint->use_dns == 0U)
+    {
+        if (ipaddr_aton(endpoint->host, out_addr) == 0)
+        {
+            return UPLINK_ERR_INVALID_ARG;
+        }
+        return UPLINK_OK;
+    }
+
+#if LWIP_DNS
+    {
+        SYS_ARCH_DECL_PROTECT(lev);
+        uplink_dns_entry_t *e;
+        uint32_t now_ms = (uint32_t)sys_now();
+
+        SYS_ARCH_PROTECT(lev);
+        e = uplink_dns_find(endpoint->host);
+        if (e != NULL)
+        {
+            e->last_use_ms = now_ms;
+
+            if ((int32_t)(e->expires_ms - now_ms) > 0)
+            {
+                if (e->negative != 0U)
+                {
+                    g_dns_stats.neg_hits++;
+                    SYS_ARCH_UNPROTECT(lev);
+                    return UPLINK_ERR_TRANSPORT;
+                }
+
+                *out_addr = e->addr;
+                g_dns_stats.hits++;
+                SYS_ARCH_UNPROTECT(lev);
+                return UPLINK_OK;
+            }
+        }
+        SYS_ARCH_UNPROTECT(lev);
+
+        return uplink_dns_lookup(endpoint->host, out_addr, 0U);
+    }
+#else
+    return UPLINK_ERR_UNSUPPORTED;
+#endif
+}
+
+/**
+ * @brief 后台刷新：对即将过期且近期被使用过的条目提前解析（由 Task_Uplink 周期调用）
+ *
+ * @note 说明：
+ * - 长时间没人使用的条目不刷新，自然过期后由下一次请求重新解析。
+ * - 刷新失败后按负缓存间隔重试，DNS 故障期间不会每个周期都阻塞在解析上。
+ * - 每次最多刷新一个条目，避免一次调用阻塞过久。
+ */
+void uplink_dns_refresh(void)
+{
+#if LWIP_DNS
+    SYS_ARCH_DECL_PROTECT(lev);
+    char host[UPLINK_MAX_HOST_LEN];
+    uint32_t now_ms = (uint32_t)sys_now();
+    uint32_t i;
+
+    host[0] = '\0';
+
+    SYS_ARCH_PROTECT(lev);
+    for (i = 0U; i < UPLINK_DNS_CACHE_SIZE; i++)
+    {
+        const uplink_dns_entry_t *e = &g_dns_cache[i];
+
+        if ((e->host[0] != '\0') && (e->has_addr != 0U) &&
+            ((int32_t)(e->expires_ms - now_ms) < (int32_t)UPLINK_DNS_REFRESH_AHEAD_MS) &&
+            ((int32_t)(now_ms - e->retry_at_ms) >= 0) &&
+            ((uint32_t)(now_ms - e->last_use_ms) < UPLINK_DNS_TTL_MS))
+        {
+            (void)memcpy(host, e->host, sizeof(host));
+            break;
+        }
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    if (host[0] != '\0')
+    {
+        ip_addr_t addr;
+        (void)uplink_dns_lookup(host, &addr, 1U);
+    }
+#endif
+}
+
+/**
+ * @brief 读取 DNS 缓存统计
+ *
+ * @param out_stats 输出：统计快照
+ */
+void uplink_dns_get_stats(uplink_dns_stats_t *out_stats)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    if (out_stats == NULL)
+    {
+        return;
+    }
+
+    SYS_ARCH_PROTECT(lev);
+    *out_stats = g_dns_stats;
+    SYS_ARCH_UNPROTECT(lev);
+}
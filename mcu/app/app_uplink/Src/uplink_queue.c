@@ -105,19 +105,21 @@ uint16_t uplink_queue_size(const uplink_queue_t *q)
 }
 
 /**
- * @brief 入队（拷贝一份消息到队列尾部）
+ * @brief 在队列尾部占用一个槽位（不拷贝，由调用者就地填写）
  *
  * @param q 队列指针
- * @param msg 待入队消息（输入）
- * @return uplink_err_t 入队结果
- * - UPLINK_OK：成功
+ * @param out_slot 输出：槽位指针（内容未初始化）
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：成功，元素数量已 +1
  * - UPLINK_ERR_INVALID_ARG：参数非法
  * - UPLINK_ERR_QUEUE_FULL：队列已满
+ *
+ * @note 槽位指针只在下一次修改队列（push/pop/remove_id）之前有效，调用者需在同一临界区内填写完毕。
  */
-uplink_err_t uplink_queue_push(uplink_queue_t *q, const uplink_msg_t *msg)
+uplink_err_t uplink_queue_push_slot(uplink_queue_t *q, uplink_msg_t **out_slot)
 {
     /* 参数检查 */
-    if ((q == NULL) || (msg == NULL))
+    if ((q == NULL) || (out_slot == NULL))
     {
         return UPLINK_ERR_INVALID_ARG;
     }
@@ -128,8 +130,7 @@ uplink_err_t uplink_queue_push(uplink_queue_t *q, const uplink_msg_t *msg)
         return UPLINK_ERR_QUEUE_FULL;
     }
 
-    /* 把消息拷贝到 tail 位置 */
-    q->items[q->tail] = *msg;
+    *out_slot = &q->items[q->tail];
 
     /* tail 前移（环形） */
     q->tail++;
@@ -144,6 +145,36 @@ uplink_err_t uplink_queue_push(uplink_queue_t *q, const uplink_msg_t *msg)
     return UPLINK_OK;
 }
 
+/**
+ * @brief 入队（拷贝一份消息到队列尾部）
+ *
+ * @param q 队列指针
+ * @param msg 待入队消息（输入）
+ * @return uplink_err_t 入队结果
+ * - UPLINK_OK：成功
+ * - UPLINK_ERR_INVALID_ARG：参数非法
+ * - UPLINK_ERR_QUEUE_FULL：队列已满
+ */
+uplink_err_t uplink_queue_push(uplink_queue_t *q, const uplink_msg_t *msg)
+{
+    uplink_msg_t *slot = NULL;
+    uplink_err_t r;
+
+    if (msg == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    r = uplink_queue_push_slot(q, &slot);
+    if (r == UPLINK_OK)
+    {
+        /* 把消息拷贝到 tail 位置 */
+        *slot = *msg;
+    }
+
+    return r;
+}
+
 /**
  * @brief 查看队头元素（不出队）
  *
@@ -212,3 +243,112 @@ uplink_err_t uplink_queue_pop(uplink_queue_t *q)
 
     return UPLINK_OK;
 }
+
+/**
+ * @brief 按逻辑位置查看元素（0=队头，不出队）
+ *
+ * @param q 队列指针
+ * @param index 逻辑位置（0..size-1）
+ * @param out_msg 输出：指向该元素的指针
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：成功
+ * - UPLINK_ERR_QUEUE_EMPTY：index 超出当前元素数量
+ * - UPLINK_ERR_INVALID_ARG：参数非法
+ */
+uplink_err_t uplink_queue_at(uplink_queue_t *q, uint16_t index, uplink_msg_t **out_msg)
+{
+    uint16_t pos;
+
+    /* 参数检查 */
+    if ((q == NULL) || (out_msg == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    /* 越界检查 */
+    if (index >= q->count)
+    {
+        *out_msg = NULL;
+        return UPLINK_ERR_QUEUE_EMPTY;
+    }
+
+    /* 逻辑位置换算为物理下标（环形） */
+    pos = (uint16_t)(q->head + index);
+    if (pos >= q->capacity)
+    {
+        pos = (uint16_t)(pos - q->capacity);
+    }
+
+    *out_msg = &q->items[pos];
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 按 message_id 移除任意位置的元素（保持其余元素顺序）
+ *
+ * @param q 队列指针
+ * @param message_id 待移除消息 ID
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：成功
+ * - UPLINK_ERR_QUEUE_EMPTY：未找到该消息
+ * - UPLINK_ERR_INVALID_ARG：参数非法
+ *
+ * @note 异步流水模式下确认可能乱序到达，不一定是队头，因此需要按 ID 删除。
+ */
+uplink_err_t uplink_queue_remove_id(uplink_queue_t *q, uint32_t message_id)
+{
+    uplink_msg_t *cur = NULL;
+    uplink_msg_t *next = NULL;
+    uint16_t i;
+
+    /* 参数检查 */
+    if (q == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    /* 查找目标位置 */
+    for (i = 0U; i < q->count; i++)
+    {
+        (void)uplink_queue_at(q, i, &cur);
+        if (cur->message_id == message_id)
+        {
+            break;
+        }
+    }
+
+    if (i >= q->count)
+    {
+        return UPLINK_ERR_QUEUE_EMPTY;
+    }
+
+    /* 队头直接出队 */
+    if (i == 0U)
+    {
+        return uplink_queue_pop(q);
+    }
+
+    /* 后续元素依次前移一位，填补空洞 */
+    for (; (uint16_t)(i + 1U) < q->count; i++)
+    {
+        (void)uplink_queue_at(q, i, &cur);
+        (void)uplink_queue_at(q, (uint16_t)(i + 1U), &next);
+        *cur = *next;
+    }
+
+    /* tail 回退一位（环形），并清空最后一个元素 */
+    if (q->tail == 0U)
+    {
+        q->tail = (uint16_t)(q->capacity - 1U);
+    }
+    else
+    {
+        q->tail--;
+    }
+    (void)memset(&q->items[q->tail], 0, sizeof(q->items[q->tail]));
+
+    /* 元素数量 -1 */
+    q->count--;
+
+    return UPLINK_OK;
+}
@@ -0,0 +1,356 @@
+/**
+ * @file    uplink_sched.c
+ * @author  Yukikaze
+ * @brief   Uplink 优先级入队准入与加权公平出队实现（调度层）
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 队列长度很小（UPLINK_QUEUE_MAX_LEN），各类别计数直接扫描队列得到，不额外维护计数器，
+ *   避免按 ID 删除、重试耗尽等路径漏改计数。
+ * - 在途消息（inflight=1）不会被挤掉，也不会因过期被清除：它已经交给传输层，移除后确认到达时无法对账；
+ *   若最终失败，下一次挑选前再按过期清除。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_sched.h"
+
+#include <string.h>
+
+/**
+ * @brief 查找某类别中最旧/最新的一条未在途消息
+ *
+ * @param q 队列指针
+ * @param prio 类别
+ * @param newest 1=找最新（队尾方向）；0=找最旧（队头方向）
+ * @return uplink_msg_t* 找到的消息；没有返回 NULL
+ */
+static uplink_msg_t *uplink_sched_find_victim(uplink_queue_t *q, uint8_t prio, uint8_t newest)
+{
+    uplink_msg_t *msg = NULL;
+    uplink_msg_t *found = NULL;
+    uint16_t i;
+
+    for (i = 0U; i < uplink_queue_size(q); i++)
+    {
+        (void)uplink_queue_at(q, i, &msg);
+        if ((msg->prio != prio) || (msg->inflight != 0U))
+        {
+            continue;
+        }
+
+        found = msg;
+        if (newest == 0U)
+        {
+            break;
+        }
+    }
+
+    return found;
+}
+
+/**
+ * @brief 挤掉一条消息（ID 与类别交给调用者用于统计）
+ */
+static void uplink_sched_evict(uplink_queue_t *q, uplink_msg_t *victim, uplink_evicted_t *out_evicted)
+{
+    out_evicted->message_id = victim->message_id;
+    out_evicted->prio = victim->prio;
+    (void)uplink_queue_remove_id(q, out_evicted->message_id);
+}
+
+/**
+ * @brief 比较两条消息的截止时刻
+ *
+ * @return uint8_t 1=a 比 b 更紧迫（a 有截止且早于 b，或 b 无截止）；0=否
+ */
+static uint8_t uplink_sched_earlier(const uplink_msg_t *a, const uplink_msg_t *b)
+{
+    if (a->deadline_ms == 0U)
+    {
+        return 0U;
+    }
+    if (b->deadline_ms == 0U)
+    {
+        return 1U;
+    }
+    return ((int32_t)(a->deadline_ms - b->deadline_ms) < 0) ? 1U : 0U;
+}
+
+/**
+ * @brief 初始化调度器
+ *
+ * @param s 调度器
+ * @param classes 各类别策略（下标为 uplink_prio_t）
+ */
+void uplink_sched_init(uplink_sched_t *s, const uplink_class_policy_t classes[UPLINK_PRIO_COUNT])
+{
+    if ((s == NULL) || (classes == NULL))
+    {
+        return;
+    }
+
+    (void)memset(s, 0, sizeof(*s));
+    (void)memcpy(s->classes, classes, sizeof(s->classes));
+}
+
+/**
+ * @brief 统计队列中某类别的消息数（含在途）
+ *
+ * @param q 队列指针
+ * @param prio 类别
+ * @return uint16_t 消息数
+ */
+uint16_t uplink_sched_class_count(uplink_queue_t *q, uint8_t prio)
+{
+    uplink_msg_t *msg = NULL;
+    uint16_t i;
+    uint16_t n = 0U;
+
+    if (q == NULL)
+    {
+        return 0U;
+    }
+
+    for (i = 0U; i < uplink_queue_size(q); i++)
+    {
+        (void)uplink_queue_at(q, i, &msg);
+        if (msg->prio == prio)
+        {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief 入队准入检查：找出为一条 prio 类别的新消息腾位置需要挤掉的消息（不修改队列）
+ *
+ * @param s 调度器
+ * @param q 队列指针
+ * @param prio 新消息类别
+ * @param out_victim 输出：需要挤掉的消息（仍在队列中）；NULL 表示直接有空位
+ * @return uplink_err_t 结果
+ * - UPLINK_OK：可以入队（*out_victim 非 NULL 时需先移除它）
+ * - UPLINK_ERR_QUEUE_FULL：本类别已满且策略为拒绝新消息，或队列已满且没有可挤掉的消息
+ * - UPLINK_ERR_INVALID_ARG：参数非法
+ *
+ * @note 顺序：
+ * 1) 本类别达到容量：DROP_OLDEST 挤掉本类别最旧的一条；DROP_NEWEST 拒绝。
+ * 2) 队列整体已满：从最低类别起，挤掉比 prio 更低的类别中最新的一条；都没有则按 1) 的策略处理本类别。
+ * @note 与 uplink_sched_admit 分开：调用者可以先决定被挤的消息去向（例如退回 SDRAM 后备队列）再移除。
+ */
+uplink_err_t uplink_sched_select_victim(uplink_sched_t *s, uplink_queue_t *q, uint8_t prio, uplink_msg_t **out_victim)
+{
+    const uplink_class_policy_t *pol;
+    uplink_msg_t *victim = NULL;
+    uint16_t cap;
+    uint8_t c;
+
+    if ((s == NULL) || (q == NULL) || (out_victim == NULL) || (prio >= (uint8_t)UPLINK_PRIO_COUNT))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    *out_victim = NULL;
+    pol = &s->classes[prio];
+
+    cap = pol->capacity;
+    if (cap > q->capacity)
+    {
+        cap = q->capacity;
+    }
+
+    /* 1) 本类别容量 */
+    if (uplink_sched_class_count(q, prio) >= cap)
+    {
+        if (pol->drop_policy == (uint8_t)UPLINK_DROP_OLDEST)
+        {
+            victim = uplink_sched_find_victim(q, prio, 0U);
+        }
+        if (victim == NULL)
+        {
+            return UPLINK_ERR_QUEUE_FULL;
+        }
+        *out_victim = victim;
+        return UPLINK_OK;
+    }
+
+    if (uplink_queue_is_full(q) == 0U)
+    {
+        return UPLINK_OK;
+    }
+
+    /* 2) 队列整体已满：先挤更低类别里最新的（保留低类别里最早、等得最久的记录） */
+    for (c = (uint8_t)(UPLINK_PRIO_COUNT - 1); c > prio; c--)
+    {
+        victim = uplink_sched_find_victim(q, c, 1U);
+        if (victim != NULL)
+        {
+            *out_victim = victim;
+            return UPLINK_OK;
+        }
+    }
+
+    if (pol->drop_policy == (uint8_t)UPLINK_DROP_OLDEST)
+    {
+        victim = uplink_sched_find_victim(q, prio, 0U);
+    }
+    if (victim == NULL)
+    {
+        return UPLINK_ERR_QUEUE_FULL;
+    }
+    *out_victim = victim;
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 入队准入：为一条 prio 类别的新消息腾出位置（按 uplink_sched_select_victim 的顺序，需要时直接挤掉）
+ *
+ * @param s 调度器
+ * @param q 队列指针
+ * @param prio 新消息类别
+ * @param out_evicted 输出：被挤掉的消息（message_id=0 表示没有挤掉任何消息）
+ * @return uplink_err_t 结果（同 uplink_sched_select_victim）
+ */
+uplink_err_t uplink_sched_admit(uplink_sched_t *s, uplink_queue_t *q, uint8_t prio, uplink_evicted_t *out_evicted)
+{
+    uplink_msg_t *victim = NULL;
+    uplink_err_t r;
+
+    if (out_evicted == NULL)
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    out_evicted->message_id = 0U;
+
+    r = uplink_sched_select_victim(s, q, prio, &victim);
+    if ((r == UPLINK_OK) && (victim != NULL))
+    {
+        uplink_sched_evict(q, victim, out_evicted);
+    }
+
+    return r;
+}
+
+/**
+ * @brief 清除已过截止时刻的未在途消息
+ *
+ * @param q 队列指针
+ * @param now_ms 当前时间（毫秒）
+ * @param out_counts 输出：各类别本次清除数（累加，调用者负责清零）
+ * @return uint16_t 本次清除总数
+ */
+uint16_t uplink_sched_expire(uplink_queue_t *q, uint32_t now_ms, uint16_t out_counts[UPLINK_PRIO_COUNT])
+{
+    uplink_msg_t *msg = NULL;
+    uint16_t total = 0U;
+    uint16_t i = 0U;
+
+    if ((q == NULL) || (out_counts == NULL))
+    {
+        return 0U;
+    }
+
+    while (uplink_queue_at(q, i, &msg) == UPLINK_OK)
+    {
+        if ((msg->deadline_ms != 0U) && (msg->inflight == 0U) && ((int32_t)(now_ms - msg->deadline_ms) >= 0))
+        {
+            if (msg->prio < (uint8_t)UPLINK_PRIO_COUNT)
+            {
+                out_counts[msg->prio]++;
+            }
+            total++;
+
+            /* 后续元素前移补位，i 不变 */
+            (void)uplink_queue_remove_id(q, msg->message_id);
+            continue;
+        }
+        i++;
+    }
+
+    return total;
+}
+
+/**
+ * @brief 选出下一条要发送的消息（平滑加权轮询 + 类别内 EDF）
+ *
+ * @param s 调度器
+ * @param q 队列指针
+ * @param now_ms 当前时间（毫秒）
+ * @return uplink_msg_t* 选中的消息（仍在队列中）；没有可发送消息返回 NULL
+ *
+ * @note 说明：
+ * - “可发送”= 未在途且已到重试时间；每个类别的候选是本类别截止时刻最早的可发送消息
+ *   （都无截止时为最早入队者）。过期消息应先由 uplink_sched_expire 清除。
+ * - 只有有候选的类别参与本轮轮转；类别在队列里完全没有消息时清零其当前值，
+ *   避免长时间空闲后积攒的权值一次性抢占。
+ * - 选中即消耗本轮份额：调用者随后因熔断等原因没有发送，也只是轮转顺序前移一格，不会累积偏差。
+ */
+uplink_msg_t *uplink_sched_pick(uplink_sched_t *s, uplink_queue_t *q, uint32_t now_ms)
+{
+    uplink_msg_t *cand[UPLINK_PRIO_COUNT];
+    uint8_t present[UPLINK_PRIO_COUNT];
+    uplink_msg_t *msg = NULL;
+    int16_t total = 0;
+    uint8_t best = (uint8_t)UPLINK_PRIO_COUNT;
+    uint16_t i;
+    uint8_t c;
+
+    if ((s == NULL) || (q == NULL))
+    {
+        return NULL;
+    }
+
+    (void)memset(cand, 0, sizeof(cand));
+    (void)memset(present, 0, sizeof(present));
+
+    for (i = 0U; i < uplink_queue_size(q); i++)
+    {
+        (void)uplink_queue_at(q, i, &msg);
+        c = (msg->prio < (uint8_t)UPLINK_PRIO_COUNT) ? msg->prio : (uint8_t)UPLINK_PRIO_NORMAL;
+        present[c] = 1U;
+
+        if ((msg->inflight != 0U) || ((int32_t)(now_ms - msg->next_retry_ms) < 0))
+        {
+            continue;
+        }
+
+        if ((cand[c] == NULL) || (uplink_sched_earlier(msg, cand[c]) != 0U))
+        {
+            cand[c] = msg;
+        }
+    }
+
+    for (c = 0U; c < (uint8_t)UPLINK_PRIO_COUNT; c++)
+    {
+        if (present[c] == 0U)
+        {
+            s->current[c] = 0;
+        }
+        if (cand[c] == NULL)
+        {
+            continue;
+        }
+
+        s->current[c] = (int16_t)(s->current[c] + (int16_t)s->classes[c].weight);
+        total = (int16_t)(total + (int16_t)s->classes[c].weight);
+
+        /* 同分时数值小（优先级高）的类别优先 */
+        if ((best == (uint8_t)UPLINK_PRIO_COUNT) || (s->current[c] > s->current[best]))
+        {
+            best = c;
+        }
+    }
+
+    if (best == (uint8_t)UPLINK_PRIO_COUNT)
+    {
+        return NULL;
+    }
+
+    s->current[best] = (int16_t)(s->current[best] - total);
+    return cand[best];
+}
@@ -0,0 +1,357 @@
+/**
+ * @file    uplink_sha256.c
+ * @author  Yukikaze
+ * @brief   SHA-256 / HMAC-SHA256 软件实现（工具层）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note 说明：
+ * - 按 FIPS 180-4 / RFC 2104 实现，结果可与 Python hashlib/hmac 直接比对。
+ * - 只做摘要计算，不做密钥管理；密钥由上层（transport 上下文）保存。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_sha256.h"
+
+#include <string.h>
+
+#define UPLINK_SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32U - (n))))
+
+static const uint32_t s_uplink_sha256_k[64] = {
+    0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+    0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+    0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+    0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+    0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+    0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+    0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+    0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U};
+
+/**
+ * @brief 处理一个 64 字节分组
+ *
+ * @param state 中间哈希值（输入/输出）
+ * @param block 64 字节分组
+ */
+static void uplink_sha256_transform(uint32_t state[8], const uint8_t block[UPLINK_SHA256_BLOCK_LEN])
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t i;
+
+    for (i = 0U; i < 16U; i++)
+    {
+        w[i] = ((uint32_t)block[i * 4U] << 24) |
+               ((uint32_t)block[i * 4U + 1U] << 16) |
+               ((uint32_t)block[i * 4U + 2U] << 8) |
+               ((uint32_t)block[i * 4U + 3U]);
+    }
+
+    for (i = 16U; i < 64U; i++)
+    {
+        uint32_t s0 = UPLINK_SHA256_ROTR(w[i - 15U], 7U) ^ UPLINK_SHA256_ROTR(w[i - 15U], 18U) ^ (w[i - 15U] >> 3);
+        uint32_t s1 = UPLINK_SHA256_ROTR(w[i - 2U], 17U) ^ UPLINK_SHA256_ROTR(w[i - 2U], 19U) ^ (w[i - 2U] >> 10);
+        w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+    }
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
+
+    for (i = 0U; i < 64U; i++)
+    {
+        uint32_t s1 = UPLINK_SHA256_ROTR(e, 6U) ^ UPLINK_SHA256_ROTR(e, 11U) ^ UPLINK_SHA256_ROTR(e, 25U);
+        uint32_t ch = (e & f) ^ ((~e) & g);
+        uint32_t t1 = h + s1 + ch + s_uplink_sha256_k[i] + w[i];
+        uint32_t s0 = UPLINK_SHA256_ROTR(a, 2U) ^ UPLINK_SHA256_ROTR(a, 13U) ^ UPLINK_SHA256_ROTR(a, 22U);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+/**
+ * @brief 初始化 SHA-256 上下文
+ *
+ * @param ctx 上下文（输出）
+ */
+void uplink_sha256_init(uplink_sha256_ctx_t *ctx)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    ctx->state[0] = 0x6a09e667U;
+    ctx->state[1] = 0xbb67ae85U;
+    ctx->state[2] = 0x3c6ef372U;
+    ctx->state[3] = 0xa54ff53aU;
+    ctx->state[4] = 0x510e527fU;
+    ctx->state[5] = 0x9b05688cU;
+    ctx->state[6] = 0x1f83d9abU;
+    ctx->state[7] = 0x5be0cd19U;
+    ctx->total_len = 0U;
+    ctx->buffer_used = 0U;
+}
+
+/**
+ * @brief 追加输入数据（可多次调用）
+ *
+ * @param ctx 上下文
+ * @param data 输入数据
+ * @param len 数据长度（字节）
+ */
+void uplink_sha256_update(uplink_sha256_ctx_t *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    if ((ctx == NULL) || (p == NULL) || (len == 0U))
+    {
+        return;
+    }
+
+    ctx->total_len += (uint64_t)len;
+
+    /* 先补齐缓存中的残余分组 */
+    if (ctx->buffer_used != 0U)
+    {
+        size_t fill = UPLINK_SHA256_BLOCK_LEN - ctx->buffer_used;
+        if (fill > len)
+        {
+            fill = len;
+        }
+
+        (void)memcpy(&ctx->buffer[ctx->buffer_used], p, fill);
+        ctx->buffer_used = (uint8_t)(ctx->buffer_used + fill);
+        p += fill;
+        len -= fill;
+
+        if (ctx->buffer_used < UPLINK_SHA256_BLOCK_LEN)
+        {
+            return;
+        }
+
+        uplink_sha256_transform(ctx->state, ctx->buffer);
+        ctx->buffer_used = 0U;
+    }
+
+    /* 整分组直接处理，不经过缓存 */
+    while (len >= UPLINK_SHA256_BLOCK_LEN)
+    {
+        uplink_sha256_transform(ctx->state, p);
+        p += UPLINK_SHA256_BLOCK_LEN;
+        len -= UPLINK_SHA256_BLOCK_LEN;
+    }
+
+    if (len != 0U)
+    {
+        (void)memcpy(ctx->buffer, p, len);
+        ctx->buffer_used = (uint8_t)len;
+    }
+}
+
+/**
+ * @brief 结束计算并输出摘要（调用后上下文需重新 init 才能复用）
+ *
+ * @param ctx 上下文
+ * @param out_digest 输出：32 字节摘要
+ */
+void uplink_sha256_final(uplink_sha256_ctx_t *ctx, uint8_t out_digest[UPLINK_SHA256_DIGEST_LEN])
+{
+    uint64_t bit_len;
+    uint32_t i;
+
+    if ((ctx == NULL) || (out_digest == NULL))
+    {
+        return;
+    }
+
+    bit_len = ctx->total_len << 3;
+
+    /* 填充：0x80 + 0x00... 直到剩余 8 字节放长度 */
+    ctx->buffer[ctx->buffer_used++] = 0x80U;
+    if (ctx->buffer_used > (UPLINK_SHA256_BLOCK_LEN - 8U))
+    {
+        (void)memset(&ctx->buffer[ctx->buffer_used], 0, UPLINK_SHA256_BLOCK_LEN - ctx->buffer_used);
+        uplink_sha256_transform(ctx->state, ctx->buffer);
+        ctx->buffer_used = 0U;
+    }
+    (void)memset(&ctx->buffer[ctx->buffer_used], 0, (UPLINK_SHA256_BLOCK_LEN - 8U) - ctx->buffer_used);
+
+    for (i = 0U; i < 8U; i++)
+    {
+        ctx->buffer[(UPLINK_SHA256_BLOCK_LEN - 1U) - i] = (uint8_t)(bit_len >> (i * 8U));
+    }
+    uplink_sha256_transform(ctx->state, ctx->buffer);
+
+    for (i = 0U; i < UPLINK_SHA256_DIGEST_LEN; i++)
+    {
+        out_digest[i] = (uint8_t)(ctx->state[i >> 2U] >> ((3U - (i & 3U)) * 8U));
+    }
+
+    (void)memset(ctx, 0, sizeof(*ctx));
+}
+
+/**
+ * @brief 预计算 HMAC-SHA256 密钥（吸收 ipad/opad 分组）
+ *
+ * @param out_key 预计算结果（输出）
+ * @param key 密钥
+ * @param key_len 密钥长度（超过 64 字节时先做一次 SHA-256）
+ */
+void uplink_hmac_sha256_key_init(uplink_hmac_sha256_key_t *out_key, const void *key, size_t key_len)
+{
+    uint8_t k0[UPLINK_SHA256_BLOCK_LEN];
+    uint8_t ipad[UPLINK_SHA256_BLOCK_LEN];
+    uint8_t opad[UPLINK_SHA256_BLOCK_LEN];
+    uint32_t i;
+
+    if (out_key == NULL)
+    {
+        return;
+    }
+
+    (void)memset(k0, 0, sizeof(k0));
+    if ((key != NULL) && (key_len > UPLINK_SHA256_BLOCK_LEN))
+    {
+        uplink_sha256_ctx_t kh;
+        uplink_sha256_init(&kh);
+        uplink_sha256_update(&kh, key, key_len);
+        uplink_sha256_final(&kh, k0);
+    }
+    else if ((key != NULL) && (key_len != 0U))
+    {
+        (void)memcpy(k0, key, key_len);
+    }
+
+    for (i = 0U; i < UPLINK_SHA256_BLOCK_LEN; i++)
+    {
+        ipad[i] = (uint8_t)(k0[i] ^ 0x36U);
+        opad[i] = (uint8_t)(k0[i] ^ 0x5cU);
+    }
+
+    uplink_sha256_init(&out_key->inner);
+    uplink_sha256_update(&out_key->inner, ipad, sizeof(ipad));
+    uplink_sha256_init(&out_key->outer);
+    uplink_sha256_update(&out_key->outer, opad, sizeof(opad));
+
+    (void)memset(k0, 0, sizeof(k0));
+    (void)memset(ipad, 0, sizeof(ipad));
+    (void)memset(opad, 0, sizeof(opad));
+}
+
+/**
+ * @brief 用预计算密钥开始一次 HMAC 计算（只拷贝中间状态，不做分组压缩）
+ *
+ * @param ctx 上下文（输出）
+ * @param key 预计算密钥
+ */
+void uplink_hmac_sha256_start(uplink_hmac_sha256_ctx_t *ctx, const uplink_hmac_sha256_key_t *key)
+{
+    if ((ctx == NULL) || (key == NULL))
+    {
+        return;
+    }
+
+    *ctx = *key;
+}
+
+/**
+ * @brief 初始化 HMAC-SHA256 上下文（一次性密钥场景）
+ *
+ * @param ctx 上下文（输出）
+ * @param key 密钥
+ * @param key_len 密钥长度（超过 64 字节时先做一次 SHA-256）
+ */
+void uplink_hmac_sha256_init(uplink_hmac_sha256_ctx_t *ctx, const void *key, size_t key_len)
+{
+    uplink_hmac_sha256_key_init(ctx, key, key_len);
+}
+
+/**
+ * @brief 追加 HMAC 输入数据
+ *
+ * @param ctx 上下文
+ * @param data 输入数据
+ * @param len 数据长度
+ */
+void uplink_hmac_sha256_update(uplink_hmac_sha256_ctx_t *ctx, const void *data, size_t len)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    uplink_sha256_update(&ctx->inner, data, len);
+}
+
+/**
+ * @brief 结束 HMAC 计算并输出 MAC
+ *
+ * @param ctx 上下文
+ * @param out_mac 输出：32 字节 MAC
+ */
+void uplink_hmac_sha256_final(uplink_hmac_sha256_ctx_t *ctx, uint8_t out_mac[UPLINK_SHA256_DIGEST_LEN])
+{
+    uint8_t inner_digest[UPLINK_SHA256_DIGEST_LEN];
+    uplink_sha256_ctx_t outer;
+
+    if ((ctx == NULL) || (out_mac == NULL))
+    {
+        return;
+    }
+
+    uplink_sha256_final(&ctx->inner, inner_digest);
+
+    outer = ctx->outer;
+    uplink_sha256_update(&outer, inner_digest, sizeof(inner_digest));
+    uplink_sha256_final(&outer, out_mac);
+
+    (void)memset(ctx, 0, sizeof(*ctx));
+}
+
+/**
+ * @brief 一次性计算 HMAC-SHA256
+ *
+ * @param key 密钥
+ * @param key_len 密钥长度
+ * @param data 输入数据
+ * @param data_len 数据长度
+ * @param out_mac 输出：32 字节 MAC
+ */
+void uplink_hmac_sha256(const void *key,
+                        size_t key_len,
+                        const void *data,
+                        size_t data_len,
+                        uint8_t out_mac[UPLINK_SHA256_DIGEST_LEN])
+{
+    uplink_hmac_sha256_ctx_t ctx;
+
+    uplink_hmac_sha256_init(&ctx, key, key_len);
+    uplink_hmac_sha256_update(&ctx, data, data_len);
+    uplink_hmac_sha256_final(&ctx, out_mac);
+}
@@ -0,0 +1,360 @@
+/**
+ * @file    uplink_sign.c
+ * @author  Yukikaze
+ * @brief   HTTP 请求签名（工具层）实现
+ * @version 0.1
+ * @date    2026-10-17
+ * @note 说明：
+ * - 签名计算是流式的：timestamp、"\n"、nonce、"\n"、body 依次送入 HMAC，不拼接原文。
+ * - 每次签名的开销 = 拷贝预计算状态 + ceil((len(ts)+len(nonce)+2+len(body)+9)/64) 次内层压缩 + 1 次外层压缩。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_sign.h"
+
+#include "uplink_codec_json.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief 小写 ASCII（只处理 A-Z）
+ */
+static char uplink_sign_lower(char c)
+{
+    if ((c >= 'A') && (c <= 'Z'))
+    {
+        return (char)(c - 'A' + 'a');
+    }
+    return c;
+}
+
+/**
+ * @brief 读取固定位数的十进制数字
+ *
+ * @return uint8_t 1=成功，0=含非数字字符
+ */
+static uint8_t uplink_sign_read_digits(const char *p, uint8_t digits, uint32_t *out_value)
+{
+    uint32_t v = 0U;
+    uint8_t i;
+
+    for (i = 0U; i < digits; i++)
+    {
+        if ((p[i] < '0') || (p[i] > '9'))
+        {
+            return 0U;
+        }
+        v = v * 10U + (uint32_t)(p[i] - '0');
+    }
+
+    *out_value = v;
+    return 1U;
+}
+
+/**
+ * @brief 公历日期转 1970-01-01 起的天数（Howard Hinnant days_from_civil，整数运算）
+ */
+static uint32_t uplink_sign_days_from_civil(uint32_t y, uint32_t m, uint32_t d)
+{
+    uint32_t era;
+    uint32_t yoe;
+    uint32_t doy;
+    uint32_t doe;
+
+    y -= (m <= 2U) ? 1U : 0U;
+    era = y / 400U;
+    yoe = y - era * 400U;
+    doy = (153U * ((m > 2U) ? (m - 3U) : (m + 9U)) + 2U) / 5U + d - 1U;
+    doe = yoe * 365U + yoe / 4U - yoe / 100U + doy;
+    return era * 146097U + doe - 719468U;
+}
+
+/**
+ * @brief 解析 HTTP Date 头的值（IMF-fixdate，例如 "Sat, 17 Oct 2026 08:00:00 GMT"）
+ *
+ * @param value 字段值起始位置（已跳过 "Date:" 与空格）
+ * @param out_epoch_s 输出：Unix 时间（秒）
+ * @return uint8_t 1=成功，0=格式不支持
+ */
+uint8_t uplink_sign_parse_http_date(const char *value, uint32_t *out_epoch_s)
+{
+    static const char months[] = "janfebmaraprmayjunjulaugsepoctnovdec";
+    const char *p;
+    uint32_t day;
+    uint32_t month = 0U;
+    uint32_t year;
+    uint32_t hh;
+    uint32_t mm;
+    uint32_t ss;
+    uint32_t i;
+
+    if ((value == NULL) || (out_epoch_s == NULL))
+    {
+        return 0U;
+    }
+
+    /* 跳过星期："Sat, " */
+    p = strchr(value, ',');
+    if ((p == NULL) || (p[1] != ' '))
+    {
+        return 0U;
+    }
+    p += 2;
+
+    /* "17 Oct 2026 08:00:00" 定长 20 字符 */
+    if ((uplink_sign_read_digits(p, 2U, &day) == 0U) || (p[2] != ' ') || (p[6] != ' ') ||
+        (uplink_sign_read_digits(p + 7, 4U, &year) == 0U) || (p[11] != ' ') ||
+        (uplink_sign_read_digits(p + 12, 2U, &hh) == 0U) || (p[14] != ':') ||
+        (uplink_sign_read_digits(p + 15, 2U, &mm) == 0U) || (p[17] != ':') ||
+        (uplink_sign_read_digits(p + 18, 2U, &ss) == 0U))
+    {
+        return 0U;
+    }
+
+    for (i = 0U; i < 12U; i++)
+    {
+        if ((uplink_sign_lower(p[3]) == months[i * 3U]) &&
+            (uplink_sign_lower(p[4]) == months[i * 3U + 1U]) &&
+            (uplink_sign_lower(p[5]) == months[i * 3U + 2U]))
+        {
+            month = i + 1U;
+            break;
+        }
+    }
+
+    if ((month == 0U) || (day == 0U) || (day > 31U) || (year < 1970U) || (hh > 23U) || (mm > 59U) || (ss > 60U))
+    {
+        return 0U;
+    }
+
+    *out_epoch_s = uplink_sign_days_from_civil(year, month, day) * 86400U + hh * 3600U + mm * 60U + ss;
+    return 1U;
+}
+
+/**
+ * @brief 初始化签名器（预计算 HMAC 密钥）
+ *
+ * @param signer 签名器
+ * @param device_id 设备 ID（X-Device-Id）
+ * @param secret 设备密钥；NULL 或空串表示不签名
+ * @param lane nonce 实例编号（同一设备上的多个签名器取不同值）
+ */
+void uplink_signer_init(uplink_signer_t *signer, const char *device_id, const char *secret, uint8_t lane)
+{
+    if (signer == NULL)
+    {
+        return;
+    }
+
+    (void)memset(signer, 0, sizeof(*signer));
+    signer->lane = lane;
+
+    if ((device_id == NULL) || (device_id[0] == '\0') || (secret == NULL) || (secret[0] == '\0'))
+    {
+        return;
+    }
+
+    (void)strncpy(signer->device_id, device_id, sizeof(signer->device_id) - 1U);
+    signer->device_id[sizeof(signer->device_id) - 1U] = '\0';
+    uplink_hmac_sha256_key_init(&signer->key, secret, strlen(secret));
+    signer->enabled = 1U;
+}
+
+/**
+ * @brief 是否还需要从服务端响应获取时间
+ *
+ * @return uint8_t 1=已启用签名但尚未对时
+ */
+uint8_t uplink_signer_need_clock(const uplink_signer_t *signer)
+{
+    return ((signer != NULL) && (signer->enabled != 0U) && (signer->clock_synced == 0U)) ? 1U : 0U;
+}
+
+/**
+ * @brief 判断应答是否为服务端签名校验失败
+ *
+ * @param ack 应答（HTTP 状态码）
+ * @param body 响应 body（可为 NULL）
+ * @param body_len body 长度
+ * @return uint8_t 1=签名校验失败
+ *
+ * @note 说明：
+ * - /api/push/stream 以 HTTP 401 表示；/api/uplink 固定返回 HTTP 200，以 code=5001 + msg="signature_*" 表示。
+ * - 其它 5001（如 service_busy、invalid_timestamp）不算，签名重发解决不了。
+ */
+uint8_t uplink_signer_rejected(const uplink_ack_t *ack, const char *body, size_t body_len)
+{
+    static const char prefix[] = "signature_";
+    int32_t code;
+    char msg[32];
+
+    if (ack == NULL)
+    {
+        return 0U;
+    }
+    if (ack->http_status == 401U)
+    {
+        return 1U;
+    }
+    if ((ack->http_status != 200U) || (body == NULL))
+    {
+        return 0U;
+    }
+    if ((uplink_codec_json_parse_app_code(body, body_len, &code) != UPLINK_OK) || (code != 5001))
+    {
+        return 0U;
+    }
+    if (uplink_codec_json_parse_str(body, body_len, "msg", msg, sizeof(msg)) != UPLINK_OK)
+    {
+        return 0U;
+    }
+    return (strncmp(msg, prefix, sizeof(prefix) - 1U) == 0) ? 1U : 0U;
+}
+
+/**
+ * @brief 从 HTTP 响应头中提取 Date，刷新时间偏移
+ *
+ * @param signer 签名器
+ * @param header 完整响应头（不要求 '\0' 结尾）
+ * @param header_len 响应头长度
+ * @param now_ms 收到响应时的本地毫秒计数
+ */
+void uplink_signer_observe_response(uplink_signer_t *signer, const char *header, size_t header_len, uint32_t now_ms)
+{
+    static const char name[] = "\ndate:";
+    const size_t n_len = sizeof(name) - 1U;
+    char value[40];
+    size_t i;
+    size_t j;
+
+    if ((signer == NULL) || (signer->enabled == 0U) || (header == NULL))
+    {
+        return;
+    }
+
+    for (i = 0U; (i + n_len) <= header_len; i++)
+    {
+        for (j = 0U; j < n_len; j++)
+        {
+            if (uplink_sign_lower(header[i + j]) != name[j])
+            {
+                break;
+            }
+        }
+
+        if (j == n_len)
+        {
+            uint32_t epoch_s;
+            size_t k = 0U;
+
+            i += n_len;
+            while ((i < header_len) && (header[i] == ' '))
+            {
+                i++;
+            }
+            while ((i < header_len) && (header[i] != '\r') && (header[i] != '\n') && (k < (sizeof(value) - 1U)))
+            {
+                value[k++] = header[i++];
+            }
+            value[k] = '\0';
+
+            if (uplink_sign_parse_http_date(value, &epoch_s) != 0U)
+            {
+                signer->epoch_at_boot_s = epoch_s - now_ms / 1000U;
+                signer->clock_synced = 1U;
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 生成签名头（追加到请求头缓冲）
+ *
+ * @param signer 签名器
+ * @param now_ms 本地毫秒计数
+ * @param body 请求 body（参与签名）
+ * @param body_len body 长度
+ * @param out_buf 输出缓冲（写入 4 行 "Name: value\r\n"，'\0' 结尾）
+ * @param out_buf_len 输出缓冲长度
+ * @param out_len 输出：写入长度；未启用或尚未对时为 0（发送不带签名的请求）
+ * @return uplink_err_t 结果
+ */
+uplink_err_t uplink_signer_append_headers(uplink_signer_t *signer,
+                                          uint32_t now_ms,
+                                          const char *body,
+                                          size_t body_len,
+                                          char *out_buf,
+                                          size_t out_buf_len,
+                                          size_t *out_len)
+{
+    static const char hex[] = "0123456789abcdef";
+    uplink_hmac_sha256_ctx_t hmac;
+    uint8_t mac[UPLINK_SHA256_DIGEST_LEN];
+    char ts[12];
+    char nonce[UPLINK_SIGN_NONCE_LEN + 1U];
+    char sig[UPLINK_SHA256_DIGEST_LEN * 2U + 1U];
+    uint32_t ts_s;
+    int ts_len;
+    int n;
+    uint32_t i;
+
+    if ((out_buf == NULL) || (out_len == NULL) || ((body == NULL) && (body_len != 0U)))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    *out_len = 0U;
+    if ((signer == NULL) || (signer->enabled == 0U) || (signer->clock_synced == 0U))
+    {
+        return UPLINK_OK;
+    }
+
+    ts_s = signer->epoch_at_boot_s + now_ms / 1000U;
+    ts_len = snprintf(ts, sizeof(ts), "%lu", (unsigned long)ts_s);
+
+    /* 时间戳在前：重启后计数器归零也不会与重启前（TTL 内）的 nonce 重复 */
+    (void)snprintf(nonce,
+                   sizeof(nonce),
+                   "%08lx%02x%06lx",
+                   (unsigned long)ts_s,
+                   (unsigned)signer->lane,
+                   (unsigned long)(signer->counter & 0xFFFFFFU));
+    signer->counter++;
+
+    uplink_hmac_sha256_start(&hmac, &signer->key);
+    uplink_hmac_sha256_update(&hmac, ts, (size_t)ts_len);
+    uplink_hmac_sha256_update(&hmac, "\n", 1U);
+    uplink_hmac_sha256_update(&hmac, nonce, UPLINK_SIGN_NONCE_LEN);
+    uplink_hmac_sha256_update(&hmac, "\n", 1U);
+    uplink_hmac_sha256_update(&hmac, body, body_len);
+    uplink_hmac_sha256_final(&hmac, mac);
+
+    for (i = 0U; i < UPLINK_SHA256_DIGEST_LEN; i++)
+    {
+        sig[i * 2U] = hex[mac[i] >> 4];
+        sig[i * 2U + 1U] = hex[mac[i] & 0x0FU];
+    }
+    sig[UPLINK_SHA256_DIGEST_LEN * 2U] = '\0';
+
+    n = snprintf(out_buf,
+                 out_buf_len,
+                 "X-Device-Id: %s\r\n"
+                 "X-Timestamp: %s\r\n"
+                 "X-Nonce: %s\r\n"
+                 "X-Signature: %s\r\n",
+                 signer->device_id,
+                 ts,
+                 nonce,
+                 sig);
+    if ((n < 0) || ((size_t)n >= out_buf_len))
+    {
+        return UPLINK_ERR_BUFFER_TOO_SMALL;
+    }
+
+    *out_len = (size_t)n;
+    return UPLINK_OK;
+}
@@ -21,6 +21,8 @@
 
 #include "uplink_transport_http_netconn.h"
 
+#include "uplink_dns.h"
+
 /* lwIP 头文件 */
 #include "api.h"
 #include "err.h"
@@ -112,107 +114,129 @@ static uint16_t uplink_http_parse_status(const char *header, size_t header_len)
 }
 
 /**
- * @brief 解析/解析 host 到 ip_addr_t
+ * @brief 解析 Retry-After 响应头（只支持秒数形式，HTTP-date 形式忽略）
  *
- * @param endpoint 服务器端点
- * @param out_addr 输出：解析得到的 IP 地址
- * @return uplink_err_t 结果
+ * @param header HTTP 响应头（'\0' 结尾）
+ * @param header_len header 长度
+ * @return uint32_t 暂缓时长（毫秒，0=没有该字段或无法解析）
  */
-static uplink_err_t uplink_resolve_host(const uplink_endpoint_t *endpoint, ip_addr_t *out_addr)
+static uint32_t uplink_http_parse_retry_after(const char *header, size_t header_len)
 {
-    /* 参数检查 */
-    if ((endpoint == NULL) || (out_addr == NULL))
-    {
-        return UPLINK_ERR_INVALID_ARG;
-    }
+    static const char name[] = "\nretry-after:";
+    const size_t n_len = sizeof(name) - 1U;
+    size_t i;
+    size_t j;
 
-    /* 优先支持“IP 字符串直转”（推荐先用 IP，避免 DNS 依赖） */
-    if (endpoint->use_dns == 0U)
+    for (i = 0U; (i + n_len) <= header_len; i++)
     {
-        /* ipaddr_aton 支持 "172.18.8.18" 这种格式 */
-        if (ipaddr_aton(endpoint->host, out_addr) == 0)
+        for (j = 0U; j < n_len; j++)
         {
-            return UPLINK_ERR_INVALID_ARG;
+            char c = header[i + j];
+            if ((c >= 'A') && (c <= 'Z'))
+            {
+                c = (char)(c - 'A' + 'a');
+            }
+            if (c != name[j])
+            {
+                break;
+            }
         }
-        return UPLINK_OK;
-    }
 
-    /**
-     * DNS 解析（可选）
-     * - 仅当 LWIP_DNS=1 时可用
-     * - 如果未开启 DNS，这里会返回“不支持”
-     */
-#if LWIP_DNS
-    {
-        err_t err = netconn_gethostbyname(endpoint->host, out_addr);
-        if (err != ERR_OK)
+        if (j == n_len)
         {
-            return UPLINK_ERR_TRANSPORT;
+            uint32_t sec = 0U;
+
+            i += n_len;
+            while ((i < header_len) && (header[i] == ' '))
+            {
+                i++;
+            }
+            while ((i < header_len) && (header[i] >= '0') && (header[i] <= '9') && (sec < 86400U))
+            {
+                sec = sec * 10U + (uint32_t)(header[i] - '0');
+                i++;
+            }
+            return (sec < 86400U) ? (sec * 1000U) : (86400U * 1000U);
         }
-        return UPLINK_OK;
     }
-#else
-    (void)endpoint;
-    (void)out_addr;
-    return UPLINK_ERR_UNSUPPORTED;
-#endif
+
+    return 0U;
 }
 
+/** uplink_http_req_recv 的返回值 */
+#define UPLINK_HTTP_RX_MORE 0U    /* 收到数据，响应可能还没结束 */
+#define UPLINK_HTTP_RX_TIMEOUT 1U /* 本次等待超时，连接仍然有效 */
+#define UPLINK_HTTP_RX_END 2U     /* 对端关闭或连接出错，接收结束 */
+
 /**
- * @brief netconn 实现：发送 HTTP POST(JSON) 并读取响应
- * 
+ * @brief 放弃请求：直接断开连接（发送失败或对冲请求已有更快的应答）
  */
-static uplink_err_t uplink_http_netconn_post_json(void *ctx,
-                                                  const uplink_endpoint_t *endpoint,
-                                                  const uplink_platform_t *platform,
-                                                  const char *json,
-                                                  size_t json_len,
-                                                  uint32_t send_timeout_ms,
-                                                  uint32_t recv_timeout_ms,
-                                                  uplink_ack_t *ack,
-                                                  char *response_body_buf,
-                                                  size_t response_body_buf_len,
-                                                  size_t *out_response_body_len)
+static void uplink_http_req_abort(uplink_http_req_t *req)
 {
-    (void)ctx; /* 当前 ctx 预留未使用 */
+    if (req->conn != NULL)
+    {
+        (void)netconn_close(req->conn);
+        (void)netconn_delete(req->conn);
+        req->conn = NULL;
+    }
 
+    req->state = UPLINK_HTTP_REQ_DONE;
+    req->done_ms = (uint32_t)sys_now();
+}
+
+/**
+ * @brief 建连并发出请求（头部可带签名），不等待响应
+ *
+ * @param req 请求状态（由本函数初始化）
+ * @param signer 请求签名器（可为 NULL）
+ * @param content_encoding body 的 Content-Encoding（NULL=明文 JSON，不带该头）
+ * @return uplink_err_t UPLINK_OK=请求已发出，之后用 uplink_http_req_recv 接收
+ */
+static uplink_err_t uplink_http_req_open(uplink_http_req_t *req,
+                                         uplink_signer_t *signer,
+                                         const char *content_encoding,
+                                         const uplink_endpoint_t *endpoint,
+                                         const uplink_platform_t *platform,
+                                         const char *json,
+                                         size_t json_len,
+                                         uint32_t send_timeout_ms,
+                                         uplink_ack_t *ack,
+                                         char *response_body_buf,
+                                         size_t response_body_buf_len)
+{
     struct netconn *conn = NULL;
-    struct netbuf *inbuf = NULL;
     ip_addr_t server_addr;
     err_t err;
 
-    /* 用于保存响应头（只需要到 \r\n\r\n 为止） */
-    char header_buf[512];
-    size_t header_used = 0U;
-    uint8_t header_done = 0U;
-
-    /* 用于检测 \r\n\r\n 的滑动窗口（0x0D0A0D0A） */
-    uint32_t marker = 0U;
-
-    /* body 写入位置 */
-    size_t body_used = 0U;
-    uint8_t body_truncated = 0U;
-
     /* 参数检查 */
-    if ((endpoint == NULL) || (json == NULL) || (ack == NULL) ||
-        (response_body_buf == NULL) || (response_body_buf_len == 0U) ||
-        (out_response_body_len == NULL))
+    if ((req == NULL) || (endpoint == NULL) || (json == NULL) || (ack == NULL) ||
+        (response_body_buf == NULL) || (response_body_buf_len == 0U))
     {
         return UPLINK_ERR_INVALID_ARG;
     }
 
     /* 初始化输出，避免上层使用到旧值 */
+    (void)memset(req, 0, sizeof(*req));
+    req->ack = ack;
+    req->body = response_body_buf;
+    req->body_cap = response_body_buf_len;
+    req->state = UPLINK_HTTP_REQ_ACTIVE;
+    req->result = UPLINK_ERR_TRANSPORT;
+    req->start_ms = (uint32_t)sys_now();
     ack->http_status = 0U;
     ack->app_code = UPLINK_APP_CODE_UNKNOWN;
+    ack->retry_after_ms = 0U;
     response_body_buf[0] = '\0';
-    *out_response_body_len = 0U;
 
     /* 解析 host -> IP 地址 */
     {
-        uplink_err_t r = uplink_resolve_host(endpoint, &server_addr);
+        uplink_err_t r = uplink_dns_resolve(endpoint, &server_addr);
         if (r != UPLINK_OK)
         {
             uplink_logf(platform, UPLINK_LOG_ERROR, "[uplink] resolve host failed: %s\r\n", endpoint->host);
+            req->result = r;
+            req->state = UPLINK_HTTP_REQ_DONE;
+            req->done_ms = (uint32_t)sys_now();
             return r;
         }
     }
@@ -221,53 +245,78 @@ static uplink_err_t uplink_http_netconn_post_json(void *ctx,
     conn = netconn_new(NETCONN_TCP);
     if (conn == NULL)
     {
+        req->state = UPLINK_HTTP_REQ_DONE;
+        req->done_ms = (uint32_t)sys_now();
         return UPLINK_ERR_TRANSPORT;
     }
 
-    /* 设置发送/接收超时（单位 ms） */
+    /* 设置发送超时（单位 ms）；接收超时由每次 uplink_http_req_recv 设置 */
     netconn_set_sendtimeout(conn, send_timeout_ms);
-    netconn_set_recvtimeout(conn, recv_timeout_ms);
 
     /* 连接服务器 */
     err = netconn_connect(conn, &server_addr, endpoint->port);
     if (err != ERR_OK)
     {
         (void)netconn_delete(conn);
+        req->state = UPLINK_HTTP_REQ_DONE;
+        req->done_ms = (uint32_t)sys_now();
         return UPLINK_ERR_TRANSPORT;
     }
 
+    req->conn = conn;
+
     /* 发送 HTTP 头（不把整个请求拼成一块，避免占用大缓冲） */
     {
-        char req_hdr[256];
+        char req_hdr[320U + UPLINK_SIGN_HEADERS_MAX_LEN]; /* 请求行 + 固定头（路径/主机取最大长度时约 300B）+ 签名头 */
         int hdr_len;
+        size_t sign_len = 0U;
 
-        /* 生成请求行与必要头部 */
+        /* 生成请求行与必要头部（结尾空行最后再补，中间插入签名头） */
         hdr_len = snprintf(req_hdr,
-                           sizeof(req_hdr),
+                           sizeof(req_hdr) - UPLINK_SIGN_HEADERS_MAX_LEN,
                            "POST %s HTTP/1.1\r\n"
                            "Host: %s\r\n"
                            "Content-Type: application/json\r\n"
+                           "%s%s%s"
                            "Content-Length: %lu\r\n"
-                           "Connection: close\r\n"
-                           "\r\n",
+                           "Connection: close\r\n",
                            endpoint->path,
                            endpoint->host,
+                           (content_encoding != NULL) ? "Content-Encoding: " : "",
+                           (content_encoding != NULL) ? content_encoding : "",
+                           (content_encoding != NULL) ? "\r\n" : "",
                            (unsigned long)json_len);
 
         /* 检查 snprintf 结果 */
-        if (hdr_len < 0 || (size_t)hdr_len >= sizeof(req_hdr))
+        if (hdr_len < 0 || (size_t)hdr_len >= (sizeof(req_hdr) - UPLINK_SIGN_HEADERS_MAX_LEN))
+        {
+            uplink_http_req_abort(req);
+            req->result = UPLINK_ERR_BUFFER_TOO_SMALL;
+            return UPLINK_ERR_BUFFER_TOO_SMALL;
+        }
+
+        /* 签名头：HMAC 直接流式吸收 json，不复制 body */
+        if (uplink_signer_append_headers(signer,
+                                         (uint32_t)sys_now(),
+                                         json,
+                                         json_len,
+                                         &req_hdr[hdr_len],
+                                         sizeof(req_hdr) - (size_t)hdr_len - 2U,
+                                         &sign_len) != UPLINK_OK)
         {
-            (void)netconn_close(conn);
-            (void)netconn_delete(conn);
+            uplink_http_req_abort(req);
+            req->result = UPLINK_ERR_BUFFER_TOO_SMALL;
             return UPLINK_ERR_BUFFER_TOO_SMALL;
         }
+        hdr_len += (int)sign_len;
+        req_hdr[hdr_len++] = '\r';
+        req_hdr[hdr_len++] = '\n';
 
         /* 发送头部 */
         err = netconn_write(conn, req_hdr, (size_t)hdr_len, NETCONN_COPY);
         if (err != ERR_OK)
         {
-            (void)netconn_close(conn);
-            (void)netconn_delete(conn);
+            uplink_http_req_abort(req);
             return UPLINK_ERR_TRANSPORT;
         }
     }
@@ -276,105 +325,253 @@ static uplink_err_t uplink_http_netconn_post_json(void *ctx,
     err = netconn_write(conn, json, json_len, NETCONN_COPY);
     if (err != ERR_OK)
     {
-        (void)netconn_close(conn);
-        (void)netconn_delete(conn);
+        uplink_http_req_abort(req);
         return UPLINK_ERR_TRANSPORT;
     }
 
-    /* 接收响应：解析出 HTTP 状态码，并把 body 拷贝到 response_body_buf */
-    for (;;)
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 接收一段响应：解析出 HTTP 状态码，并把 body 拷贝到响应缓冲
+ *
+ * @param req 请求状态（state 必须为 ACTIVE）
+ * @param signer 请求签名器（可为 NULL，用响应 Date 对时）
+ * @param wait_ms 本次最长等待（毫秒）
+ * @return uint8_t UPLINK_HTTP_RX_MORE / UPLINK_HTTP_RX_TIMEOUT / UPLINK_HTTP_RX_END
+ */
+static uint8_t uplink_http_req_recv(uplink_http_req_t *req, uplink_signer_t *signer, uint32_t wait_ms)
+{
+    struct netbuf *inbuf = NULL;
+    err_t err;
+
+    netconn_set_recvtimeout(req->conn, (int)((wait_ms == 0U) ? 1U : wait_ms));
+    err = netconn_recv(req->conn, &inbuf);
+
+    if (err == ERR_TIMEOUT)
     {
-        err = netconn_recv(conn, &inbuf);
+        return UPLINK_HTTP_RX_TIMEOUT;
+    }
 
-        /* 连接关闭/超时等：结束接收循环 */
-        if (err != ERR_OK)
+    /* 连接关闭/出错：结束接收 */
+    if (err != ERR_OK)
+    {
+        return UPLINK_HTTP_RX_END;
+    }
+
+    /* 遍历 netbuf 内部 pbuf 链 */
+    netbuf_first(inbuf);
+    do
+    {
+        void *data = NULL;
+        u16_t len = 0U;
+
+        /* 取出当前片段的指针与长度 */
+        if (netbuf_data(inbuf, &data, &len) != ERR_OK || data == NULL || len == 0U)
         {
-            break;
+            continue;
         }
 
-        /* 遍历 netbuf 内部 pbuf 链 */
-        netbuf_first(inbuf);
-        do
+        /* 逐字节处理，便于跨片段寻找 \r\n\r\n */
+        for (u16_t i = 0U; i < len; i++)
         {
-            void *data = NULL;
-            u16_t len = 0U;
+            char ch = ((const char *)data)[i];
 
-            /* 取出当前片段的指针与长度 */
-            if (netbuf_data(inbuf, &data, &len) != ERR_OK || data == NULL || len == 0U)
+            if (req->header_done == 0U)
             {
-                continue;
-            }
+                /* 还在解析 header：尽量写入 header_buf（用于解析状态码） */
+                if (req->header_used < (sizeof(req->header_buf) - 1U))
+                {
+                    req->header_buf[req->header_used++] = ch;
+                    req->header_buf[req->header_used] = '\0';
+                }
 
-            /* 逐字节处理，便于跨片段寻找 \r\n\r\n */
-            for (u16_t i = 0U; i < len; i++)
-            {
-                char ch = ((const char *)data)[i];
+                /* 更新 marker，用于检测 \r\n\r\n（0x0D0A0D0A） */
+                req->marker = (req->marker << 8) | (uint8_t)ch;
+                if (req->marker == 0x0D0A0D0AU)
+                {
+                    /* header 已结束 */
+                    req->header_done = 1U;
+                    req->header_buf[req->header_used] = '\0';
 
-                if (header_done == 0U)
+                    /* 解析 HTTP 状态码 */
+                    req->ack->http_status = uplink_http_parse_status(req->header_buf, req->header_used);
+                    req->ack->retry_after_ms = uplink_http_parse_retry_after(req->header_buf, req->header_used);
+
+                    /* 用响应 Date 刷新签名时钟（任何状态码的响应都带 Date） */
+                    uplink_signer_observe_response(signer, req->header_buf, req->header_used, (uint32_t)sys_now());
+                }
+            }
+            else
+            {
+                /* header 已结束：后续数据都属于 body */
+                if (req->body_used < (req->body_cap - 1U))
                 {
-                    /* 还在解析 header：尽量写入 header_buf（用于解析状态码） */
-                    if (header_used < (sizeof(header_buf) - 1U))
-                    {
-                        header_buf[header_used++] = ch;
-                        header_buf[header_used] = '\0';
-                    }
-
-                    /* 更新 marker，用于检测 \r\n\r\n */
-                    marker = (marker << 8) | (uint8_t)ch;
-                    if (marker == 0x0D0A0D0AU)
-                    {
-                        /* header 已结束 */
-                        header_done = 1U;
-                        header_buf[header_used] = '\0';
-
-                        /* 解析 HTTP 状态码 */
-                        ack->http_status = uplink_http_parse_status(header_buf, header_used);
-                    }
+                    req->body[req->body_used++] = ch;
+                    req->body[req->body_used] = '\0';
                 }
                 else
                 {
-                    /* header 已结束：后续数据都属于 body */
-                    if (body_used < (response_body_buf_len - 1U))
-                    {
-                        response_body_buf[body_used++] = ch;
-                        response_body_buf[body_used] = '\0';
-                    }
-                    else
-                    {
-                        /* body 缓冲区不足：标记截断，但仍继续把数据读完（避免影响 TCP 状态） */
-                        body_truncated = 1U;
-                    }
+                    /* body 缓冲区不足：标记截断，但仍继续把数据读完（避免影响 TCP 状态） */
+                    req->body_truncated = 1U;
                 }
             }
+        }
 
-        } while (netbuf_next(inbuf) >= 0);
+    } while (netbuf_next(inbuf) >= 0);
 
-        /* 释放 netbuf */
-        netbuf_delete(inbuf);
-        inbuf = NULL;
-    }
+    /* 释放 netbuf */
+    netbuf_delete(inbuf);
+    return UPLINK_HTTP_RX_MORE;
+}
 
+/**
+ * @brief 接收结束：关闭连接并给出本次请求结果
+ *
+ * @param req 请求状态
+ * @return uplink_err_t 结果（同时写入 req->result）
+ */
+static uplink_err_t uplink_http_req_finish(uplink_http_req_t *req)
+{
     /* 主动关闭并释放连接 */
-    (void)netconn_close(conn);
-    (void)netconn_delete(conn);
-    conn = NULL;
+    if (req->conn != NULL)
+    {
+        (void)netconn_close(req->conn);
+        (void)netconn_delete(req->conn);
+        req->conn = NULL;
+    }
 
-    /* 输出 body 长度 */
-    *out_response_body_len = body_used;
+    req->state = UPLINK_HTTP_REQ_DONE;
+    req->done_ms = (uint32_t)sys_now();
 
-    /* 若 header 未解析完成，说明响应格式异常 */
-    if (header_done == 0U)
+    if (req->header_done == 0U)
     {
-        return UPLINK_ERR_TRANSPORT;
+        /* header 未解析完成，说明响应格式异常或超时 */
+        req->result = UPLINK_ERR_TRANSPORT;
+    }
+    else if (req->body_truncated != 0U)
+    {
+        /* body 被截断：提示上层增大缓冲区 */
+        req->result = UPLINK_ERR_BUFFER_TOO_SMALL;
+    }
+    else
+    {
+        req->result = UPLINK_OK;
     }
 
-    /* body 被截断：提示上层增大缓冲区 */
-    if (body_truncated != 0U)
+    return req->result;
+}
+
+/**
+ * @brief 一次完整的 HTTP POST(JSON) 交互：建连 -> 发送（可带签名头）-> 读取响应 -> 关闭
+ *
+ * @param signer 请求签名器（可为 NULL）
+ * @param content_encoding body 的 Content-Encoding（NULL=明文 JSON）
+ */
+static uplink_err_t uplink_http_netconn_exchange(uplink_signer_t *signer,
+                                                 const char *content_encoding,
+                                                 const uplink_endpoint_t *endpoint,
+                                                 const uplink_platform_t *platform,
+                                                 const char *json,
+                                                 size_t json_len,
+                                                 uint32_t send_timeout_ms,
+                                                 uint32_t recv_timeout_ms,
+                                                 uplink_ack_t *ack,
+                                                 char *response_body_buf,
+                                                 size_t response_body_buf_len,
+                                                 size_t *out_response_body_len)
+{
+    uplink_http_req_t req;
+    uplink_err_t r;
+
+    if (out_response_body_len == NULL)
     {
-        return UPLINK_ERR_BUFFER_TOO_SMALL;
+        return UPLINK_ERR_INVALID_ARG;
     }
+    *out_response_body_len = 0U;
 
-    return UPLINK_OK;
+    r = uplink_http_req_open(&req,
+                             signer,
+                             content_encoding,
+                             endpoint,
+                             platform,
+                             json,
+                             json_len,
+                             send_timeout_ms,
+                             ack,
+                             response_body_buf,
+                             response_body_buf_len);
+    if (r != UPLINK_OK)
+    {
+        return r;
+    }
+
+    /* 每次等待 recv_timeout_ms：超时或对端关闭即结束（服务端 Connection: close） */
+    while (uplink_http_req_recv(&req, signer, recv_timeout_ms) == UPLINK_HTTP_RX_MORE)
+    {
+    }
+
+    r = uplink_http_req_finish(&req);
+    *out_response_body_len = req.body_used;
+    return r;
+}
+
+/**
+ * @brief netconn 实现：发送 HTTP POST(JSON) 并读取响应
+ *
+ * @note 签名与对时：
+ * - 签名器尚未对时时只能发出不带签名的请求；若服务端强制签名拒绝（/api/uplink 为 200 + code=5001
+ *   msg=signature_*，推送流为 401），而这次响应已经带回 Date 完成对时，则立即签名重发一次，不消耗上层重试次数。
+ */
+static uplink_err_t uplink_http_netconn_post_json(void *ctx,
+                                                  const uplink_endpoint_t *endpoint,
+                                                  const uplink_platform_t *platform,
+                                                  const char *json,
+                                                  size_t json_len,
+                                                  uint32_t send_timeout_ms,
+                                                  uint32_t recv_timeout_ms,
+                                                  uplink_ack_t *ack,
+                                                  char *response_body_buf,
+                                                  size_t response_body_buf_len,
+                                                  size_t *out_response_body_len)
+{
+    uplink_signer_t *signer = (ctx != NULL) ? ((uplink_transport_http_netconn_ctx_t *)ctx)->signer : NULL;
+    const char *encoding = (ctx != NULL) ? ((uplink_transport_http_netconn_ctx_t *)ctx)->content_encoding : NULL;
+    uint8_t unsynced = uplink_signer_need_clock(signer);
+    uplink_err_t r;
+
+    r = uplink_http_netconn_exchange(signer,
+                                     encoding,
+                                     endpoint,
+                                     platform,
+                                     json,
+                                     json_len,
+                                     send_timeout_ms,
+                                     recv_timeout_ms,
+                                     ack,
+                                     response_body_buf,
+                                     response_body_buf_len,
+                                     out_response_body_len);
+
+    if ((r == UPLINK_OK) && (unsynced != 0U) && (uplink_signer_need_clock(signer) == 0U) &&
+        (uplink_signer_rejected(ack, response_body_buf, *out_response_body_len) != 0U))
+    {
+        uplink_logf(platform, UPLINK_LOG_DEBUG, "[uplink] clock synced from Date, resend signed\r\n");
+        r = uplink_http_netconn_exchange(signer,
+                                         encoding,
+                                         endpoint,
+                                         platform,
+                                         json,
+                                         json_len,
+                                         send_timeout_ms,
+                                         recv_timeout_ms,
+                                         ack,
+                                         response_body_buf,
+                                         response_body_buf_len,
+                                         out_response_body_len);
+    }
+
+    return r;
 }
 
 /**
@@ -392,7 +589,485 @@ void uplink_transport_http_netconn_bind(uplink_transport_t *out_transport,
         return;
     }
 
+    /* 默认不签名、body 为明文 JSON，需要时由 set_signer / set_content_encoding 挂接 */
+    ctx->signer = NULL;
+    ctx->content_encoding = NULL;
+    ctx->parallel_work = NULL;
+    ctx->parallel_count = 0U;
+
     /* 绑定函数指针与上下文 */
     out_transport->ctx = (void *)ctx;
     out_transport->post_json = uplink_http_netconn_post_json;
+
+    /* 一问一答的短连接实现，不支持异步流水 */
+    out_transport->max_inflight = 1U;
+    out_transport->submit_json = NULL;
+    out_transport->poll_acks = NULL;
+    out_transport->max_parallel = 1U;
+    out_transport->post_json_parallel = NULL;
+}
+
+/**
+ * @brief 挂接请求签名器（需在 bind 之后调用）
+ *
+ * @param ctx netconn 实现私有上下文
+ * @param signer 签名器（NULL=不签名）
+ */
+void uplink_transport_http_netconn_set_signer(uplink_transport_http_netconn_ctx_t *ctx, uplink_signer_t *signer)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    ctx->signer = signer;
+}
+
+/**
+ * @brief 设置请求 body 的 Content-Encoding（需在 bind 之后调用）
+ *
+ * @param ctx netconn 实现私有上下文
+ * @param content_encoding 编码名（如 UPLINK_LZSS_CONTENT_ENCODING，需长期有效）；NULL=明文 JSON
+ *
+ * @note 只负责带上请求头，body 由上层按该编码事先压缩好再交给 post_json。
+ */
+void uplink_transport_http_netconn_set_content_encoding(uplink_transport_http_netconn_ctx_t *ctx,
+                                                        const char *content_encoding)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    ctx->content_encoding = content_encoding;
+}
+
+/**
+ * @brief 对冲请求中某一路是否拿到了可用应答（有状态码且非 5xx）
+ */
+static uint8_t uplink_http_req_usable(const uplink_http_req_t *req)
+{
+    return ((req->state == UPLINK_HTTP_REQ_DONE) && (req->cancelled == 0U) &&
+            ((req->result == UPLINK_OK) || (req->result == UPLINK_ERR_BUFFER_TOO_SMALL)) &&
+            (req->ack->http_status != 0U) && (req->ack->http_status < 500U)) ? 1U : 0U;
+}
+
+/**
+ * @brief 对冲发送：首选端点超过 hedge_after_ms 仍未应答时，把同一请求发往备用端点，先到的有效应答胜出
+ *
+ * @param ctx HTTP 实现私有上下文（签名器对两路请求都生效）
+ * @param work 工作区（两路请求状态 + 备用响应缓冲）
+ * @param primary 首选端点
+ * @param secondary 备用端点（NULL=不对冲，等价于普通请求）
+ * @param platform 平台回调（可为 NULL）
+ * @param json 请求 JSON（两路发送同一内容，messageId 相同，服务端按幂等处理）
+ * @param json_len JSON 长度
+ * @param send_timeout_ms 发送超时（毫秒）
+ * @param recv_timeout_ms 每一路从发出到收完应答的时限（毫秒）
+ * @param hedge_after_ms 对冲阈值（毫秒）；首选端点提前失败时立即发出备用请求
+ * @param ack 输出：胜出一路的状态码
+ * @param response_body_buf 输出：胜出一路的响应 body
+ * @param response_body_buf_len response_body_buf 总长度
+ * @param out_response_body_len 输出：body 长度
+ * @param out_winner 输出：0=首选胜出，1=备用胜出，0xFF=两路都没有可用应答（可为 NULL）
+ * @return uplink_err_t 胜出一路的结果；都失败时返回首选端点的结果
+ *
+ * @note 说明：
+ * - 有效应答 = 有 HTTP 状态码且非 5xx；5xx/超时/断开的一路不参与胜出，继续等另一路。
+ * - 一路胜出后立即断开另一路（cancelled=1）；调用者按 work->req[] 反馈端点健康度。
+ * - 只有一路在途时按剩余时间阻塞等待；两路都在途时轮流以 UPLINK_HTTP_HEDGE_POLL_MS 为片等待。
+ */
+static uplink_err_t uplink_http_netconn_hedged_once(uplink_transport_http_netconn_ctx_t *ctx,
+                                                    uplink_http_hedge_t *work,
+                                                    const uplink_endpoint_t *primary,
+                                                    const uplink_endpoint_t *secondary,
+                                                    const uplink_platform_t *platform,
+                                                    const char *json,
+                                                    size_t json_len,
+                                                    uint32_t send_timeout_ms,
+                                                    uint32_t recv_timeout_ms,
+                                                    uint32_t hedge_after_ms,
+                                                    uplink_ack_t *ack,
+                                                    char *response_body_buf,
+                                                    size_t response_body_buf_len,
+                                                    size_t *out_response_body_len,
+                                                    uint8_t *out_winner)
+{
+    uplink_signer_t *signer = (ctx != NULL) ? ctx->signer : NULL;
+    const char *encoding = (ctx != NULL) ? ctx->content_encoding : NULL;
+    uplink_http_req_t *req;
+    uint8_t winner = 0xFFU;
+    uint8_t i;
+
+    if ((work == NULL) || (primary == NULL) || (json == NULL) || (ack == NULL) ||
+        (response_body_buf == NULL) || (response_body_buf_len == 0U) || (out_response_body_len == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    (void)memset(work->req, 0, sizeof(work->req));
+    *out_response_body_len = 0U;
+
+    /* 首选端点：建连失败时 req[0] 直接进入 DONE，下面会立刻发出备用请求 */
+    (void)uplink_http_req_open(&work->req[0],
+                               signer,
+                               encoding,
+                               primary,
+                               platform,
+                               json,
+                               json_len,
+                               send_timeout_ms,
+                               ack,
+                               response_body_buf,
+                               response_body_buf_len);
+
+    for (;;)
+    {
+        uint32_t now_ms = (uint32_t)sys_now();
+        uint8_t active = 0U;
+
+        /* 发出对冲请求：首选端点已失败，或超过阈值仍未应答 */
+        if ((secondary != NULL) && (work->req[1].state == UPLINK_HTTP_REQ_IDLE) &&
+            ((work->req[0].state == UPLINK_HTTP_REQ_DONE) ||
+             ((uint32_t)(now_ms - work->req[0].start_ms) >= hedge_after_ms)))
+        {
+            if (uplink_http_req_usable(&work->req[0]) == 0U)
+            {
+                uplink_logf(platform, UPLINK_LOG_DEBUG, "[uplink] hedge to %s:%u\r\n",
+                            secondary->host, (unsigned)secondary->port);
+                (void)uplink_http_req_open(&work->req[1],
+                                           signer,
+                                           encoding,
+                                           secondary,
+                                           platform,
+                                           json,
+                                           json_len,
+                                           send_timeout_ms,
+                                           &work->hedge_ack,
+                                           work->hedge_body,
+                                           sizeof(work->hedge_body));
+                now_ms = (uint32_t)sys_now();
+            }
+        }
+
+        /* 先到的有效应答胜出 */
+        for (i = 0U; i < 2U; i++)
+        {
+            if (uplink_http_req_usable(&work->req[i]) != 0U)
+            {
+                winner = i;
+                break;
+            }
+            if (work->req[i].state == UPLINK_HTTP_REQ_ACTIVE)
+            {
+                active++;
+            }
+        }
+
+        if ((winner != 0xFFU) ||
+            ((active == 0U) && ((secondary == NULL) || (work->req[1].state != UPLINK_HTTP_REQ_IDLE))))
+        {
+            break;
+        }
+
+        /* 等待应答：单路在途时等到对冲时刻或截止时刻，两路在途时轮流短等 */
+        for (i = 0U; i < 2U; i++)
+        {
+            uint32_t elapsed;
+            uint32_t wait_ms;
+            uint8_t rx;
+
+            req = &work->req[i];
+            if (req->state != UPLINK_HTTP_REQ_ACTIVE)
+            {
+                continue;
+            }
+
+            elapsed = (uint32_t)(now_ms - req->start_ms);
+            if (elapsed >= recv_timeout_ms)
+            {
+                (void)uplink_http_req_finish(req);
+                continue;
+            }
+
+            wait_ms = recv_timeout_ms - elapsed;
+            if (active > 1U)
+            {
+                wait_ms = (wait_ms < UPLINK_HTTP_HEDGE_POLL_MS) ? wait_ms : UPLINK_HTTP_HEDGE_POLL_MS;
+            }
+            else if ((i == 0U) && (secondary != NULL) && (work->req[1].state == UPLINK_HTTP_REQ_IDLE) &&
+                     (hedge_after_ms > elapsed) && ((hedge_after_ms - elapsed) < wait_ms))
+            {
+                wait_ms = hedge_after_ms - elapsed;
+            }
+
+            rx = uplink_http_req_recv(req, signer, wait_ms);
+            while (rx == UPLINK_HTTP_RX_MORE)
+            {
+                /* 数据到达后短等剩余部分（服务端 Connection: close，应答一般一两个报文） */
+                rx = uplink_http_req_recv(req, signer, UPLINK_HTTP_HEDGE_POLL_MS);
+            }
+
+            if (rx == UPLINK_HTTP_RX_END)
+            {
+                (void)uplink_http_req_finish(req);
+            }
+            else if ((uint32_t)((uint32_t)sys_now() - req->start_ms) >= recv_timeout_ms)
+            {
+                (void)uplink_http_req_finish(req);
+            }
+        }
+    }
+
+    /* 放弃落后的一路 */
+    for (i = 0U; i < 2U; i++)
+    {
+        if (work->req[i].state == UPLINK_HTTP_REQ_ACTIVE)
+        {
+            uplink_http_req_abort(&work->req[i]);
+            work->req[i].cancelled = 1U;
+        }
+    }
+
+    if (out_winner != NULL)
+    {
+        *out_winner = winner;
+    }
+
+    if (winner == 1U)
+    {
+        size_t n = work->req[1].body_used;
+
+        if (n >= response_body_buf_len)
+        {
+            n = response_body_buf_len - 1U;
+        }
+        (void)memcpy(response_body_buf, work->hedge_body, n);
+        response_body_buf[n] = '\0';
+        *ack = work->hedge_ack;
+        *out_response_body_len = n;
+        return work->req[1].result;
+    }
+
+    *out_response_body_len = work->req[0].body_used;
+    return work->req[0].result;
+}
+
+/**
+ * @brief 对冲发送（对外接口）：参数与行为见 uplink_http_netconn_hedged_once
+ *
+ * @note 签名器尚未对时时两路都不带签名；服务端强制签名拒绝且已从应答 Date 对时后，签名整体重发一次。
+ */
+uplink_err_t uplink_transport_http_netconn_post_json_hedged(uplink_transport_http_netconn_ctx_t *ctx,
+                                                            uplink_http_hedge_t *work,
+                                                            const uplink_endpoint_t *primary,
+                                                            const uplink_endpoint_t *secondary,
+                                                            const uplink_platform_t *platform,
+                                                            const char *json,
+                                                            size_t json_len,
+                                                            uint32_t send_timeout_ms,
+                                                            uint32_t recv_timeout_ms,
+                                                            uint32_t hedge_after_ms,
+                                                            uplink_ack_t *ack,
+                                                            char *response_body_buf,
+                                                            size_t response_body_buf_len,
+                                                            size_t *out_response_body_len,
+                                                            uint8_t *out_winner)
+{
+    uplink_signer_t *signer = (ctx != NULL) ? ctx->signer : NULL;
+    uint8_t unsynced = uplink_signer_need_clock(signer);
+    uplink_err_t r;
+
+    r = uplink_http_netconn_hedged_once(ctx, work, primary, secondary, platform, json, json_len,
+                                        send_timeout_ms, recv_timeout_ms, hedge_after_ms,
+                                        ack, response_body_buf, response_body_buf_len,
+                                        out_response_body_len, out_winner);
+
+    /* 与 post_json 相同：未对时的请求被拒，且这次应答已带回 Date，签名后整体重来一次 */
+    if ((r == UPLINK_OK) && (unsynced != 0U) && (uplink_signer_need_clock(signer) == 0U) &&
+        (uplink_signer_rejected(ack, response_body_buf, *out_response_body_len) != 0U))
+    {
+        uplink_logf(platform, UPLINK_LOG_DEBUG, "[uplink] clock synced from Date, resend signed\r\n");
+        r = uplink_http_netconn_hedged_once(ctx, work, primary, secondary, platform, json, json_len,
+                                            send_timeout_ms, recv_timeout_ms, hedge_after_ms,
+                                            ack, response_body_buf, response_body_buf_len,
+                                            out_response_body_len, out_winner);
+    }
+
+    return r;
+}
+
+/**
+ * @brief 并发发送：多路互相独立的请求依次建连发出，再一起等待应答
+ *
+ * @note 说明：
+ * - 建连是阻塞的，后面的请求建连时前面的请求已在上级处理，总耗时约为“逐路建连 + 最慢一路的应答”。
+ * - 签名器尚未对时时，第一路按 post_json 单独发送（签名被拒后对时重发），其余各路对时后再一起发出。
+ * - 有多路在途时轮流以 UPLINK_HTTP_HEDGE_POLL_MS 为片等待；某一路超时或断开不影响其他路。
+ */
+static void uplink_http_netconn_post_json_parallel(void *ctx,
+                                                   const uplink_endpoint_t *endpoint,
+                                                   const uplink_platform_t *platform,
+                                                   uplink_post_t *posts,
+                                                   uint8_t count,
+                                                   uint32_t send_timeout_ms,
+                                                   uint32_t recv_timeout_ms)
+{
+    uplink_transport_http_netconn_ctx_t *hctx = (uplink_transport_http_netconn_ctx_t *)ctx;
+    uplink_http_req_t *work;
+    uint8_t first = 0U;
+    uint8_t i;
+
+    if ((hctx == NULL) || (posts == NULL))
+    {
+        return;
+    }
+
+    work = hctx->parallel_work;
+    for (i = 0U; i < count; i++)
+    {
+        posts[i].body_len = 0U;
+        posts[i].result = UPLINK_ERR_INVALID_ARG;
+        posts[i].start_ms = (uint32_t)sys_now();
+        posts[i].done_ms = posts[i].start_ms;
+    }
+    if ((work == NULL) || (count > hctx->parallel_count))
+    {
+        return;
+    }
+    (void)memset(work, 0, (size_t)count * sizeof(work[0]));
+
+    if (uplink_signer_need_clock(hctx->signer) != 0U)
+    {
+        posts[0].result = uplink_http_netconn_post_json(ctx,
+                                                        endpoint,
+                                                        platform,
+                                                        posts[0].json,
+                                                        posts[0].json_len,
+                                                        send_timeout_ms,
+                                                        recv_timeout_ms,
+                                                        &posts[0].ack,
+                                                        posts[0].body,
+                                                        posts[0].body_cap,
+                                                        &posts[0].body_len);
+        posts[0].done_ms = (uint32_t)sys_now();
+        first = 1U;
+    }
+
+    /* 依次发出（建连失败的一路直接进入 DONE） */
+    for (i = first; i < count; i++)
+    {
+        (void)uplink_http_req_open(&work[i],
+                                   hctx->signer,
+                                   hctx->content_encoding,
+                                   endpoint,
+                                   platform,
+                                   posts[i].json,
+                                   posts[i].json_len,
+                                   send_timeout_ms,
+                                   &posts[i].ack,
+                                   posts[i].body,
+                                   posts[i].body_cap);
+    }
+
+    for (;;)
+    {
+        uint32_t now_ms = (uint32_t)sys_now();
+        uint8_t active = 0U;
+
+        for (i = first; i < count; i++)
+        {
+            if (work[i].state != UPLINK_HTTP_REQ_ACTIVE)
+            {
+                continue;
+            }
+            if ((uint32_t)(now_ms - work[i].start_ms) >= recv_timeout_ms)
+            {
+                (void)uplink_http_req_finish(&work[i]);
+                continue;
+            }
+            active++;
+        }
+
+        if (active == 0U)
+        {
+            break;
+        }
+
+        for (i = first; i < count; i++)
+        {
+            uplink_http_req_t *req = &work[i];
+            uint32_t wait_ms;
+            uint8_t rx;
+
+            if (req->state != UPLINK_HTTP_REQ_ACTIVE)
+            {
+                continue;
+            }
+
+            wait_ms = recv_timeout_ms - (uint32_t)(now_ms - req->start_ms);
+            if ((active > 1U) && (wait_ms > UPLINK_HTTP_HEDGE_POLL_MS))
+            {
+                wait_ms = UPLINK_HTTP_HEDGE_POLL_MS;
+            }
+
+            rx = uplink_http_req_recv(req, hctx->signer, wait_ms);
+            while (rx == UPLINK_HTTP_RX_MORE)
+            {
+                rx = uplink_http_req_recv(req, hctx->signer, UPLINK_HTTP_HEDGE_POLL_MS);
+            }
+
+            if ((rx == UPLINK_HTTP_RX_END) ||
+                ((uint32_t)((uint32_t)sys_now() - req->start_ms) >= recv_timeout_ms))
+            {
+                (void)uplink_http_req_finish(req);
+            }
+        }
+    }
+
+    for (i = first; i < count; i++)
+    {
+        posts[i].body_len = work[i].body_used;
+        posts[i].result = work[i].result;
+        posts[i].start_ms = work[i].start_ms;
+        posts[i].done_ms = work[i].done_ms;
+    }
+}
+
+/**
+ * @brief 挂接并发请求工作区并启用 post_json_parallel（需在 bind 之后调用）
+ *
+ * @param transport 已 bind 的通用 transport 接口
+ * @param ctx netconn 实现私有上下文
+ * @param work 工作区（count 路请求状态，由调用者静态分配）
+ * @param count 工作区路数（超过 UPLINK_MAX_PARALLEL 按上限计；0 或 work 为 NULL 时关闭并发）
+ */
+void uplink_transport_http_netconn_enable_parallel(uplink_transport_t *transport,
+                                                   uplink_transport_http_netconn_ctx_t *ctx,
+                                                   uplink_http_req_t *work,
+                                                   uint8_t count)
+{
+    if ((transport == NULL) || (ctx == NULL))
+    {
+        return;
+    }
+
+    if (count > (uint8_t)UPLINK_MAX_PARALLEL)
+    {
+        count = (uint8_t)UPLINK_MAX_PARALLEL;
+    }
+
+    if ((work == NULL) || (count == 0U))
+    {
+        ctx->parallel_work = NULL;
+        ctx->parallel_count = 0U;
+        transport->max_parallel = 1U;
+        transport->post_json_parallel = NULL;
+        return;
+    }
+
+    ctx->parallel_work = work;
+    ctx->parallel_count = count;
+    transport->max_parallel = count;
+    transport->post_json_parallel = uplink_http_netconn_post_json_parallel;
 }
@@ -0,0 +1,776 @@
+/**
+ * @file    uplink_transport_mqtt_netconn.c
+ * @author  Yukikaze
+ * @brief   基于 lwIP Netconn TCP 的 MQTT 3.1.1 传输层实现（传输层-实现）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note 说明：
+ * - 只实现发布端需要的最小子集：CONNECT/CONNACK、PUBLISH(QoS1)/PUBACK、PINGREQ/PINGRESP、DISCONNECT。
+ * - 不订阅任何主题；收到其他类型报文按协议错误断线处理。
+ * - 建连是惰性的：首次 submit 或断线后的下一次 submit 才会连接 broker。
+ * - 断线时不自行重发：poll_acks 返回 UPLINK_ERR_TRANSPORT，由 uplink 核心把在途消息按同一 messageId
+ *   重新提交，本层查在途表发现“已发送过”即置 DUP 并沿用原 packetId。
+ * - 未做板上基准：与 HTTP 的 msgs/sec 对比没有板上数据，TASK_UPLINK_USE_MQTT 默认保持 0。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_transport_mqtt_netconn.h"
+
+#include "uplink_codec_json.h"
+#include "uplink_dns.h"
+
+/* lwIP 头文件 */
+#include "api.h"
+#include "err.h"
+#include "ip_addr.h"
+#include "opt.h"
+#include "sys.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+/** MQTT 控制报文类型（固定头高 4 位） */
+#define UPLINK_MQTT_CONNECT 0x10U
+#define UPLINK_MQTT_CONNACK 0x20U
+#define UPLINK_MQTT_PUBLISH 0x30U
+#define UPLINK_MQTT_PUBACK 0x40U
+#define UPLINK_MQTT_PINGREQ 0xC0U
+#define UPLINK_MQTT_PINGRESP 0xD0U
+#define UPLINK_MQTT_DISCONNECT 0xE0U
+
+/** PUBLISH 标志位：QoS1 与 DUP */
+#define UPLINK_MQTT_FLAG_QOS1 0x02U
+#define UPLINK_MQTT_FLAG_DUP 0x08U
+
+/**
+ * @brief 日志输出（内部工具函数）
+ *
+ * @param platform 平台回调（可为 NULL）
+ * @param level 日志等级
+ * @param fmt printf 格式
+ * @param ... 可变参数
+ */
+static void uplink_logf(const uplink_platform_t *platform, uplink_log_level_t level, const char *fmt, ...)
+{
+    if ((platform == NULL) || (platform->log == NULL))
+    {
+        return;
+    }
+
+    {
+        char buf[160];
+        va_list args;
+
+        va_start(args, fmt);
+        (void)vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+
+        platform->log(platform->user_ctx, level, buf);
+    }
+}
+
+/**
+ * @brief messageId 映射为 packetId（1..65535，同一 messageId 结果固定）
+ *
+ * @param message_id uplink 消息 ID
+ * @return uint16_t packetId
+ */
+static uint16_t uplink_mqtt_packet_id(uint32_t message_id)
+{
+    return (uint16_t)(((message_id - 1U) % 65535U) + 1U);
+}
+
+/**
+ * @brief 编码“剩余长度”（变长整数，每字节 7 位）
+ *
+ * @param out 输出缓冲（至少 4 字节）
+ * @param len 剩余长度
+ * @return uint8_t 编码后字节数
+ */
+static uint8_t uplink_mqtt_encode_len(uint8_t *out, uint32_t len)
+{
+    uint8_t n = 0U;
+
+    do
+    {
+        uint8_t b = (uint8_t)(len % 128U);
+        len /= 128U;
+        if (len > 0U)
+        {
+            b |= 0x80U;
+        }
+        out[n++] = b;
+    } while ((len > 0U) && (n < 4U));
+
+    return n;
+}
+
+/**
+ * @brief 断开连接并复位连接态（在途表保留，供重连后重发）
+ *
+ * @param m 传输层上下文
+ * @param platform 平台回调
+ * @param reason 断线原因（日志用）
+ */
+static void uplink_mqtt_close(uplink_transport_mqtt_netconn_ctx_t *m,
+                              const uplink_platform_t *platform,
+                              const char *reason)
+{
+    if (m->conn != NULL)
+    {
+        (void)netconn_close(m->conn);
+        (void)netconn_delete(m->conn);
+        m->conn = NULL;
+        m->disconnects++;
+
+        uplink_logf(platform, UPLINK_LOG_WARN, "[uplink-mqtt] disconnect: %s\r\n", reason);
+    }
+
+    m->rx_used = 0U;
+    m->ping_outstanding = 0U;
+}
+
+/**
+ * @brief 写出一段数据并刷新“最近发送时间”
+ *
+ * @param m 传输层上下文
+ * @param data 数据
+ * @param len 长度
+ * @param flags netconn_write 标志（NETCONN_COPY / NETCONN_MORE）
+ * @return err_t lwIP 错误码
+ */
+static err_t uplink_mqtt_write(uplink_transport_mqtt_netconn_ctx_t *m, const void *data, size_t len, u8_t flags)
+{
+    err_t err = netconn_write(m->conn, data, len, flags);
+
+    if (err == ERR_OK)
+    {
+        m->last_tx_ms = (uint32_t)sys_now();
+    }
+    return err;
+}
+
+/**
+ * @brief 从 rx_buf 头部取出一个完整报文
+ *
+ * @param m 传输层上下文
+ * @param out_type 输出：固定头首字节
+ * @param out_body 输出：可变头+载荷起始位置（指向 rx_buf 内部）
+ * @param out_body_len 输出：可变头+载荷长度
+ * @param out_total 输出：整个报文长度（供调用者消费）
+ * @return int8_t 1=取到；0=数据不足；-1=报文超出缓冲（协议错误）
+ */
+static int8_t uplink_mqtt_peek_packet(const uplink_transport_mqtt_netconn_ctx_t *m,
+                                      uint8_t *out_type,
+                                      const uint8_t **out_body,
+                                      uint32_t *out_body_len,
+                                      uint32_t *out_total)
+{
+    uint32_t len = 0U;
+    uint32_t mul = 1U;
+    uint16_t pos = 1U;
+
+    if (m->rx_used < 2U)
+    {
+        return 0;
+    }
+
+    /* 解析剩余长度（最多 4 字节） */
+    for (;;)
+    {
+        uint8_t b;
+
+        if (pos >= m->rx_used)
+        {
+            return 0;
+        }
+        if (pos > 4U)
+        {
+            return -1;
+        }
+
+        b = m->rx_buf[pos++];
+        len += (uint32_t)(b & 0x7FU) * mul;
+        mul *= 128U;
+        if ((b & 0x80U) == 0U)
+        {
+            break;
+        }
+    }
+
+    if ((pos + len) > UPLINK_MQTT_RX_BUF_LEN)
+    {
+        return -1;
+    }
+    if ((pos + len) > m->rx_used)
+    {
+        return 0;
+    }
+
+    *out_type = m->rx_buf[0];
+    *out_body = &m->rx_buf[pos];
+    *out_body_len = len;
+    *out_total = pos + len;
+    return 1;
+}
+
+/**
+ * @brief 丢弃 rx_buf 头部已处理的字节
+ *
+ * @param m 传输层上下文
+ * @param n 字节数
+ */
+static void uplink_mqtt_consume(uplink_transport_mqtt_netconn_ctx_t *m, uint32_t n)
+{
+    if (n >= m->rx_used)
+    {
+        m->rx_used = 0U;
+        return;
+    }
+
+    (void)memmove(m->rx_buf, &m->rx_buf[n], (size_t)(m->rx_used - n));
+    m->rx_used = (uint16_t)(m->rx_used - n);
+}
+
+/**
+ * @brief 接收一个 netbuf 追加到 rx_buf
+ *
+ * @param m 传输层上下文
+ * @param timeout_ms 接收超时（毫秒，>=1）
+ * @return err_t
+ * - ERR_OK：收到数据
+ * - ERR_TIMEOUT：超时无数据
+ * - ERR_BUF：报文超出缓冲（协议错误）
+ * - 其他：连接错误
+ */
+static err_t uplink_mqtt_recv(uplink_transport_mqtt_netconn_ctx_t *m, uint32_t timeout_ms)
+{
+    struct netbuf *inbuf = NULL;
+    u16_t len;
+    err_t err;
+
+    netconn_set_recvtimeout(m->conn, (int)((timeout_ms == 0U) ? 1U : timeout_ms));
+    err = netconn_recv(m->conn, &inbuf);
+    if (err != ERR_OK)
+    {
+        return err;
+    }
+
+    len = netbuf_len(inbuf);
+    if ((uint32_t)m->rx_used + len > UPLINK_MQTT_RX_BUF_LEN)
+    {
+        netbuf_delete(inbuf);
+        return ERR_BUF;
+    }
+
+    (void)netbuf_copy(inbuf, &m->rx_buf[m->rx_used], len);
+    m->rx_used = (uint16_t)(m->rx_used + len);
+    netbuf_delete(inbuf);
+    return ERR_OK;
+}
+
+/**
+ * @brief 建立连接并完成 CONNECT/CONNACK 握手（持久会话）
+ *
+ * @param m 传输层上下文
+ * @param endpoint 服务器端点
+ * @param platform 平台回调
+ * @param timeout_ms 建连与等待 CONNACK 的超时（毫秒）
+ * @return uplink_err_t 结果
+ */
+static uplink_err_t uplink_mqtt_connect(uplink_transport_mqtt_netconn_ctx_t *m,
+                                        const uplink_endpoint_t *endpoint,
+                                        const uplink_platform_t *platform,
+                                        uint32_t timeout_ms)
+{
+    ip_addr_t server_addr;
+    size_t id_len = strlen(m->client_id);
+    uint32_t remaining = 10U + 2U + (uint32_t)id_len;
+    uint8_t *p = m->tx_hdr;
+    uint32_t start_ms;
+
+    {
+        uplink_err_t r = uplink_dns_resolve(endpoint, &server_addr);
+        if (r != UPLINK_OK)
+        {
+            uplink_logf(platform, UPLINK_LOG_ERROR, "[uplink-mqtt] resolve host failed: %s\r\n", endpoint->host);
+            return r;
+        }
+    }
+
+    m->conn = netconn_new(NETCONN_TCP);
+    if (m->conn == NULL)
+    {
+        return UPLINK_ERR_TRANSPORT;
+    }
+
+    netconn_set_sendtimeout(m->conn, (int)timeout_ms);
+    if (netconn_connect(m->conn, &server_addr, endpoint->port) != ERR_OK)
+    {
+        (void)netconn_delete(m->conn);
+        m->conn = NULL;
+        return UPLINK_ERR_TRANSPORT;
+    }
+
+    m->rx_used = 0U;
+    m->ping_outstanding = 0U;
+
+    /* CONNECT：协议名 "MQTT"、级别 4、CleanSession=0（持久会话）、心跳、客户端 ID */
+    *p++ = (uint8_t)UPLINK_MQTT_CONNECT;
+    p += uplink_mqtt_encode_len(p, remaining);
+    *p++ = 0x00U;
+    *p++ = 0x04U;
+    *p++ = (uint8_t)'M';
+    *p++ = (uint8_t)'Q';
+    *p++ = (uint8_t)'T';
+    *p++ = (uint8_t)'T';
+    *p++ = 0x04U;
+    *p++ = 0x00U;
+    *p++ = (uint8_t)(m->keepalive_s >> 8);
+    *p++ = (uint8_t)m->keepalive_s;
+    *p++ = (uint8_t)(id_len >> 8);
+    *p++ = (uint8_t)id_len;
+    (void)memcpy(p, m->client_id, id_len);
+    p += id_len;
+
+    if (uplink_mqtt_write(m, m->tx_hdr, (size_t)(p - m->tx_hdr), NETCONN_COPY) != ERR_OK)
+    {
+        uplink_mqtt_close(m, platform, "connect write");
+        return UPLINK_ERR_TRANSPORT;
+    }
+
+    /* 等待 CONNACK */
+    start_ms = (uint32_t)sys_now();
+    for (;;)
+    {
+        uint8_t type = 0U;
+        const uint8_t *body = NULL;
+        uint32_t body_len = 0U;
+        uint32_t total = 0U;
+        uint32_t elapsed = (uint32_t)sys_now() - start_ms;
+        int8_t got = uplink_mqtt_peek_packet(m, &type, &body, &body_len, &total);
+
+        if (got > 0)
+        {
+            if ((type != (uint8_t)UPLINK_MQTT_CONNACK) || (body_len != 2U) || (body[1] != 0U))
+            {
+                uplink_logf(platform,
+                            UPLINK_LOG_ERROR,
+                            "[uplink-mqtt] connack rejected: type=0x%02x rc=%u\r\n",
+                            (unsigned)type,
+                            (unsigned)((body_len >= 2U) ? body[1] : 0xFFU));
+                uplink_mqtt_close(m, platform, "connack");
+                return UPLINK_ERR_TRANSPORT;
+            }
+
+            m->session_present = (uint8_t)(body[0] & 0x01U);
+            uplink_mqtt_consume(m, total);
+            break;
+        }
+
+        if ((got < 0) || (elapsed >= timeout_ms) ||
+            (uplink_mqtt_recv(m, timeout_ms - elapsed) != ERR_OK))
+        {
+            uplink_mqtt_close(m, platform, "connack timeout");
+            return UPLINK_ERR_TRANSPORT;
+        }
+    }
+
+    m->connects++;
+    uplink_logf(platform,
+                UPLINK_LOG_INFO,
+                "[uplink-mqtt] connected: session_present=%u\r\n",
+                (unsigned)m->session_present);
+    return UPLINK_OK;
+}
+
+/**
+ * @brief 查找或登记在途表项
+ *
+ * @param m 传输层上下文
+ * @param message_id uplink 消息 ID
+ * @return uplink_mqtt_inflight_t* 表项（表满时淘汰最旧项后复用）
+ */
+static uplink_mqtt_inflight_t *uplink_mqtt_track(uplink_transport_mqtt_netconn_ctx_t *m, uint32_t message_id)
+{
+    uplink_mqtt_inflight_t *slot = NULL;
+    uint32_t i;
+
+    for (i = 0U; i < (uint32_t)UPLINK_MAX_INFLIGHT; i++)
+    {
+        if ((m->inflight[i].used != 0U) && (m->inflight[i].message_id == message_id))
+        {
+            return &m->inflight[i];
+        }
+    }
+
+    /* 优先空闲项；没有则淘汰最旧项（上层已放弃的消息会残留在表中） */
+    for (i = 0U; i < (uint32_t)UPLINK_MAX_INFLIGHT; i++)
+    {
+        if (m->inflight[i].used == 0U)
+        {
+            slot = &m->inflight[i];
+            break;
+        }
+        if ((slot == NULL) || ((int32_t)(m->inflight[i].seq - slot->seq) < 0))
+        {
+            slot = &m->inflight[i];
+        }
+    }
+
+    (void)memset(slot, 0, sizeof(*slot));
+    slot->used = 1U;
+    slot->packet_id = uplink_mqtt_packet_id(message_id);
+    slot->message_id = message_id;
+    slot->seq = ++m->inflight_seq;
+    return slot;
+}
+
+/**
+ * @brief 处理 rx_buf 中所有完整报文（PUBACK/PINGRESP）
+ *
+ * @param m 传输层上下文
+ * @return uint8_t 1=正常；0=协议错误（需断线）
+ */
+static uint8_t uplink_mqtt_dispatch(uplink_transport_mqtt_netconn_ctx_t *m)
+{
+    for (;;)
+    {
+        uint8_t type = 0U;
+        const uint8_t *body = NULL;
+        uint32_t body_len = 0U;
+        uint32_t total = 0U;
+        int8_t got = uplink_mqtt_peek_packet(m, &type, &body, &body_len, &total);
+
+        if (got == 0)
+        {
+            return 1U;
+        }
+        if (got < 0)
+        {
+            return 0U;
+        }
+
+        if ((type == (uint8_t)UPLINK_MQTT_PUBACK) && (body_len == 2U))
+        {
+            uint16_t pid = (uint16_t)(((uint16_t)body[0] << 8) | body[1]);
+            uint32_t i;
+
+            /* 按 packetId 反查在途表；找不到的（重复 PUBACK）直接忽略 */
+            for (i = 0U; i < (uint32_t)UPLINK_MAX_INFLIGHT; i++)
+            {
+                if ((m->inflight[i].used != 0U) && (m->inflight[i].acked == 0U) &&
+                    (m->inflight[i].packet_id == pid))
+                {
+                    m->inflight[i].acked = 1U;
+                    m->rx_puback++;
+                    break;
+                }
+            }
+        }
+        else if ((type == (uint8_t)UPLINK_MQTT_PINGRESP) && (body_len == 0U))
+        {
+            m->ping_outstanding = 0U;
+        }
+        else
+        {
+            /* 未订阅任何主题，其他报文一律视为协议错误 */
+            return 0U;
+        }
+
+        uplink_mqtt_consume(m, total);
+    }
+}
+
+/**
+ * @brief netconn MQTT 实现：异步发布一条 QoS1 消息
+ *
+ */
+static uplink_err_t uplink_mqtt_netconn_submit_json(void *ctx,
+                                                    const uplink_endpoint_t *endpoint,
+                                                    const uplink_platform_t *platform,
+                                                    uint32_t message_id,
+                                                    const char *json,
+                                                    size_t json_len,
+                                                    uint32_t send_timeout_ms)
+{
+    uplink_transport_mqtt_netconn_ctx_t *m = (uplink_transport_mqtt_netconn_ctx_t *)ctx;
+    uplink_mqtt_inflight_t *slot;
+    size_t topic_len;
+    uint32_t remaining;
+    uint8_t *p;
+    uint8_t dup;
+
+    if ((m == NULL) || (endpoint == NULL) || (json == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    topic_len = strlen(endpoint->path);
+    if ((topic_len == 0U) || (topic_len >= UPLINK_MAX_PATH_LEN))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    if (m->conn == NULL)
+    {
+        uplink_err_t r = uplink_mqtt_connect(m, endpoint, platform, send_timeout_ms);
+        if (r != UPLINK_OK)
+        {
+            return r;
+        }
+    }
+
+    slot = uplink_mqtt_track(m, message_id);
+    slot->acked = 0U;
+    dup = slot->sent;
+
+    /* PUBLISH 头：固定头 + 主题 + packetId；载荷（JSON）单独写出，避免再拷贝一遍 */
+    remaining = 2U + (uint32_t)topic_len + 2U + (uint32_t)json_len;
+    p = m->tx_hdr;
+    *p++ = (uint8_t)(UPLINK_MQTT_PUBLISH | UPLINK_MQTT_FLAG_QOS1 | ((dup != 0U) ? UPLINK_MQTT_FLAG_DUP : 0U));
+    p += uplink_mqtt_encode_len(p, remaining);
+    *p++ = (uint8_t)(topic_len >> 8);
+    *p++ = (uint8_t)topic_len;
+    (void)memcpy(p, endpoint->path, topic_len);
+    p += topic_len;
+    *p++ = (uint8_t)(slot->packet_id >> 8);
+    *p++ = (uint8_t)slot->packet_id;
+
+    if ((uplink_mqtt_write(m, m->tx_hdr, (size_t)(p - m->tx_hdr), NETCONN_COPY | NETCONN_MORE) != ERR_OK) ||
+        (uplink_mqtt_write(m, json, json_len, NETCONN_COPY) != ERR_OK))
+    {
+        uplink_mqtt_close(m, platform, "publish write");
+        return UPLINK_ERR_TRANSPORT;
+    }
+
+    slot->sent = 1U;
+    m->tx_publish++;
+    if (dup != 0U)
+    {
+        m->tx_dup++;
+    }
+
+    return UPLINK_OK;
+}
+
+/**
+ * @brief netconn MQTT 实现：收取 PUBACK 并维持心跳
+ *
+ */
+static uplink_err_t uplink_mqtt_netconn_poll_acks(void *ctx,
+                                                  const uplink_endpoint_t *endpoint,
+                                                  const uplink_platform_t *platform,
+                                                  uint32_t wait_ms,
+                                                  uint32_t *out_acked_ids,
+                                                  uint16_t max_ids,
+                                                  uint16_t *out_count)
+{
+    uplink_transport_mqtt_netconn_ctx_t *m = (uplink_transport_mqtt_netconn_ctx_t *)ctx;
+    uint32_t half_ka_ms;
+    uint32_t now_ms;
+    uint32_t i;
+    err_t err;
+
+    (void)endpoint;
+
+    if ((m == NULL) || (out_count == NULL) || ((out_acked_ids == NULL) && (max_ids != 0U)))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    *out_count = 0U;
+
+    /* 未连接：没有在途报文，也无需心跳；下一次 submit 时再建连 */
+    if (m->conn == NULL)
+    {
+        return UPLINK_OK;
+    }
+
+    /* 心跳：空闲 keepalive/2 发 PINGREQ；再等 keepalive/2 无 PINGRESP 判定断线 */
+    now_ms = (uint32_t)sys_now();
+    half_ka_ms = ((uint32_t)m->keepalive_s * 1000U) / 2U;
+    if (m->ping_outstanding != 0U)
+    {
+        if ((now_ms - m->ping_sent_ms) >= half_ka_ms)
+        {
+            uplink_mqtt_close(m, platform, "ping timeout");
+            return UPLINK_ERR_TRANSPORT;
+        }
+    }
+    else if ((now_ms - m->last_tx_ms) >= half_ka_ms)
+    {
+        static const uint8_t s_pingreq[2] = {(uint8_t)UPLINK_MQTT_PINGREQ, 0x00U};
+
+        if (uplink_mqtt_write(m, s_pingreq, sizeof(s_pingreq), NETCONN_COPY) != ERR_OK)
+        {
+            uplink_mqtt_close(m, platform, "ping write");
+            return UPLINK_ERR_TRANSPORT;
+        }
+        m->ping_outstanding = 1U;
+        m->ping_sent_ms = now_ms;
+    }
+
+    /* 收包：首次最多等 wait_ms，之后只把已到达的数据取完 */
+    err = uplink_mqtt_recv(m, wait_ms);
+    while (err == ERR_OK)
+    {
+        if (uplink_mqtt_dispatch(m) == 0U)
+        {
+            uplink_mqtt_close(m, platform, "protocol");
+            return UPLINK_ERR_TRANSPORT;
+        }
+        err = uplink_mqtt_recv(m, 1U);
+    }
+
+    if (err != ERR_TIMEOUT)
+    {
+        uplink_mqtt_close(m, platform, "recv");
+        return UPLINK_ERR_TRANSPORT;
+    }
+
+    /* 把已确认的表项交给上层并释放 */
+    for (i = 0U; (i < (uint32_t)UPLINK_MAX_INFLIGHT) && (*out_count < max_ids); i++)
+    {
+        if ((m->inflight[i].used != 0U) && (m->inflight[i].acked != 0U))
+        {
+            out_acked_ids[*out_count] = m->inflight[i].message_id;
+            (*out_count)++;
+            (void)memset(&m->inflight[i], 0, sizeof(m->inflight[i]));
+        }
+    }
+
+    return UPLINK_OK;
+}
+
+/**
+ * @brief netconn MQTT 实现：同步发布（提交后等待本条 PUBACK）
+ *
+ * @note 说明：
+ * - 供直接调用 post_json 的场景使用；MQTT 没有响应 body，收到 PUBACK 即记 http_status=200，
+ *   app_code 保持 UNKNOWN（uplink 核心按“code 缺失”视为成功）。
+ * - 等待期间到达的其他消息的 PUBACK 会被一并释放，不要与异步流水模式混用同一个上下文。
+ */
+static uplink_err_t uplink_mqtt_netconn_post_json(void *ctx,
+                                                  const uplink_endpoint_t *endpoint,
+                                                  const uplink_platform_t *platform,
+                                                  const char *json,
+                                                  size_t json_len,
+                                                  uint32_t send_timeout_ms,
+                                                  uint32_t recv_timeout_ms,
+                                                  uplink_ack_t *ack,
+                                                  char *response_body_buf,
+                                                  size_t response_body_buf_len,
+                                                  size_t *out_response_body_len)
+{
+    uint32_t message_id = 0U;
+    uint32_t start_ms;
+    uplink_err_t r;
+
+    if ((ack == NULL) || (response_body_buf == NULL) || (response_body_buf_len == 0U) ||
+        (out_response_body_len == NULL) || (json == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    ack->http_status = 0U;
+    ack->app_code = UPLINK_APP_CODE_UNKNOWN;
+    ack->retry_after_ms = 0U;
+    response_body_buf[0] = '\0';
+    *out_response_body_len = 0U;
+
+    if (uplink_codec_json_parse_u32(json, json_len, "messageId", &message_id) != UPLINK_OK)
+    {
+        return UPLINK_ERR_CODEC;
+    }
+
+    r = uplink_mqtt_netconn_submit_json(ctx, endpoint, platform, message_id, json, json_len, send_timeout_ms);
+    if (r != UPLINK_OK)
+    {
+        return r;
+    }
+
+    start_ms = (uint32_t)sys_now();
+    for (;;)
+    {
+        uint32_t ids[UPLINK_MAX_INFLIGHT];
+        uint16_t n = 0U;
+        uint16_t i;
+        uint32_t elapsed = (uint32_t)sys_now() - start_ms;
+
+        if (elapsed >= recv_timeout_ms)
+        {
+            return UPLINK_ERR_TRANSPORT;
+        }
+
+        r = uplink_mqtt_netconn_poll_acks(ctx,
+                                          endpoint,
+                                          platform,
+                                          recv_timeout_ms - elapsed,
+                                          ids,
+                                          (uint16_t)UPLINK_MAX_INFLIGHT,
+                                          &n);
+        if (r != UPLINK_OK)
+        {
+            return r;
+        }
+
+        for (i = 0U; i < n; i++)
+        {
+            if (ids[i] == message_id)
+            {
+                ack->http_status = 200U;
+                return UPLINK_OK;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 绑定 netconn MQTT 实现到通用 transport 接口
+ *
+ * @param out_transport 输出：通用 transport 接口
+ * @param ctx MQTT 实现私有上下文（由调用者分配，生命周期需覆盖 out_transport 使用期）
+ * @param client_id 客户端 ID（建议使用 device_id，持久会话依赖其稳定不变）
+ * @param keepalive_s 心跳周期（秒，>0）
+ * @param max_inflight 同时在途的 PUBLISH 数（1..UPLINK_MAX_INFLIGHT，越界会被截断）
+ */
+void uplink_transport_mqtt_netconn_bind(uplink_transport_t *out_transport,
+                                        uplink_transport_mqtt_netconn_ctx_t *ctx,
+                                        const char *client_id,
+                                        uint16_t keepalive_s,
+                                        uint8_t max_inflight)
+{
+    if ((out_transport == NULL) || (ctx == NULL))
+    {
+        return;
+    }
+
+    (void)memset(ctx, 0, sizeof(*ctx));
+    if (client_id != NULL)
+    {
+        (void)strncpy(ctx->client_id, client_id, sizeof(ctx->client_id) - 1U);
+    }
+    ctx->keepalive_s = (keepalive_s == 0U) ? 30U : keepalive_s;
+
+    if (max_inflight == 0U)
+    {
+        max_inflight = 1U;
+    }
+    else if (max_inflight > (uint8_t)UPLINK_MAX_INFLIGHT)
+    {
+        max_inflight = (uint8_t)UPLINK_MAX_INFLIGHT;
+    }
+
+    out_transport->ctx = (void *)ctx;
+    out_transport->post_json = uplink_mqtt_netconn_post_json;
+    out_transport->max_inflight = (uint16_t)max_inflight;
+    out_transport->submit_json = uplink_mqtt_netconn_submit_json;
+    out_transport->poll_acks = uplink_mqtt_netconn_poll_acks;
+    out_transport->max_parallel = 1U;
+    out_transport->post_json_parallel = NULL;
+}
@@ -0,0 +1,569 @@
+/**
+ * @file    uplink_transport_udp_netconn.c
+ * @author  Yukikaze
+ * @brief   基于 lwIP Netconn UDP 的单往返鉴权传输实现（传输层-实现）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note 说明：
+ * - 发送：组包（头部 + JSON + HMAC 标签）后发出，按 RTO 等待匹配的 ACK。
+ * - 重传：未在 RTO 内收到合法 ACK 则原样重发（同一 messageId、timestamp、nonce），RTO 翻倍，
+ *   总等待时间不超过 recv_timeout_ms，重传次数不超过 max_retransmit。
+ * - 幂等：服务端按 (deviceId, messageId, timestamp, nonce) 缓存应答，重传请求拿到的是同一份结论。
+ * - 对时：收到 TIME 应答后按服务端时间对时，换新 timestamp/nonce 立即重发（每次请求最多两次）。
+ *
+ * @copyright Copyright (c) 2026 Yukikaze
+ *
+ */
+
+#include "uplink_transport_udp_netconn.h"
+
+#include "uplink_codec_json.h"
+#include "uplink_dns.h"
+#include "uplink_sha256.h"
+
+/* lwIP 头文件 */
+#include "api.h"
+#include "err.h"
+#include "ip_addr.h"
+#include "opt.h"
+#include "sys.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+/**
+ * @brief 日志输出（内部工具函数）
+ *
+ * @param platform 平台回调（可为 NULL）
+ * @param level 日志等级
+ * @param fmt printf 格式
+ * @param ... 可变参数
+ */
+static void uplink_logf(const uplink_platform_t *platform, uplink_log_level_t level, const char *fmt, ...)
+{
+    if ((platform == NULL) || (platform->log == NULL))
+    {
+        return;
+    }
+
+    {
+        char buf[160];
+        va_list args;
+
+        va_start(args, fmt);
+        (void)vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+
+        platform->log(platform->user_ctx, level, buf);
+    }
+}
+
+/**
+ * @brief 计算报文认证标签（HMAC-SHA256 截断）
+ *
+ * @param ctx 传输层上下文（提供密钥）
+ * @param data 头部 + JSON
+ * @param len 数据长度
+ * @param out_tag 输出：UPLINK_UDP_TAG_LEN 字节标签
+ */
+static void uplink_udp_calc_tag(const uplink_transport_udp_netconn_ctx_t *ctx,
+                                const uint8_t *data,
+                                size_t len,
+                                uint8_t out_tag[UPLINK_UDP_TAG_LEN])
+{
+    uint8_t mac[UPLINK_SHA256_DIGEST_LEN];
+    uplink_hmac_sha256_ctx_t hmac;
+
+    uplink_hmac_sha256_start(&hmac, &ctx->hmac_key);
+    uplink_hmac_sha256_update(&hmac, data, len);
+    uplink_hmac_sha256_final(&hmac, mac);
+    (void)memcpy(out_tag, mac, UPLINK_UDP_TAG_LEN);
+}
+
+/**
+ * @brief 读取大端 32 位整数
+ *
+ * @param p 4 字节起始位置
+ * @return uint32_t 数值
+ */
+static uint32_t uplink_udp_rd32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief 写入大端 32 位整数
+ *
+ * @param p 4 字节起始位置
+ * @param v 数值
+ */
+static void uplink_udp_wr32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+/**
+ * @brief 组一个 CON 请求报文到 tx_buf（timestamp/nonce 按当前对时状态生成）
+ *
+ * @param ctx 传输层上下文
+ * @param message_id 事件 messageId
+ * @param json 事件 JSON
+ * @param json_len JSON 长度（调用者已检查不超过 UPLINK_MAX_EVENT_JSON_LEN）
+ * @param platform 平台回调（未对时时取随机数，可为 NULL）
+ * @param out_nonce 输出：本报文的 nonce（ACK 须回显）
+ * @return size_t 报文长度
+ *
+ * @note 说明：
+ * - 未对时：timestamp=0，nonce 取随机数；服务端只会回 TIME，不会给出判定。
+ * - 已对时：nonce = (timestamp 低 24 位 << 8) | 计数器低 8 位，每秒 256 个以内不重复，重启前后也不重复。
+ */
+static size_t uplink_udp_build_con(uplink_transport_udp_netconn_ctx_t *ctx,
+                                   uint32_t message_id,
+                                   const char *json,
+                                   size_t json_len,
+                                   const uplink_platform_t *platform,
+                                   uint32_t *out_nonce)
+{
+    uint32_t ts_s = 0U;
+    uint32_t nonce;
+
+    if (ctx->clock_synced != 0U)
+    {
+        ts_s = ctx->epoch_at_boot_s + (uint32_t)sys_now() / 1000U;
+        nonce = ((ts_s & 0x00FFFFFFU) << 8) | (ctx->nonce_counter & 0xFFU);
+    }
+    else if ((platform != NULL) && (platform->rand_u32 != NULL))
+    {
+        nonce = platform->rand_u32(platform->user_ctx);
+    }
+    else
+    {
+        nonce = (uint32_t)sys_now() ^ (ctx->nonce_counter << 16);
+    }
+    ctx->nonce_counter++;
+
+    ctx->tx_buf[0] = UPLINK_UDP_MAGIC;
+    ctx->tx_buf[1] = (uint8_t)((UPLINK_UDP_VERSION << 4) | UPLINK_UDP_TYPE_CON);
+    uplink_udp_wr32(&ctx->tx_buf[2], message_id);
+    uplink_udp_wr32(&ctx->tx_buf[6], ts_s);
+    uplink_udp_wr32(&ctx->tx_buf[10], nonce);
+    ctx->tx_buf[14] = (uint8_t)(json_len >> 8);
+    ctx->tx_buf[15] = (uint8_t)json_len;
+    (void)memcpy(&ctx->tx_buf[UPLINK_UDP_HEADER_LEN], json, json_len);
+    uplink_udp_calc_tag(ctx,
+                        ctx->tx_buf,
+                        UPLINK_UDP_HEADER_LEN + json_len,
+                        &ctx->tx_buf[UPLINK_UDP_HEADER_LEN + json_len]);
+
+    *out_nonce = nonce;
+    return UPLINK_UDP_HEADER_LEN + json_len + UPLINK_UDP_TAG_LEN;
+}
+
+/**
+ * @brief 校验收到的应答报文（ACK 或 TIME）
+ *
+ * @param ctx 传输层上下文
+ * @param pkt 报文
+ * @param pkt_len 报文长度
+ * @param message_id 期望的 messageId
+ * @param nonce 期望回显的 nonce
+ * @param out_type 输出：UPLINK_UDP_TYPE_ACK / UPLINK_UDP_TYPE_TIME
+ * @param out_ts 输出：服务端时间（Unix 秒）
+ * @param out_json 输出：JSON 起始位置（指向 pkt 内部）
+ * @param out_json_len 输出：JSON 长度（TIME 为 0）
+ * @return uint8_t 1=合法且匹配；0=丢弃
+ *
+ * @note 时间窗口（ACK 时间与本地估计之差）由调用者检查：TIME 本身就是用来对时的。
+ */
+static uint8_t uplink_udp_check_reply(const uplink_transport_udp_netconn_ctx_t *ctx,
+                                      const uint8_t *pkt,
+                                      size_t pkt_len,
+                                      uint32_t message_id,
+                                      uint32_t nonce,
+                                      uint8_t *out_type,
+                                      uint32_t *out_ts,
+                                      const uint8_t **out_json,
+                                      size_t *out_json_len)
+{
+    uint8_t tag[UPLINK_UDP_TAG_LEN];
+    uint8_t type;
+    size_t json_len;
+    uint8_t diff = 0U;
+    uint32_t i;
+
+    if (pkt_len < (UPLINK_UDP_HEADER_LEN + UPLINK_UDP_TAG_LEN))
+    {
+        return 0U;
+    }
+
+    if ((pkt[0] != UPLINK_UDP_MAGIC) || ((pkt[1] >> 4) != UPLINK_UDP_VERSION))
+    {
+        return 0U;
+    }
+
+    type = (uint8_t)(pkt[1] & 0x0FU);
+    if ((type != UPLINK_UDP_TYPE_ACK) && (type != UPLINK_UDP_TYPE_TIME))
+    {
+        return 0U;
+    }
+
+    /* messageId 与 nonce 都要匹配：纪元重复时旧 ACK 的 messageId 可能相同，nonce 不会 */
+    if ((uplink_udp_rd32(&pkt[2]) != message_id) || (uplink_udp_rd32(&pkt[10]) != nonce))
+    {
+        return 0U;
+    }
+
+    json_len = ((size_t)pkt[14] << 8) | (size_t)pkt[15];
+    if ((UPLINK_UDP_HEADER_LEN + json_len + UPLINK_UDP_TAG_LEN) != pkt_len)
+    {
+        return 0U;
+    }
+    if ((type == UPLINK_UDP_TYPE_TIME) && (json_len != 0U))
+    {
+        return 0U;
+    }
+
+    /* 常量时间比较，避免按字节提前返回泄露时序 */
+    uplink_udp_calc_tag(ctx, pkt, UPLINK_UDP_HEADER_LEN + json_len, tag);
+    for (i = 0U; i < UPLINK_UDP_TAG_LEN; i++)
+    {
+        diff |= (uint8_t)(tag[i] ^ pkt[UPLINK_UDP_HEADER_LEN + json_len + i]);
+    }
+    if (diff != 0U)
+    {
+        return 0U;
+    }
+
+    *out_type = type;
+    *out_ts = uplink_udp_rd32(&pkt[6]);
+    *out_json = &pkt[UPLINK_UDP_HEADER_LEN];
+    *out_json_len = json_len;
+    return 1U;
+}
+
+/**
+ * @brief 按服务端时间对时
+ *
+ * @param ctx 传输层上下文
+ * @param server_s 服务端 Unix 秒
+ */
+static void uplink_udp_sync_clock(uplink_transport_udp_netconn_ctx_t *ctx, uint32_t server_s)
+{
+    ctx->epoch_at_boot_s = server_s - (uint32_t)sys_now() / 1000U;
+    ctx->clock_synced = 1U;
+}
+
+/**
+ * @brief ACK 时间是否在本地估计的窗口内
+ *
+ * @param ctx 传输层上下文（已对时）
+ * @param server_s ACK 中的服务端 Unix 秒
+ * @return uint8_t 1=在窗口内
+ */
+static uint8_t uplink_udp_ts_fresh(const uplink_transport_udp_netconn_ctx_t *ctx, uint32_t server_s)
+{
+    uint32_t local_s = ctx->epoch_at_boot_s + (uint32_t)sys_now() / 1000U;
+    uint32_t diff = (server_s > local_s) ? (server_s - local_s) : (local_s - server_s);
+
+    return (diff <= UPLINK_UDP_MAX_SKEW_S) ? 1U : 0U;
+}
+
+/**
+ * @brief netconn UDP 实现：发送一条可确认请求并等待匹配的 ACK
+ *
+ */
+static uplink_err_t uplink_udp_netconn_post_json(void *ctx,
+                                                 const uplink_endpoint_t *endpoint,
+                                                 const uplink_platform_t *platform,
+                                                 const char *json,
+                                                 size_t json_len,
+                                                 uint32_t send_timeout_ms,
+                                                 uint32_t recv_timeout_ms,
+                                                 uplink_ack_t *ack,
+                                                 char *response_body_buf,
+                                                 size_t response_body_buf_len,
+                                                 size_t *out_response_body_len)
+{
+    uplink_transport_udp_netconn_ctx_t *udp = (uplink_transport_udp_netconn_ctx_t *)ctx;
+    struct netconn *conn = NULL;
+    ip_addr_t server_addr;
+    uint32_t message_id = 0U;
+    uint32_t nonce = 0U;
+    size_t pkt_len;
+    uint32_t start_ms;
+    uint32_t rto_ms;
+    uint8_t tx_count = 0U;
+    uint8_t resynced = 0U;
+    uint8_t resend_now;
+    uplink_err_t result = UPLINK_ERR_TRANSPORT;
+
+    (void)send_timeout_ms; /* UDP 发送不阻塞，无需发送超时 */
+
+    if ((udp == NULL) || (endpoint == NULL) || (json == NULL) || (ack == NULL) ||
+        (response_body_buf == NULL) || (response_body_buf_len == 0U) ||
+        (out_response_body_len == NULL))
+    {
+        return UPLINK_ERR_INVALID_ARG;
+    }
+
+    ack->http_status = 0U;
+    ack->app_code = UPLINK_APP_CODE_UNKNOWN;
+    ack->retry_after_ms = 0U;
+    response_body_buf[0] = '\0';
+    *out_response_body_len = 0U;
+
+    if (json_len > UPLINK_MAX_EVENT_JSON_LEN)
+    {
+        return UPLINK_ERR_BUFFER_TOO_SMALL;
+    }
+
+    /* messageId 是重传匹配键，直接取自事件外壳 */
+    if (uplink_codec_json_parse_u32(json, json_len, "messageId", &message_id) != UPLINK_OK)
+    {
+        return UPLINK_ERR_CODEC;
+    }
+
+    {
+        uplink_err_t r = uplink_dns_resolve(endpoint, &server_addr);
+        if (r != UPLINK_OK)
+        {
+            uplink_logf(platform, UPLINK_LOG_ERROR, "[uplink-udp] resolve host failed: %s\r\n", endpoint->host);
+            return r;
+        }
+    }
+
+    /* 组包：头部 + JSON + 标签（重传时原样复用，对时后重组一次） */
+    pkt_len = uplink_udp_build_con(udp, message_id, json, json_len, platform, &nonce);
+
+    conn = netconn_new(NETCONN_UDP);
+    if (conn == NULL)
+    {
+        return UPLINK_ERR_TRANSPORT;
+    }
+
+    if (netconn_connect(conn, &server_addr, endpoint->port) != ERR_OK)
+    {
+        (void)netconn_delete(conn);
+        return UPLINK_ERR_TRANSPORT;
+    }
+
+    start_ms = (uint32_t)sys_now();
+
+    /* 初始 RTO 加入 0~50% 随机量，避免多台设备同步重传 */
+    rto_ms = udp->ack_timeout_ms;
+    if (platform != NULL && platform->rand_u32 != NULL)
+    {
+        rto_ms += (platform->rand_u32(platform->user_ctx) % ((rto_ms / 2U) + 1U));
+    }
+    else
+    {
+        rto_ms += (start_ms % ((rto_ms / 2U) + 1U));
+    }
+
+    while (result != UPLINK_OK)
+    {
+        uint32_t elapsed = (uint32_t)sys_now() - start_ms;
+        uint32_t window_end;
+
+        if ((elapsed >= recv_timeout_ms) || (tx_count > udp->max_retransmit))
+        {
+            break;
+        }
+
+        /* 发送（首次或重传） */
+        {
+            struct netbuf *nb = netbuf_new();
+            err_t err;
+
+            if (nb == NULL)
+            {
+                break;
+            }
+
+            if (netbuf_ref(nb, udp->tx_buf, (u16_t)pkt_len) != ERR_OK)
+            {
+                netbuf_delete(nb);
+                break;
+            }
+
+            err = netconn_send(conn, nb);
+            netbuf_delete(nb);
+            if (err != ERR_OK)
+            {
+                break;
+            }
+
+            udp->tx_datagrams++;
+            if (tx_count != 0U)
+            {
+                udp->retransmits++;
+            }
+            tx_count++;
+        }
+
+        /* 本轮等待窗口：min(RTO, 剩余总超时) */
+        window_end = elapsed + rto_ms;
+        if (window_end > recv_timeout_ms)
+        {
+            window_end = recv_timeout_ms;
+        }
+        resend_now = 0U;
+
+        for (;;)
+        {
+            struct netbuf *inbuf = NULL;
+            uint32_t now_elapsed = (uint32_t)sys_now() - start_ms;
+            const uint8_t *rsp_json = NULL;
+            size_t rsp_len = 0U;
+            uint8_t rsp_type = 0U;
+            uint32_t rsp_ts = 0U;
+            u16_t rx_len;
+
+            if (now_elapsed >= window_end)
+            {
+                break;
+            }
+
+            netconn_set_recvtimeout(conn, (int)(window_end - now_elapsed));
+            if (netconn_recv(conn, &inbuf) != ERR_OK)
+            {
+                break;
+            }
+
+            udp->rx_datagrams++;
+            rx_len = netbuf_len(inbuf);
+            if (rx_len > sizeof(udp->rx_buf))
+            {
+                udp->rx_rejected++;
+                netbuf_delete(inbuf);
+                continue;
+            }
+
+            (void)netbuf_copy(inbuf, udp->rx_buf, rx_len);
+            netbuf_delete(inbuf);
+
+            if (uplink_udp_check_reply(udp,
+                                       udp->rx_buf,
+                                       rx_len,
+                                       message_id,
+                                       nonce,
+                                       &rsp_type,
+                                       &rsp_ts,
+                                       &rsp_json,
+                                       &rsp_len) == 0U)
+            {
+                /* 迟到的旧应答/伪造报文：丢弃并继续等待 */
+                udp->rx_rejected++;
+                continue;
+            }
+
+            if (rsp_type == UPLINK_UDP_TYPE_TIME)
+            {
+                /* 服务端未判定：对时后换新 timestamp/nonce 立即重发；
+                   未对时的首个请求可能先对时、再碰上重复 nonce，一次请求最多两次 */
+                if (resynced >= 2U)
+                {
+                    udp->rx_rejected++;
+                    continue;
+                }
+                uplink_udp_sync_clock(udp, rsp_ts);
+                /* 秒级对时可能与重启前最后一秒重合：按毫秒计数打散计数器，不沿着旧的 nonce 序列逐个碰撞 */
+                udp->nonce_counter += (uint32_t)sys_now() | 1U;
+                pkt_len = uplink_udp_build_con(udp, message_id, json, json_len, platform, &nonce);
+                udp->time_resyncs++;
+                resynced++;
+                resend_now = 1U;
+                break;
+            }
+
+            /* 未对时的请求服务端只回 TIME；判定 ACK 还须时间在窗口内 */
+            if ((udp->clock_synced == 0U) || (uplink_udp_ts_fresh(udp, rsp_ts) == 0U))
+            {
+                udp->rx_rejected++;
+                continue;
+            }
+            uplink_udp_sync_clock(udp, rsp_ts);
+
+            if (rsp_len >= response_body_buf_len)
+            {
+                rsp_len = response_body_buf_len - 1U;
+                result = UPLINK_ERR_BUFFER_TOO_SMALL;
+            }
+            else
+            {
+                result = UPLINK_OK;
+            }
+
+            (void)memcpy(response_body_buf, rsp_json, rsp_len);
+            response_body_buf[rsp_len] = '\0';
+            *out_response_body_len = rsp_len;
+            ack->http_status = 200U;
+            break;
+        }
+
+        if (ack->http_status != 0U)
+        {
+            break;
+        }
+
+        if (resend_now != 0U)
+        {
+            /* 对时后的新请求：不计重传、不退避 */
+            tx_count = 0U;
+            continue;
+        }
+
+        /* 指数退避 */
+        rto_ms = (rto_ms > (recv_timeout_ms / 2U)) ? recv_timeout_ms : (rto_ms * 2U);
+    }
+
+    (void)netconn_delete(conn);
+
+    if ((ack->http_status == 0U) && (tx_count > 0U))
+    {
+        uplink_logf(platform,
+                    UPLINK_LOG_WARN,
+                    "[uplink-udp] no ack: id=%lu tx=%u\r\n",
+                    (unsigned long)message_id,
+                    (unsigned)tx_count);
+    }
+
+    return result;
+}
+
+/**
+ * @brief 绑定 netconn UDP 实现到通用 transport 接口
+ *
+ * @param out_transport 输出：通用 transport 接口
+ * @param ctx UDP 实现私有上下文（由调用者分配，生命周期需覆盖 out_transport 使用期）
+ * @param secret 设备共享密钥（与服务端 devices.secret 一致）
+ */
+void uplink_transport_udp_netconn_bind(uplink_transport_t *out_transport,
+                                       uplink_transport_udp_netconn_ctx_t *ctx,
+                                       const char *secret)
+{
+    if ((out_transport == NULL) || (ctx == NULL))
+    {
+        return;
+    }
+
+    (void)memset(ctx, 0, sizeof(*ctx));
+    uplink_hmac_sha256_key_init(&ctx->hmac_key, secret, (secret != NULL) ? strlen(secret) : 0U);
+    ctx->ack_timeout_ms = UPLINK_UDP_DEFAULT_ACK_TIMEOUT_MS;
+    ctx->max_retransmit = UPLINK_UDP_DEFAULT_MAX_RETRANSMIT;
+
+    out_transport->ctx = (void *)ctx;
+    out_transport->post_json = uplink_udp_netconn_post_json;
+
+    /* 一问一答的短连接实现，不支持异步流水 */
+    out_transport->max_inflight = 1U;
+    out_transport->submit_json = NULL;
+    out_transport->poll_acks = NULL;
+    out_transport->max_parallel = 1U;
+    out_transport->post_json_parallel = NULL;
+}
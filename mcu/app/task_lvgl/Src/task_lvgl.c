@@ -13,6 +13,7 @@
 #include "bsp_locker.h"
 #include "bsp_i2c_touch.h"
 #include "gt9xx.h"
+#include "uplink_breaker.h"
 
 #include "lvgl.h"
 #include "lv_port_disp.h"
@@ -237,10 +238,12 @@ static void Task_Lvgl_CreateUi(void)
 static void Task_Lvgl_RefreshUi(void)
 {
     AppSessionData_TypeDef session;
+    uplink_breaker_state_t breaker;
     uint32_t i;
     const char *hint = "";
 
     AppData_GetSessionData(&session);
+    breaker = uplink_breaker_get_state();
 
     /* 状态主文案 */
     lv_label_set_text_fmt(g_labelState,
@@ -248,8 +251,18 @@ static void Task_Lvgl_RefreshUi(void)
                           Task_Lvgl_StateText(session.state),
                           (session.selected_locker_id[0] != '\0') ? "" : "");
 
-    /* 网络状态 */
-    if (session.state == APP_SESSION_STATE_NET_FAIL)
+    /* 网络状态：上级熔断（鉴权与上报共享的健康状态）优先于单次会话结果 */
+    if (breaker == UPLINK_BREAKER_OPEN)
+    {
+        lv_label_set_text(g_labelNet, "网络: 中断");
+        lv_obj_set_style_text_color(g_labelNet, lv_color_hex(0xFF7B7B), 0);
+    }
+    else if (breaker == UPLINK_BREAKER_HALF_OPEN)
+    {
+        lv_label_set_text(g_labelNet, "网络: 探查中");
+        lv_obj_set_style_text_color(g_labelNet, lv_color_hex(0xFFE08A), 0);
+    }
+    else if (session.state == APP_SESSION_STATE_NET_FAIL)
     {
         lv_label_set_text(g_labelNet, "网络: 异常");
         lv_obj_set_style_text_color(g_labelNet, lv_color_hex(0xFFB66D), 0);
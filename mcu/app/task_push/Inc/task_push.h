@@ -0,0 +1,65 @@
+/**
+ * @file    task_push.h
+ * @author  Yukikaze
+ * @brief   下行推送任务头文件（常连上级推送流，分发权限变更/远程开门）
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note
+ * - 本任务循环调用 AppPush_RunSession()，断线后按返回的退避时间重连。
+ * - 收到的命令只做解析与投递，实际开门/失效缓存在 Task_RfidAuth 中执行。
+ */
+
+#ifndef __TASK_PUSH_H
+#define __TASK_PUSH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/** 任务名称 */
+#define TASK_PUSH_NAME "Task_Push"
+
+/** 任务栈大小（word） */
+#define TASK_PUSH_STACK_SIZE 768
+
+/** 任务优先级（与 Task_Uplink 相同，大部分时间阻塞在 netconn_recv） */
+#define TASK_PUSH_PRIORITY 3
+
+/** 任务句柄 */
+extern TaskHandle_t Task_Push_Handle;
+
+/**
+ * @brief 初始化推送通道
+ *
+ * @return BaseType_t
+ * - pdPASS：初始化成功
+ * - pdFAIL：初始化失败
+ */
+BaseType_t Task_Push_Init(void);
+
+/**
+ * @brief 创建下行推送任务
+ *
+ * @return BaseType_t
+ * - pdPASS：创建成功
+ * - pdFAIL：创建失败
+ */
+BaseType_t Task_Push_Create(void);
+
+/**
+ * @brief 下行推送任务入口
+ *
+ * @param pvParameters 任务参数（未使用）
+ */
+void Task_Push(void *pvParameters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TASK_PUSH_H */
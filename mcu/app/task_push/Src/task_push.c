@@ -0,0 +1,102 @@
+/**
+ * @file    task_push.c
+ * @author  Yukikaze
+ * @brief   下行推送任务实现
+ * @version 0.1
+ * @date    2026-10-17
+ *
+ * @note
+ * - 消息格式（一行一条 JSON）：
+ *   - {"type":"OPEN_DOOR","lockerId":"A01","cmdId":7}
+ *   - {"type":"PERM_UPDATE","uidSha1":"<40 hex>"}（uidSha1 缺省/为空表示全部失效）
+ *   - {"type":"PING"} / {"type":"HELLO",...}：仅用于保活，忽略。
+ * - 未识别的 type 直接忽略，便于上级平滑增加新命令。
+ */
+
+#include "task_push.h"
+
+#include "app_push.h"
+#include "task_rfid_auth.h"
+#include "uplink_codec_json.h"
+
+#include <string.h>
+
+/** 任务句柄 */
+TaskHandle_t Task_Push_Handle = NULL;
+
+/**
+ * @brief 推送消息回调：解析命令并投递给 Task_RfidAuth
+ *
+ * @param user_ctx 用户上下文（未使用）
+ * @param line 一行 JSON
+ * @param line_len 行长度
+ */
+static void Task_Push_OnMessage(void *user_ctx, const char *line, size_t line_len)
+{
+    char type[16];
+    task_rfid_remote_cmd_t cmd;
+
+    (void)user_ctx;
+
+    if (uplink_codec_json_parse_str(line, line_len, "type", type, sizeof(type)) != UPLINK_OK)
+    {
+        return;
+    }
+
+    (void)memset(&cmd, 0, sizeof(cmd));
+
+    if (strcmp(type, "OPEN_DOOR") == 0)
+    {
+        cmd.type = TASK_RFID_REMOTE_OPEN_DOOR;
+        if (uplink_codec_json_parse_str(line, line_len, "lockerId", cmd.locker_id, sizeof(cmd.locker_id)) != UPLINK_OK)
+        {
+            return;
+        }
+        (void)uplink_codec_json_parse_u32(line, line_len, "cmdId", &cmd.cmd_id);
+    }
+    else if (strcmp(type, "PERM_UPDATE") == 0)
+    {
+        cmd.type = TASK_RFID_REMOTE_PERM_UPDATE;
+        if (uplink_codec_json_parse_str(line, line_len, "uidSha1", cmd.uid_sha1_hex, sizeof(cmd.uid_sha1_hex)) != UPLINK_OK)
+        {
+            cmd.uid_sha1_hex[0] = '\0';
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    (void)Task_RfidAuth_PostRemoteCmd(&cmd);
+}
+
+BaseType_t Task_Push_Init(void)
+{
+    return AppPush_Init(Task_Push_OnMessage, NULL);
+}
+
+BaseType_t Task_Push_Create(void)
+{
+    BaseType_t xReturn;
+
+    xReturn = xTaskCreate((TaskFunction_t)Task_Push,
+                          (const char *)TASK_PUSH_NAME,
+                          (uint16_t)TASK_PUSH_STACK_SIZE,
+                          (void *)NULL,
+                          (UBaseType_t)TASK_PUSH_PRIORITY,
+                          (TaskHandle_t *)&Task_Push_Handle);
+
+    return xReturn;
+}
+
+void Task_Push(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;)
+    {
+        uint32_t delay_ms = AppPush_RunSession();
+
+        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+    }
+}
@@ -16,6 +16,8 @@ extern "C" {
 #include "FreeRTOS.h"
 #include "task.h"
 
+#include <stdint.h>
+
 /** 任务名称 */
 #define TASK_RFID_AUTH_NAME "Task_RfidAuth"
 
@@ -46,11 +48,37 @@ extern "C" {
 /** 本地放行缓存容量 */
 #define TASK_RFID_AUTH_CACHE_CAPACITY 256U
 
+/** 远程命令队列长度（推送通道 -> 鉴权任务） */
+#define TASK_RFID_AUTH_REMOTE_QUEUE_LEN 4U
+
+/** 远程命令类型 */
+typedef enum
+{
+    TASK_RFID_REMOTE_OPEN_DOOR = 1,   /* 远程开门 */
+    TASK_RFID_REMOTE_PERM_UPDATE = 2  /* 权限变更：失效本地放行缓存 */
+} task_rfid_remote_type_t;
+
+/**
+ * @brief 远程命令（由推送通道投递，在鉴权任务上下文中执行）
+ *
+ * @note
+ * - OPEN_DOOR：locker_id 为门位 ID（如 "A01"），cmd_id 作为审计 sid 回传上级便于对账。
+ * - PERM_UPDATE：uid_sha1_hex 为空表示失效全部缓存，否则只失效该卡。
+ */
+typedef struct
+{
+    task_rfid_remote_type_t type;
+    uint32_t cmd_id;
+    char locker_id[8];
+    char uid_sha1_hex[41];
+} task_rfid_remote_cmd_t;
+
 extern TaskHandle_t Task_RfidAuth_Handle;
 
 BaseType_t Task_RfidAuth_Init(void);
 BaseType_t Task_RfidAuth_Create(void);
 void Task_RfidAuth(void *pvParameters);
+BaseType_t Task_RfidAuth_PostRemoteCmd(const task_rfid_remote_cmd_t *cmd);
 
 #ifdef __cplusplus
 }
@@ -12,6 +12,7 @@
 
 #include "task_rfid_auth.h"
 
+#include "app_audit.h"
 #include "app_auth.h"
 #include "app_data.h"
 #include "bsp_locker.h"
@@ -19,6 +20,7 @@
 #include "rc522_function.h"
 #include "task_uplink.h"
 
+#include "queue.h"
 #include "sys.h"
 
 #include <stdio.h>
@@ -43,8 +45,9 @@ static uint32_t g_allowCacheSeq = 1U;
  */
 TaskHandle_t Task_RfidAuth_Handle = NULL;
 
+static QueueHandle_t g_remoteQueue = NULL;
+
 static uint32_t g_nextSessionId = 1U;
-static uint32_t g_auditDropCount = 0U;
 
 /* 去抖记录：2 秒内同卡同门忽略 */
 static uint8_t g_lastUid[4] = {0};
@@ -237,7 +240,7 @@ static void Task_RfidAuth_CachePut(const char *uid_sha1_hex, uint32_t now_ms)
 }
 
 /**
- * @brief 异步审计上报（复用 app_uplink 队列）
+ * @brief 异步审计上报（合并、分类别与丢失汇总见 app_audit）
  */
 static void Task_RfidAuth_Audit(const char *event,
                                 uint32_t session_id,
@@ -249,40 +252,84 @@ static void Task_RfidAuth_Audit(const char *event,
                                 uint8_t door_ok,
                                 uint8_t cache_hit)
 {
-    char payload[UPLINK_MAX_PAYLOAD_LEN];
-    uint16_t depth;
-    uplink_err_t qerr;
+    AppAudit_Report(event,
+                    session_id,
+                    locker_id,
+                    uid_hex,
+                    code,
+                    http_status,
+                    network_ok,
+                    door_ok,
+                    cache_hit,
+                    (uint32_t)sys_now());
+}
+
+/**
+ * @brief 失效放行缓存（uid_sha1_hex 为空时全部失效）
+ */
+static void Task_RfidAuth_CacheInvalidate(const char *uid_sha1_hex)
+{
+    uint32_t i;
 
-    if ((event == NULL) || (locker_id == NULL) || (uid_hex == NULL))
+    for (i = 0U; i < TASK_RFID_AUTH_CACHE_CAPACITY; i++)
     {
+        if (g_allowCache[i].valid == 0U)
+        {
+            continue;
+        }
+
+        if ((uid_sha1_hex == NULL) || (uid_sha1_hex[0] == '\0') ||
+            (strncmp(g_allowCache[i].uid_sha1_hex, uid_sha1_hex, APP_AUTH_UID_SHA1_HEX_LEN) == 0))
+        {
+            g_allowCache[i].valid = 0U;
+        }
+    }
+}
+
+/**
+ * @brief 执行推送通道投递的远程命令
+ */
+static void Task_RfidAuth_HandleRemoteCmd(const task_rfid_remote_cmd_t *cmd)
+{
+    uint8_t count;
+    uint8_t i;
+
+    if (cmd->type == TASK_RFID_REMOTE_PERM_UPDATE)
+    {
+        Task_RfidAuth_CacheInvalidate(cmd->uid_sha1_hex);
         return;
     }
 
-    depth = uplink_get_queue_depth(&g_uplink);
-    if (depth >= (uint16_t)(UPLINK_QUEUE_MAX_LEN - 1U))
+    if (cmd->type != TASK_RFID_REMOTE_OPEN_DOOR)
     {
-        g_auditDropCount++;
         return;
     }
 
-    (void)snprintf(payload,
-                   sizeof(payload),
-                   "{\"ev\":\"%s\",\"sid\":%lu,\"lockerId\":\"%s\",\"uid\":\"%s\",\"code\":%ld,\"http\":%u,\"net\":%u,\"door\":%u,\"cache\":%u,\"drop\":%lu}",
-                   event,
-                   (unsigned long)session_id,
-                   locker_id,
-                   uid_hex,
-                   (long)code,
-                   (unsigned)http_status,
-                   (unsigned)network_ok,
-                   (unsigned)door_ok,
-                   (unsigned)cache_hit,
-                   (unsigned long)g_auditDropCount);
-
-    qerr = uplink_enqueue_json(&g_uplink, "RFID_AUDIT", payload);
-    if (qerr != UPLINK_OK)
+    count = Locker_GetCount();
+    for (i = 0U; i < count; i++)
     {
-        g_auditDropCount++;
+        const char *id = Locker_GetId(i);
+
+        if ((id != NULL) && (strcmp(id, cmd->locker_id) == 0))
+        {
+            break;
+        }
+    }
+
+    if (i >= count)
+    {
+        /* 未知门位：只审计，不动作 */
+        Task_RfidAuth_Audit("REMOTE_OPEN", cmd->cmd_id, cmd->locker_id, "", 1003, 0U, 1U, 0U, 0U);
+        return;
+    }
+
+    if (Locker_Open(i, LOCKER_DEFAULT_OPEN_PULSE_MS) == LOCKER_OK)
+    {
+        Task_RfidAuth_Audit("REMOTE_OPEN", cmd->cmd_id, cmd->locker_id, "", 0, 0U, 1U, 1U, 0U);
+    }
+    else
+    {
+        Task_RfidAuth_Audit("REMOTE_OPEN", cmd->cmd_id, cmd->locker_id, "", 9001, 0U, 1U, 0U, 0U);
     }
 }
 
@@ -329,11 +376,20 @@ BaseType_t Task_RfidAuth_Init(void)
         return pdFAIL;
     }
 
+    if (g_remoteQueue == NULL)
+    {
+        g_remoteQueue = xQueueCreate(TASK_RFID_AUTH_REMOTE_QUEUE_LEN, sizeof(task_rfid_remote_cmd_t));
+        if (g_remoteQueue == NULL)
+        {
+            return pdFAIL;
+        }
+    }
+
     AppData_ResetSession(now_ms);
     AppData_SetSessionState(APP_SESSION_STATE_IDLE_SELECT, now_ms);
 
     g_nextSessionId = 1U;
-    g_auditDropCount = 0U;
+    AppAudit_Init(&g_uplink);
     g_allowCacheSeq = 1U;
     (void)memset(g_allowCache, 0, sizeof(g_allowCache));
     Task_RfidAuth_ResetDebounce();
@@ -364,6 +420,16 @@ void Task_RfidAuth(void *pvParameters)
         AppSessionData_TypeDef session;
         uint32_t now_ms = (uint32_t)sys_now();
         uint32_t ui_actions;
+        task_rfid_remote_cmd_t remote_cmd;
+
+        /* 审计丢失汇总：发现 uplink 内部丢弃后补报一条汇总记录 */
+        AppAudit_Poll(now_ms);
+
+        /* 远程命令：最迟一个任务周期内执行，不影响本地会话状态 */
+        while (xQueueReceive(g_remoteQueue, &remote_cmd, 0) == pdTRUE)
+        {
+            Task_RfidAuth_HandleRemoteCmd(&remote_cmd);
+        }
 
         AppData_GetSessionData(&session);
         ui_actions = AppData_TakeUiActions();
@@ -620,3 +686,13 @@ void Task_RfidAuth(void *pvParameters)
     }
 }
 
+BaseType_t Task_RfidAuth_PostRemoteCmd(const task_rfid_remote_cmd_t *cmd)
+{
+    if ((cmd == NULL) || (g_remoteQueue == NULL))
+    {
+        return pdFAIL;
+    }
+
+    /* 不阻塞推送任务：队列满说明鉴权任务忙，由上级按需重发 */
+    return xQueueSend(g_remoteQueue, cmd, 0);
+}
@@ -50,6 +50,52 @@ extern "C"
 #define TASK_UPLINK_SERVER_PATH "/api/uplink"
 #endif
 
+/** 备用上级地址（如 PC 服务器）；空串=只有首选上级。传输方式/路径与首选上级相同 */
+#ifndef TASK_UPLINK_FALLBACK_HOST
+#define TASK_UPLINK_FALLBACK_HOST ""
+#endif
+
+/** 备用上级端口；0=与首选上级相同 */
+#ifndef TASK_UPLINK_FALLBACK_PORT
+#define TASK_UPLINK_FALLBACK_PORT 0
+#endif
+
+/** 异步上报传输方式：0=HTTP 短连接（默认）；1=MQTT 长连接（QoS1，多条在途）
+ *  MQTT 未做板上基准（与 HTTP 的 msgs/sec 对比未测），保持默认关闭 */
+#ifndef TASK_UPLINK_USE_MQTT
+#define TASK_UPLINK_USE_MQTT 0
+#endif
+
+/** MQTT broker 端口（地址沿用 TASK_UPLINK_SERVER_HOST） */
+#ifndef TASK_UPLINK_MQTT_PORT
+#define TASK_UPLINK_MQTT_PORT 1883
+#endif
+
+/** MQTT 发布主题 */
+#ifndef TASK_UPLINK_MQTT_TOPIC
+#define TASK_UPLINK_MQTT_TOPIC "cabinet/stm32f4/uplink"
+#endif
+
+/** 合并上报：一次 POST 最多携带的审计事件数（1=逐条发送；>1 需编译期 UPLINK_BATCH_ENABLE=1；MQTT 逐条发布，不受影响） */
+#ifndef TASK_UPLINK_BATCH_EVENTS
+#define TASK_UPLINK_BATCH_EVENTS UPLINK_MAX_BATCH_EVENTS
+#endif
+
+/** 请求 body 压缩：1=按 heatshrink 码流压缩（Content-Encoding: x-heatshrink，需服务端解压中间件与编译期 UPLINK_LZSS_ENABLE=1） */
+#ifndef TASK_UPLINK_COMPRESS
+#define TASK_UPLINK_COMPRESS UPLINK_LZSS_ENABLE
+#endif
+
+/** 积压时并发发送的 POST 路数（1=关闭；>1 需编译期加大 UPLINK_MAX_PARALLEL；仅 HTTP 生效，各路独立短连接） */
+#ifndef TASK_UPLINK_PARALLEL
+#define TASK_UPLINK_PARALLEL UPLINK_MAX_PARALLEL
+#endif
+
+/** 待发送消息（热队列 + 积压层）达到该条数才启用并发 */
+#ifndef TASK_UPLINK_PARALLEL_THRESHOLD
+#define TASK_UPLINK_PARALLEL_THRESHOLD 32
+#endif
+
 /** uplink 全局上下文（供其他任务入队使用） */
 extern uplink_t g_uplink;
 
@@ -12,6 +12,9 @@
 
 #include "task_uplink.h"
 
+#include "app_epoch.h"
+#include "uplink_dns.h"
+
 #include <string.h>
 
 /** uplink 全局上下文：供业务任务调用 uplink_enqueue_json() 入队 */
@@ -70,9 +73,37 @@ BaseType_t Task_Uplink_Init(void)
     cfg.endpoint.port = (uint16_t)TASK_UPLINK_SERVER_PORT;
     Task_Uplink_SetStr(cfg.endpoint.path, sizeof(cfg.endpoint.path), TASK_UPLINK_SERVER_PATH);
 
+#if TASK_UPLINK_USE_MQTT
+    /* MQTT：同一上级地址，端口换成 broker 端口，path 字段承载发布主题 */
+    cfg.endpoint.scheme = UPLINK_SCHEME_MQTT;
+    cfg.endpoint.port = (uint16_t)TASK_UPLINK_MQTT_PORT;
+    Task_Uplink_SetStr(cfg.endpoint.path, sizeof(cfg.endpoint.path), TASK_UPLINK_MQTT_TOPIC);
+#endif
+
+    /* 备用上级：同一传输与路径，只换地址（和可选端口）；MQTT 异步流水只连首选上级 */
+    if (TASK_UPLINK_FALLBACK_HOST[0] != '\0')
+    {
+        cfg.fallback.list[0] = cfg.endpoint;
+        Task_Uplink_SetStr(cfg.fallback.list[0].host, sizeof(cfg.fallback.list[0].host), TASK_UPLINK_FALLBACK_HOST);
+        if ((uint16_t)TASK_UPLINK_FALLBACK_PORT != 0U)
+        {
+            cfg.fallback.list[0].port = (uint16_t)TASK_UPLINK_FALLBACK_PORT;
+        }
+        cfg.fallback.count = 1U;
+    }
+
+    /* 合并上报与压缩：本仓库服务端已支持批量入口与解压中间件 */
+    cfg.batch.max_events = (uint8_t)TASK_UPLINK_BATCH_EVENTS;
+    cfg.batch.compress = (uint8_t)TASK_UPLINK_COMPRESS;
+
+    /* 积压排空：开机补报或断网恢复时多路同时发送，平时仍是一条在途 */
+    cfg.parallel.max_requests = (uint8_t)TASK_UPLINK_PARALLEL;
+    cfg.parallel.threshold = (uint16_t)TASK_UPLINK_PARALLEL_THRESHOLD;
+
     (void)memset(&platform, 0, sizeof(platform));
     platform.user_ctx = NULL;
     platform.log = Task_Uplink_Log;
+    platform.id_epoch = AppEpoch_ClaimCb; /* 消息 ID 跨重启不重复 */
 
     err = uplink_init(&g_uplink, &cfg, &platform);
     if (err != UPLINK_OK)
@@ -109,6 +140,10 @@ void Task_Uplink(void *pvParameters)
     for (;;)
     {
         uplink_poll(&g_uplink);
+
+        /* 域名端点：在上报任务里提前刷新即将过期的解析结果，鉴权/上报请求路径只查缓存 */
+        uplink_dns_refresh();
+
         vTaskDelayUntil(&xLastWakeTime, xPeriod);
     }
 }
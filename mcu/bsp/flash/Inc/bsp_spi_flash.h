@@ -109,4 +109,8 @@ u16 SPI_FLASH_SendHalfWord(u16 HalfWord);
 void SPI_FLASH_WriteEnable(void);
 void SPI_FLASH_WaitForWriteEnd(void);
 
+void SPI_FLASH_LockInit(void);
+void SPI_FLASH_Lock(void);
+void SPI_FLASH_Unlock(void);
+
 #endif /* __SPI_FLASH_H */
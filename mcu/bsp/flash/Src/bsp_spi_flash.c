@@ -11,8 +11,14 @@
 
 #include "bsp_spi_flash.h"
 
+#include "FreeRTOS.h"
+#include "semphr.h"
+
 static __IO uint32_t SPITimeout = SPIT_LONG_TIMEOUT;
 
+/* Ƭ flash һֿȡϢ ID ԪĲдSPI_FLASH_LockInit  */
+static SemaphoreHandle_t s_flash_mutex = NULL;
+
 static uint16_t SPI_TIMEOUT_UserCallback(uint8_t errorCode);
 
 /**
@@ -546,6 +552,40 @@ void SPI_Flash_WAKEUP(void)
     SPI_FLASH_CS_HIGH(); // ȴTRES1
 }
 
+/**
+ * @brief   SPI FLASH  main СǰһΣ
+ * @param  
+ * @retval 
+ */
+void SPI_FLASH_LockInit(void)
+{
+    s_flash_mutex = xSemaphoreCreateMutex();
+    configASSERT(s_flash_mutex != NULL);
+}
+
+/**
+ * @brief  ռ SPI FLASHֻеã
+ * @param  
+ * @retval 
+ * @note   SPI_FLASH_xxx ʱñ SPI_FLASH_Unlock סһ
+ *         硰д + У顱ڲĶдڼȴ
+ */
+void SPI_FLASH_Lock(void)
+{
+    configASSERT(s_flash_mutex != NULL);
+    (void)xSemaphoreTake(s_flash_mutex, portMAX_DELAY);
+}
+
+/**
+ * @brief  ͷ SPI FLASH
+ * @param  
+ * @retval 
+ */
+void SPI_FLASH_Unlock(void)
+{
+    (void)xSemaphoreGive(s_flash_mutex);
+}
+
 /**
  * @brief  ȴʱص
  * @param  None
@@ -1006,10 +1006,14 @@ int GetGBKCode_from_EXFlash( uint8_t * pBuffer, uint16_t c)
 	
 		static uint8_t everRead=0;
 		
+		/*Ϣ ID ԪĲд SPI FLASHȡڼ*/
+		SPI_FLASH_Lock();
+
 		/*һʹãʼFLASH*/
 		if(everRead == 0)
 		{
 			SPI_FLASH_Init();
+			everRead = 1;
 		}
 	
 	  High8bit= c >> 8;     /* ȡ8λ */
@@ -1018,6 +1022,7 @@ int GetGBKCode_from_EXFlash( uint8_t * pBuffer, uint16_t c)
 		/*GB2312 ʽ*/
     pos = ((High8bit-0xa1)*94+Low8bit-0xa1)*24*24/8;
 		SPI_FLASH_BufferRead(pBuffer,GBKCODE_START_ADDRESS+pos,24*24/8); //ȡֿ  
+		SPI_FLASH_Unlock();
 
 //	  printf ( "%02x %02x %02x %02x\n", pBuffer[0],pBuffer[1],pBuffer[2],pBuffer[3]);
 	
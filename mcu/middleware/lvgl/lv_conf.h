@@ -46,6 +46,7 @@
  * 约定：
  * - 帧缓冲：0xD0000000 起（800*480*2 ≈ 768KB）
  * - LVGL heap：0xD0100000 起（默认 512KB）
+ * - uplink 后备队列：0xD0200000 起（4MB，见 uplink_backlog.h）
  *
  * 若后续启用更大字体/图片缓存/双缓冲，可再调整地址与大小。
  */
@@ -11,6 +11,7 @@
  *   - Task_Uplink：周期调用 uplink_poll()，发送异步上报队列。
  *   - Task_Lvgl：LVGL 图形界面任务，驱动 LCD + 触摸屏。
  *   - Task_RfidAuth：RFID 主业务任务（选门、刷卡、鉴权、开门、会话流转）。
+ *   - Task_Push：常连上级推送流，接收权限变更/远程开门并投递给 Task_RfidAuth。
  * - LwIP_Init 必须在调度器启动后调用（当前 NO_SYS=0，依赖 tcpip_thread）。
  *
  * @copyright Copyright (c) 2025 Yukikaze
@@ -25,12 +26,15 @@
 /* BSP 驱动头文件 */
 #include "bsp_led.h"
 #include "bsp_usart.h"
+#include "bsp_spi_flash.h"
 
 /* 应用层任务头文件 */
 #include "app_data.h"
+#include "app_epoch.h"
 #include "task_uplink.h"
 #include "task_lvgl.h"
 #include "task_rfid_auth.h"
+#include "task_push.h"
 
 /* LwIP 网络协议栈头文件 */
 #include "netconf.h"
@@ -99,6 +103,7 @@ int main(void)
  * 1. NVIC 分组
  * 2. LED GPIO
  * 3. 串口（调试输出）
+ * 4. SPI flash 锁（字库与消息 ID 纪元共用，须在调度器启动前创建）
  */
 static void BSP_Init(void)
 {
@@ -121,6 +126,9 @@ static void BSP_Init(void)
     }
     LED_RGBOFF;
 
+    /* SPI flash 锁：任务中才会用到，这里先建好，避免首次使用时再创建 */
+    SPI_FLASH_LockInit();
+
     /* 旧光照传感链路已下线，此处无 ADC 初始化 */
 }
 
@@ -151,6 +159,13 @@ static void AppTaskCreate(void *pvParameters)
         goto error_no_critical;
     }
 
+    /* 恢复消息 ID 纪元（SPI flash），须在 uplink/鉴权模块之前 */
+    xReturn = AppEpoch_Init();
+    if (pdPASS != xReturn)
+    {
+        goto error_no_critical;
+    }
+
     /* 初始化 uplink 模块（HTTP JSON 异步上报） */
     xReturn = Task_Uplink_Init();
     if (pdPASS != xReturn)
@@ -172,6 +187,13 @@ static void AppTaskCreate(void *pvParameters)
         goto error_no_critical;
     }
 
+    /* 初始化下行推送通道（依赖 Task_RfidAuth 的远程命令队列） */
+    xReturn = Task_Push_Init();
+    if (pdPASS != xReturn)
+    {
+        goto error_no_critical;
+    }
+
     /* 进入临界区，集中创建任务 */
     taskENTER_CRITICAL();
     critical_entered = pdTRUE;
@@ -197,6 +219,13 @@ static void AppTaskCreate(void *pvParameters)
         goto error;
     }
 
+    /* 创建下行推送任务 */
+    xReturn = Task_Push_Create();
+    if (pdPASS != xReturn)
+    {
+        goto error;
+    }
+
     /* 退出临界区并删除自身任务 */
     if (critical_entered == pdTRUE)
     {
@@ -0,0 +1,217 @@
+﻿"""
+文件作用：审计写入队列（组提交）与过载暂缓提示（Retry-After）。
+
+主要职责：
+- 组提交：各请求的审计行先在事件循环里攒成一组，每 `AUDIT_GROUP_MS` 毫秒或攒够 `AUDIT_GROUP_ROWS` 行
+  交给 `db_workers.DbWorkers` 的写线程（审计优先级，排在鉴权结论之后），一个事务 `executemany` 写完只提交一次；
+  提交成功后才给这一组的各个请求应答；写连接为 `synchronous=FULL`（见 `SQLiteRepo.set_durable_commits`），
+  设备收到 `code=0` 时记录已经落盘。写连接未确认为 FULL（`durable` 为 False）时不受理审计，见 `router_uplink.py`。
+  上一组还在写时新来的行继续攒，写完立即提交下一组：负载越高每组越大，单次提交的开销分摊到更多行上。
+- `depth` 即等待应答的审计请求数（攒组中 + 写线程排队/执行中，真实的写队列深度）。
+- 队列深度超过软上限时给出暂缓时长，由路由以 `code=5001 msg=service_busy` + `Retry-After` 头
+  + `retryAfterMs` 字段返回给设备。
+- 暂缓时长按“回来的时刻”分配：先排到当前队列的预计排空时刻（深度 × 每个请求的写入耗时 EWMA，单写线程顺序执行）之后，
+  再给每个被暂缓的请求错开一个写入时隙。只按排空时间给同一个值的话，被暂缓的设备会在同一时刻一起回来，
+  又一起被暂缓。
+- 只对审计削峰；鉴权不经过本模块，过载时照常处理（鉴权写入在写线程里优先执行）。
+
+依赖/调用关系：
+- `main.py` 创建 `AuditWriteQueue` 并挂在 `app.state.audit_queue`。
+- `router_uplink.py` 在分发审计/合并上报前查询 `retry_after_ms()`，再用 `submit()` 提交审计行并等待落库。
+"""
+
+import asyncio
+import math
+import time
+from typing import Any, List, Optional, Sequence, Tuple
+
+from .db_workers import PRIO_AUDIT, DbWorkers
+
+# 暂缓时长下限（毫秒）：太短的暂缓只会让设备立刻回来再撞一次。
+RETRY_AFTER_MIN_MS = 200
+
+# 每个请求的写入耗时 EWMA 的平滑系数。
+_EWMA_ALPHA = 0.2
+
+# 还没有写入样本时假定的每个请求写入耗时（毫秒）。
+_DEFAULT_WRITE_MS = 5.0
+
+
+class AuditWriteQueue:
+    """
+    用途：审计组提交队列（攒组 + 写线程提交 + 深度/耗时统计）。
+
+    说明：
+    - `depth`、待提交的组只在事件循环线程里读写，不需要加锁。
+    - 写入耗时 EWMA 只由写线程更新，记录的是一组的提交耗时按请求数平均后的值（暂缓时隙按请求分配）。
+    - 同一时刻最多一组在写线程执行，攒够行数时例外（直接排到写线程，不等上一组写完）。
+    """
+
+    def __init__(
+        self,
+        db: DbWorkers,
+        repo: Any,
+        soft_limit: int,
+        retry_after_max_ms: int,
+        group_rows: int,
+        group_ms: int,
+    ) -> None:
+        """
+        用途：创建写队列。
+
+        参数：
+        - db: 数据库访问线程（审计写入在其写线程执行）。
+        - repo: SQLite 仓储实例（`insert_audit_rows`）。
+        - soft_limit: 队列软上限，深度达到后新来的审计请求被要求暂缓。
+        - retry_after_max_ms: 暂缓时长上限（毫秒）。
+        - group_rows: 一组最多攒多少行，攒够立即提交。
+        - group_ms: 组内第一行最多等多少毫秒就提交（`0` 表示写线程空闲时立即提交）。
+        """
+        self._db = db
+        self._repo = repo
+        self._soft_limit = max(soft_limit, 1)
+        self._retry_after_max_ms = max(retry_after_max_ms, RETRY_AFTER_MIN_MS)
+        self._group_rows = max(group_rows, 1)
+        self._group_sec = max(group_ms, 0) / 1000.0
+        self._write_ms = _DEFAULT_WRITE_MS
+        self._next_slot_ms = 0.0
+        self._pending: List[Tuple[Sequence[tuple], "asyncio.Future[int]"]] = []
+        self._pending_rows = 0
+        self._timer: Optional[asyncio.TimerHandle] = None
+        self._inflight = 0
+        self._tasks: set = set()
+        self.depth = 0
+        self.max_depth = 0
+        self.shed = 0
+        self.groups = 0
+
+    @property
+    def durable(self) -> bool:
+        """
+        用途：组提交返回是否即已落盘（写连接已确认为 `synchronous=FULL`）。
+        """
+        return bool(getattr(self._repo, "durable_commits", False))
+
+    def retry_after_ms(self, now_ms: Optional[float] = None) -> int:
+        """
+        用途：查询当前是否需要设备暂缓，需要时为该请求分配回来的时隙。
+
+        参数：
+        - now_ms: 当前时刻（毫秒，单调时钟）；默认取 `time.monotonic()`，仿真时可传入。
+
+        返回值：
+        - int: 暂缓毫秒数（`RETRY_AFTER_MIN_MS`..上限）；`0` 表示照常受理。
+          需要暂缓时同时累加 `shed` 计数。
+
+        说明：
+        - 时隙超过上限时按上限返回，时隙游标也不再往后推，避免过载结束后还在给出很长的暂缓。
+        """
+        if self.depth < self._soft_limit:
+            return 0
+
+        if now_ms is None:
+            now_ms = time.monotonic() * 1000.0
+        slot_ms = self._write_ms
+        slot = max(self._next_slot_ms, now_ms + self.depth * slot_ms)
+        slot = min(slot, now_ms + self._retry_after_max_ms)
+        self._next_slot_ms = slot + slot_ms
+        self.shed += 1
+        return int(max(math.ceil(slot - now_ms), RETRY_AFTER_MIN_MS))
+
+    async def submit(self, rows: Sequence[tuple]) -> int:
+        """
+        用途：提交一个请求的审计行，等待所在的组提交后返回。
+
+        参数：
+        - rows: 本请求的审计行（`SQLiteRepo.audit_row` 生成，至少一行）。
+
+        返回值：
+        - int: 本请求新写入的行数（已入库的重发行不计）；写库异常原样抛出（整组一起失败，设备重发）。
+
+        说明：
+        - 等待方被取消（如客户端断开）时行仍会随组写入；设备重发由唯一键去重。
+        """
+        loop = asyncio.get_running_loop()
+        future: "asyncio.Future[int]" = loop.create_future()
+        self._pending.append((rows, future))
+        self._pending_rows += len(rows)
+        if self._pending_rows >= self._group_rows:
+            self._flush()
+        elif self._timer is None:
+            self._timer = loop.call_later(self._group_sec, self._on_timer)
+
+        self.depth += 1
+        if self.depth > self.max_depth:
+            self.max_depth = self.depth
+        try:
+            return await future
+        finally:
+            self.depth -= 1
+
+    async def drain(self) -> None:
+        """
+        用途：提交已攒下的行并等待所有组写完（服务关闭前调用）。
+        """
+        if self._pending:
+            self._flush()
+        while self._tasks:
+            await asyncio.gather(*self._tasks, return_exceptions=True)
+
+    def _on_timer(self) -> None:
+        """
+        用途：攒组时间到：写线程空闲则提交；上一组还在写时等它写完再提交（期间继续攒）。
+        """
+        self._timer = None
+        if self._inflight == 0:
+            self._flush()
+
+    def _flush(self) -> None:
+        """
+        用途：把已攒下的行作为一组交给写线程。
+        """
+        if self._timer is not None:
+            self._timer.cancel()
+            self._timer = None
+        if not self._pending:
+            return
+        group, self._pending, self._pending_rows = self._pending, [], 0
+        task = asyncio.get_running_loop().create_task(self._write_group(group))
+        self._tasks.add(task)
+        task.add_done_callback(self._tasks.discard)
+
+    async def _write_group(self, group: List[Tuple[Sequence[tuple], "asyncio.Future[int]"]]) -> None:
+        """
+        用途：在写线程中提交一组，提交后（或失败后）逐个唤醒该组的请求。
+        """
+        self._inflight += 1
+        try:
+            counts = await self._db.write(self._commit, [rows for rows, _ in group], priority=PRIO_AUDIT)
+        except asyncio.CancelledError:
+            for _, future in group:
+                future.cancel()
+            raise
+        except Exception as exc:
+            for _, future in group:
+                if not future.done():
+                    future.set_exception(exc)
+        else:
+            for (_, future), count in zip(group, counts):
+                if not future.done():
+                    future.set_result(count)
+        finally:
+            self._inflight -= 1
+            # 写组期间攒组时间已到（或期间没有开始计时）的行立即成组；否则等计时器。
+            if self._pending and self._inflight == 0 and self._timer is None:
+                self._flush()
+
+    def _commit(self, groups: List[Sequence[tuple]]) -> List[int]:
+        """
+        用途：在写线程中写入一组并记录纯执行耗时（不含排队），按请求数平均计入 EWMA。
+        """
+        t0 = time.perf_counter()
+        try:
+            return self._repo.insert_audit_rows(groups)
+        finally:
+            cost_ms = (time.perf_counter() - t0) * 1000.0 / len(groups)
+            self._write_ms += _EWMA_ALPHA * (cost_ms - self._write_ms)
+            self.groups += 1
@@ -13,14 +13,16 @@ import asyncio
 import logging
 
 from .config import Settings
+from .db_workers import PRIO_BACKGROUND, DbWorkers
 from .repo_sqlite import SQLiteRepo
 
 
-async def run_cleanup_loop(repo: SQLiteRepo, settings: Settings) -> None:
+async def run_cleanup_loop(db: DbWorkers, repo: SQLiteRepo, settings: Settings) -> None:
     """
     用途：循环执行历史审计清理。
 
     参数：
+    - db: 数据库访问线程（清理在写线程按后台优先级执行，不阻塞事件循环，也不挡在鉴权前面）。
     - repo: SQLite 仓储实例。
     - settings: 配置对象，提供保留天数。
 
@@ -32,7 +34,7 @@ async def run_cleanup_loop(repo: SQLiteRepo, settings: Settings) -> None:
     """
     while True:
         try:
-            deleted = repo.cleanup_audit_events(settings.data_retention_days)
+            deleted = await db.write(repo.cleanup_audit_events, settings.data_retention_days, priority=PRIO_BACKGROUND)
             logging.getLogger("uplink.cleanup").info(
                 "cleanup completed, deleted=%s retention_days=%s",
                 deleted,
@@ -93,6 +93,17 @@ class Settings:
     - signature_max_skew_sec: 签名时间戳允许偏差秒数。
     - nonce_ttl_sec: 防重放 nonce 的保留秒数。
     - log_level: 日志级别。
+    - auth_udp_enabled: 是否启用 UDP 单往返鉴权监听。
+    - auth_udp_port: UDP 鉴权监听端口（与 MCU `APP_AUTH_UDP_PORT` 一致）。
+    - push_heartbeat_sec: 推送流空闲时发送 PING 的间隔秒数（需小于 MCU 心跳超时）。
+    - push_admin_token: 调用 `/api/push/send` 所需的管理令牌，空字符串表示不校验。
+    - db_read_workers: 数据库读线程数（鉴权判定、签名查设备）；写入固定由单个写线程执行。
+    - audit_queue_soft: 审计写队列软上限，达到后新的审计请求被要求暂缓（`service_busy`）。
+    - retry_after_max_ms: 返回给设备的暂缓时长上限（毫秒）。
+    - audit_group_rows: 审计组提交一组最多攒多少行，攒够立即提交。
+    - audit_group_ms: 审计组提交中第一行最多等待的毫秒数（`0` 表示写线程空闲时立即提交）。
+    - perm_cache_enabled: 是否把卡权限载入内存，鉴权判定不查库。
+    - perm_cache_refresh_sec: 检查库内权限版本的间隔秒数（其它进程改了权限时据此重载）。
     """
 
     app_host: str
@@ -103,6 +114,17 @@ class Settings:
     signature_max_skew_sec: int
     nonce_ttl_sec: int
     log_level: str
+    auth_udp_enabled: bool
+    auth_udp_port: int
+    push_heartbeat_sec: int
+    push_admin_token: str
+    db_read_workers: int
+    audit_queue_soft: int
+    retry_after_max_ms: int
+    audit_group_rows: int
+    audit_group_ms: int
+    perm_cache_enabled: bool
+    perm_cache_refresh_sec: int
 
 
 def load_settings() -> Settings:
@@ -137,4 +159,15 @@ def load_settings() -> Settings:
         signature_max_skew_sec=_to_int(os.getenv("SIGNATURE_MAX_SKEW_SEC"), 120),
         nonce_ttl_sec=_to_int(os.getenv("NONCE_TTL_SEC"), 300),
         log_level=os.getenv("LOG_LEVEL", "INFO").upper(),
+        auth_udp_enabled=_to_bool(os.getenv("AUTH_UDP_ENABLED"), False),
+        auth_udp_port=_to_int(os.getenv("AUTH_UDP_PORT"), 5683),
+        push_heartbeat_sec=_to_int(os.getenv("PUSH_HEARTBEAT_SEC"), 10),
+        push_admin_token=os.getenv("PUSH_ADMIN_TOKEN", ""),
+        db_read_workers=_to_int(os.getenv("DB_READ_WORKERS"), 4),
+        audit_queue_soft=_to_int(os.getenv("AUDIT_QUEUE_SOFT"), 64),
+        retry_after_max_ms=_to_int(os.getenv("RETRY_AFTER_MAX_MS"), 30000),
+        audit_group_rows=_to_int(os.getenv("AUDIT_GROUP_ROWS"), 256),
+        audit_group_ms=_to_int(os.getenv("AUDIT_GROUP_MS"), 0),
+        perm_cache_enabled=_to_bool(os.getenv("PERM_CACHE_ENABLED"), True),
+        perm_cache_refresh_sec=_to_int(os.getenv("PERM_CACHE_REFRESH_SEC"), 5),
     )
@@ -0,0 +1,268 @@
+﻿"""
+文件作用：请求体解压中间件（`Content-Encoding`）。
+
+主要职责：
+- 按 `Content-Encoding` 把压缩过的请求体解开，再交给后续路由，路由看到的始终是明文 JSON。
+- 支持 `x-heatshrink`（MCU 合并上报使用，见 `uplink_lzss.h`）与 `gzip`/`deflate`（便于工具脚本调试）。
+- 限制解压后大小，防止小包解出超大 body 拖垮进程。
+
+依赖/调用关系：
+- `main.py` 通过 `app.add_middleware` 挂接。
+- `router_uplink.py` 从 `request.state.wire_body` 取线上原始字节做签名校验
+  （MCU 对实际发出的字节签名，压缩时即对压缩后的 body 签名）。
+
+说明：
+- 纯 ASGI 中间件，不经过 `BaseHTTPMiddleware`，避免改写 body 时重复缓冲。
+- 解码失败时按上报接口约定返回 HTTP 200 + `code=5001`，不进入业务层。
+"""
+
+import json
+import zlib
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+HEATSHRINK_ENCODING = "x-heatshrink"
+
+# 与 MCU 端 UPLINK_LZSS_WINDOW_BITS / UPLINK_LZSS_LOOKAHEAD_BITS 保持一致。
+HEATSHRINK_WINDOW_BITS = 8
+HEATSHRINK_LOOKAHEAD_BITS = 4
+
+# 解压后 body 上限（字节）；MCU 单批不超过几 KB，留足余量。
+MAX_DECODED_BODY = 256 * 1024
+
+
+class ContentDecodeError(ValueError):
+    """
+    用途：请求体无法按声明的 `Content-Encoding` 解码（格式错误/不支持/超过上限）。
+    """
+
+
+def heatshrink_decode(
+    data: bytes,
+    max_size: int = MAX_DECODED_BODY,
+    window_bits: int = HEATSHRINK_WINDOW_BITS,
+    lookahead_bits: int = HEATSHRINK_LOOKAHEAD_BITS,
+) -> bytes:
+    """
+    用途：解码 heatshrink 码流（高位在前；1+8 位字面量，0+窗口位+长度位为回溯引用）。
+
+    参数：
+    - data: 压缩数据。
+    - max_size: 解码结果上限（字节）。
+    - window_bits / lookahead_bits: 与编码端一致的窗口与最长匹配位数。
+
+    返回值：
+    - bytes: 解码结果。
+
+    异常：
+    - ContentDecodeError: 引用越过已解出的数据，或结果超过上限。
+
+    边界行为：
+    - 末尾不足一个完整记号的位视为补齐位，直接结束。
+    """
+    out = bytearray()
+    ref_bits = window_bits + lookahead_bits
+    count_mask = (1 << lookahead_bits) - 1
+    acc = 0
+    acc_bits = 0
+    idx = 0
+
+    while True:
+        # 累加器补到至少够一个完整记号（标志位 + 引用）。
+        while acc_bits <= ref_bits and idx < len(data):
+            acc = (acc << 8) | data[idx]
+            acc_bits += 8
+            idx += 1
+
+        if acc_bits == 0:
+            break
+        acc_bits -= 1
+        is_literal = (acc >> acc_bits) & 1
+
+        if is_literal:
+            if acc_bits < 8:
+                break
+            acc_bits -= 8
+            out.append((acc >> acc_bits) & 0xFF)
+        else:
+            if acc_bits < ref_bits:
+                break
+            acc_bits -= ref_bits
+            token = (acc >> acc_bits) & ((1 << ref_bits) - 1)
+            dist = (token >> lookahead_bits) + 1
+            count = (token & count_mask) + 1
+            if dist > len(out):
+                raise ContentDecodeError("heatshrink_bad_backref")
+            # 逐字节复制：引用可以与正在写出的数据重叠。
+            start = len(out) - dist
+            for k in range(count):
+                out.append(out[start + k])
+
+        acc &= (1 << acc_bits) - 1
+        if len(out) > max_size:
+            raise ContentDecodeError("decoded_body_too_large")
+
+    return bytes(out)
+
+
+def _zlib_decode(data: bytes, max_size: int) -> bytes:
+    """
+    用途：解码 gzip / deflate（zlib 封装），自动识别头部。
+
+    参数：
+    - data: 压缩数据。
+    - max_size: 解码结果上限（字节）。
+
+    返回值：
+    - bytes: 解码结果。
+
+    异常：
+    - ContentDecodeError: 数据损坏、不完整或结果超过上限。
+    """
+    decoder = zlib.decompressobj(wbits=zlib.MAX_WBITS | 32)
+    try:
+        out = decoder.decompress(data, max_size + 1)
+    except zlib.error as exc:
+        raise ContentDecodeError("zlib_error") from exc
+    if len(out) > max_size or decoder.unconsumed_tail:
+        raise ContentDecodeError("decoded_body_too_large")
+    if not decoder.eof:
+        raise ContentDecodeError("zlib_truncated")
+    return out
+
+
+_DECODERS: Dict[str, Callable[[bytes, int], bytes]] = {
+    HEATSHRINK_ENCODING: heatshrink_decode,
+    "gzip": _zlib_decode,
+    "deflate": _zlib_decode,
+}
+
+
+def decode_body(encoding: str, data: bytes, max_size: int = MAX_DECODED_BODY) -> bytes:
+    """
+    用途：按 `Content-Encoding` 解码请求体。
+
+    参数：
+    - encoding: 编码名（小写，已去空白）。
+    - data: 线上原始字节。
+    - max_size: 解码结果上限（字节）。
+
+    返回值：
+    - bytes: 明文 body。
+
+    异常：
+    - ContentDecodeError: 不支持的编码或解码失败。
+    """
+    decoder = _DECODERS.get(encoding)
+    if decoder is None:
+        raise ContentDecodeError(f"unsupported_content_encoding_{encoding}")
+    return decoder(data, max_size)
+
+
+class ContentDecodingMiddleware:
+    """
+    用途：ASGI 中间件，在路由之前解开压缩的请求体。
+
+    说明：
+    - 无 `Content-Encoding` 或为 `identity` 的请求原样透传，不额外缓冲。
+    - 解码后替换 `receive`、去掉 `Content-Encoding`、改写 `Content-Length`，
+      线上原始字节放在 `scope["state"]["wire_body"]`（即 `request.state.wire_body`）。
+    """
+
+    def __init__(self, app: Any, max_body: int = MAX_DECODED_BODY) -> None:
+        """
+        用途：初始化中间件。
+
+        参数：
+        - app: 下游 ASGI 应用。
+        - max_body: 线上 body 与解码结果的上限（字节）。
+        """
+        self.app = app
+        self.max_body = max_body
+
+    async def __call__(self, scope: Dict[str, Any], receive: Callable, send: Callable) -> None:
+        """
+        用途：ASGI 入口。
+
+        参数：
+        - scope / receive / send: ASGI 标准参数。
+
+        返回值：
+        - 无。
+        """
+        if scope["type"] != "http":
+            await self.app(scope, receive, send)
+            return
+
+        encoding: Optional[str] = None
+        headers: List[Tuple[bytes, bytes]] = []
+        for key, value in scope["headers"]:
+            if key == b"content-encoding":
+                encoding = value.decode("latin-1").strip().lower()
+            elif key != b"content-length":
+                headers.append((key, value))
+
+        if not encoding or encoding == "identity":
+            await self.app(scope, receive, send)
+            return
+
+        # 读完整个线上 body（MCU 请求都很小，超过上限直接拒绝）。
+        chunks: List[bytes] = []
+        size = 0
+        more = True
+        while more:
+            message = await receive()
+            if message["type"] != "http.request":
+                return
+            chunk = message.get("body", b"")
+            size += len(chunk)
+            if size > self.max_body:
+                await _reject(send, "wire_body_too_large")
+                return
+            chunks.append(chunk)
+            more = message.get("more_body", False)
+        wire = b"".join(chunks)
+
+        try:
+            body = decode_body(encoding, wire, self.max_body)
+        except ContentDecodeError as exc:
+            await _reject(send, str(exc))
+            return
+
+        headers.append((b"content-length", str(len(body)).encode("latin-1")))
+        inner = dict(scope)
+        inner["headers"] = headers
+        inner["state"] = dict(scope.get("state") or {})
+        inner["state"]["wire_body"] = wire
+
+        delivered = False
+
+        async def receive_decoded() -> Dict[str, Any]:
+            nonlocal delivered
+            if not delivered:
+                delivered = True
+                return {"type": "http.request", "body": body, "more_body": False}
+            return await receive()
+
+        await self.app(inner, receive_decoded, send)
+
+
+async def _reject(send: Callable, msg: str) -> None:
+    """
+    用途：按上报接口约定返回解码失败（HTTP 200 + `code=5001`）。
+
+    参数：
+    - send: ASGI send。
+    - msg: 失败原因。
+    """
+    payload = json.dumps({"code": 5001, "msg": msg}).encode("utf-8")
+    await send(
+        {
+            "type": "http.response.start",
+            "status": 200,
+            "headers": [
+                (b"content-type", b"application/json"),
+                (b"content-length", str(len(payload)).encode("latin-1")),
+            ],
+        }
+    )
+    await send({"type": "http.response.body", "body": payload})
@@ -0,0 +1,210 @@
+﻿"""
+文件作用：数据库访问线程（读线程池 + 单写线程优先级队列）。
+
+主要职责：
+- 把所有 SQLite 访问移出事件循环：事件循环线程只做解析、分发与应答，不再等库锁。
+- 读：有界线程池（`DB_READ_WORKERS`），鉴权判定、签名查设备走这里，不和审计写入排队。
+- 写：单个写线程按优先级取任务，鉴权结论 > 审计写入 > 后台维护（设备最近访问时间等）。
+  SQLite 同一时刻只有一个写者，多个写线程只会在库锁上忙等（busy handler 按递增间隔睡眠），
+  一个写线程顺序执行反而没有锁竞争，排队顺序也由这里决定，而不是由谁先抢到锁决定。
+- 后台写可按键合并：同一键已在队列里时不再重复入队。
+
+依赖/调用关系：
+- `main.py` 创建 `DbWorkers` 并挂在 `app.state.db`，关闭时调用 `close()`。
+- `router_uplink.py`、`udp_auth.py` 经此执行鉴权读写；`backpressure.AuditWriteQueue` 经此执行审计写入。
+"""
+
+import asyncio
+import functools
+import itertools
+import logging
+import queue
+import threading
+from concurrent.futures import Future, ThreadPoolExecutor
+from typing import Any, Callable, Hashable, Optional, Set
+
+logger = logging.getLogger("uplink.db")
+
+# 写任务优先级（数值越小越先执行）。
+PRIO_AUTH = 0
+PRIO_AUDIT = 1
+PRIO_BACKGROUND = 2
+
+# 关闭标记排在所有写任务之后：已入队的写入先执行完。
+_PRIO_STOP = 99
+
+
+class DbWorkers:
+    """
+    用途：数据库读线程池 + 单写线程。
+
+    说明：
+    - 读写函数都是 `SQLiteRepo` 的同步方法（或以它为参数的同步函数），在各自线程里使用该线程的长连接。
+    - 同一优先级内按入队顺序执行。
+    - 写线程是唯一执行写入的线程；`write_depth` 为排队 + 执行中的写任务数。
+    - `writer_init` 失败时构造直接抛出：写连接没有按要求配置（如未设为同步落盘）时不允许服务启动。
+    """
+
+    def __init__(self, read_workers: int, writer_init: Optional[Callable[[], None]] = None) -> None:
+        """
+        用途：创建读线程池并启动写线程。
+
+        参数：
+        - read_workers: 读线程数。
+        - writer_init: 写线程启动后、执行任何写任务前在写线程里调用一次（如把写连接设为同步落盘）。
+
+        异常：
+        - `writer_init` 抛出的异常原样抛出；此时写线程已退出，读线程池已关闭。
+        """
+        self._readers = ThreadPoolExecutor(max_workers=max(read_workers, 1), thread_name_prefix="db-read")
+        self._writes: "queue.PriorityQueue[tuple]" = queue.PriorityQueue()
+        self._seq = itertools.count()
+        self._pending_keys: Set[Hashable] = set()
+        self._keys_lock = threading.Lock()
+        self._writer_init = writer_init
+        self._running = 0
+        self._ready: Future = Future()
+        self._writer = threading.Thread(target=self._write_loop, name="db-write", daemon=True)
+        self._writer.start()
+        try:
+            self._ready.result()
+        except BaseException:
+            self._writer.join()
+            self._readers.shutdown(wait=True)
+            raise
+
+    @property
+    def write_depth(self) -> int:
+        """
+        用途：写任务深度（排队中 + 正在执行的一个）。
+        """
+        return self._writes.qsize() + self._running
+
+    async def read(self, fn: Callable[..., Any], *args: Any, **kwargs: Any) -> Any:
+        """
+        用途：在读线程池中执行一次只读访问。
+
+        参数：
+        - fn: 同步读函数。
+        - args/kwargs: 透传参数。
+
+        返回值：
+        - Any: `fn` 的返回值；异常原样抛出。
+        """
+        loop = asyncio.get_running_loop()
+        return await loop.run_in_executor(self._readers, functools.partial(fn, *args, **kwargs))
+
+    async def write(self, fn: Callable[..., Any], *args: Any, priority: int = PRIO_AUDIT, **kwargs: Any) -> Any:
+        """
+        用途：在写线程中执行一次写入并等待结果。
+
+        参数：
+        - fn: 同步写函数。
+        - args/kwargs: 透传参数。
+        - priority: 写任务优先级（`PRIO_*`）。
+
+        返回值：
+        - Any: `fn` 的返回值；异常原样抛出。
+
+        说明：
+        - 等待方被取消（如客户端断开）且任务尚未开始执行时，任务不再执行。
+        """
+        return await asyncio.wrap_future(self._submit(priority, functools.partial(fn, *args, **kwargs), None))
+
+    def write_wait(self, fn: Callable[..., Any], *args: Any, priority: int = PRIO_AUDIT, **kwargs: Any) -> Any:
+        """
+        用途：在读线程等工作线程中提交一次写入并阻塞等待结果。
+
+        参数：
+        - fn: 同步写函数。
+        - args/kwargs: 透传参数。
+        - priority: 写任务优先级（`PRIO_*`）。
+
+        返回值：
+        - Any: `fn` 的返回值；异常原样抛出。
+
+        说明：
+        - 不能在事件循环线程（会阻塞事件循环）或写线程自身（自等死锁）中调用。
+        """
+        return self._submit(priority, functools.partial(fn, *args, **kwargs), None).result()
+
+    def write_nowait(
+        self,
+        fn: Callable[..., Any],
+        *args: Any,
+        priority: int = PRIO_BACKGROUND,
+        key: Optional[Hashable] = None,
+    ) -> None:
+        """
+        用途：提交一次不等待结果的写入（后台维护类）。
+
+        参数：
+        - fn: 同步写函数。
+        - args: 透传参数。
+        - priority: 写任务优先级，默认最低。
+        - key: 合并键；同一键的任务尚未执行时，新的提交直接丢弃。
+
+        返回值：
+        - 无；执行失败只记日志。
+        """
+        if key is not None:
+            with self._keys_lock:
+                if key in self._pending_keys:
+                    return
+                self._pending_keys.add(key)
+        future = self._submit(priority, functools.partial(fn, *args), key)
+        future.add_done_callback(_log_failure)
+
+    def _submit(self, priority: int, call: Callable[[], Any], key: Optional[Hashable]) -> Future:
+        future: Future = Future()
+        self._writes.put((priority, next(self._seq), call, future, key))
+        return future
+
+    def _write_loop(self) -> None:
+        """
+        用途：写线程主循环：按优先级逐个执行写任务，收到关闭标记后退出。
+        """
+        if self._writer_init is not None:
+            try:
+                self._writer_init()
+            except BaseException as exc:
+                logger.error("db writer init failed: %r", exc)
+                self._ready.set_exception(exc)
+                return
+        self._ready.set_result(None)
+        while True:
+            _, _, call, future, key = self._writes.get()
+            if call is None:
+                return
+            if key is not None:
+                # 先释放合并键再执行：执行期间的新提交需要重新入队，才能写入更新后的值。
+                with self._keys_lock:
+                    self._pending_keys.discard(key)
+            if not future.set_running_or_notify_cancel():
+                continue
+            self._running = 1
+            try:
+                future.set_result(call())
+            except BaseException as exc:
+                future.set_exception(exc)
+            finally:
+                self._running = 0
+
+    def close(self) -> None:
+        """
+        用途：等待已入队的写入执行完，停止写线程并关闭读线程池。
+        """
+        self._writes.put((_PRIO_STOP, next(self._seq), None, None, None))
+        self._writer.join()
+        self._readers.shutdown(wait=True)
+
+
+def _log_failure(future: Future) -> None:
+    """
+    用途：`write_nowait` 任务的完成回调，失败时记日志。
+    """
+    if future.cancelled():
+        return
+    exc = future.exception()
+    if exc is not None:
+        logger.warning("background db write failed: %r", exc)
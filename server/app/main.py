@@ -3,12 +3,18 @@
 
 主要职责：
 - 加载配置并初始化 SQLite 仓储。
-- 注册 HTTP 路由（/api/uplink、/healthz）。
+- 注册 HTTP 路由（/api/uplink、/api/push/*、/healthz）。
+- 挂接请求体解压中间件（`Content-Encoding: x-heatshrink/gzip/deflate`）。
 - 在启动时创建后台清理协程，在关闭时安全取消。
+- 按配置启动 UDP 单往返鉴权监听（`udp_auth`）。
+- 创建数据库访问线程（`db_workers`：读线程池 + 单写线程），事件循环里不直接访问数据库。
+- 创建审计写队列（`backpressure`），过载时按队列深度要求设备暂缓审计上报。
+- 按配置载入卡权限内存索引（`perm_cache`），并定期检查库内权限版本。
 
 依赖/调用关系：
 - Uvicorn 通过 `app.main:app` 导入该文件。
 - 调用 `router_uplink` 处理上报请求。
+- 调用 `router_push` 维护设备推送流，并持有进程内 `PushHub`。
 - 调用 `cleanup.run_cleanup_loop` 定期清理历史审计数据。
 """
 
@@ -18,11 +24,18 @@ import logging
 
 from fastapi import FastAPI
 
+from .backpressure import AuditWriteQueue
 from .cleanup import run_cleanup_loop
 from .config import load_settings
+from .content_encoding import ContentDecodingMiddleware
+from .db_workers import DbWorkers
+from .perm_cache import run_refresh_loop
+from .push_hub import PushHub
 from .repo_sqlite import SQLiteRepo
+from .router_push import router as push_router
 from .router_uplink import router
 from .security import NonceStore
+from .udp_auth import UdpAuthProtocol
 
 
 def _setup_logging(level: str) -> None:
@@ -60,6 +73,9 @@ def create_app() -> FastAPI:
     # 初始化数据库访问层，并确保表结构存在。
     repo = SQLiteRepo(settings.db_path)
     repo.init_db()
+    if settings.perm_cache_enabled:
+        cards = repo.enable_permission_cache()
+        logging.getLogger("uplink.perm_cache").info("permission cache loaded: cards=%s", cards)
 
     app = FastAPI(title="RFID Uplink Server", version="0.1.0")
 
@@ -68,9 +84,25 @@ def create_app() -> FastAPI:
     app.state.repo = repo
     app.state.nonce_store = NonceStore(ttl_sec=settings.nonce_ttl_sec)
     app.state.cleanup_task = None
+    app.state.perm_refresh_task = None
+    app.state.udp_auth_transport = None
+    app.state.push_hub = PushHub()
+    app.state.db = DbWorkers(read_workers=settings.db_read_workers, writer_init=repo.set_durable_commits)
+    app.state.audit_queue = AuditWriteQueue(
+        db=app.state.db,
+        repo=repo,
+        soft_limit=settings.audit_queue_soft,
+        retry_after_max_ms=settings.retry_after_max_ms,
+        group_rows=settings.audit_group_rows,
+        group_ms=settings.audit_group_ms,
+    )
+
+    # 压缩的请求体先解压再进路由（MCU 合并上报使用 x-heatshrink）。
+    app.add_middleware(ContentDecodingMiddleware)
 
-    # 注册上报路由。
+    # 注册上报路由与推送路由。
     app.include_router(router)
+    app.include_router(push_router)
 
     @app.get("/healthz")
     async def healthz():
@@ -81,9 +113,21 @@ def create_app() -> FastAPI:
         - 无。
 
         返回值：
-        - dict: 固定返回 {"ok": True}。
+        - dict: `ok`、`durableCommits`（审计提交是否同步落盘，False 时审计被拒收，`ok` 同为 False）
+          与审计写队列统计（当前/最大深度、写线程深度、已提交组数、暂缓次数）。
         """
-        return {"ok": True}
+        queue = app.state.audit_queue
+        return {
+            "ok": repo.durable_commits,
+            "durableCommits": repo.durable_commits,
+            "audit": {
+                "depth": queue.depth,
+                "maxDepth": queue.max_depth,
+                "writeDepth": app.state.db.write_depth,
+                "groups": queue.groups,
+                "shed": queue.shed,
+            },
+        }
 
     @app.on_event("startup")
     async def startup_event() -> None:
@@ -98,8 +142,28 @@ def create_app() -> FastAPI:
 
         说明：
         - 启动后台协程，每日执行一次审计数据清理。
+        - 启用权限内存索引时，启动版本检查协程。
+        - 若启用 UDP 鉴权，在同一监听地址上绑定 UDP 端口。
         """
-        app.state.cleanup_task = asyncio.create_task(run_cleanup_loop(repo, settings))
+        app.state.cleanup_task = asyncio.create_task(run_cleanup_loop(app.state.db, repo, settings))
+        if settings.perm_cache_enabled and settings.perm_cache_refresh_sec > 0:
+            app.state.perm_refresh_task = asyncio.create_task(
+                run_refresh_loop(app.state.db, repo, settings.perm_cache_refresh_sec)
+            )
+
+        if settings.auth_udp_enabled:
+            loop = asyncio.get_running_loop()
+            transport, _ = await loop.create_datagram_endpoint(
+                lambda: UdpAuthProtocol(
+                    repo,
+                    cache_ttl_sec=settings.nonce_ttl_sec,
+                    db=app.state.db,
+                    max_skew_sec=settings.signature_max_skew_sec,
+                    nonce_store=app.state.nonce_store,
+                ),
+                local_addr=(settings.app_host, settings.auth_udp_port),
+            )
+            app.state.udp_auth_transport = transport
 
     @app.on_event("shutdown")
     async def shutdown_event() -> None:
@@ -113,13 +177,24 @@ def create_app() -> FastAPI:
         - 无。
 
         说明：
-        - 安全取消后台清理协程，避免进程退出时挂起任务。
+        - 安全取消后台清理与权限版本检查协程，避免进程退出时挂起任务。
+        - 关闭 UDP 鉴权监听。
+        - 提交已攒下的审计行，等待写线程中已受理的写入完成，再关闭各线程的数据库长连接。
         """
-        task = app.state.cleanup_task
-        if task is not None:
-            task.cancel()
-            with contextlib.suppress(asyncio.CancelledError):
-                await task
+        udp_transport = app.state.udp_auth_transport
+        if udp_transport is not None:
+            udp_transport.close()
+            app.state.udp_auth_transport = None
+
+        for task in (app.state.cleanup_task, app.state.perm_refresh_task):
+            if task is not None:
+                task.cancel()
+                with contextlib.suppress(asyncio.CancelledError):
+                    await task
+
+        await app.state.audit_queue.drain()
+        app.state.db.close()
+        repo.close()
 
     return app
 
@@ -0,0 +1,134 @@
+﻿"""
+文件作用：卡权限内存索引（鉴权判定不查库）。
+
+主要职责：
+- 启动时把 `card_permissions` 整表载入内存：`uid_sha1 -> ((locker_id, active, valid_from, valid_to), ...)`。
+- 本进程内 `SQLiteRepo.upsert_permission` 提交后直接写穿到索引。
+- 带版本号：库内 `perm_version` 由触发器在 `card_permissions` 每次增删改时加一，索引记录自己对应的版本；
+  其它进程（`seed_demo_data.py`、运维直接改库）改了权限时版本对不上，后台定期检查后整表重载。
+
+依赖/调用关系：
+- `SQLiteRepo` 持有索引（`enable_permission_cache()` 之后 `check_card_access` 改查内存）。
+- `main.py` 启动时载入，并创建 `run_refresh_loop` 协程定期检查版本。
+"""
+
+import asyncio
+import logging
+import threading
+from typing import Any, Dict, Iterable, Optional, Tuple
+
+logger = logging.getLogger("uplink.perm_cache")
+
+# 单个门位的权限：(locker_id, active, valid_from, valid_to)，时间为 ISO 字符串，与库内比较方式一致。
+PermEntry = Tuple[str, int, Optional[str], Optional[str]]
+
+
+class PermissionCache:
+    """
+    用途：卡权限内存索引。
+
+    说明：
+    - 每张卡的门位用元组顺序保存（一张卡通常只有几个门位，顺序查找比每卡一个 dict 省一半内存，
+      10 万张卡约 30MB）；门位 ID 与有效期字符串大量重复，载入时共用同一个对象。
+    - 读不加锁：每张卡的门位元组不可变，更新时整张替换，读到的总是完整的一份。
+    - 写（载入/写穿）加锁，保证版本号与内容一起前进。
+    - `version` 为 -1 表示尚未载入。
+    """
+
+    def __init__(self) -> None:
+        self._cards: Dict[str, Tuple[PermEntry, ...]] = {}
+        self._lock = threading.Lock()
+        self.version = -1
+
+    def __len__(self) -> int:
+        return len(self._cards)
+
+    def load(self, rows: Iterable[Any], version: int) -> None:
+        """
+        用途：整表载入（替换现有内容）。
+
+        参数：
+        - rows: `(uid_sha1, locker_id, active, valid_from, valid_to)` 行序列。
+        - version: 读取这些行时库内的权限版本（与行在同一事务中读取）。
+        """
+        cards: Dict[str, Tuple[PermEntry, ...]] = {}
+        shared: Dict[Any, Any] = {None: None}
+        for uid_sha1, locker_id, active, valid_from, valid_to in rows:
+            entry = (
+                shared.setdefault(locker_id, locker_id),
+                int(active),
+                shared.setdefault(valid_from, valid_from),
+                shared.setdefault(valid_to, valid_to),
+            )
+            cards[uid_sha1] = cards.get(uid_sha1, ()) + (entry,)
+        with self._lock:
+            self._cards = cards
+            self.version = version
+
+    def apply(self, uid_sha1: str, entry: PermEntry, version: int) -> bool:
+        """
+        用途：写穿一条权限变更。
+
+        参数：
+        - uid_sha1: 卡。
+        - entry: 变更后的 `(locker_id, active, valid_from, valid_to)`。
+        - version: 该变更提交后的库内版本。
+
+        返回值：
+        - bool: True 表示已应用；False 表示版本不连续（期间有别的写入），调用方应整表重载。
+        """
+        with self._lock:
+            if version != self.version + 1:
+                return False
+            others = tuple(e for e in self._cards.get(uid_sha1, ()) if e[0] != entry[0])
+            self._cards[uid_sha1] = others + (entry,)
+            self.version = version
+            return True
+
+    def check(self, uid_sha1: str, locker_id: str, now_iso: str) -> Tuple[bool, bool]:
+        """
+        用途：判断卡是否存在、当前时间是否拥有指定门位权限（与 `SQLiteRepo.check_card_access` 的 SQL 同义）。
+
+        参数：
+        - uid_sha1: UID SHA1。
+        - locker_id: 门位 ID。
+        - now_iso: 当前时间（ISO 字符串）。
+
+        返回值：
+        - Tuple[bool, bool]: `(卡是否存在, 是否有权限)`。
+        """
+        entries = self._cards.get(uid_sha1)
+        if entries is None:
+            return False, False
+        for entry_locker, active, valid_from, valid_to in entries:
+            if entry_locker == locker_id:
+                permitted = (
+                    active == 1
+                    and (valid_from is None or valid_from <= now_iso)
+                    and (valid_to is None or valid_to >= now_iso)
+                )
+                return True, permitted
+        return True, False
+
+
+async def run_refresh_loop(db: Any, repo: Any, interval_sec: int) -> None:
+    """
+    用途：定期检查库内权限版本，被其它进程修改过时整表重载。
+
+    参数：
+    - db: 数据库访问线程（检查与重载在读线程执行）。
+    - repo: SQLite 仓储实例（已启用权限索引）。
+    - interval_sec: 检查间隔（秒）。
+
+    返回值：
+    - 无（长期运行协程）。
+
+    边界行为：
+    - 任意一次检查异常不会中断循环，记录后进入下一轮；期间继续使用旧索引。
+    """
+    while True:
+        await asyncio.sleep(interval_sec)
+        try:
+            await db.read(repo.refresh_permission_cache)
+        except Exception as exc:  # pragma: no cover
+            logger.exception("permission cache refresh failed: %s", exc)
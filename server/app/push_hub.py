@@ -0,0 +1,116 @@
+﻿"""
+文件作用：下行推送订阅中心（进程内）。
+
+主要职责：
+- 维护“设备 ID -> 订阅队列”映射，每条推送流连接对应一个 asyncio.Queue。
+- 提供按设备投递与全体广播，返回实际投递的连接数。
+
+依赖/调用关系：
+- `router_push.py` 在推送流连接建立/断开时订阅/退订。
+- 管理接口或业务代码调用 `publish` 下发 OPEN_DOOR / PERM_UPDATE 等命令。
+
+说明：
+- 仅在单进程内有效；多 worker 部署时需要换成外部消息总线。
+"""
+
+import asyncio
+from typing import Any, Dict, Set
+
+
+class PushHub:
+    """
+    用途：进程内推送订阅中心。
+
+    说明：
+    - 同一设备允许多条连接（如设备重连时旧连接尚未超时），消息会投递到全部连接。
+    - 单连接队列有上限，队列满时丢弃该条消息而不是阻塞发送方。
+    """
+
+    def __init__(self, queue_max: int = 64) -> None:
+        """
+        用途：初始化订阅中心。
+
+        参数：
+        - queue_max: 单连接待发送消息上限。
+
+        返回值：
+        - 无。
+        """
+        self._queue_max = queue_max
+        self._subs: Dict[str, Set[asyncio.Queue]] = {}
+
+    def subscribe(self, device_id: str) -> asyncio.Queue:
+        """
+        用途：为一条推送流连接创建订阅队列。
+
+        参数：
+        - device_id: 设备 ID。
+
+        返回值：
+        - asyncio.Queue: 该连接专属的消息队列。
+        """
+        queue: asyncio.Queue = asyncio.Queue(maxsize=self._queue_max)
+        self._subs.setdefault(device_id, set()).add(queue)
+        return queue
+
+    def unsubscribe(self, device_id: str, queue: asyncio.Queue) -> None:
+        """
+        用途：连接断开时移除订阅。
+
+        参数：
+        - device_id: 设备 ID。
+        - queue: `subscribe` 返回的队列。
+
+        返回值：
+        - 无。
+        """
+        queues = self._subs.get(device_id)
+        if not queues:
+            return
+        queues.discard(queue)
+        if not queues:
+            del self._subs[device_id]
+
+    def publish(self, device_id: str, message: Dict[str, Any]) -> int:
+        """
+        用途：向指定设备的全部在线连接投递一条消息。
+
+        参数：
+        - device_id: 设备 ID。
+        - message: 消息字典（至少包含 `type`）。
+
+        返回值：
+        - int: 实际投递成功的连接数，0 表示设备当前不在线。
+        """
+        delivered = 0
+        for queue in list(self._subs.get(device_id, ())):
+            try:
+                queue.put_nowait(message)
+                delivered += 1
+            except asyncio.QueueFull:
+                continue
+        return delivered
+
+    def broadcast(self, message: Dict[str, Any]) -> int:
+        """
+        用途：向所有在线设备投递一条消息（如全局权限刷新）。
+
+        参数：
+        - message: 消息字典。
+
+        返回值：
+        - int: 实际投递成功的连接数。
+        """
+        return sum(self.publish(device_id, message) for device_id in list(self._subs))
+
+    def online_devices(self) -> Dict[str, int]:
+        """
+        用途：查询当前在线设备及其连接数。
+
+        参数：
+        - 无。
+
+        返回值：
+        - dict: `{deviceId: 连接数}`。
+        """
+        return {device_id: len(queues) for device_id, queues in self._subs.items()}
@@ -5,6 +5,8 @@
 - 初始化数据库与表结构。
 - 提供设备、权限、鉴权决策、审计事件的读写接口。
 - 提供按保留策略清理历史审计数据的接口。
+- 每个线程持有一条长连接（数据库读线程、写线程各一条），语句由连接内的预编译缓存复用。
+- 可选启用卡权限内存索引（`perm_cache`）：鉴权判定查内存，`upsert_permission` 写穿。
 
 依赖/调用关系：
 - `main.py` 启动时调用 `init_db()`。
@@ -13,11 +15,20 @@
 - `security.py` 使用设备查询与心跳更新时间接口。
 """
 
+import logging
 import sqlite3
+import threading
 from contextlib import contextmanager
 from datetime import datetime, timedelta, timezone
 from pathlib import Path
-from typing import Any, Dict, Optional
+from typing import Any, Dict, Iterable, List, Optional, Sequence, Tuple
+
+from .perm_cache import PermissionCache
+
+logger = logging.getLogger("uplink.repo")
+
+# 每条连接缓存的预编译语句数：仓储内的 SQL 都是固定文本，远小于该值，全部常驻缓存。
+_STATEMENT_CACHE_SIZE = 64
 
 
 class SQLiteRepo:
@@ -30,11 +41,47 @@ class SQLiteRepo:
 
     def __init__(self, db_path: Path) -> None:
         self._db_path = db_path
+        self._local = threading.local()
+        self._all_conns = []
+        self._all_lock = threading.Lock()
+        self._perm_cache: Optional[PermissionCache] = None
+        # 写线程的连接已确认为 synchronous=FULL（`set_durable_commits` 成功后置位）。
+        self.durable_commits = False
+
+    def _open(self) -> sqlite3.Connection:
+        """
+        用途：为当前线程打开一条长连接并完成一次性设置。
+
+        参数：
+        - 无。
+
+        返回值：
+        - sqlite3.Connection: 新连接（已登记，`close()` 时统一关闭）。
+
+        关键行为：
+        - WAL 与同步级别只在打开时设置一次，不再每次访问都执行 PRAGMA。
+        - `cached_statements` 让同一条 SQL 文本只编译一次，后续直接复用预编译语句。
+        """
+        # 连接只在打开它的线程里使用；关闭 check_same_thread 只是为了让 close() 能在主线程统一关闭。
+        conn = sqlite3.connect(
+            str(self._db_path),
+            timeout=5.0,
+            cached_statements=_STATEMENT_CACHE_SIZE,
+            check_same_thread=False,
+        )
+        conn.row_factory = sqlite3.Row
+        # WAL 模式对“读多写少”的审计场景更友好。
+        # NORMAL 下提交不 fsync（读连接不提交，无所谓）；写线程的连接由 `set_durable_commits` 改为 FULL。
+        conn.execute("PRAGMA journal_mode=WAL;")
+        conn.execute("PRAGMA synchronous=NORMAL;")
+        with self._all_lock:
+            self._all_conns.append(conn)
+        return conn
 
     @contextmanager
     def _conn(self):
         """
-        用途：创建并管理数据库连接上下文。
+        用途：取当前线程的长连接，并把本次访问包成一个事务。
 
         参数：
         - 无。
@@ -43,19 +90,62 @@ class SQLiteRepo:
         - 迭代器上下文：yield `sqlite3.Connection`。
 
         关键行为：
-        - 启用 WAL 模式以提升读写并发能力。
-        - 退出时自动提交事务并关闭连接。
+        - 线程首次访问时打开连接，之后一直复用（sqlite3 连接不跨线程使用）。
+        - 正常退出时提交；异常时回滚，连接保持可用。
         """
-        conn = sqlite3.connect(str(self._db_path), timeout=5.0)
-        conn.row_factory = sqlite3.Row
+        conn = getattr(self._local, "conn", None)
+        if conn is None:
+            conn = self._open()
+            self._local.conn = conn
         try:
-            # WAL 模式对“读多写少”的审计场景更友好。
-            conn.execute("PRAGMA journal_mode=WAL;")
-            conn.execute("PRAGMA synchronous=NORMAL;")
             yield conn
             conn.commit()
-        finally:
+        except BaseException:
+            conn.rollback()
+            raise
+
+    def set_durable_commits(self) -> None:
+        """
+        用途：把当前线程的连接设为 `synchronous=FULL`：每次提交都 fsync WAL，提交返回即已落盘。
+
+        参数：
+        - 无。
+
+        返回值：
+        - 无；设置后回读 `PRAGMA synchronous`，不是 FULL（或更高）时抛 `RuntimeError`。
+
+        说明：
+        - 由写线程启动时调用（`DbWorkers` 的 `writer_init`）：审计组提交后才应答设备，设备随即从队列删除该记录，
+          NORMAL 下掉电可能丢掉已应答的最后几次提交。组提交把一次 fsync 分摊到整组，代价可接受。
+        - 成功后 `durable_commits` 置为 True；审计写队列只在它为 True 时应答 `code=0`，`/healthz` 同时给出该值。
+        - 读线程保持 NORMAL。
+        """
+        with self._conn() as conn:
+            conn.execute("PRAGMA synchronous=FULL;")
+            level = conn.execute("PRAGMA synchronous;").fetchone()[0]
+        # 0=OFF 1=NORMAL 2=FULL 3=EXTRA
+        if level < 2:
+            raise RuntimeError("synchronous=FULL not applied (level=%s)" % level)
+        self.durable_commits = True
+
+    def close(self) -> None:
+        """
+        用途：关闭所有线程打开的长连接（进程退出前调用）。
+
+        参数：
+        - 无。
+
+        返回值：
+        - 无。
+
+        说明：
+        - 调用前应先停掉会访问仓储的线程（如审计写队列）；之后再访问会重新打开连接。
+        """
+        with self._all_lock:
+            conns, self._all_conns = self._all_conns, []
+        for conn in conns:
             conn.close()
+        self._local = threading.local()
 
     def init_db(self) -> None:
         """
@@ -119,19 +209,41 @@ class SQLiteRepo:
                     door INTEGER,
                     cache INTEGER,
                     drop_count INTEGER,
+                    ev_count INTEGER,
+                    first_ms INTEGER,
+                    last_ms INTEGER,
                     created_at TEXT NOT NULL
                 );
 
                 CREATE INDEX IF NOT EXISTS idx_audit_created_at ON audit_events(created_at);
                 CREATE INDEX IF NOT EXISTS idx_auth_created_at ON auth_decisions(created_at);
+
+                -- 鉴权判定的覆盖索引：卡是否存在、门位权限及有效期都在索引里判断，不回表。
+                CREATE INDEX IF NOT EXISTS idx_perm_access
+                    ON card_permissions(uid_sha1, locker_id, active, valid_from, valid_to);
+
+                -- 权限版本：card_permissions 每次增删改都加一（含其它进程、手工 SQL），供内存索引判断是否过期。
+                CREATE TABLE IF NOT EXISTS perm_version (
+                    id INTEGER PRIMARY KEY CHECK (id = 1),
+                    version INTEGER NOT NULL
+                );
+                INSERT OR IGNORE INTO perm_version(id, version) VALUES (1, 0);
+                CREATE TRIGGER IF NOT EXISTS trg_perm_version_insert AFTER INSERT ON card_permissions
+                BEGIN UPDATE perm_version SET version = version + 1 WHERE id = 1; END;
+                CREATE TRIGGER IF NOT EXISTS trg_perm_version_update AFTER UPDATE ON card_permissions
+                BEGIN UPDATE perm_version SET version = version + 1 WHERE id = 1; END;
+                CREATE TRIGGER IF NOT EXISTS trg_perm_version_delete AFTER DELETE ON card_permissions
+                BEGIN UPDATE perm_version SET version = version + 1 WHERE id = 1; END;
                 """
             )
-            # 兼容历史库：若旧版本已创建 `drop` 列，启动时自动迁移为 `drop_count`。
+            # 兼容历史库：若旧版本已创建 `drop` 列，启动时自动迁移为 `drop_count`，并补齐合并/汇总列。
             self._migrate_audit_events_schema(conn)
+            # 审计幂等：(device_id, message_id) 唯一，重发/批量重放直接被 INSERT OR IGNORE 吸收。
+            self._ensure_audit_unique_index(conn)
 
     def _migrate_audit_events_schema(self, conn: sqlite3.Connection) -> None:
         """
-        用途：迁移 audit_events 表中与关键字冲突的旧列名。
+        用途：迁移 audit_events 表中与关键字冲突的旧列名，并补齐后续版本新增的列。
 
         参数：
         - conn: 当前数据库连接对象。
@@ -143,6 +255,7 @@ class SQLiteRepo:
         - 已存在 `drop_count`：不处理。
         - 存在旧列 `drop`：重命名为 `drop_count`。
         - 两者都不存在：补加 `drop_count`（防御性兜底）。
+        - 缺少合并/汇总列 `ev_count`/`first_ms`/`last_ms`：逐列补加。
         """
         exists = conn.execute(
             "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'audit_events' LIMIT 1"
@@ -153,6 +266,10 @@ class SQLiteRepo:
         columns = {
             row["name"] for row in conn.execute("PRAGMA table_info(audit_events)").fetchall()
         }
+        for column in ("ev_count", "first_ms", "last_ms"):
+            if column not in columns:
+                conn.execute(f"ALTER TABLE audit_events ADD COLUMN {column} INTEGER")
+
         if "drop_count" in columns:
             return
 
@@ -162,6 +279,43 @@ class SQLiteRepo:
 
         conn.execute("ALTER TABLE audit_events ADD COLUMN drop_count INTEGER")
 
+    def _ensure_audit_unique_index(self, conn: sqlite3.Connection) -> None:
+        """
+        用途：为 audit_events 建立 (device_id, message_id) 唯一索引。
+
+        参数：
+        - conn: 当前数据库连接对象。
+
+        返回值：
+        - 无。
+
+        迁移规则：
+        - 旧版设备每次启动 messageId 都从 1 开始，历史库中可能有同一键的多条不同事件。
+          同一键只保留最早一条的 messageId，其余行改为 `-id`（负数不会与设备上报的 ID 冲突），
+          行本身保留，不丢审计记录。
+        """
+        exists = conn.execute(
+            "SELECT 1 FROM sqlite_master WHERE type = 'index' AND name = 'uq_audit_device_message' LIMIT 1"
+        ).fetchone()
+        if exists is not None:
+            return
+
+        cur = conn.execute(
+            """
+            UPDATE audit_events
+            SET message_id = -id
+            WHERE id NOT IN (
+                SELECT MIN(id) FROM audit_events GROUP BY device_id, message_id
+            )
+            """
+        )
+        if cur.rowcount:
+            logger.warning("audit_events: %d legacy rows with reused messageId renumbered to -id", cur.rowcount)
+
+        conn.execute(
+            "CREATE UNIQUE INDEX uq_audit_device_message ON audit_events(device_id, message_id)"
+        )
+
     def get_device(self, device_id: str) -> Optional[Dict[str, Any]]:
         """
         用途：查询设备基础信息与密钥。
@@ -204,11 +358,11 @@ class SQLiteRepo:
         - message_id: 消息 ID。
 
         返回值：
-        - dict | None: 命中返回决策记录，未命中返回 None。
+        - dict | None: 命中返回决策记录（code/msg/uid_sha1/locker_id），未命中返回 None。
         """
         with self._conn() as conn:
             row = conn.execute(
-                "SELECT code, msg FROM auth_decisions WHERE device_id = ? AND message_id = ?",
+                "SELECT code, msg, uid_sha1, locker_id FROM auth_decisions WHERE device_id = ? AND message_id = ?",
                 (device_id, message_id),
             ).fetchone()
             return dict(row) if row else None
@@ -223,7 +377,7 @@ class SQLiteRepo:
         uid_sha1: str,
         code: int,
         msg: str,
-    ) -> None:
+    ) -> bool:
         """
         用途：写入鉴权决策日志。
 
@@ -238,13 +392,13 @@ class SQLiteRepo:
         - msg: 文本消息。
 
         返回值：
-        - 无。
+        - bool: True 表示新写入；False 表示同设备同 messageId 已有结论（重发/对冲），本次未写入。
 
         说明：
-        - 使用 `INSERT OR IGNORE`，配合唯一键实现幂等写入。
+        - 使用 `INSERT OR IGNORE`，配合唯一键实现幂等写入；首次请求不需要先查一次。
         """
         with self._conn() as conn:
-            conn.execute(
+            cur = conn.execute(
                 """
                 INSERT OR IGNORE INTO auth_decisions
                 (trace_id, device_id, message_id, locker_id, uid, uid_sha1, code, msg, created_at)
@@ -262,61 +416,57 @@ class SQLiteRepo:
                     self._now_iso(),
                 ),
             )
+            return cur.rowcount == 1
 
-    def has_card(self, uid_sha1: str) -> bool:
+    def check_card_access(self, uid_sha1: str, locker_id: str) -> Tuple[bool, bool]:
         """
-        用途：判断卡是否在权限系统中存在。
-
-        参数：
-        - uid_sha1: UID SHA1。
-
-        返回值：
-        - bool: True 表示存在，False 表示不存在。
-        """
-        with self._conn() as conn:
-            row = conn.execute(
-                "SELECT 1 FROM card_permissions WHERE uid_sha1 = ? LIMIT 1",
-                (uid_sha1,),
-            ).fetchone()
-            return row is not None
-
-    def has_permission(self, uid_sha1: str, locker_id: str) -> bool:
-        """
-        用途：判断卡在当前时间是否拥有指定门位权限。
+        用途：一次查询判断卡是否存在、当前时间是否拥有指定门位权限。
 
         参数：
         - uid_sha1: UID SHA1。
         - locker_id: 门位 ID。
 
         返回值：
-        - bool: True 表示有权限，False 表示无权限。
+        - Tuple[bool, bool]: `(卡是否存在, 是否有权限)`。
+
+        说明：
+        - 已启用内存索引时直接查内存，不访问数据库。
+        - 两个判断都只查索引、不回表。主键索引唯一，规划器会优先选它再回表读有效期，
+          权限判断因此显式指定覆盖索引 `idx_perm_access`。
         """
         now = self._now_iso()
+        cache = self._perm_cache
+        if cache is not None:
+            return cache.check(uid_sha1, locker_id, now)
+
         with self._conn() as conn:
             row = conn.execute(
                 """
-                SELECT 1
-                FROM card_permissions
-                WHERE uid_sha1 = ?
-                  AND locker_id = ?
-                  AND active = 1
-                  AND (valid_from IS NULL OR valid_from <= ?)
-                  AND (valid_to IS NULL OR valid_to >= ?)
-                LIMIT 1
+                SELECT
+                    EXISTS(SELECT 1 FROM card_permissions WHERE uid_sha1 = ?),
+                    EXISTS(
+                        SELECT 1
+                        FROM card_permissions INDEXED BY idx_perm_access
+                        WHERE uid_sha1 = ?
+                          AND locker_id = ?
+                          AND active = 1
+                          AND (valid_from IS NULL OR valid_from <= ?)
+                          AND (valid_to IS NULL OR valid_to >= ?)
+                    )
                 """,
-                (uid_sha1, locker_id, now, now),
+                (uid_sha1, uid_sha1, locker_id, now, now),
             ).fetchone()
-            return row is not None
+            return bool(row[0]), bool(row[1])
 
-    def insert_audit_event(
+    def audit_row(
         self,
         trace_id: str,
         device_id: str,
         message_id: int,
         payload: Dict[str, Any],
-    ) -> None:
+    ) -> Tuple[Any, ...]:
         """
-        用途：写入一条审计事件。
+        用途：把一条审计事件转换成 `audit_events` 的插入行（不访问数据库，可在任意线程调用）。
 
         参数：
         - trace_id: 请求追踪 ID。
@@ -325,37 +475,63 @@ class SQLiteRepo:
         - payload: 审计载荷字典。
 
         返回值：
-        - 无。
+        - Tuple[Any, ...]: 与 `insert_audit_rows` 列顺序一致的行。
         """
         # 协议层继续兼容 payload.drop；若后续上位改为 dropCount 也可直接接收。
         drop_count = payload.get("drop")
         if drop_count is None:
             drop_count = payload.get("dropCount")
 
+        # 设备端合并记录（同卡同柜重复读卡）与丢失汇总（AUDIT_DROP）带 cnt/firstMs/lastMs；普通记录视为 1 条。
+        ev_count = payload.get("cnt", 1)
+
+        return (
+            trace_id,
+            device_id,
+            message_id,
+            payload.get("ev"),
+            payload.get("sid"),
+            payload.get("lockerId"),
+            payload.get("uid"),
+            payload.get("code"),
+            payload.get("http"),
+            payload.get("net"),
+            payload.get("door"),
+            payload.get("cache"),
+            drop_count,
+            ev_count,
+            payload.get("firstMs"),
+            payload.get("lastMs"),
+            self._now_iso(),
+        )
+
+    def insert_audit_rows(self, groups: Sequence[Sequence[Tuple[Any, ...]]]) -> List[int]:
+        """
+        用途：在一个事务里写入多组审计行（组提交，幂等）。
+
+        参数：
+        - groups: 行分组（通常一组对应一个上报请求），行由 `audit_row` 生成。
+
+        返回值：
+        - List[int]: 每组新写入的行数（已入库的重发行不计）。
+
+        说明：
+        - 每组一次 `executemany`，全部写完只提交一次；任一组出错整个事务回滚，调用方整组重试或报错。
+        """
+        counts: List[int] = []
         with self._conn() as conn:
-            conn.execute(
-                """
-                INSERT INTO audit_events
-                (trace_id, device_id, message_id, ev, sid, locker_id, uid, code, http, net, door, cache, drop_count, created_at)
-                VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-                """,
-                (
-                    trace_id,
-                    device_id,
-                    message_id,
-                    payload.get("ev"),
-                    payload.get("sid"),
-                    payload.get("lockerId"),
-                    payload.get("uid"),
-                    payload.get("code"),
-                    payload.get("http"),
-                    payload.get("net"),
-                    payload.get("door"),
-                    payload.get("cache"),
-                    drop_count,
-                    self._now_iso(),
-                ),
-            )
+            for rows in groups:
+                cur = conn.executemany(
+                    """
+                    INSERT OR IGNORE INTO audit_events
+                    (trace_id, device_id, message_id, ev, sid, locker_id, uid, code, http, net, door, cache,
+                     drop_count, ev_count, first_ms, last_ms, created_at)
+                    VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+                    """,
+                    rows,
+                )
+                counts.append(cur.rowcount)
+        return counts
 
     def cleanup_audit_events(self, retention_days: int) -> int:
         """
@@ -421,6 +597,9 @@ class SQLiteRepo:
 
         返回值：
         - 无。
+
+        说明：
+        - 已启用内存索引时，提交后写穿到索引；版本不连续（期间有别的写入）则整表重载。
         """
         with self._conn() as conn:
             conn.execute(
@@ -432,6 +611,90 @@ class SQLiteRepo:
                 """,
                 (uid_sha1, locker_id, active, valid_from, valid_to),
             )
+            version = conn.execute("SELECT version FROM perm_version WHERE id = 1").fetchone()[0]
+
+        cache = self._perm_cache
+        entry = (locker_id, int(active), valid_from, valid_to)
+        if cache is not None and not cache.apply(uid_sha1, entry, version):
+            self._reload_permission_cache(cache)
+
+    def upsert_permissions(self, rows: Iterable[Tuple[str, str, int, Optional[str], Optional[str]]]) -> int:
+        """
+        用途：批量插入或更新卡权限（一个事务）。
+
+        参数：
+        - rows: `(uid_sha1, locker_id, active, valid_from, valid_to)` 序列。
+
+        返回值：
+        - int: 写入行数。
+
+        说明：
+        - 已启用内存索引时，提交后整表重载（批量导入不逐条写穿）。
+        """
+        with self._conn() as conn:
+            cur = conn.executemany(
+                """
+                INSERT INTO card_permissions(uid_sha1, locker_id, active, valid_from, valid_to)
+                VALUES(?, ?, ?, ?, ?)
+                ON CONFLICT(uid_sha1, locker_id)
+                DO UPDATE SET active=excluded.active, valid_from=excluded.valid_from, valid_to=excluded.valid_to
+                """,
+                rows,
+            )
+            count = cur.rowcount
+
+        cache = self._perm_cache
+        if cache is not None:
+            self._reload_permission_cache(cache)
+        return count
+
+    def enable_permission_cache(self) -> int:
+        """
+        用途：载入卡权限内存索引，之后鉴权判定改查内存。
+
+        参数：
+        - 无。
+
+        返回值：
+        - int: 载入的卡数。
+        """
+        cache = PermissionCache()
+        self._reload_permission_cache(cache)
+        self._perm_cache = cache
+        return len(cache)
+
+    def refresh_permission_cache(self) -> bool:
+        """
+        用途：库内权限版本与内存索引不一致时（其它进程改过权限）整表重载。
+
+        参数：
+        - 无。
+
+        返回值：
+        - bool: True 表示发生了重载。
+        """
+        cache = self._perm_cache
+        if cache is None:
+            return False
+        with self._conn() as conn:
+            version = conn.execute("SELECT version FROM perm_version WHERE id = 1").fetchone()[0]
+        if version == cache.version:
+            return False
+        self._reload_permission_cache(cache)
+        logger.info("permission cache reloaded: version=%s cards=%s", cache.version, len(cache))
+        return True
+
+    def _reload_permission_cache(self, cache: PermissionCache) -> None:
+        """
+        用途：从库中整表载入权限（版本与行在同一个读事务里读取，二者一致）。
+        """
+        with self._conn() as conn:
+            conn.execute("BEGIN")
+            version = conn.execute("SELECT version FROM perm_version WHERE id = 1").fetchone()[0]
+            # 逐行载入，不先把整表取成列表；行用普通元组（不需要按列名访问）。
+            cur = conn.cursor()
+            cur.row_factory = None
+            cache.load(cur.execute("SELECT uid_sha1, locker_id, active, valid_from, valid_to FROM card_permissions"), version)
 
     @staticmethod
     def _now_iso() -> str:
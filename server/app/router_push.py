@@ -0,0 +1,170 @@
+﻿"""
+文件作用：下行推送通道路由。
+
+主要职责：
+- 提供 `GET /api/push/stream`：设备常连的推送流（HTTP chunked，一行一条 JSON）。
+- 提供 `POST /api/push/send`：管理端向指定设备（或全部设备）下发命令。
+
+依赖/调用关系：
+- 调用 `security.verify_signature` 校验设备身份（body 为空串参与签名），经 `db_workers.DbWorkers` 读线程执行。
+- 通过 `app.state.push_hub`（`push_hub.PushHub`）完成订阅与投递。
+
+消息格式：
+- 连接建立后先发送 `{"type":"HELLO","heartbeatSec":N}`。
+- 空闲 `PUSH_HEARTBEAT_SEC` 秒发送 `{"type":"PING"}`，MCU 据此判断连接存活。
+- 业务命令：`{"type":"OPEN_DOOR","lockerId":"A01","cmdId":7}`、`{"type":"PERM_UPDATE","uidSha1":"..."}`。
+"""
+
+import asyncio
+import json
+import logging
+from typing import Any, AsyncIterator, Dict
+
+from fastapi import APIRouter, Request
+from fastapi.responses import JSONResponse, StreamingResponse
+
+from .db_workers import PRIO_BACKGROUND, DbWorkers
+from .push_hub import PushHub
+from .security import verify_signature
+
+
+router = APIRouter()
+logger = logging.getLogger("uplink.push")
+
+
+def _encode_line(message: Dict[str, Any]) -> bytes:
+    """
+    用途：把消息编码为一行紧凑 JSON。
+
+    参数：
+    - message: 消息字典。
+
+    返回值：
+    - bytes: 以 `\\n` 结尾的 UTF-8 字节串。
+
+    边界行为：
+    - 使用 `ensure_ascii=False`，避免产生 `\\uXXXX` 转义（MCU 端轻量解析器不处理转义）。
+    """
+    return (json.dumps(message, ensure_ascii=False, separators=(",", ":")) + "\n").encode("utf-8")
+
+
+async def _stream_messages(
+    hub: PushHub,
+    device_id: str,
+    queue: asyncio.Queue,
+    heartbeat_sec: int,
+) -> AsyncIterator[bytes]:
+    """
+    用途：推送流生成器，逐行产出消息。
+
+    参数：
+    - hub: 订阅中心。
+    - device_id: 设备 ID。
+    - queue: 该连接的订阅队列。
+    - heartbeat_sec: 空闲心跳间隔秒数。
+
+    返回值：
+    - AsyncIterator[bytes]: 每次产出一行 JSON。
+
+    边界行为：
+    - 客户端断开时生成器被取消，`finally` 中退订，避免队列泄漏。
+    """
+    try:
+        yield _encode_line({"type": "HELLO", "heartbeatSec": heartbeat_sec})
+        while True:
+            try:
+                message = await asyncio.wait_for(queue.get(), timeout=heartbeat_sec)
+            except asyncio.TimeoutError:
+                message = {"type": "PING"}
+            yield _encode_line(message)
+    finally:
+        hub.unsubscribe(device_id, queue)
+        logger.info("push stream closed device=%s", device_id)
+
+
+@router.get("/api/push/stream")
+async def push_stream(request: Request):
+    """
+    用途：设备推送流入口。
+
+    参数：
+    - request: FastAPI 请求对象。
+
+    返回值：
+    - StreamingResponse: 校验通过时返回长连接 NDJSON 流。
+    - JSONResponse: 校验失败时返回 401/403。
+
+    边界行为：
+    - 设备必须已注册且启用，即使签名为可选模式也会检查。
+    """
+    settings = request.app.state.settings
+    repo = request.app.state.repo
+    hub: PushHub = request.app.state.push_hub
+
+    db: DbWorkers = request.app.state.db
+
+    ok, sign_msg = await db.read(
+        verify_signature, request.headers, b"", repo, settings, request.app.state.nonce_store, touch_seen=False
+    )
+    if not ok:
+        return JSONResponse(status_code=401, content={"code": 5001, "msg": sign_msg})
+
+    device_id = request.headers.get("X-Device-Id", "")
+    if sign_msg == "ok":
+        db.write_nowait(repo.touch_device_seen, device_id, priority=PRIO_BACKGROUND, key=("seen", device_id))
+    device = await db.read(repo.get_device, device_id) if device_id else None
+    if not device or int(device.get("status", 0)) != 1:
+        return JSONResponse(status_code=403, content={"code": 5001, "msg": "device_not_registered"})
+
+    queue = hub.subscribe(device_id)
+    logger.info("push stream opened device=%s", device_id)
+
+    return StreamingResponse(
+        _stream_messages(hub, device_id, queue, settings.push_heartbeat_sec),
+        media_type="application/x-ndjson",
+        headers={"Cache-Control": "no-cache"},
+    )
+
+
+@router.post("/api/push/send")
+async def push_send(request: Request) -> JSONResponse:
+    """
+    用途：管理端下发推送命令。
+
+    参数：
+    - request: 请求体 `{"deviceId": "...", "type": "...", "payload": {...}}`，
+      `deviceId` 为 `*` 时广播给全部在线设备。
+
+    返回值：
+    - JSONResponse: `{"code":0,"delivered":N}`，N 为实际投递的连接数。
+
+    边界行为：
+    - 配置了 `PUSH_ADMIN_TOKEN` 时，必须携带相同的 `X-Admin-Token`。
+    - `payload` 字段会平铺到消息顶层，便于 MCU 直接按键取值。
+    """
+    settings = request.app.state.settings
+    hub: PushHub = request.app.state.push_hub
+
+    if settings.push_admin_token and request.headers.get("X-Admin-Token") != settings.push_admin_token:
+        return JSONResponse(status_code=403, content={"code": 5001, "msg": "admin_token_invalid"})
+
+    try:
+        body = json.loads((await request.body()).decode("utf-8"))
+        device_id = str(body["deviceId"])
+        msg_type = str(body["type"])
+        payload = body.get("payload") or {}
+        if not isinstance(payload, dict):
+            raise ValueError("payload")
+    except Exception:
+        return JSONResponse(status_code=400, content={"code": 5001, "msg": "invalid_request"})
+
+    message: Dict[str, Any] = {"type": msg_type}
+    message.update(payload)
+
+    if device_id == "*":
+        delivered = hub.broadcast(message)
+    else:
+        delivered = hub.publish(device_id, message)
+
+    logger.info("push send device=%s type=%s delivered=%d", device_id, msg_type, delivered)
+    return JSONResponse(status_code=200, content={"code": 0, "delivered": delivered})
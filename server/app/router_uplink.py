@@ -4,33 +4,47 @@
 主要职责：
 - 提供 `/api/uplink` 接口。
 - 完成签名校验、请求解析、按 `type` 分发。
+- 支持合并上报：body 为事件数组时逐条分发，整批一次应答。
 - 统一构造响应格式 `code/msg/traceId`。
+- 审计写队列过载时直接回 `service_busy` 并给出暂缓时长（`Retry-After` 头 + `retryAfterMs`），
+  鉴权不受影响。
+- 事件循环里不访问数据库：签名查设备、鉴权判定、审计校验在读线程池执行，鉴权结论与审计在写线程执行
+  （鉴权优先，审计按组提交），设备最近访问时间作为后台写入合并提交。
 
 依赖/调用关系：
-- 调用 `security.verify_signature` 进行设备签名校验。
-- 调用 `service_auth.handle_auth_event` 处理同步鉴权。
-- 调用 `service_audit.handle_audit_event` 处理异步审计。
+- 调用 `security.verify_signature` 进行设备签名校验（压缩请求由 `content_encoding` 中间件先行解压，
+  签名按线上原始字节校验）。
+- 调用 `service_auth.decide_auth` / `record_auth_decision` 处理同步鉴权。
+- 经 `db_workers.DbWorkers` 执行全部数据库访问。
+- 调用 `service_audit.build_audit_row` 校验异步审计，经 `backpressure.AuditWriteQueue` 组提交写库。
 """
 
 import json
 import logging
+import math
 import uuid
-from typing import Any, Dict
+from typing import Any, List, Optional, Tuple
 
 from fastapi import APIRouter, Request
 from fastapi.responses import JSONResponse
 
-from .schemas import UplinkResponse, parse_uplink_event
+from .backpressure import AuditWriteQueue
+from .db_workers import PRIO_AUTH, PRIO_BACKGROUND, DbWorkers
+from .schemas import UplinkEvent, UplinkResponse, parse_uplink_event
 from .security import verify_signature
-from .service_audit import handle_audit_event
-from .service_auth import handle_auth_event
+from .service_audit import audit_result_msg, build_audit_row
+from .service_auth import decide_auth, record_auth_decision
 
 
 router = APIRouter()
 logger = logging.getLogger("uplink.router")
 
+# 合并上报单批事件数上限：设备端编译期上限为 8（UPLINK_MAX_BATCH_EVENTS），这里留余量，
+# 只为不让一个请求（解码后最多 256KB）在读线程里逐条校验上千个事件。
+MAX_BATCH_EVENTS = 64
 
-def _json_response(code: int, msg: str, trace_id: str) -> JSONResponse:
+
+def _json_response(code: int, msg: str, trace_id: str, retry_after_ms: Optional[int] = None) -> JSONResponse:
     """
     用途：统一封装 API 返回体，避免各分支重复拼装。
 
@@ -38,12 +52,16 @@ def _json_response(code: int, msg: str, trace_id: str) -> JSONResponse:
     - code: 业务码。
     - msg: 业务描述。
     - trace_id: 服务端追踪 ID。
+    - retry_after_ms: 过载暂缓时长（毫秒），给出时同时带 `Retry-After` 头（秒，向上取整）。
 
     返回值：
     - JSONResponse: HTTP 200 + 统一 JSON 结构。
     """
-    body = UplinkResponse(code=code, msg=msg, traceId=trace_id).dict(exclude_none=True)
-    return JSONResponse(status_code=200, content=body)
+    body = UplinkResponse(code=code, msg=msg, traceId=trace_id, retryAfterMs=retry_after_ms).dict(exclude_none=True)
+    headers = None
+    if retry_after_ms:
+        headers = {"Retry-After": str(math.ceil(retry_after_ms / 1000))}
+    return JSONResponse(status_code=200, content=body, headers=headers)
 
 
 @router.post("/api/uplink")
@@ -59,9 +77,8 @@ async def uplink_entry(request: Request) -> JSONResponse:
 
     处理步骤：
     1. 生成 traceId。
-    2. 校验签名（按配置可选/强制）。
-    3. 解析 JSON 与事件模型。
-    4. 按 `type` 分发到鉴权或审计处理。
+    2. 读线程中校验签名（按配置可选/强制）、解析 JSON 与事件模型（数组为合并上报）；鉴权在此处理完。
+    3. 审计/合并上报先看写队列是否过载，过载则要求暂缓；否则审计行进写队列，所在的组提交后应答。
     """
     # 为每次请求生成追踪 ID，便于日志与数据库记录关联。
     trace_id = uuid.uuid4().hex
@@ -69,47 +86,231 @@ async def uplink_entry(request: Request) -> JSONResponse:
     settings = request.app.state.settings
     repo = request.app.state.repo
     nonce_store = request.app.state.nonce_store
+    audit_queue = request.app.state.audit_queue
+    db: DbWorkers = request.app.state.db
 
     # 原始 body 用于签名校验，也用于后续 JSON 解析。
     raw = await request.body()
 
+    # 压缩请求：签名覆盖线上字节（压缩后），解压由中间件完成，原始字节放在 request.state。
+    wire = getattr(request.state, "wire_body", raw)
+
+    # 签名校验、解析与鉴权在读线程里一次做完：事件循环繁忙时每次 await 都要在所有连接之后重新排队，
+    # 鉴权请求只切换一次线程。
+    code, msg, rows, single = await db.read(
+        _verify_and_parse, db, repo, settings, nonce_store, request.headers, wire, raw, trace_id
+    )
+    if rows is None:
+        return _json_response(code, msg, trace_id)
+
+    # 提交不保证落盘时不应答 code=0：设备收到成功就删除记录，掉电会丢。失败应答让设备保留并重发。
+    if not audit_queue.durable:
+        logger.error("audit refused trace=%s reason=audit_not_durable", trace_id)
+        return _json_response(5001, "audit_not_durable", trace_id)
+
+    busy = _busy_response(audit_queue, trace_id)
+    if busy is not None:
+        return busy
+
+    # 合并上报整批一次应答（批内只有审计，整批在同一组里提交）；单条审计按是否重发给出文本。
+    inserted = await audit_queue.submit(rows)
+    if single:
+        msg = audit_result_msg(inserted)
+    return _json_response(code, msg, trace_id)
+
+
+def _verify_and_parse(
+    db: DbWorkers,
+    repo: Any,
+    settings: Any,
+    nonce_store: Any,
+    headers: Any,
+    wire: bytes,
+    raw: bytes,
+    trace_id: str,
+) -> Tuple[int, str, Optional[List[tuple]], bool]:
+    """
+    用途：请求前半段（读线程中执行）：签名校验、JSON 解析与事件模型校验；单条鉴权就地处理完，审计生成插入行。
+
+    参数：
+    - db: 数据库访问线程。
+    - repo/settings/nonce_store: 见 `uplink_entry`。
+    - headers: HTTP 请求头。
+    - wire: 线上原始字节（签名覆盖）。
+    - raw: 解压后的 body。
+    - trace_id: 服务端追踪 ID。
+
+    返回值：
+    - Tuple[int, str, Optional[List[tuple]], bool]: `(业务码, 文本消息, 待写入的审计行, 是否单条审计)`；
+      第三项为 `None` 时前两项即最终应答，否则审计行进写队列，提交后以前两项应答（单条审计按是否重发改写文本）。
+    """
     # 先做签名校验，失败时直接返回，不进入业务层。
-    ok, sign_msg = verify_signature(request.headers, raw, repo, settings, nonce_store)
+    ok, sign_msg = verify_signature(headers, wire, repo, settings, nonce_store, touch_seen=False)
     if not ok:
         logger.warning("signature check failed trace=%s reason=%s", trace_id, sign_msg)
-        return _json_response(5001, sign_msg, trace_id)
+        return 5001, sign_msg, None, False
+    if sign_msg == "ok":
+        # 最近访问时间只用于运维查看，排在所有写入之后，同一设备未执行前只保留一份。
+        device_id = headers.get("X-Device-Id")
+        db.write_nowait(repo.touch_device_seen, device_id, priority=PRIO_BACKGROUND, key=("seen", device_id))
 
     try:
-        event_dict: Dict[str, Any] = json.loads(raw.decode("utf-8"))
+        parsed: Any = json.loads(raw.decode("utf-8"))
     except Exception:
-        return _json_response(5001, "invalid_json", trace_id)
+        return 5001, "invalid_json", None, False
+
+    if isinstance(parsed, list):
+        code, msg, rows = _prepare_batch(repo, trace_id, parsed)
+        return code, msg, (rows or None), False
 
     try:
-        event = parse_uplink_event(event_dict)
+        event = parse_uplink_event(parsed)
     except Exception:
-        return _json_response(5001, "invalid_event_schema", trace_id)
+        return 5001, "invalid_event_schema", None, False
 
-    # 同步鉴权链路：返回结果直接影响 MCU 是否开门。
+    # 同步鉴权不做削峰：本线程判定，写线程按鉴权优先级落库。
     if event.type == "RFID_AUTH_REQ":
-        code, msg = handle_auth_event(
-            repo=repo,
-            trace_id=trace_id,
-            device_id=event.deviceId,
-            message_id=event.messageId,
-            payload=event.payload,
-        )
-        return _json_response(code, msg, trace_id)
+        code, msg = _handle_auth(db, repo, trace_id, event)
+        return code, msg, None, False
+
+    code, msg, row = _dispatch_event(repo, trace_id, event)
+    if row is None:
+        return code, msg, None, False
+    return code, msg, [row], True
+
+
+def _handle_auth(db: DbWorkers, repo: Any, trace_id: str, event: UplinkEvent) -> Tuple[int, str]:
+    """
+    用途：处理同步鉴权（读线程中执行）：就地判定，等待写线程按鉴权优先级落库。
+
+    参数：
+    - db: 数据库访问线程。
+    - repo: SQLite 仓储实例。
+    - trace_id: 服务端追踪 ID。
+    - event: 已通过模型校验的 `RFID_AUTH_REQ` 事件。
+
+    返回值：
+    - Tuple[int, str]: `(业务码, 文本消息)`；重复 messageId 回放首次结论。
+
+    说明：
+    - 判定不占写线程；审计补报高峰时鉴权只需等写线程上当前这一笔写完即可插队落库。
+    """
+    code, msg, fields = decide_auth(repo, event.payload)
+    if fields is None:
+        return code, msg
+    return db.write_wait(
+        record_auth_decision,
+        repo,
+        trace_id,
+        event.deviceId,
+        event.messageId,
+        fields,
+        code,
+        msg,
+        priority=PRIO_AUTH,
+    )
+
+
+def _busy_response(audit_queue: AuditWriteQueue, trace_id: str) -> Optional[JSONResponse]:
+    """
+    用途：审计写队列过载时构造 `service_busy` 应答。
+
+    参数：
+    - audit_queue: 审计写队列。
+    - trace_id: 服务端追踪 ID。
+
+    返回值：
+    - Optional[JSONResponse]: 需要暂缓时返回应答；否则返回 `None`，照常受理。
+
+    说明：
+    - 被暂缓的请求没有写库，设备按 `retryAfterMs` 之后原样重发（同一 messageId）。
+    """
+    hint = audit_queue.retry_after_ms()
+    if not hint:
+        return None
+    logger.debug("audit shed trace=%s depth=%s retryAfterMs=%s", trace_id, audit_queue.depth, hint)
+    return _json_response(5001, "service_busy", trace_id, retry_after_ms=hint)
+
+
+def _dispatch_event(repo: Any, trace_id: str, event: UplinkEvent) -> Tuple[int, str, Optional[tuple]]:
+    """
+    用途：按 `type` 把单个事件分发到业务处理（审计只生成插入行，由写队列组提交；鉴权见 `_handle_auth`）。
+
+    参数：
+    - repo: SQLite 仓储实例。
+    - trace_id: 服务端追踪 ID。
+    - event: 已通过模型校验的事件。
 
+    返回值：
+    - Tuple[int, str, Optional[tuple]]: `(业务码, 文本消息, 审计插入行)`；非审计或校验失败时插入行为 `None`。
+    """
     # 异步审计链路：记录关键事件，主逻辑返回成功/失败码。
     if event.type == "RFID_AUDIT":
-        code, msg = handle_audit_event(
+        return build_audit_row(
             repo=repo,
             trace_id=trace_id,
             device_id=event.deviceId,
             message_id=event.messageId,
             payload=event.payload,
         )
-        return _json_response(code, msg, trace_id)
 
     # 未支持类型统一返回维护类错误码。
-    return _json_response(5002, f"unsupported_type_{event.type}", trace_id)
+    return 5002, f"unsupported_type_{event.type}", None
+
+
+def _prepare_batch(repo: Any, trace_id: str, items: List[Any]) -> Tuple[int, str, List[tuple]]:
+    """
+    用途：校验合并上报的一批事件，生成审计插入行（读线程中执行，写库由写队列组提交）。
+
+    参数：
+    - repo: SQLite 仓储实例。
+    - trace_id: 服务端追踪 ID（整批共用）。
+    - items: 事件数组。
+
+    返回值：
+    - Tuple[int, str, List[tuple]]: `(业务码, 文本消息, 审计插入行)`；整批校验完即返回 `0`，
+      行写入后以此应答。
+
+    边界行为：
+    - 空数组或超过 `MAX_BATCH_EVENTS` 条返回 `5001`，整批不受理。
+    - 单条事件格式错误或业务拒绝属于永久错误，重发也不会成功：记日志后跳过，
+      不让整批失败；`msg` 带上被拒条数。数据库异常等临时错误照常抛出，整批由 MCU 重发。
+    - 鉴权请求需要逐条给出放行结论，不允许放进批量请求。
+    """
+    if not items:
+        return 5001, "empty_batch", []
+    if len(items) > MAX_BATCH_EVENTS:
+        logger.warning("batch rejected trace=%s reason=batch_too_large size=%d", trace_id, len(items))
+        return 5001, "batch_too_large", []
+
+    rows: List[tuple] = []
+    rejected = 0
+    for item in items:
+        try:
+            event = parse_uplink_event(item)
+        except Exception:
+            rejected += 1
+            logger.warning("batch item rejected trace=%s reason=invalid_event_schema", trace_id)
+            continue
+
+        if event.type == "RFID_AUTH_REQ":
+            code, msg, row = 5001, "auth_not_batchable", None
+        else:
+            code, msg, row = _dispatch_event(repo, trace_id, event)
+
+        if row is not None:
+            rows.append(row)
+        else:
+            rejected += 1
+            logger.warning(
+                "batch item rejected trace=%s device=%s messageId=%s code=%s reason=%s",
+                trace_id,
+                event.deviceId,
+                event.messageId,
+                code,
+                msg,
+            )
+
+    if rejected:
+        return 0, f"ok_rejected_{rejected}_of_{len(items)}", rows
+    return 0, "ok", rows
@@ -41,11 +41,13 @@ class UplinkResponse(BaseModel):
     - code: 业务码。
     - msg: 可读消息。
     - traceId: 服务端链路追踪 ID。
+    - retryAfterMs: 过载暂缓时长（毫秒），仅 `service_busy` 时出现。
     """
 
     code: int
     msg: Optional[str] = None
     traceId: Optional[str] = None
+    retryAfterMs: Optional[int] = None
 
 
 def parse_uplink_event(payload: Dict[str, Any]) -> UplinkEvent:
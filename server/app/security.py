@@ -4,15 +4,16 @@
 主要职责：
 - 在请求入口校验设备签名是否合法。
 - 通过时间窗与 nonce 缓存降低重放攻击风险。
-- 在签名通过后更新设备最近访问时间。
+- 在签名通过后更新设备最近访问时间（调用方也可自行安排，避免在读线程里写库）。
 
 依赖/调用关系：
-- 由 `router_uplink.py` 调用 `verify_signature`。
+- 由 `router_uplink.py`（在数据库读线程中）与 `router_push.py` 调用 `verify_signature`。
 - 使用 `repo_sqlite.SQLiteRepo` 查询设备密钥。
 """
 
 import hashlib
 import hmac
+import threading
 import time
 from dataclasses import dataclass, field
 from typing import Dict, Tuple
@@ -31,10 +32,12 @@ class NonceStore:
     字段说明：
     - ttl_sec: nonce 有效期（秒）。
     - _nonces: `nonce_key -> 过期时间戳` 映射。
+    - _lock: 签名校验在数据库读线程池中并发执行，查询与写入需要互斥。
     """
 
     ttl_sec: int
     _nonces: Dict[str, int] = field(default_factory=dict)
+    _lock: threading.Lock = field(default_factory=threading.Lock)
 
     def seen(self, key: str, now_sec: int) -> bool:
         """
@@ -49,13 +52,14 @@ class NonceStore:
           - True: 视为重放（已见过且未过期）。
           - False: 首次出现，已写入缓存。
         """
-        self._cleanup(now_sec)
-        expire_at = self._nonces.get(key)
-        if expire_at is not None and expire_at >= now_sec:
-            return True
+        with self._lock:
+            self._cleanup(now_sec)
+            expire_at = self._nonces.get(key)
+            if expire_at is not None and expire_at >= now_sec:
+                return True
 
-        self._nonces[key] = now_sec + self.ttl_sec
-        return False
+            self._nonces[key] = now_sec + self.ttl_sec
+            return False
 
     def _cleanup(self, now_sec: int) -> None:
         """
@@ -78,6 +82,7 @@ def verify_signature(
     repo: SQLiteRepo,
     settings: Settings,
     nonce_store: NonceStore,
+    touch_seen: bool = True,
 ) -> Tuple[bool, str]:
     """
     用途：校验请求签名。
@@ -88,6 +93,7 @@ def verify_signature(
     - repo: SQLite 仓储实例。
     - settings: 配置对象（签名开关、时间窗、nonce TTL）。
     - nonce_store: nonce 缓存实例。
+    - touch_seen: 通过后是否顺带更新设备最近访问时间；为 `False` 时由调用方安排（消息为 `ok` 时）。
 
     返回值：
     - Tuple[bool, str]: `(是否通过, 说明消息)`。
@@ -141,5 +147,6 @@ def verify_signature(
     if not hmac.compare_digest(expected.lower(), signature.lower()):
         return False, "signature_mismatch"
 
-    repo.touch_device_seen(device_id)
+    if touch_seen:
+        repo.touch_device_seen(device_id)
     return True, "ok"
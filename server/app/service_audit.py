@@ -3,15 +3,15 @@
 
 主要职责：
 - 接收 `RFID_AUDIT` 审计 payload。
-- 做最小字段校验。
-- 将事件写入审计表。
+- 做最小字段校验，生成审计表插入行。
+- 将事件写入审计表（HTTP 上报经 `backpressure.AuditWriteQueue` 组提交；其它入口逐条写入）。
 
 依赖/调用关系：
-- 由 `router_uplink.py` 调用。
+- 由 `router_uplink.py` 调用 `build_audit_row`，`tools/mqtt_broker_stub.py` 调用 `handle_audit_event`。
 - 使用 `repo_sqlite.SQLiteRepo` 写入数据库。
 """
 
-from typing import Any, Dict, Tuple
+from typing import Any, Dict, Optional, Tuple
 
 from .repo_sqlite import SQLiteRepo
 
@@ -20,6 +20,48 @@ from .repo_sqlite import SQLiteRepo
 _REQUIRED_FIELDS = ("ev", "sid", "lockerId", "uid")
 
 
+def build_audit_row(
+    repo: SQLiteRepo,
+    trace_id: str,
+    device_id: str,
+    message_id: int,
+    payload: Dict[str, Any],
+) -> Tuple[int, str, Optional[Tuple[Any, ...]]]:
+    """
+    用途：校验审计 payload 并生成插入行（不访问数据库）。
+
+    参数：
+    - repo: SQLite 仓储实例。
+    - trace_id: 服务端追踪 ID。
+    - device_id: 设备 ID。
+    - message_id: 消息 ID。
+    - payload: 审计字段对象。
+
+    返回值：
+    - Tuple[int, str, Optional[tuple]]: `(业务码, 文本消息, 插入行)`；校验失败时插入行为 `None`。
+
+    边界行为：
+    - 缺少关键字段时返回 `5001`。
+    """
+    for key in _REQUIRED_FIELDS:
+        if key not in payload:
+            return 5001, f"invalid_audit_payload_missing_{key}", None
+    return 0, "ok", repo.audit_row(trace_id, device_id, message_id, payload)
+
+
+def audit_result_msg(inserted: int) -> str:
+    """
+    用途：单条审计入库后的应答文本。
+
+    参数：
+    - inserted: 新写入行数。
+
+    返回值：
+    - str: `ok`；同设备同 messageId 已入库（重发）时为 `duplicate_ignored`。
+    """
+    return "ok" if inserted else "duplicate_ignored"
+
+
 def handle_audit_event(
     repo: SQLiteRepo,
     trace_id: str,
@@ -42,16 +84,12 @@ def handle_audit_event(
 
     边界行为：
     - 缺少关键字段时返回 `5001`。
+    - 同设备同 messageId 重复上报（设备重发、批量重放）按成功返回，不重复入库。
     """
-    for key in _REQUIRED_FIELDS:
-        if key not in payload:
-            return 5001, f"invalid_audit_payload_missing_{key}"
-
-    # 审计数据直接入库，便于后续追溯。
-    repo.insert_audit_event(
-        trace_id=trace_id,
-        device_id=device_id,
-        message_id=message_id,
-        payload=payload,
-    )
-    return 0, "ok"
+    code, msg, row = build_audit_row(repo, trace_id, device_id, message_id, payload)
+    if row is None:
+        return code, msg
+
+    # 审计数据直接入库，便于后续追溯；唯一索引吸收重复，不必先查。
+    inserted = repo.insert_audit_rows([[row]])[0]
+    return 0, audit_result_msg(inserted)
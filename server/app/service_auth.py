@@ -5,16 +5,20 @@
 - 接收 `RFID_AUTH_REQ` 的 payload。
 - 执行业务判定（卡是否注册、是否有门位权限、是否重复请求）。
 - 生成业务码并持久化鉴权决策日志。
+- 判定（只读）与落库（写）拆成两步，路由可分别放到读线程池与写线程执行。
 
 依赖/调用关系：
-- 由 `router_uplink.py` 调用。
+- 由 `router_uplink.py` 分两步调用（`decide_auth` + `record_auth_decision`），`udp_auth.py` 调用 `handle_auth_event`。
 - 使用 `repo_sqlite.SQLiteRepo` 读写设备权限与鉴权记录。
 """
 
-from typing import Any, Dict, Tuple
+import logging
+from typing import Any, Dict, Optional, Tuple
 
 from .repo_sqlite import SQLiteRepo
 
+logger = logging.getLogger("uplink.auth")
+
 
 def _message_for_code(code: int) -> str:
     """
@@ -38,29 +42,20 @@ def _message_for_code(code: int) -> str:
     return mapping.get(code, "unknown")
 
 
-def handle_auth_event(
-    repo: SQLiteRepo,
-    trace_id: str,
-    device_id: str,
-    message_id: int,
-    payload: Dict[str, Any],
-) -> Tuple[int, str]:
+def decide_auth(repo: SQLiteRepo, payload: Dict[str, Any]) -> Tuple[int, str, Optional[Dict[str, str]]]:
     """
-    用途：处理同步鉴权事件。
+    用途：鉴权判定（只读，不落库）。
 
     参数：
     - repo: SQLite 仓储实例。
-    - trace_id: 服务端追踪 ID。
-    - device_id: 设备 ID。
-    - message_id: 消息 ID（用于幂等判重）。
     - payload: 鉴权业务字段（lockerId/uid/uidSha1 等）。
 
     返回值：
-    - Tuple[int, str]: `(业务码, 文本消息)`。
+    - Tuple[int, str, Optional[Dict[str, str]]]: `(业务码, 文本消息, 规整后的字段)`；
+      字段为 `None` 表示请求无效，不需要落库。
 
     边界行为：
     - payload 字段缺失时返回 `5001`。
-    - 同一设备同一 messageId 重复提交时返回 `1004`。
     """
     locker_id = str(payload.get("lockerId", "")).strip()
     uid = str(payload.get("uid", "")).strip()
@@ -68,34 +63,102 @@ def handle_auth_event(
 
     # 必要字段校验，缺失时视为请求无效。
     if not locker_id or not uid or not uid_sha1:
-        code = 5001
-        return code, "invalid_auth_payload"
-
-    # 幂等处理：同设备+同 messageId 视为重复请求。
-    duplicate = repo.get_auth_decision(device_id, message_id)
-    if duplicate is not None:
-        return 1004, _message_for_code(1004)
+        return 5001, "invalid_auth_payload", None
 
-    # 业务判定顺序：先确认卡存在，再确认门权限。
-    if not repo.has_card(uid_sha1):
+    # 业务判定顺序：先确认卡存在，再确认门权限（一次查询同时给出两者）。
+    card_exists, permitted = repo.check_card_access(uid_sha1, locker_id)
+    if not card_exists:
         code = 1001
-    elif not repo.has_permission(uid_sha1, locker_id):
+    elif not permitted:
         code = 1002
     else:
         code = 0
 
-    msg = _message_for_code(code)
+    return code, _message_for_code(code), {"locker_id": locker_id, "uid": uid, "uid_sha1": uid_sha1}
+
+
+def record_auth_decision(
+    repo: SQLiteRepo,
+    trace_id: str,
+    device_id: str,
+    message_id: int,
+    fields: Dict[str, str],
+    code: int,
+    msg: str,
+) -> Tuple[int, str]:
+    """
+    用途：持久化鉴权决策，返回最终应答的结论。
+
+    参数：
+    - repo: SQLite 仓储实例。
+    - trace_id: 服务端追踪 ID。
+    - device_id: 设备 ID。
+    - message_id: 消息 ID（用于幂等判重）。
+    - fields: `decide_auth` 返回的规整字段。
+    - code/msg: `decide_auth` 给出的判定。
 
+    返回值：
+    - Tuple[int, str]: `(业务码, 文本消息)`；同设备同 messageId 已有同卡同门位的结论时为首次结论，
+      卡或门位不同（messageId 被另一次刷卡复用）时为 `1004`。
+    """
     # 无论放行或拒绝，都记录一次鉴权决策，便于追踪。
-    repo.insert_auth_decision(
+    inserted = repo.insert_auth_decision(
         trace_id=trace_id,
         device_id=device_id,
         message_id=message_id,
-        locker_id=locker_id,
-        uid=uid,
-        uid_sha1=uid_sha1,
+        locker_id=fields["locker_id"],
+        uid=fields["uid"],
+        uid_sha1=fields["uid_sha1"],
         code=code,
         msg=msg,
     )
 
+    # 幂等处理：同设备+同 messageId 已有结论时回放首次判定（唯一键冲突才查，首次请求不多查一次）。
+    # MCU 对冲鉴权会把同一请求同时发往两个上级（或同一上级两次），先到的应答决定是否开门，
+    # 返回 1004 会让重复的那一份被当成拒绝；期间权限若有变更，也以首次结论为准。
+    # 只有同一张卡、同一门位才算同一请求：messageId 被另一次刷卡复用时不能回放（首次结论可能是放行），按 1004 拒绝。
+    if not inserted:
+        first = repo.get_auth_decision(device_id, message_id)
+        if first is not None:
+            if first["uid_sha1"] == fields["uid_sha1"] and first["locker_id"] == fields["locker_id"]:
+                return int(first["code"]), str(first["msg"])
+            logger.warning(
+                "auth messageId reused by a different request device=%s messageId=%s trace=%s",
+                device_id,
+                message_id,
+                trace_id,
+            )
+            return 1004, _message_for_code(1004)
+
     return code, msg
+
+
+def handle_auth_event(
+    repo: SQLiteRepo,
+    trace_id: str,
+    device_id: str,
+    message_id: int,
+    payload: Dict[str, Any],
+) -> Tuple[int, str]:
+    """
+    用途：处理同步鉴权事件（判定 + 落库在同一线程顺序执行）。
+
+    参数：
+    - repo: SQLite 仓储实例。
+    - trace_id: 服务端追踪 ID。
+    - device_id: 设备 ID。
+    - message_id: 消息 ID（用于幂等判重）。
+    - payload: 鉴权业务字段（lockerId/uid/uidSha1 等）。
+
+    返回值：
+    - Tuple[int, str]: `(业务码, 文本消息)`。
+
+    边界行为：
+    - payload 字段缺失时返回 `5001`。
+    - 同一设备同一 messageId 重复提交时回放首次判定结果（设备重传、对冲请求得到同一结论）；
+      卡或门位与首次不同则返回 `1004`。
+    """
+    code, msg, fields = decide_auth(repo, payload)
+    if fields is None:
+        return code, msg
+    return record_auth_decision(repo, trace_id, device_id, message_id, fields, code, msg)
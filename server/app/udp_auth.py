@@ -0,0 +1,302 @@
+﻿"""
+文件作用：UDP 单往返同步鉴权监听模块。
+
+主要职责：
+- 在独立 UDP 端口接收 MCU 的 `RFID_AUTH_REQ` 请求报文（CON）。
+- 按设备共享密钥校验报文 HMAC 标签，复用 `service_auth.handle_auth_event` 做业务判定。
+- 以相同 messageId 回送应答报文（ACK），body 与 HTTP 响应一致（code/msg/traceId）。
+- 新鲜度与 HTTP 签名对应：请求时间戳超出 `SIGNATURE_MAX_SKEW_SEC` 时不判定，回 TIME 报文让设备对时；
+  `(deviceId, timestamp, nonce)` 在 nonce 缓存里见过的新请求丢弃（重传由 `AckCache` 回放）。
+
+报文格式（大端，与 MCU `uplink_transport_udp_netconn.h` 一致）：
+- 0x55 | (版本<<4)|类型 | messageId(4B) | timestamp(4B) | nonce(4B) | json_len(2B) | JSON | HMAC-SHA256 前 16 字节
+- HMAC 覆盖头部 16 字节 + JSON。
+- ACK/TIME 的 timestamp 为服务端 Unix 秒，nonce 回显请求的 nonce：设备只接受与本次请求 nonce 一致的应答，
+  messageId 在重启前后重复时，截获的旧 ACK 也无法冒充新请求的应答。
+
+依赖/调用关系：
+- 由 `main.py` 在启动事件中通过 `loop.create_datagram_endpoint` 创建。
+- 使用 `repo_sqlite.SQLiteRepo` 查询设备密钥。
+- 给出 `db_workers.DbWorkers` 时，整个报文处理（查设备、判定、落库）放到写线程按鉴权优先级执行，
+  事件循环不访问数据库；`AckCache` 也因此只在写线程里读写。
+"""
+
+import hashlib
+import hmac
+import json
+import logging
+import struct
+import time
+import asyncio
+import uuid
+from collections import OrderedDict
+from typing import Any, Dict, Optional, Set, Tuple
+
+from .db_workers import PRIO_AUTH, DbWorkers
+from .repo_sqlite import SQLiteRepo
+from .security import NonceStore
+from .service_auth import handle_auth_event
+
+logger = logging.getLogger("uplink.udp_auth")
+
+UDP_MAGIC = 0x55
+UDP_VERSION = 2
+UDP_TYPE_CON = 0
+UDP_TYPE_ACK = 2
+UDP_TYPE_TIME = 3
+UDP_HEADER = struct.Struct(">BBIIIH")
+UDP_TAG_LEN = 16
+
+
+def _calc_tag(secret: str, data: bytes) -> bytes:
+    """
+    用途：计算报文认证标签（HMAC-SHA256 截断 16 字节）。
+
+    参数：
+    - secret: 设备共享密钥。
+    - data: 头部 + JSON 字节串。
+
+    返回值：
+    - bytes: 16 字节标签。
+    """
+    return hmac.new(secret.encode("utf-8"), data, hashlib.sha256).digest()[:UDP_TAG_LEN]
+
+
+def build_ack(
+    secret: str,
+    message_id: int,
+    nonce: int,
+    body: Optional[Dict[str, Any]],
+    now_sec: Optional[int] = None,
+) -> bytes:
+    """
+    用途：构造应答报文（ACK；`body` 为 None 时构造 TIME 对时报文）。
+
+    参数：
+    - secret: 设备共享密钥。
+    - message_id: 与请求相同的 messageId。
+    - nonce: 回显请求的 nonce。
+    - body: 响应 JSON 对象（code/msg/traceId）；None 表示 TIME（无 JSON）。
+    - now_sec: 报文时间戳（Unix 秒），默认取当前时间。
+
+    返回值：
+    - bytes: 完整报文字节串。
+    """
+    if now_sec is None:
+        now_sec = int(time.time())
+    json_bytes = b"" if body is None else json.dumps(body, separators=(",", ":")).encode("utf-8")
+    msg_type = UDP_TYPE_TIME if body is None else UDP_TYPE_ACK
+    header = UDP_HEADER.pack(
+        UDP_MAGIC, (UDP_VERSION << 4) | msg_type, message_id, now_sec & 0xFFFFFFFF, nonce, len(json_bytes)
+    )
+    signed = header + json_bytes
+    return signed + _calc_tag(secret, signed)
+
+
+class AckCache:
+    """
+    用途：按 `(deviceId, messageId, timestamp, nonce)` 缓存最近的 ACK 报文。
+
+    说明：
+    - MCU 在 ACK 丢失时会原样重传（messageId、timestamp、nonce 都不变）；命中缓存直接回送原应答（含原 traceId），
+      不再查库重判。
+    - 键带 timestamp/nonce：重启后 messageId 重复的新请求 timestamp/nonce 不同，不会拿到旧请求的应答。
+    - 容量与 TTL 双重约束，防止内存无限增长。
+    """
+
+    def __init__(self, ttl_sec: int, max_items: int = 1024) -> None:
+        self.ttl_sec = ttl_sec
+        self.max_items = max_items
+        self._items: "OrderedDict[Tuple[str, int, int, int], Tuple[float, bytes]]" = OrderedDict()
+
+    def get(self, key: Tuple[str, int, int, int], now: float) -> Optional[bytes]:
+        """
+        用途：查询未过期的缓存应答。
+
+        参数：
+        - key: `(deviceId, messageId, timestamp, nonce)`。
+        - now: 当前单调时间（秒）。
+
+        返回值：
+        - bytes | None: 命中返回 ACK 报文，未命中或已过期返回 None。
+        """
+        item = self._items.get(key)
+        if item is None:
+            return None
+        if item[0] < now:
+            self._items.pop(key, None)
+            return None
+        return item[1]
+
+    def put(self, key: Tuple[str, int, int, int], packet: bytes, now: float) -> None:
+        """
+        用途：写入一条应答缓存，超出容量时淘汰最旧项。
+
+        参数：
+        - key: `(deviceId, messageId, timestamp, nonce)`。
+        - packet: ACK 报文。
+        - now: 当前单调时间（秒）。
+
+        返回值：
+        - 无。
+        """
+        self._items[key] = (now + self.ttl_sec, packet)
+        self._items.move_to_end(key)
+        while len(self._items) > self.max_items:
+            self._items.popitem(last=False)
+
+
+class UdpAuthProtocol:
+    """
+    用途：asyncio DatagramProtocol 实现，处理 UDP 鉴权请求。
+
+    字段说明：
+    - repo: SQLite 仓储实例。
+    - cache: 重传去重用的 ACK 缓存。
+    - transport: asyncio 数据报传输对象（连接建立后赋值）。
+    - db: 数据库访问线程；为 `None` 时在事件循环里直接处理。
+    - max_skew_sec: 请求时间戳允许偏差（秒），与 HTTP 签名共用 `SIGNATURE_MAX_SKEW_SEC`。
+    - nonce_store: 防重放 nonce 缓存（与 HTTP 签名共用，键加 `udp:` 前缀）。
+    """
+
+    def __init__(
+        self,
+        repo: SQLiteRepo,
+        cache_ttl_sec: int,
+        db: Optional[DbWorkers] = None,
+        max_skew_sec: int = 120,
+        nonce_store: Optional[NonceStore] = None,
+    ) -> None:
+        self.repo = repo
+        self.cache = AckCache(ttl_sec=cache_ttl_sec)
+        self.transport = None
+        self.db = db
+        self.max_skew_sec = max_skew_sec
+        self.nonce_store = nonce_store if nonce_store is not None else NonceStore(ttl_sec=cache_ttl_sec)
+        self._tasks: Set[asyncio.Task] = set()
+
+    def connection_made(self, transport) -> None:
+        self.transport = transport
+
+    def connection_lost(self, exc) -> None:
+        self.transport = None
+
+    def error_received(self, exc) -> None:
+        logger.warning("udp auth socket error: %s", exc)
+
+    def datagram_received(self, data: bytes, addr) -> None:
+        """
+        用途：处理单个请求报文。
+
+        参数：
+        - data: 原始报文。
+        - addr: 对端地址。
+
+        返回值：
+        - 无。
+
+        边界行为：
+        - 格式错误、设备未注册、标签校验失败的报文直接丢弃，不回任何应答
+          （避免被用作反射放大），MCU 侧按超时处理。
+        - 标签合法但时间戳超出窗口或 nonce 已用过时回 TIME（不判定、不落库），报文不比请求大。
+        """
+        if self.db is None:
+            self._reply(self.handle_datagram(data), addr)
+            return
+
+        # 事件循环只持有任务的弱引用，这里保留到完成为止。
+        task = asyncio.ensure_future(self._handle_in_db(data, addr))
+        self._tasks.add(task)
+        task.add_done_callback(self._tasks.discard)
+
+    async def _handle_in_db(self, data: bytes, addr) -> None:
+        """
+        用途：在写线程中处理报文，完成后回到事件循环发送应答。
+        """
+        try:
+            packet = await self.db.write(self.handle_datagram, data, priority=PRIO_AUTH)
+        except Exception as exc:
+            logger.warning("udp auth failed: %r", exc)
+            return
+        self._reply(packet, addr)
+
+    def _reply(self, packet: Optional[bytes], addr) -> None:
+        if packet is not None and self.transport is not None:
+            self.transport.sendto(packet, addr)
+
+    def handle_datagram(self, data: bytes) -> Optional[bytes]:
+        """
+        用途：解析、校验并处理请求报文，返回应回送的 ACK。
+
+        参数：
+        - data: 原始报文。
+
+        返回值：
+        - bytes | None: 应答报文；需静默丢弃时返回 None。
+        """
+        if len(data) < UDP_HEADER.size + UDP_TAG_LEN:
+            return None
+
+        magic, ver_type, message_id, ts, nonce, json_len = UDP_HEADER.unpack_from(data, 0)
+        if magic != UDP_MAGIC or ver_type != ((UDP_VERSION << 4) | UDP_TYPE_CON):
+            return None
+        if UDP_HEADER.size + json_len + UDP_TAG_LEN != len(data):
+            return None
+
+        signed = data[: UDP_HEADER.size + json_len]
+        tag = data[UDP_HEADER.size + json_len :]
+
+        try:
+            event = json.loads(signed[UDP_HEADER.size :].decode("utf-8"))
+            device_id = str(event["deviceId"])
+            payload = event["payload"]
+            event_type = event["type"]
+            body_message_id = int(event["messageId"])
+        except Exception:
+            return None
+
+        # 头部 messageId 与 JSON 内的必须一致，避免拿一个 id 的 ACK 去应答另一个请求。
+        if body_message_id != message_id or not isinstance(payload, dict):
+            return None
+
+        device = self.repo.get_device(device_id)
+        if not device or int(device.get("status", 0)) != 1:
+            return None
+
+        secret = device.get("secret", "")
+        if not hmac.compare_digest(_calc_tag(secret, signed), tag):
+            return None
+
+        now = time.monotonic()
+        key = (device_id, message_id, ts, nonce)
+        cached = self.cache.get(key, now)
+        if cached is not None:
+            return cached
+
+        # 时间窗口与 nonce 与 HTTP 签名相同；未对时的设备时间戳为 0，先拿 TIME 对时再重发。
+        # 重复的 nonce（重放，或设备重启前后碰上）同样不判定，回 TIME 让设备换 nonce 重发。
+        now_sec = int(time.time())
+        if abs(now_sec - ts) > self.max_skew_sec:
+            logger.debug("udp auth time sync device=%s ts=%s", device_id, ts)
+            return build_ack(secret, message_id, nonce, None, now_sec)
+        if self.nonce_store.seen(f"udp:{device_id}:{ts}:{nonce}", now_sec):
+            logger.warning("udp auth nonce reused device=%s messageId=%s", device_id, message_id)
+            return build_ack(secret, message_id, nonce, None, now_sec)
+
+        trace_id = uuid.uuid4().hex
+        if event_type == "RFID_AUTH_REQ":
+            code, msg = handle_auth_event(
+                repo=self.repo,
+                trace_id=trace_id,
+                device_id=device_id,
+                message_id=message_id,
+                payload=payload,
+            )
+        else:
+            # UDP 通道只承载同步鉴权，审计仍走 HTTP。
+            code, msg = 5002, f"unsupported_type_{event_type}"
+
+        self.repo.touch_device_seen(device_id)
+        packet = build_ack(secret, message_id, nonce, {"code": code, "msg": msg, "traceId": trace_id}, now_sec)
+        self.cache.put(key, packet, now)
+        return packet
@@ -0,0 +1,260 @@
+﻿"""
+文件作用：上级服务压测脚本（同步鉴权吞吐与时延，可叠加审计背景负载）。
+
+主要职责：
+- 多线程并发发送带签名的 `RFID_AUTH_REQ`，每个线程复用一条 keep-alive 连接。
+- 可选：另开线程持续发送合并上报的审计（`RFID_AUDIT` 数组），按 `retryAfterMs` 暂缓，模拟补报高峰。
+- 统计鉴权请求数/秒与时延分位（p50/p99/max），以及审计入库条数/秒。
+
+使用场景：
+- 先执行 `seed_demo_data.py` 写入演示设备与卡，再启动服务，然后执行本脚本，例如：
+  `python tools/load_test.py --concurrency 16 --duration 10`
+  `python tools/load_test.py --concurrency 4 --audit-concurrency 32 --audit-batch 8`
+- 只用标准库，不依赖服务端代码，可在任意机器上对远端服务压测。
+"""
+
+import argparse
+import hashlib
+import hmac
+import http.client
+import json
+import random
+import threading
+import time
+import uuid
+from typing import List
+from urllib.parse import urlparse
+
+# 与 seed_demo_data.py 写入的演示数据一致。
+DEMO_CARDS = (
+    ("1111111111111111111111111111111111111111", "A01"),
+    ("2222222222222222222222222222222222222222", "A02"),
+)
+
+# 与 seed_demo_data.py `--cards` 写入的压测卡一致（uid_sha1 = sha1("bench-card-<i>")，门位 B01..B16）。
+BENCH_LOCKERS = 16
+
+
+def _pick_card(rng: random.Random, cards: int):
+    """
+    用途：随机取一张卡：`--cards` 为 0 时取演示卡，否则从压测卡中取（用它有权限的第一个门位）。
+    """
+    if cards <= 0:
+        return rng.choice(DEMO_CARDS)
+    index = rng.randrange(cards)
+    return hashlib.sha1(f"bench-card-{index}".encode("utf-8")).hexdigest(), f"B{index % BENCH_LOCKERS + 1:02d}"
+
+
+class _Worker(threading.Thread):
+    """
+    用途：单个压测线程，在截止时刻前循环发送鉴权请求。
+
+    参数：
+    - args: 命令行参数。
+    - deadline: 截止时刻（`time.perf_counter()`）。
+    - id_base: 本线程 messageId 起点（各线程错开，避免被当成重发）。
+    """
+
+    def __init__(self, args: argparse.Namespace, deadline: float, id_base: int, audit: bool = False) -> None:
+        super().__init__(daemon=True)
+        self.args = args
+        self.deadline = deadline
+        self.next_id = id_base
+        self.audit = audit
+        self.latencies_ms: List[float] = []
+        self.errors = 0
+        self.codes = {}
+        self.events_ok = 0
+
+    def run(self) -> None:
+        url = urlparse(self.args.url)
+        conn = http.client.HTTPConnection(url.hostname, url.port or 80, timeout=10)
+        rng = random.Random(self.next_id)
+
+        while time.perf_counter() < self.deadline:
+            uid_sha1, locker_id = _pick_card(rng, self.args.cards)
+            if self.audit:
+                body = self._audit_body(uid_sha1, locker_id)
+            else:
+                body = self._auth_body(uid_sha1, locker_id)
+            headers = self._headers(body)
+
+            t0 = time.perf_counter()
+            try:
+                conn.request("POST", url.path, body=body, headers=headers)
+                resp = conn.getresponse()
+                data = resp.read()
+            except (OSError, http.client.HTTPException):
+                self.errors += 1
+                conn.close()
+                conn = http.client.HTTPConnection(url.hostname, url.port or 80, timeout=10)
+                continue
+            self.latencies_ms.append((time.perf_counter() - t0) * 1000.0)
+
+            rsp = json.loads(data)
+            code = rsp.get("code")
+            self.codes[code] = self.codes.get(code, 0) + 1
+            if self.audit and code == 0:
+                self.events_ok += self.args.audit_batch
+                if self.args.audit_interval_ms:
+                    # 定速模式：按设定间隔发送（减去本次耗时），模拟真实补报节奏而不是打满 CPU。
+                    wait = self.args.audit_interval_ms / 1000.0 - (time.perf_counter() - t0)
+                    if wait > 0:
+                        time.sleep(min(wait, max(self.deadline - time.perf_counter(), 0.0)))
+            elif rsp.get("retryAfterMs"):
+                # 与设备一致：被要求暂缓时等到给出的时刻再发（同一批不重发，换下一批即可）。
+                time.sleep(min(rsp["retryAfterMs"] / 1000.0, max(self.deadline - time.perf_counter(), 0.0)))
+
+        conn.close()
+
+    def _auth_body(self, uid_sha1: str, locker_id: str) -> bytes:
+        """
+        用途：构造一条鉴权请求 body（messageId 递增，不触发幂等回放）。
+        """
+        self.next_id += 1
+        event = {
+            "deviceId": self.args.device,
+            "messageId": self.next_id,
+            "ts": int(time.time() * 1000),
+            "type": "RFID_AUTH_REQ",
+            "payload": {
+                "lockerId": locker_id,
+                "uid": uid_sha1[:8].upper(),
+                "uidSha1": uid_sha1,
+                "deviceId": self.args.device,
+                "sessionId": self.next_id,
+                "clientTsMs": int(time.time() * 1000),
+            },
+        }
+        return json.dumps(event, separators=(",", ":")).encode("utf-8")
+
+    def _audit_body(self, uid_sha1: str, locker_id: str) -> bytes:
+        """
+        用途：构造一条合并上报 body（`--audit-batch` 条读卡审计组成的数组）。
+        """
+        events = []
+        for _ in range(self.args.audit_batch):
+            self.next_id += 1
+            events.append(
+                {
+                    "deviceId": self.args.device,
+                    "messageId": self.next_id,
+                    "ts": int(time.time() * 1000),
+                    "type": "RFID_AUDIT",
+                    "payload": {
+                        "ev": "CARD_READ",
+                        "sid": self.next_id,
+                        "lockerId": locker_id,
+                        "uid": uid_sha1[:8].upper(),
+                        "code": 0,
+                        "http": 200,
+                        "net": 1,
+                        "door": 1,
+                        "cache": 0,
+                        "drop": 0,
+                    },
+                }
+            )
+        return json.dumps(events, separators=(",", ":")).encode("utf-8")
+
+    def _headers(self, body: bytes) -> dict:
+        """
+        用途：构造请求头；给出设备密钥时按 MCU 的方式签名（timestamp + nonce + body）。
+        """
+        headers = {"Content-Type": "application/json"}
+        if not self.args.secret:
+            return headers
+
+        ts = str(int(time.time()))
+        nonce = uuid.uuid4().hex
+        data = f"{ts}\n{nonce}\n".encode("utf-8") + body
+        headers.update(
+            {
+                "X-Device-Id": self.args.device,
+                "X-Timestamp": ts,
+                "X-Nonce": nonce,
+                "X-Signature": hmac.new(self.args.secret.encode("utf-8"), data, hashlib.sha256).hexdigest(),
+            }
+        )
+        return headers
+
+
+def _percentile(sorted_values: List[float], p: float) -> float:
+    """
+    用途：取已排序序列的分位值（最近秩）。
+    """
+    if not sorted_values:
+        return 0.0
+    return sorted_values[min(len(sorted_values) - 1, int(p * len(sorted_values)))]
+
+
+def main() -> None:
+    """
+    用途：解析参数、启动压测线程并打印汇总。
+
+    参数：
+    - 无（命令行参数见 `--help`）。
+
+    返回值：
+    - 无（结果打印到终端）。
+    """
+    parser = argparse.ArgumentParser(description="RFID uplink server load test (auth)")
+    parser.add_argument("--url", default="http://127.0.0.1:8080/api/uplink")
+    parser.add_argument("--concurrency", type=int, default=16, help="并发连接数")
+    parser.add_argument("--duration", type=float, default=10.0, help="压测时长（秒）")
+    parser.add_argument("--device", default="stm32f4")
+    parser.add_argument("--secret", default="dev-secret-stm32f4", help="设备密钥；置空则不签名")
+    parser.add_argument("--cards", type=int, default=0, help="从 seed --cards 写入的前 N 张压测卡中随机取卡（0=演示卡）")
+    parser.add_argument("--audit-concurrency", type=int, default=0, help="审计背景负载的并发连接数（0=不加）")
+    parser.add_argument("--audit-batch", type=int, default=8, help="每个审计请求合并的事件数")
+    parser.add_argument("--audit-interval-ms", type=float, default=0.0, help="每个审计连接的发送间隔（0=收到应答立即再发）")
+    args = parser.parse_args()
+
+    deadline = time.perf_counter() + args.duration
+    # messageId 按运行时刻错开，重复执行不会撞上上一轮已落库的结论。
+    id_base = (int(time.time()) % 400) * 10000000
+    workers = [_Worker(args, deadline, id_base + i * 100000) for i in range(args.concurrency)]
+    auditors = [
+        _Worker(args, deadline, id_base + (args.concurrency + i) * 100000, audit=True)
+        for i in range(args.audit_concurrency)
+    ]
+
+    t0 = time.perf_counter()
+    for w in workers + auditors:
+        w.start()
+    for w in workers + auditors:
+        w.join()
+    elapsed = time.perf_counter() - t0
+
+    latencies = sorted(x for w in workers for x in w.latencies_ms)
+    errors = sum(w.errors for w in workers)
+    codes = {}
+    for w in workers:
+        for code, count in w.codes.items():
+            codes[code] = codes.get(code, 0) + count
+
+    print(
+        f"auth: {len(latencies)} req in {elapsed:.1f}s = {len(latencies) / elapsed:.0f} req/s "
+        f"(concurrency={args.concurrency}, errors={errors})"
+    )
+    print(
+        f"latency ms: p50={_percentile(latencies, 0.50):.1f} p99={_percentile(latencies, 0.99):.1f} "
+        f"max={latencies[-1] if latencies else 0.0:.1f}"
+    )
+    print(f"codes: {codes}")
+
+    if auditors:
+        audit_codes = {}
+        for w in auditors:
+            for code, count in w.codes.items():
+                audit_codes[code] = audit_codes.get(code, 0) + count
+        events_ok = sum(w.events_ok for w in auditors)
+        print(
+            f"audit: {events_ok / elapsed:.0f} events/s stored "
+            f"(concurrency={args.audit_concurrency}, batch={args.audit_batch}, "
+            f"errors={sum(w.errors for w in auditors)}, codes={audit_codes})"
+        )
+
+
+if __name__ == "__main__":
+    main()
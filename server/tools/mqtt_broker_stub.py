@@ -0,0 +1,254 @@
+﻿"""
+文件作用：本机联调用的最小 MQTT broker 替身。
+
+主要职责：
+- 接受 MCU `uplink_transport_mqtt_netconn` 的 CONNECT，回 CONNACK（按 clientId 记录会话是否存在）。
+- 对 QoS1 PUBLISH 回 PUBACK，可选把 JSON 事件落库（复用 `service_audit` / `service_auth`）。
+- 回应 PINGREQ；每隔固定秒数打印一次消息速率（msgs/sec）与重复投递（DUP）计数。
+
+使用场景：
+- 没有正式 broker 时验证 MCU 的 MQTT 链路、在途窗口与断线重发行为。
+- 只实现发布端需要的子集，不支持订阅/转发，不能替代正式 broker。
+"""
+
+import argparse
+import asyncio
+import json
+import struct
+import time
+import uuid
+from pathlib import Path
+import sys
+from typing import Optional, Set
+
+# 让脚本可从 `server/tools` 直接执行并导入 `app` 包。
+ROOT_DIR = Path(__file__).resolve().parents[1]
+if str(ROOT_DIR) not in sys.path:
+    sys.path.insert(0, str(ROOT_DIR))
+
+from app.config import load_settings
+from app.repo_sqlite import SQLiteRepo
+from app.service_audit import handle_audit_event
+from app.service_auth import handle_auth_event
+
+
+class Stats:
+    """
+    用途：统计 PUBLISH 数量并周期输出速率。
+
+    字段说明：
+    - total: 累计 PUBLISH 数。
+    - dup: 其中带 DUP 标志的重发数。
+    - window: 当前统计窗口内的 PUBLISH 数。
+    """
+
+    def __init__(self) -> None:
+        self.total = 0
+        self.dup = 0
+        self.window = 0
+        self.window_start = time.monotonic()
+
+    def report(self) -> None:
+        """
+        用途：打印当前窗口速率并开启下一个窗口。
+
+        参数：
+        - 无。
+
+        返回值：
+        - 无（结果打印到终端）。
+        """
+        now = time.monotonic()
+        elapsed = max(now - self.window_start, 1e-6)
+        print(f"[broker] {self.window / elapsed:.1f} msgs/sec total={self.total} dup={self.dup}")
+        self.window = 0
+        self.window_start = now
+
+
+async def _read_packet(reader: asyncio.StreamReader):
+    """
+    用途：读取一个完整 MQTT 控制报文。
+
+    参数：
+    - reader: 连接读取流。
+
+    返回值：
+    - Tuple[int, bytes]: `(固定头首字节, 可变头+载荷)`。
+
+    异常：
+    - 连接关闭时抛出 `asyncio.IncompleteReadError`。
+    """
+    first = (await reader.readexactly(1))[0]
+    length = 0
+    mul = 1
+    for _ in range(4):
+        b = (await reader.readexactly(1))[0]
+        length += (b & 0x7F) * mul
+        mul *= 128
+        if not b & 0x80:
+            break
+    body = await reader.readexactly(length) if length else b""
+    return first, body
+
+
+def _ingest(repo: SQLiteRepo, raw: bytes) -> None:
+    """
+    用途：把 PUBLISH 载荷当作 uplink 事件落库。
+
+    参数：
+    - repo: SQLite 仓储实例。
+    - raw: 事件 JSON 字节串。
+
+    返回值：
+    - 无。
+
+    边界行为：
+    - 解析失败或类型未知时静默忽略（broker 仍回 PUBACK，避免设备无限重发）。
+    """
+    try:
+        event = json.loads(raw.decode("utf-8"))
+        kwargs = dict(
+            repo=repo,
+            trace_id=uuid.uuid4().hex,
+            device_id=str(event["deviceId"]),
+            message_id=int(event["messageId"]),
+            payload=event["payload"],
+        )
+    except Exception:
+        return
+
+    if event.get("type") == "RFID_AUDIT":
+        handle_audit_event(**kwargs)
+    elif event.get("type") == "RFID_AUTH_REQ":
+        handle_auth_event(**kwargs)
+
+
+async def _serve_client(
+    reader: asyncio.StreamReader,
+    writer: asyncio.StreamWriter,
+    sessions: Set[str],
+    stats: Stats,
+    repo: Optional[SQLiteRepo],
+) -> None:
+    """
+    用途：处理单个客户端连接。
+
+    参数：
+    - reader/writer: 连接读写流。
+    - sessions: 已建立过持久会话的 clientId 集合。
+    - stats: 速率统计对象。
+    - repo: 非 None 时把事件落库。
+
+    返回值：
+    - 无。
+    """
+    client_id = "?"
+    try:
+        while True:
+            first, body = await _read_packet(reader)
+            ptype = first & 0xF0
+
+            if ptype == 0x10:  # CONNECT
+                name_len = struct.unpack_from(">H", body, 0)[0]
+                flags = body[2 + name_len + 1]
+                id_len = struct.unpack_from(">H", body, 2 + name_len + 4)[0]
+                client_id = body[2 + name_len + 6 : 2 + name_len + 6 + id_len].decode("utf-8", "replace")
+                clean = bool(flags & 0x02)
+                present = (not clean) and client_id in sessions
+                if clean:
+                    sessions.discard(client_id)
+                else:
+                    sessions.add(client_id)
+                writer.write(bytes([0x20, 0x02, 0x01 if present else 0x00, 0x00]))
+                print(f"[broker] connect client={client_id} clean={int(clean)} session_present={int(present)}")
+
+            elif ptype == 0x30:  # PUBLISH
+                qos = (first >> 1) & 0x03
+                topic_len = struct.unpack_from(">H", body, 0)[0]
+                pos = 2 + topic_len
+                packet_id = None
+                if qos > 0:
+                    packet_id = struct.unpack_from(">H", body, pos)[0]
+                    pos += 2
+
+                stats.total += 1
+                stats.window += 1
+                if first & 0x08:
+                    stats.dup += 1
+
+                if repo is not None:
+                    _ingest(repo, body[pos:])
+
+                if qos == 1:
+                    writer.write(bytes([0x40, 0x02]) + struct.pack(">H", packet_id))
+
+            elif ptype == 0xC0:  # PINGREQ
+                writer.write(bytes([0xD0, 0x00]))
+
+            elif ptype == 0xE0:  # DISCONNECT
+                break
+
+            await writer.drain()
+    except (asyncio.IncompleteReadError, ConnectionError):
+        pass
+    finally:
+        print(f"[broker] disconnect client={client_id}")
+        writer.close()
+
+
+async def _run(host: str, port: int, interval: float, ingest: bool) -> None:
+    """
+    用途：启动监听并周期打印速率。
+
+    参数：
+    - host/port: 监听地址与端口。
+    - interval: 速率打印间隔（秒）。
+    - ingest: 是否把事件落库。
+
+    返回值：
+    - 无（直到进程被中断）。
+    """
+    repo = None
+    if ingest:
+        settings = load_settings()
+        repo = SQLiteRepo(settings.db_path)
+        repo.init_db()
+
+    sessions: Set[str] = set()
+    stats = Stats()
+    server = await asyncio.start_server(
+        lambda r, w: _serve_client(r, w, sessions, stats, repo), host=host, port=port
+    )
+    print(f"[broker] listening on {host}:{port}")
+
+    async with server:
+        while True:
+            await asyncio.sleep(interval)
+            stats.report()
+
+
+def main() -> None:
+    """
+    用途：解析命令行参数并运行 broker 替身。
+
+    参数：
+    - 无（命令行：--host/--port/--interval/--ingest）。
+
+    返回值：
+    - 无。
+    """
+    parser = argparse.ArgumentParser(description="minimal MQTT broker stand-in for uplink tests")
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--interval", type=float, default=5.0)
+    parser.add_argument("--ingest", action="store_true", help="write received events into the SQLite db")
+    args = parser.parse_args()
+
+    try:
+        asyncio.run(_run(args.host, args.port, args.interval, args.ingest))
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+﻿"""
+文件作用：下行推送通道的回环时延测量（管理端下发 → 设备收到一行）。
+
+主要职责：
+- 以设备身份常连 `GET /api/push/stream`（带签名头，与 MCU `app_push` 相同），按 HTTP chunked 逐行解析。
+- 另开一条连接向 `POST /api/push/send` 逐条下发 `PERM_UPDATE`（payload 带序号），
+  记录从发出下发请求到推送流上收到该行的耗时。
+- 打印送达条数与时延分位（p50/p99/max）。
+
+使用场景：
+- 先执行 `seed_demo_data.py`，再启动服务，然后执行本脚本，例如：
+  `python tools/push_latency.py --count 1000`
+- 只用标准库，不依赖服务端代码。测的是服务端 + 本机协议栈，不含设备侧网络与任务调度。
+"""
+
+import argparse
+import hashlib
+import hmac
+import http.client
+import json
+import socket
+import threading
+import time
+import uuid
+from typing import Dict, List
+from urllib.parse import urlparse
+
+
+class _StreamReader(threading.Thread):
+    """
+    用途：设备侧推送流读取线程，记录每条 `PERM_UPDATE` 到达的时刻。
+
+    字段说明：
+    - arrived: `序号 -> 到达时刻（time.perf_counter）`。
+    - ready: 收到 `HELLO` 后置位。
+    """
+
+    def __init__(self, args: argparse.Namespace) -> None:
+        super().__init__(daemon=True)
+        self.args = args
+        self.arrived: Dict[int, float] = {}
+        self.ready = threading.Event()
+        self.sock = None
+
+    def _request(self, url) -> bytes:
+        headers = [
+            "GET /api/push/stream HTTP/1.1",
+            f"Host: {url.hostname}:{url.port or 80}",
+            "Accept: application/x-ndjson",
+            f"X-Device-Id: {self.args.device}",
+        ]
+        if self.args.secret:
+            ts = str(int(time.time()))
+            nonce = uuid.uuid4().hex
+            signature = hmac.new(
+                self.args.secret.encode("utf-8"), f"{ts}\n{nonce}\n".encode("utf-8"), hashlib.sha256
+            ).hexdigest()
+            headers += [f"X-Timestamp: {ts}", f"X-Nonce: {nonce}", f"X-Signature: {signature}"]
+        return ("\r\n".join(headers) + "\r\n\r\n").encode("ascii")
+
+    def run(self) -> None:
+        url = urlparse(self.args.url)
+        self.sock = socket.create_connection((url.hostname, url.port or 80))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.sock.sendall(self._request(url))
+        reader = self.sock.makefile("rb")
+
+        status = reader.readline()
+        if b" 200 " not in status:
+            print(f"push stream rejected: {status!r}")
+            self.ready.set()
+            return
+        while reader.readline() not in (b"\r\n", b""):
+            pass
+
+        # chunked：每块一行 JSON（服务端逐行产出），块内仍按行切分以防合并。
+        pending = b""
+        while True:
+            size_line = reader.readline()
+            if not size_line:
+                return
+            size = int(size_line.split(b";")[0], 16)
+            if size == 0:
+                return
+            pending += reader.read(size)
+            reader.readline()
+            now = time.perf_counter()
+            while b"\n" in pending:
+                line, pending = pending.split(b"\n", 1)
+                message = json.loads(line)
+                if message.get("type") == "HELLO":
+                    self.ready.set()
+                elif message.get("type") == "PERM_UPDATE" and "seq" in message:
+                    self.arrived[int(message["seq"])] = now
+
+
+def _percentile(sorted_values: List[float], p: float) -> float:
+    """
+    用途：取已排序序列的分位值（最近秩）。
+    """
+    if not sorted_values:
+        return 0.0
+    return sorted_values[min(len(sorted_values) - 1, int(p * len(sorted_values)))]
+
+
+def main() -> None:
+    """
+    用途：解析参数，建立推送流后逐条下发并打印时延汇总。
+
+    参数：
+    - 无（命令行参数见 `--help`）。
+
+    返回值：
+    - 无（结果打印到终端）。
+    """
+    parser = argparse.ArgumentParser(description="RFID push channel loopback latency")
+    parser.add_argument("--url", default="http://127.0.0.1:8080")
+    parser.add_argument("--count", type=int, default=200, help="下发条数")
+    parser.add_argument("--interval-ms", type=float, default=20.0, help="两次下发的间隔")
+    parser.add_argument("--device", default="stm32f4")
+    parser.add_argument("--secret", default="dev-secret-stm32f4", help="设备密钥；置空则不签名")
+    parser.add_argument("--admin-token", default="", help="服务端配置了 PUSH_ADMIN_TOKEN 时填写")
+    args = parser.parse_args()
+
+    reader = _StreamReader(args)
+    reader.start()
+    if not reader.ready.wait(5.0):
+        print("push stream not ready (no HELLO within 5s)")
+        return
+
+    url = urlparse(args.url)
+    conn = http.client.HTTPConnection(url.hostname, url.port or 80, timeout=5)
+    headers = {"Content-Type": "application/json"}
+    if args.admin_token:
+        headers["X-Admin-Token"] = args.admin_token
+
+    sent: Dict[int, float] = {}
+    for seq in range(args.count):
+        body = json.dumps(
+            {"deviceId": args.device, "type": "PERM_UPDATE", "payload": {"uidSha1": "0" * 40, "seq": seq}}
+        )
+        sent[seq] = time.perf_counter()
+        conn.request("POST", "/api/push/send", body=body, headers=headers)
+        conn.getresponse().read()
+        time.sleep(args.interval_ms / 1000.0)
+
+    time.sleep(0.5)
+    latencies = sorted((reader.arrived[seq] - t0) * 1000.0 for seq, t0 in sent.items() if seq in reader.arrived)
+    print(
+        f"push: delivered {len(latencies)}/{args.count} "
+        f"p50={_percentile(latencies, 0.50):.2f}ms p99={_percentile(latencies, 0.99):.2f}ms "
+        f"max={latencies[-1] if latencies else 0.0:.2f}ms"
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -5,6 +5,7 @@
 - 初始化数据库表结构。
 - 写入一个演示设备（`stm32f4`）。
 - 写入两条演示权限（A01/A02）。
+- 可选：`--cards N` 额外写入 N 张压测用卡（每张两个门位），用于大卡量下的鉴权压测。
 
 使用场景：
 - 本机第一次联调前执行一次，确保服务有可判定的数据。
@@ -12,6 +13,8 @@
 
 from datetime import datetime, timedelta, timezone
 from pathlib import Path
+import argparse
+import hashlib
 import sys
 
 # 让脚本可从 `server/tools` 直接执行并导入 `app` 包。
@@ -22,6 +25,20 @@ if str(ROOT_DIR) not in sys.path:
 from app.config import load_settings
 from app.repo_sqlite import SQLiteRepo
 
+# 压测卡的门位数（B01..B16），与 tools/load_test.py 一致。
+BENCH_LOCKERS = 16
+
+
+def bench_card(index: int):
+    """
+    用途：第 index 张压测卡的 uid_sha1 与门位（确定性生成，load_test 按同一规则取卡）。
+
+    返回值：
+    - Tuple[str, Tuple[str, str]]: `(uid_sha1, (门位1, 门位2))`。
+    """
+    uid_sha1 = hashlib.sha1(f"bench-card-{index}".encode("utf-8")).hexdigest()
+    return uid_sha1, (f"B{index % BENCH_LOCKERS + 1:02d}", f"B{(index + 5) % BENCH_LOCKERS + 1:02d}")
+
 
 def main() -> None:
     """
@@ -33,6 +50,10 @@ def main() -> None:
     返回值：
     - 无（结果通过 stdout 打印）。
     """
+    parser = argparse.ArgumentParser(description="seed demo data")
+    parser.add_argument("--cards", type=int, default=0, help="额外写入的压测卡数")
+    args = parser.parse_args()
+
     settings = load_settings()
     repo = SQLiteRepo(settings.db_path)
     repo.init_db()
@@ -60,6 +81,14 @@ def main() -> None:
         valid_to=valid_to,
     )
 
+    if args.cards > 0:
+        rows = (
+            (uid_sha1, locker_id, 1, valid_from, valid_to)
+            for uid_sha1, lockers in (bench_card(i) for i in range(args.cards))
+            for locker_id in lockers
+        )
+        print(f"bench cards={args.cards} permissions={repo.upsert_permissions(rows)}")
+
     print("seed completed")
     print(f"db={Path(settings.db_path)}")
 
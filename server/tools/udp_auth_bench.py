@@ -0,0 +1,265 @@
+﻿"""
+文件作用：同步鉴权 UDP 单往返与 HTTP 的对比测量（时延 + 每次决策的报文数）。
+
+主要职责：
+- UDP：按 MCU `uplink_transport_udp_netconn` 的报文格式（v2，timestamp + nonce + HMAC 标签）逐条发送 `RFID_AUTH_REQ`，
+  首条请求不带时间戳，先拿 TIME 对时（与设备启动后第一次鉴权相同，单独统计）。
+- HTTP：与 MCU 相同，每次决策新建一条 TCP 连接（`Connection: close`），带签名头。
+- 统计两种方式的时延分位（p50/p99/max）与每次决策的收发报文数：UDP 为数据报数；
+  HTTP 为内核 `TCP_INFO` 的 `segs_out/segs_in`（含握手、挥手与纯 ACK，仅 Linux）。
+
+使用场景：
+- 先执行 `seed_demo_data.py`，再以 `AUTH_UDP_ENABLED=1` 启动服务，然后执行本脚本，例如：
+  `python tools/udp_auth_bench.py --count 500`
+- 只用标准库，不依赖服务端代码；报文格式改动时需与 `app/udp_auth.py` 同步修改。
+"""
+
+import argparse
+import hashlib
+import hmac
+import json
+import socket
+import struct
+import time
+import uuid
+from typing import List, Optional, Tuple
+from urllib.parse import urlparse
+
+UDP_MAGIC = 0x55
+UDP_VERSION = 2
+UDP_TYPE_CON = 0
+UDP_TYPE_ACK = 2
+UDP_TYPE_TIME = 3
+UDP_HEADER = struct.Struct(">BBIIIH")
+UDP_TAG_LEN = 16
+
+# struct tcp_info 中 tcpi_segs_out / tcpi_segs_in 的偏移（Linux 4.2+）。
+_TCP_INFO_LEN = 232
+_TCP_INFO_SEGS = struct.Struct("=II")
+_TCP_INFO_SEGS_OFFSET = 136
+
+
+def _auth_event(device: str, message_id: int) -> bytes:
+    """
+    用途：构造一条鉴权请求 body（演示卡 + 演示门位）。
+    """
+    now_ms = int(time.time() * 1000)
+    event = {
+        "deviceId": device,
+        "messageId": message_id,
+        "ts": now_ms,
+        "type": "RFID_AUTH_REQ",
+        "payload": {
+            "lockerId": "A01",
+            "uid": "A1B2C3D4",
+            "uidSha1": "1111111111111111111111111111111111111111",
+            "deviceId": device,
+            "sessionId": message_id,
+            "clientTsMs": now_ms,
+        },
+    }
+    return json.dumps(event, separators=(",", ":")).encode("utf-8")
+
+
+def _tag(secret: str, data: bytes) -> bytes:
+    return hmac.new(secret.encode("utf-8"), data, hashlib.sha256).digest()[:UDP_TAG_LEN]
+
+
+class _UdpClient:
+    """
+    用途：UDP 鉴权客户端（与 MCU 传输层相同的对时、nonce 与应答匹配规则）。
+
+    字段说明：
+    - offset_s: 服务端时间 - 本地时间（秒）；`None` 表示尚未对时。
+    - tx/rx: 已发送/接收的数据报数。
+    """
+
+    def __init__(self, host: str, port: int, secret: str, timeout_s: float) -> None:
+        self.addr = (host, port)
+        self.secret = secret
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.settimeout(timeout_s)
+        self.offset_s: Optional[int] = None
+        self.counter = 0
+        self.tx = 0
+        self.rx = 0
+
+    def _con(self, message_id: int, body: bytes) -> Tuple[bytes, int]:
+        if self.offset_s is None:
+            ts, nonce = 0, int.from_bytes(uuid.uuid4().bytes[:4], "big")
+        else:
+            ts = int(time.time()) + self.offset_s
+            nonce = ((ts & 0xFFFFFF) << 8) | (self.counter & 0xFF)
+        self.counter += 1
+        header = UDP_HEADER.pack(UDP_MAGIC, (UDP_VERSION << 4) | UDP_TYPE_CON, message_id, ts, nonce, len(body))
+        return header + body + _tag(self.secret, header + body), nonce
+
+    def auth(self, message_id: int, body: bytes) -> Optional[dict]:
+        """
+        用途：发送一次鉴权并等待匹配的 ACK；收到 TIME 时对时后换 nonce 重发（最多两次）。
+
+        返回值：
+        - dict | None: ACK 的 JSON；超时返回 None（本工具不做重传，丢包按失败计）。
+        """
+        packet, nonce = self._con(message_id, body)
+        for _ in range(3):
+            self.sock.sendto(packet, self.addr)
+            self.tx += 1
+            try:
+                data = self.sock.recv(2048)
+            except socket.timeout:
+                return None
+            self.rx += 1
+            if len(data) < UDP_HEADER.size + UDP_TAG_LEN or _tag(self.secret, data[:-UDP_TAG_LEN]) != data[-UDP_TAG_LEN:]:
+                return None
+            _, ver_type, rx_id, ts, rx_nonce, json_len = UDP_HEADER.unpack_from(data, 0)
+            if rx_id != message_id or rx_nonce != nonce:
+                return None
+            self.offset_s = ts - int(time.time())
+            if ver_type & 0x0F == UDP_TYPE_TIME:
+                # 与设备相同：打散计数器后换 nonce 重发。
+                self.counter += int.from_bytes(uuid.uuid4().bytes[:1], "big") | 1
+                packet, nonce = self._con(message_id, body)
+                continue
+            return json.loads(data[UDP_HEADER.size : UDP_HEADER.size + json_len])
+        return None
+
+
+def _http_auth(url, device: str, secret: str, body: bytes, timeout_s: float) -> Tuple[Optional[dict], int, int]:
+    """
+    用途：新建 TCP 连接发送一次签名鉴权请求，读到对端关闭为止。
+
+    返回值：
+    - Tuple[dict | None, int, int]: `(响应 JSON, 发出报文段数, 收到报文段数)`；取不到 TCP_INFO 时报文段数为 -1。
+    """
+    ts = str(int(time.time()))
+    nonce = uuid.uuid4().hex
+    signature = hmac.new(secret.encode("utf-8"), f"{ts}\n{nonce}\n".encode("utf-8") + body, hashlib.sha256).hexdigest()
+    request = (
+        f"POST {url.path} HTTP/1.1\r\n"
+        f"Host: {url.hostname}:{url.port or 80}\r\n"
+        "Content-Type: application/json\r\n"
+        f"Content-Length: {len(body)}\r\n"
+        "Connection: close\r\n"
+        f"X-Device-Id: {device}\r\n"
+        f"X-Timestamp: {ts}\r\n"
+        f"X-Nonce: {nonce}\r\n"
+        f"X-Signature: {signature}\r\n"
+        "\r\n"
+    ).encode("ascii") + body
+
+    sock = socket.create_connection((url.hostname, url.port or 80), timeout=timeout_s)
+    try:
+        sock.sendall(request)
+        chunks = []
+        while True:
+            chunk = sock.recv(4096)
+            if not chunk:
+                break
+            chunks.append(chunk)
+        sock.shutdown(socket.SHUT_WR)
+        segs_out = segs_in = -1
+        if hasattr(socket, "TCP_INFO"):
+            info = sock.getsockopt(socket.IPPROTO_TCP, socket.TCP_INFO, _TCP_INFO_LEN)
+            if len(info) >= _TCP_INFO_SEGS_OFFSET + _TCP_INFO_SEGS.size:
+                segs_out, segs_in = _TCP_INFO_SEGS.unpack_from(info, _TCP_INFO_SEGS_OFFSET)
+    finally:
+        sock.close()
+
+    raw = b"".join(chunks)
+    _, _, rsp_body = raw.partition(b"\r\n\r\n")
+    try:
+        return json.loads(rsp_body), segs_out, segs_in
+    except ValueError:
+        return None, segs_out, segs_in
+
+
+def _percentile(sorted_values: List[float], p: float) -> float:
+    """
+    用途：取已排序序列的分位值（最近秩）。
+    """
+    if not sorted_values:
+        return 0.0
+    return sorted_values[min(len(sorted_values) - 1, int(p * len(sorted_values)))]
+
+
+def _report(name: str, latencies: List[float], failures: int, pkts_out: float, pkts_in: float) -> None:
+    latencies.sort()
+    print(
+        f"{name}: n={len(latencies)} fail={failures} "
+        f"p50={_percentile(latencies, 0.50):.2f}ms p99={_percentile(latencies, 0.99):.2f}ms "
+        f"max={latencies[-1] if latencies else 0.0:.2f}ms | packets/decision out={pkts_out:.1f} in={pkts_in:.1f}"
+    )
+
+
+def main() -> None:
+    """
+    用途：解析参数，依次测量 UDP 与 HTTP 并打印汇总。
+
+    参数：
+    - 无（命令行参数见 `--help`）。
+
+    返回值：
+    - 无（结果打印到终端）。
+    """
+    parser = argparse.ArgumentParser(description="RFID auth: UDP single round trip vs HTTP")
+    parser.add_argument("--url", default="http://127.0.0.1:8080/api/uplink")
+    parser.add_argument("--udp-port", type=int, default=5683)
+    parser.add_argument("--count", type=int, default=200, help="每种方式的鉴权次数")
+    parser.add_argument("--device", default="stm32f4")
+    parser.add_argument("--secret", default="dev-secret-stm32f4")
+    parser.add_argument("--timeout", type=float, default=1.5, help="单次等待应答的超时（秒）")
+    parser.add_argument(
+        "--interval-ms", type=float, default=5.0, help="两次鉴权的间隔；设备 nonce 每秒最多 256 个，间隔不宜小于 4ms"
+    )
+    args = parser.parse_args()
+
+    url = urlparse(args.url)
+    # messageId 按运行时刻错开，重复执行不会撞上上一轮已落库的结论。
+    id_base = (int(time.time()) % 400) * 10000000
+
+    udp = _UdpClient(url.hostname, args.udp_port, args.secret, args.timeout)
+    t0 = time.perf_counter()
+    first = udp.auth(id_base, _auth_event(args.device, id_base))
+    first_ms = (time.perf_counter() - t0) * 1000.0
+    print(f"udp first (time sync): {first_ms:.2f}ms tx={udp.tx} rx={udp.rx} code={first and first.get('code')}")
+
+    latencies: List[float] = []
+    failures = 0
+    tx0, rx0 = udp.tx, udp.rx
+    for i in range(1, args.count + 1):
+        message_id = id_base + i
+        body = _auth_event(args.device, message_id)
+        t0 = time.perf_counter()
+        rsp = udp.auth(message_id, body)
+        if rsp is None:
+            failures += 1
+        else:
+            latencies.append((time.perf_counter() - t0) * 1000.0)
+        time.sleep(args.interval_ms / 1000.0)
+    n = max(args.count, 1)
+    _report("udp ", latencies, failures, (udp.tx - tx0) / n, (udp.rx - rx0) / n)
+
+    latencies = []
+    failures = 0
+    segs_out = segs_in = 0
+    for i in range(1, args.count + 1):
+        message_id = id_base + args.count + i
+        body = _auth_event(args.device, message_id)
+        t0 = time.perf_counter()
+        try:
+            rsp, s_out, s_in = _http_auth(url, args.device, args.secret, body, args.timeout)
+        except OSError:
+            rsp, s_out, s_in = None, 0, 0
+        if rsp is None:
+            failures += 1
+        else:
+            latencies.append((time.perf_counter() - t0) * 1000.0)
+        segs_out += s_out
+        segs_in += s_in
+        time.sleep(args.interval_ms / 1000.0)
+    _report("http", latencies, failures, segs_out / n, segs_in / n)
+
+
+if __name__ == "__main__":
+    main()